@@ -37,6 +37,7 @@ enum {
     REPORT_ID_LIGHTING_LAMP_MULTI_UPDATE,      // 7: 多灯光更新报告ID
     REPORT_ID_LIGHTING_LAMP_RANGE_UPDATE,       // 8: 灯光范围更新报告ID
     REPORT_ID_LIGHTING_LAMP_ARRAY_CONTROL,       // 9: 灯光阵列控制报告ID
+    REPORT_ID_MOUSE,                            // 10: 摇杆鼠标报告ID
     REPORT_ID_COUNT                             // 报告ID总数
 };
 
@@ -97,6 +98,9 @@ enum {
       HID_INPUT        ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE )  ,\
   HID_COLLECTION_END \
 
+// 每个多灯更新报告最多携带的灯数量
+#define LAMP_MULTI_UPDATE_MAX_LAMPS 8
+
 // HID灯光和照明报告描述符模板宏定义
 // 参数: report_id - 基础报告ID
 // 生成6个连续的灯光HID报告ID，顺序如下:
@@ -181,7 +185,7 @@ enum {
       HID_USAGE         ( HID_USAGE_LIGHTING_LAMP_COUNT               ),\
       HID_USAGE         ( HID_USAGE_LIGHTING_LAMP_UPDATE_FLAGS        ),\
       HID_LOGICAL_MIN   ( 0                                           ),\
-      HID_LOGICAL_MAX   ( 8                                           ),\
+      HID_LOGICAL_MAX   ( LAMP_MULTI_UPDATE_MAX_LAMPS                 ),\
       HID_REPORT_SIZE   ( 8                                           ),\
       HID_REPORT_COUNT  ( 2                                           ),\
       HID_FEATURE       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE      ),\
@@ -189,7 +193,7 @@ enum {
       HID_LOGICAL_MIN   ( 0                                           ),\
       HID_LOGICAL_MAX_N ( 65535, 3                                    ),\
       HID_REPORT_SIZE   ( 16                                          ),\
-      HID_REPORT_COUNT  ( 8                                           ),\
+      HID_REPORT_COUNT  ( LAMP_MULTI_UPDATE_MAX_LAMPS                 ),\
       HID_FEATURE       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE      ),\
       HID_USAGE         ( HID_USAGE_LIGHTING_RED_UPDATE_CHANNEL       ),\
       HID_USAGE         ( HID_USAGE_LIGHTING_GREEN_UPDATE_CHANNEL     ),\
@@ -226,7 +230,7 @@ enum {
       HID_LOGICAL_MIN   ( 0                                           ),\
       HID_LOGICAL_MAX_N ( 255, 2                                      ),\
       HID_REPORT_SIZE   ( 8                                           ),\
-      HID_REPORT_COUNT  ( 32                                          ),\
+      HID_REPORT_COUNT  ( LAMP_MULTI_UPDATE_MAX_LAMPS * 4             ),\
       HID_FEATURE       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE      ),\
     HID_COLLECTION_END ,\
     /* Lamp Range Update Report */ \
@@ -269,4 +273,84 @@ enum {
     HID_COLLECTION_END ,\
   HID_COLLECTION_END \
 
+// 高分辨率滚轮的分辨率倍数，主机启用后每个滚轮单位为1/HID_MOUSE_SCROLL_RESOLUTION个刻度
+#define HID_MOUSE_SCROLL_RESOLUTION 8
+
+// 鼠标与滚轮HID报告描述符模板宏定义
+// 参数: report_id - 报告ID
+// 输入报告: 5个按键 + 16位相对X/Y + 8位垂直滚轮 + 8位水平滚轮(AC Pan)
+// 功能报告: 垂直和水平滚轮的分辨率倍数各2位，主机写1表示启用高分辨率滚动
+#define TUD_HID_REPORT_DESC_JOYSTICK_MOUSE(report_id) \
+  HID_USAGE_PAGE ( HID_USAGE_PAGE_DESKTOP     )                    ,\
+  HID_USAGE      ( HID_USAGE_DESKTOP_MOUSE    )                    ,\
+  HID_COLLECTION ( HID_COLLECTION_APPLICATION )                    ,\
+    HID_REPORT_ID ( report_id                 ) \
+    HID_USAGE      ( HID_USAGE_DESKTOP_POINTER )                   ,\
+    HID_COLLECTION ( HID_COLLECTION_PHYSICAL   )                   ,\
+      /* 5 buttons + 3 bit padding */ \
+      HID_USAGE_PAGE   ( HID_USAGE_PAGE_BUTTON                  )  ,\
+      HID_USAGE_MIN    ( 1                                      )  ,\
+      HID_USAGE_MAX    ( 5                                      )  ,\
+      HID_LOGICAL_MIN  ( 0                                      )  ,\
+      HID_LOGICAL_MAX  ( 1                                      )  ,\
+      HID_REPORT_COUNT ( 5                                      )  ,\
+      HID_REPORT_SIZE  ( 1                                      )  ,\
+      HID_INPUT        ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE )  ,\
+      HID_REPORT_COUNT ( 1                                      )  ,\
+      HID_REPORT_SIZE  ( 3                                      )  ,\
+      HID_INPUT        ( HID_CONSTANT                           )  ,\
+      /* 16 bit relative X, Y */ \
+      HID_USAGE_PAGE   ( HID_USAGE_PAGE_DESKTOP                 )  ,\
+      HID_USAGE        ( HID_USAGE_DESKTOP_X                    )  ,\
+      HID_USAGE        ( HID_USAGE_DESKTOP_Y                    )  ,\
+      HID_LOGICAL_MIN_N( -32767, 2                              )  ,\
+      HID_LOGICAL_MAX_N( 32767, 2                               )  ,\
+      HID_REPORT_COUNT ( 2                                      )  ,\
+      HID_REPORT_SIZE  ( 16                                     )  ,\
+      HID_INPUT        ( HID_DATA | HID_VARIABLE | HID_RELATIVE )  ,\
+      /* Vertical wheel with resolution multiplier */ \
+      HID_COLLECTION ( HID_COLLECTION_LOGICAL )                    ,\
+        HID_USAGE        ( HID_USAGE_DESKTOP_RESOLUTION_MULTIPLIER ),\
+        HID_LOGICAL_MIN  ( 0                                      ),\
+        HID_LOGICAL_MAX  ( 1                                      ),\
+        HID_PHYSICAL_MIN ( 1                                      ),\
+        HID_PHYSICAL_MAX ( HID_MOUSE_SCROLL_RESOLUTION            ),\
+        HID_REPORT_COUNT ( 1                                      ),\
+        HID_REPORT_SIZE  ( 2                                      ),\
+        HID_FEATURE      ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),\
+        HID_PHYSICAL_MIN ( 0                                      ),\
+        HID_PHYSICAL_MAX ( 0                                      ),\
+        HID_USAGE        ( HID_USAGE_DESKTOP_WHEEL                ),\
+        HID_LOGICAL_MIN  ( 0x81                                   ),\
+        HID_LOGICAL_MAX  ( 0x7f                                   ),\
+        HID_REPORT_COUNT ( 1                                      ),\
+        HID_REPORT_SIZE  ( 8                                      ),\
+        HID_INPUT        ( HID_DATA | HID_VARIABLE | HID_RELATIVE ),\
+      HID_COLLECTION_END                                           ,\
+      /* Horizontal wheel (AC Pan) with resolution multiplier */ \
+      HID_COLLECTION ( HID_COLLECTION_LOGICAL )                    ,\
+        HID_USAGE        ( HID_USAGE_DESKTOP_RESOLUTION_MULTIPLIER ),\
+        HID_LOGICAL_MIN  ( 0                                      ),\
+        HID_LOGICAL_MAX  ( 1                                      ),\
+        HID_PHYSICAL_MIN ( 1                                      ),\
+        HID_PHYSICAL_MAX ( HID_MOUSE_SCROLL_RESOLUTION            ),\
+        HID_REPORT_COUNT ( 1                                      ),\
+        HID_REPORT_SIZE  ( 2                                      ),\
+        HID_FEATURE      ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),\
+        /* 4 bit feature padding */ \
+        HID_REPORT_SIZE  ( 4                                      ),\
+        HID_FEATURE      ( HID_CONSTANT                           ),\
+        HID_PHYSICAL_MIN ( 0                                      ),\
+        HID_PHYSICAL_MAX ( 0                                      ),\
+        HID_USAGE_PAGE   ( HID_USAGE_PAGE_CONSUMER                ),\
+        HID_USAGE_N      ( HID_USAGE_CONSUMER_AC_PAN, 2           ),\
+        HID_LOGICAL_MIN  ( 0x81                                   ),\
+        HID_LOGICAL_MAX  ( 0x7f                                   ),\
+        HID_REPORT_COUNT ( 1                                      ),\
+        HID_REPORT_SIZE  ( 8                                      ),\
+        HID_INPUT        ( HID_DATA | HID_VARIABLE | HID_RELATIVE ),\
+      HID_COLLECTION_END                                           ,\
+    HID_COLLECTION_END                                             ,\
+  HID_COLLECTION_END \
+
 #endif
@@ -0,0 +1,352 @@
+#include <math.h>
+#include <inttypes.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_dsp.h"
+#include "seqlock.h"
+#include "audio_spectrum.h"
+#include "input_event.h"
+
+static const char *TAG = "audio_spectrum";
+
+// 分析任务参数，优先级低于音频管道的各个元素
+#define ANALYSIS_TASK_STACK     (3 * 1024)
+#define ANALYSIS_TASK_PRIO      2
+
+// 超出预算时最多每几块分析一块
+#define MAX_HOP                 4
+
+// 频段能量每块最多下降的量，上升不受限制
+#define BAND_DECAY              12
+
+// 满幅正弦的能量对数（单位为1/16个二进制数量级，约0.19dB），与之相差255即-48dB
+#define LEVEL_FULL_Q4           464     // 去直流后的均方值
+#define BAND_FULL_Q4            425     // 加汉宁窗、FFT按1/N缩放后一个频段内的能量
+
+#define HALF_SIZE               (AUDIO_SPECTRUM_FFT_SIZE / 2)
+
+// 频段边界（FFT bin），按对数间隔划分，抽取后采样率为11025Hz时约为43Hz到5.5kHz
+static const uint8_t s_band_edges[AUDIO_SPECTRUM_BANDS + 1] = {1, 3, 5, 9, 15, 26, 44, 75, HALF_SIZE};
+
+// 透传元素的抽取状态，只由元素任务访问
+typedef struct {
+    int sample_rate;
+    int channels;
+    int bits;
+    uint32_t decimation;                        // 抽取倍数，0表示格式不支持，不做分析
+    int32_t sum;                                // 当前抽取窗口内的累加值
+    uint32_t count;
+    int16_t block[AUDIO_SPECTRUM_FFT_SIZE];     // 抽取后的单声道样本
+    uint32_t fill;
+    uint32_t hop_count;
+} tap_state_t;
+
+static tap_state_t s_tap;
+
+// 交给分析任务的块，s_pending为true时属于分析任务
+static int16_t s_work[AUDIO_SPECTRUM_FFT_SIZE];
+static uint32_t s_work_rate;
+static _Atomic bool s_pending;
+static _Atomic uint8_t s_hop = 1;
+static TaskHandle_t s_analysis_task = NULL;
+
+// 以下只由分析任务访问
+static int16_t s_fft[AUDIO_SPECTRUM_FFT_SIZE * 2] __attribute__((aligned(16)));
+static int16_t s_window[AUDIO_SPECTRUM_FFT_SIZE];
+static uint8_t s_bands[AUDIO_SPECTRUM_BANDS];
+
+static audio_spectrum_stats_t s_stats;
+
+// 上一次通知界面时的音量和各频段能量，没有变化时不再发布事件
+static uint8_t s_notified[1 + AUDIO_SPECTRUM_BANDS];
+
+// 已发布的结果，按32位字通过顺序锁发布
+#define PUBLISHED_WORDS     ((sizeof(audio_spectrum_t) + 3) / 4)
+static _Atomic uint32_t s_published[PUBLISHED_WORDS];
+static seqlock_t s_lock;
+
+static void publish(const audio_spectrum_t *spectrum)
+{
+    uint32_t words[PUBLISHED_WORDS] = {0};
+    memcpy(words, spectrum, sizeof(*spectrum));
+    seqlock_publish(&s_lock, s_published, words, PUBLISHED_WORDS);
+}
+
+bool audio_spectrum_read(audio_spectrum_t *spectrum)
+{
+    uint32_t words[PUBLISHED_WORDS];
+    uint32_t published = 0;
+
+    // 分析任务正在发布时不等待，沿用调用者上一次读到的结果
+    if (seqlock_try_read(&s_lock, s_published, words, PUBLISHED_WORDS, &published)) {
+        if (published == 0) {
+            memset(spectrum, 0, sizeof(*spectrum));
+            return false;
+        }
+        memcpy(spectrum, words, sizeof(*spectrum));
+    }
+
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    if (spectrum->time_ms == 0 || now_ms - spectrum->time_ms > AUDIO_SPECTRUM_STALE_MS) {
+        memset(spectrum, 0, sizeof(*spectrum));
+        return false;
+    }
+    return true;
+}
+
+void audio_spectrum_get_stats(audio_spectrum_stats_t *stats)
+{
+    *stats = s_stats;
+    stats->hop = atomic_load_explicit(&s_hop, memory_order_relaxed);
+}
+
+// 能量的对数，单位为1/16个二进制数量级
+static uint32_t log2_q4(uint64_t value)
+{
+    if (value == 0) {
+        return 0;
+    }
+    uint32_t msb = 63 - __builtin_clzll(value);
+    uint32_t frac = (msb >= 4) ? (uint32_t)(value >> (msb - 4)) : (uint32_t)(value << (4 - msb));
+    return msb * 16 + (frac & 0x0f);
+}
+
+// 把能量换算为0-255，full_q4对应255
+static uint8_t energy_to_level(uint64_t energy, uint32_t full_q4)
+{
+    uint32_t log = log2_q4(energy);
+    if (log + 255 <= full_q4) {
+        return 0;
+    }
+    log -= full_q4 - 255;
+    return log > 255 ? 255 : (uint8_t)log;
+}
+
+// 分析一块样本，结果写入spectrum
+static void analyse_block(audio_spectrum_t *spectrum)
+{
+    int32_t sum = 0;
+    for (int i = 0; i < AUDIO_SPECTRUM_FFT_SIZE; i++) {
+        sum += s_work[i];
+    }
+    int32_t mean = sum / AUDIO_SPECTRUM_FFT_SIZE;
+
+    // 去直流后计算均方值，同时加窗写入FFT缓冲区（实部为样本，虚部为0）
+    uint64_t power = 0;
+    for (int i = 0; i < AUDIO_SPECTRUM_FFT_SIZE; i++) {
+        int32_t x = s_work[i] - mean;
+        if (x > INT16_MAX) {
+            x = INT16_MAX;
+        } else if (x < INT16_MIN) {
+            x = INT16_MIN;
+        }
+        power += (uint64_t)(x * x);
+        s_fft[i * 2] = (int16_t)((x * s_window[i]) >> 15);
+        s_fft[i * 2 + 1] = 0;
+    }
+    spectrum->level = energy_to_level(power / AUDIO_SPECTRUM_FFT_SIZE, LEVEL_FULL_Q4);
+
+    // 定点FFT每级缩小一半，不会溢出
+    dsps_fft2r_sc16(s_fft, AUDIO_SPECTRUM_FFT_SIZE);
+    dsps_bit_rev_sc16_ansi(s_fft, AUDIO_SPECTRUM_FFT_SIZE);
+
+    for (int b = 0; b < AUDIO_SPECTRUM_BANDS; b++) {
+        uint64_t energy = 0;
+        for (int k = s_band_edges[b]; k < s_band_edges[b + 1]; k++) {
+            int32_t re = s_fft[k * 2];
+            int32_t im = s_fft[k * 2 + 1];
+            energy += (uint32_t)(re * re) + (uint32_t)(im * im);
+        }
+
+        // 快速上升、缓慢下降
+        uint8_t level = energy_to_level(energy, BAND_FULL_Q4);
+        if (level + BAND_DECAY < s_bands[b]) {
+            level = s_bands[b] - BAND_DECAY;
+        }
+        s_bands[b] = level;
+        spectrum->bands[b] = level;
+    }
+}
+
+// 按本块的分析耗时调整分析间隔，使分析任务占用的CPU不超过预算
+static void adjust_hop(uint32_t analysis_us, uint32_t rate)
+{
+    if (rate == 0) {
+        return;
+    }
+    uint64_t block_us = (uint64_t)AUDIO_SPECTRUM_FFT_SIZE * 1000000 / rate;
+    uint8_t hop = atomic_load_explicit(&s_hop, memory_order_relaxed);
+
+    if ((uint64_t)analysis_us * 100 > block_us * hop * AUDIO_SPECTRUM_BUDGET_PCT) {
+        if (hop < MAX_HOP) {
+            atomic_store_explicit(&s_hop, hop + 1, memory_order_relaxed);
+            ESP_LOGW(TAG, "Analysis took %" PRIu32 " us, analysing 1 of %d blocks", analysis_us, hop + 1);
+        }
+    } else if (hop > 1 && (uint64_t)analysis_us * 200 < block_us * (hop - 1) * AUDIO_SPECTRUM_BUDGET_PCT) {
+        // 间隔缩小后仍有一半余量时才恢复
+        atomic_store_explicit(&s_hop, hop - 1, memory_order_relaxed);
+    }
+}
+
+static void analysis_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!atomic_load_explicit(&s_pending, memory_order_acquire)) {
+            continue;
+        }
+
+        int64_t start = esp_timer_get_time();
+        audio_spectrum_t spectrum = {0};
+        uint32_t rate = s_work_rate;
+        analyse_block(&spectrum);
+
+        // 样本已用完，把缓冲区还给透传元素
+        atomic_store_explicit(&s_pending, false, memory_order_release);
+
+        int64_t now = esp_timer_get_time();
+        spectrum.time_ms = (uint32_t)(now / 1000);
+        publish(&spectrum);
+
+        // 频谱有变化时通知界面重绘，静音衰减到0以后不再唤醒UI任务
+        if (s_notified[0] != spectrum.level ||
+            memcmp(&s_notified[1], spectrum.bands, AUDIO_SPECTRUM_BANDS) != 0) {
+            s_notified[0] = spectrum.level;
+            memcpy(&s_notified[1], spectrum.bands, AUDIO_SPECTRUM_BANDS);
+            input_event_publish(INPUT_EVENT_AUDIO, INPUT_AUDIO_SPECTRUM);
+        }
+
+        uint32_t analysis_us = (uint32_t)(now - start);
+        s_stats.blocks++;
+        s_stats.last_us = analysis_us;
+        if (analysis_us > s_stats.max_us) {
+            s_stats.max_us = analysis_us;
+        }
+        adjust_hop(analysis_us, rate);
+    }
+}
+
+// 按解码器给出的格式重新计算抽取倍数
+static void tap_configure(const audio_element_info_t *info)
+{
+    memset(&s_tap, 0, sizeof(s_tap));
+    s_tap.sample_rate = info->sample_rates;
+    s_tap.channels = info->channels;
+    s_tap.bits = info->bits;
+
+    if (info->bits != 16 || info->channels < 1 || info->sample_rates <= 0) {
+        ESP_LOGW(TAG, "Unsupported format %d Hz, %d bits, %d channels, spectrum disabled",
+                 info->sample_rates, info->bits, info->channels);
+        return;
+    }
+    s_tap.decimation = (info->sample_rates + AUDIO_SPECTRUM_TARGET_RATE - 1) / AUDIO_SPECTRUM_TARGET_RATE;
+}
+
+// 一块抽取完成，分析任务空闲时交给它，否则丢弃
+static void tap_hand_off(void)
+{
+    uint8_t hop = atomic_load_explicit(&s_hop, memory_order_relaxed);
+    if (++s_tap.hop_count < hop) {
+        s_stats.skipped++;
+        return;
+    }
+    s_tap.hop_count = 0;
+
+    if (atomic_load_explicit(&s_pending, memory_order_acquire)) {
+        s_stats.dropped++;
+        return;
+    }
+    memcpy(s_work, s_tap.block, sizeof(s_work));
+    s_work_rate = s_tap.sample_rate / s_tap.decimation;
+    atomic_store_explicit(&s_pending, true, memory_order_release);
+    xTaskNotifyGive(s_analysis_task);
+}
+
+// 混为单声道并抽取，每个样本只做几次加法
+static void tap_feed(const int16_t *pcm, int samples)
+{
+    int channels = s_tap.channels;
+
+    for (int i = 0; i + channels <= samples; i += channels) {
+        int32_t mono = (channels >= 2) ? (pcm[i] + pcm[i + 1]) / 2 : pcm[i];
+        s_tap.sum += mono;
+        if (++s_tap.count < s_tap.decimation) {
+            continue;
+        }
+
+        s_tap.block[s_tap.fill++] = (int16_t)(s_tap.sum / (int32_t)s_tap.decimation);
+        s_tap.sum = 0;
+        s_tap.count = 0;
+        if (s_tap.fill == AUDIO_SPECTRUM_FFT_SIZE) {
+            s_tap.fill = 0;
+            tap_hand_off();
+        }
+    }
+}
+
+static esp_err_t spectrum_tap_open(audio_element_handle_t self)
+{
+    // 格式在第一次处理数据时按元素信息重新配置
+    memset(&s_tap, 0, sizeof(s_tap));
+    return ESP_OK;
+}
+
+static esp_err_t spectrum_tap_close(audio_element_handle_t self)
+{
+    memset(&s_tap, 0, sizeof(s_tap));
+    return ESP_OK;
+}
+
+static audio_element_err_t spectrum_tap_process(audio_element_handle_t self, char *in_buffer, int in_len)
+{
+    int r_size = audio_element_input(self, in_buffer, in_len);
+    if (r_size <= 0) {
+        return r_size;
+    }
+
+    audio_element_info_t info = {0};
+    audio_element_getinfo(self, &info);
+    if (info.sample_rates != s_tap.sample_rate || info.channels != s_tap.channels || info.bits != s_tap.bits) {
+        tap_configure(&info);
+    }
+    if (s_tap.decimation) {
+        tap_feed((const int16_t *)in_buffer, r_size / (int)sizeof(int16_t));
+    }
+
+    // 数据原样交给下一个元素
+    return audio_element_output(self, in_buffer, r_size);
+}
+
+audio_element_handle_t audio_spectrum_tap_init(void)
+{
+    if (s_analysis_task == NULL) {
+        esp_err_t err = dsps_fft2r_init_sc16(NULL, AUDIO_SPECTRUM_FFT_SIZE);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize FFT: %s", esp_err_to_name(err));
+            return NULL;
+        }
+
+        // 汉宁窗，Q15
+        for (int i = 0; i < AUDIO_SPECTRUM_FFT_SIZE; i++) {
+            float w = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / AUDIO_SPECTRUM_FFT_SIZE);
+            s_window[i] = (int16_t)(w * INT16_MAX + 0.5f);
+        }
+
+        if (xTaskCreate(analysis_task, "spectrum", ANALYSIS_TASK_STACK, NULL, ANALYSIS_TASK_PRIO, &s_analysis_task) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create analysis task");
+            s_analysis_task = NULL;
+            return NULL;
+        }
+    }
+
+    audio_element_cfg_t cfg = DEFAULT_AUDIO_ELEMENT_CONFIG();
+    cfg.open = spectrum_tap_open;
+    cfg.close = spectrum_tap_close;
+    cfg.process = spectrum_tap_process;
+    cfg.tag = "spectrum";
+    return audio_element_init(&cfg);
+}
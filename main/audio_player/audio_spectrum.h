@@ -0,0 +1,69 @@
+#ifndef _AUDIO_SPECTRUM_H_
+#define _AUDIO_SPECTRUM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_element.h"
+
+/*
+ * 音频频谱分析
+ * 在mp3_decoder和i2s_stream之间插入一个透传元素，数据原样交给I2S，同时做频谱分析供灯效和OLED使用：
+ *   1. 透传元素只把PCM混为单声道并抽取到约11kHz，攒满一块后交给分析任务，不在音频管道中做FFT
+ *   2. 分析任务优先级低于音频管道，做加窗和定点FFT（esp-dsp），按对数频段汇总能量
+ *   3. 分析耗时超出预算时隔块分析，上一块还没分析完时丢弃新块，不会拖慢音频管道
+ *   4. 结果通过顺序锁（seqlock.h）发布，读方不加锁也不休眠；结果有变化时在输入事件总线上发布INPUT_EVENT_AUDIO通知界面
+ */
+
+// 频段数量，低频在前
+#define AUDIO_SPECTRUM_BANDS        8
+
+// FFT点数
+#define AUDIO_SPECTRUM_FFT_SIZE     256
+
+// 抽取后的采样率上限
+#define AUDIO_SPECTRUM_TARGET_RATE  11025
+
+// 分析耗时占一块音频时长的上限（百分比）
+#define AUDIO_SPECTRUM_BUDGET_PCT   10
+
+// 超过这么久没有新的分析结果时视为静音
+#define AUDIO_SPECTRUM_STALE_MS     200
+
+// 分析结果
+typedef struct {
+    uint32_t time_ms;                       // 分析完成的时刻
+    uint8_t level;                          // 整体音量，0-255对应-48dB到满幅
+    uint8_t bands[AUDIO_SPECTRUM_BANDS];    // 各频段能量，0-255对应-48dB到满幅
+} audio_spectrum_t;
+
+// 分析统计信息
+typedef struct {
+    uint32_t blocks;            // 已分析的块数
+    uint32_t dropped;           // 分析任务忙而丢弃的块数
+    uint32_t skipped;           // 超出预算而隔块跳过的块数
+    uint32_t last_us;           // 最近一块的分析耗时
+    uint32_t max_us;            // 最长的一块分析耗时
+    uint8_t hop;                // 当前每几块分析一块
+} audio_spectrum_stats_t;
+
+/**
+ * @brief 创建频谱分析透传元素，首次调用时创建分析任务
+ * @return 元素句柄，失败返回NULL
+ * @note 采样率等信息由播放器在收到解码器的音乐信息后通过audio_element_setinfo设置
+ */
+audio_element_handle_t audio_spectrum_tap_init(void);
+
+/**
+ * @brief 读取最近一次分析结果，不阻塞、不休眠，可在渲染回调中调用
+ * @param spectrum 输入调用者上一次读到的结果（首次调用时清零），输出最新结果；
+ *                 分析任务正在发布时保留原内容，没有新结果时各项为0
+ * @return 结果在AUDIO_SPECTRUM_STALE_MS以内时返回true
+ */
+bool audio_spectrum_read(audio_spectrum_t *spectrum);
+
+/**
+ * @brief 获取分析统计信息
+ */
+void audio_spectrum_get_stats(audio_spectrum_stats_t *stats);
+
+#endif
@@ -10,12 +10,14 @@
 */
 
 #include <stdio.h>
+#include <inttypes.h>
 #include <string.h>
 #include <stdlib.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "audio_element.h"
 #include "audio_pipeline.h"
 #include "audio_event_iface.h"
@@ -25,6 +27,11 @@
 #include "board.h"
 #include "esp_spiffs.h"
 #include "mp3_player.h"
+#include "audio_spectrum.h"
+#include "mp3_stream.h"
+#include "music_pack.h"
+#include "playlist.h"
+#include "input_event.h"
 
 static const char *TAG = "MP3_PLAYER_MAX98375A";
 
@@ -33,75 +40,152 @@ static MP3Player* s_mp3_player = NULL;
 // 互斥锁，用于确保单例初始化的线程安全
 static SemaphoreHandle_t s_mp3_player_mutex = NULL;
 
+// 提前多少字节打开下一首歌，留出打开文件和预读的时间
+#define PREFETCH_MARGIN (2 * MP3_STREAM_RING_SIZE)
+
+/**
+ * @brief 更新播放状态，状态改变时通过输入事件总线通知界面重绘
+ */
+static void set_playing(MP3Player* player, bool playing)
+{
+    if (player->is_playing != playing) {
+        player->is_playing = playing;
+        input_event_publish(INPUT_EVENT_AUDIO, INPUT_AUDIO_PLAYER_STATE);
+    }
+}
+
+/**
+ * @brief 在指定的预读对象上打开播放列表中的曲目，从第一帧开始读
+ */
+static esp_err_t open_track(MP3Player* player, mp3_stream_t *stream, int index)
+{
+    const playlist_track_t *track = &player->playlist.tracks[index];
+
+    if (player->pack_mounted) {
+        // 打包镜像中的曲目直接从映射的Flash播放
+        const uint8_t *data;
+        size_t size;
+        esp_err_t ret = music_pack_get_track(index, &data, &size, NULL);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        return mp3_stream_open_mapped(stream, data + track->audio_offset, size - track->audio_offset);
+    }
+
+    char path[sizeof(PLAYLIST_SPIFFS_BASE) + PLAYLIST_NAME_LEN];
+    playlist_track_path(&player->playlist, index, path, sizeof(path));
+    return mp3_stream_open(stream, path, track->audio_offset);
+}
+
+/**
+ * @brief 关闭已预读的下一首歌，播放顺序改变或手动切歌时调用，调用前需持有stream_lock
+ */
+static void drop_prefetch(MP3Player* player)
+{
+    mp3_stream_close(player->next_stream);
+    player->next_ready = false;
+    player->prefetch_tried = false;
+}
+
+/**
+ * @brief 当前歌曲快读完时打开下一首歌并开始预读，在播放器任务中周期调用
+ *
+ * 只有采样格式相同时才能无缝衔接，格式不同或已是最后一首时不预读，
+ * 由解码器结束事件重启管道切歌
+ */
+static void prefetch_next_track(MP3Player* player)
+{
+    xSemaphoreTake(player->stream_lock, portMAX_DELAY);
+    if (player->is_playing && !player->prefetch_tried && mp3_stream_is_open(player->stream) &&
+        mp3_stream_size(player->stream) - mp3_stream_pos(player->stream) <= PREFETCH_MARGIN) {
+        player->prefetch_tried = true;
+        int next = playlist_peek(&player->playlist, 1, false);
+        if (next >= 0 && playlist_same_format(&player->playlist, player->current_song_idx, next) &&
+            open_track(player, player->next_stream, next) == ESP_OK) {
+            player->next_ready = true;
+            ESP_LOGI(TAG, "[ * ] Prefetching %s", player->playlist.tracks[next].name);
+        }
+    }
+    xSemaphoreGive(player->stream_lock);
+}
+
+/**
+ * @brief 当前歌曲读完时换到已预读的下一首歌，解码器不停止，两首歌之间没有间隙
+ * @return 没有预读下一首歌时返回false
+ */
+static bool switch_to_prefetched(MP3Player* player)
+{
+    xSemaphoreTake(player->stream_lock, portMAX_DELAY);
+    bool ready = player->next_ready;
+    if (ready) {
+        mp3_stream_t *finished = player->stream;
+        player->stream = player->next_stream;
+        player->next_stream = finished;
+        mp3_stream_close(finished);
+        player->next_ready = false;
+        player->prefetch_tried = false;
+        player->current_song_idx = playlist_advance(&player->playlist, 1, false);
+        // 无缝切换没有重新启动管道，不统计启动耗时
+        player->first_read_us = -1;
+        ESP_LOGI(TAG, "[ * ] Gapless switch to %s", player->playlist.tracks[player->current_song_idx].name);
+    }
+    xSemaphoreGive(player->stream_lock);
+    return ready;
+}
+
+static void log_stream_stats(MP3Player* player)
+{
+    mp3_stream_stats_t stats;
+    mp3_stream_get_stats(player->stream, &stats);
+    ESP_LOGI(TAG, "[ * ] Read-ahead: open %" PRIu32 " us, %" PRIu32 " reads in %" PRIu32 " us (max %" PRIu32 " us), %" PRIu32 " underruns (%" PRIu32 " ms), min level %" PRIu32 " bytes",
+             stats.open_us, stats.reads, stats.read_us, stats.max_read_us, stats.underruns, stats.underrun_ms, stats.min_level);
+}
+
 static void set_file_marker(MP3Player* player, int direction) // direction: 0=current, 1=next, -1=prev
 {
-    const char *file_path = NULL;
-    const char *song_name = NULL;
-    int new_idx = player->current_song_idx;
+    // 手动切歌或重新打开时，已预读的下一首歌作废
+    xSemaphoreTake(player->stream_lock, portMAX_DELAY);
+    drop_prefetch(player);
 
-    // 根据方向计算新的索引，确保不会超出范围
-    if (direction == 1) { // next
-        new_idx = (player->current_song_idx < 1) ? player->current_song_idx + 1 : player->current_song_idx;
-    } else if (direction == -1) { // prev
-        new_idx = (player->current_song_idx > 0) ? player->current_song_idx - 1 : player->current_song_idx;
-    } else { // current
-        new_idx = player->current_song_idx;
+    int new_idx;
+    if (direction == 0) {
+        new_idx = playlist_current(&player->playlist);
+    } else {
+        new_idx = playlist_advance(&player->playlist, direction, true);
     }
 
-    // 如果索引没有变化，但文件已关闭，重新打开文件
-    if (new_idx == player->current_song_idx && direction != 0) {
+    // 已到列表一端，没有循环播放
+    if (new_idx < 0 && direction != 0) {
         ESP_LOGI(TAG, "[ * ] Already at %s, no change", direction == 1 ? "last song" : "first song");
         // 如果文件已关闭，重新打开文件
-        if (player->current_file == NULL) {
+        if (!mp3_stream_is_open(player->stream)) {
             ESP_LOGI(TAG, "[ * ] File is closed, reopening current song");
+            new_idx = playlist_current(&player->playlist);
         } else {
+            xSemaphoreGive(player->stream_lock);
             return; // 文件已打开，不需要重新设置
         }
     }
+    if (new_idx < 0) {
+        ESP_LOGE(TAG, "[ * ] Playlist is empty");
+        xSemaphoreGive(player->stream_lock);
+        return;
+    }
 
     // 关闭当前打开的文件
-    if (player->current_file != NULL) {
-        fclose(player->current_file);
-        player->current_file = NULL;
-    }
+    mp3_stream_close(player->stream);
+    player->first_read_us = 0;
 
     // 更新当前索引
     player->current_song_idx = new_idx;
 
-    switch (player->current_song_idx) {
-        case 0:
-            file_path = MUSIC_FILE_1;
-            song_name = "Song 1 - M500003c89uw1rfLwc.mp3";
-            break;
-        case 1:
-            file_path = MUSIC_FILE_2;
-            song_name = "Song 2 - music-16b-2c-44100hz.mp3";
-            break;
-        default:
-            ESP_LOGE(TAG, "[ * ] Not supported index = %d", player->current_song_idx);
-            return;
-    }
-    
-    // 打开音乐文件
-    player->current_file = fopen(file_path, "rb");
-    if (player->current_file == NULL) {
-        ESP_LOGE(TAG, "[ * ] Failed to open music file: %s", file_path);
-        return;
+    if (open_track(player, player->stream, new_idx) != ESP_OK) {
+        ESP_LOGE(TAG, "[ * ] Failed to open music file: %s", player->playlist.tracks[new_idx].name);
+    } else {
+        ESP_LOGI(TAG, "[ * ] Playing: %s (%s), size: %d bytes", player->playlist.tracks[new_idx].name,
+                 player->pack_mounted ? "mapped" : "spiffs", mp3_stream_size(player->stream));
     }
-    
-    // 获取文件大小
-    fseek(player->current_file, 0, SEEK_END);
-    player->current_file_size = ftell(player->current_file);
-    fseek(player->current_file, 0, SEEK_SET);
-    player->current_file_pos = 0;
-    
-    ESP_LOGI(TAG, "[ * ] Playing: %s, file size: %d bytes", song_name, player->current_file_size);
-}
-
-// 向后兼容，保持原有函数接口
-static void set_next_file_marker(MP3Player* player)
-{
-    set_file_marker(player, 1);
+    xSemaphoreGive(player->stream_lock);
 }
 
 int mp3_music_read_cb(audio_element_handle_t el, char *buf, int len, TickType_t wait_time, void *ctx)
@@ -109,46 +193,50 @@ int mp3_music_read_cb(audio_element_handle_t el, char *buf, int len, TickType_t
     MP3Player* player = (MP3Player*)ctx;
     
     // 检查文件是否已打开
-    if (player->current_file == NULL) {
+    if (!mp3_stream_is_open(player->stream)) {
         ESP_LOGI(TAG, "[ * ] No music file open, returning AEL_IO_DONE");
         return AEL_IO_DONE;
     }
     
-    // 计算剩余可读数据
-    size_t remaining_size = player->current_file_size - player->current_file_pos;
-    
-    // 检查是否已经读取完所有数据
-    if (remaining_size <= 0) {
-        ESP_LOGI(TAG, "[ * ] MP3 file fully read, returning AEL_IO_DONE");
-        fclose(player->current_file);
-        player->current_file = NULL;
-        return AEL_IO_DONE; // 使用标准的文件结束标记
+    // 记录每首歌第一次取数据的时刻，用于统计出声前的启动耗时
+    if (mp3_stream_pos(player->stream) == 0 && player->first_read_us == 0) {
+        player->first_read_us = esp_timer_get_time();
     }
     
-    // 计算实际可以读取的大小，确保不会读取超出文件范围的数据
-    size_t read_size = (len < remaining_size) ? len : remaining_size;
-    
-    // 从文件中读取数据
-    size_t bytes_read = fread(buf, 1, read_size, player->current_file);
-    if (bytes_read != read_size) {
-        ESP_LOGW(TAG, "[ * ] Failed to read full data from file, expected: %d, got: %d", read_size, bytes_read);
-        if (feof(player->current_file)) {
-            ESP_LOGI(TAG, "[ * ] End of file reached");
-            fclose(player->current_file);
-            player->current_file = NULL;
-            return AEL_IO_DONE;
+    // 从预读缓冲区（或映射的Flash）取数据，文件读取由读取任务完成
+    int bytes_read = mp3_stream_read(player->stream, buf, len, wait_time);
+    if (bytes_read == MP3_STREAM_EOF) {
+        // 已预读下一首歌时直接接着读，解码器看到的是连续的MP3帧
+        log_stream_stats(player);
+        if (switch_to_prefetched(player)) {
+            bytes_read = mp3_stream_read(player->stream, buf, len, wait_time);
         }
     }
-    
-    // 更新文件位置
-    player->current_file_pos += bytes_read;
+    if (bytes_read == MP3_STREAM_TIMEOUT) {
+        return AEL_IO_TIMEOUT;
+    }
+    if (bytes_read <= 0) {
+        if (bytes_read == MP3_STREAM_ERROR) {
+            ESP_LOGE(TAG, "[ * ] Failed to read music file");
+            log_stream_stats(player);
+        } else {
+            ESP_LOGI(TAG, "[ * ] MP3 file fully read, returning AEL_IO_DONE");
+        }
+        mp3_stream_close(player->stream);
+        return bytes_read == MP3_STREAM_ERROR ? AEL_IO_FAIL : AEL_IO_DONE;
+    }
     
     // 记录读取进度
     static size_t last_log_pos = 0;
-    if (player->current_file_pos - last_log_pos > 102400) {
-        int progress = (player->current_file_pos * 100) / player->current_file_size;
-        ESP_LOGI(TAG, "[ * ] MP3 read progress: %d%% (%d/%d bytes)", progress, player->current_file_pos, player->current_file_size);
-        last_log_pos = player->current_file_pos;
+    size_t file_pos = mp3_stream_pos(player->stream);
+    size_t file_size = mp3_stream_size(player->stream);
+    if (file_pos < last_log_pos) {
+        last_log_pos = 0;
+    }
+    if (file_pos - last_log_pos > 102400) {
+        int progress = (file_pos * 100) / file_size;
+        ESP_LOGI(TAG, "[ * ] MP3 read progress: %d%% (%d/%d bytes)", progress, file_pos, file_size);
+        last_log_pos = file_pos;
     }
     
     return bytes_read;
@@ -162,35 +250,56 @@ static void mp3_player_task(void *arg)
 
     // 初始化资源标志
     player->spiffs_initialized = false;
+    player->pack_mounted = false;
     player->pipeline_initialized = false;
     player->mp3_decoder_initialized = false;
+    player->spectrum_tap_initialized = false;
     player->i2s_stream_initialized = false;
     player->evt_initialized = false;
 
-    ESP_LOGI(TAG, "[ 1 ] Initialize SPIFFS file system for music resources");
-    esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs",
-        .partition_label = "music",
-        .max_files = 5,
-        .format_if_mount_failed = true
-    };
-    
-    esp_err_t ret = esp_vfs_spiffs_register(&conf);
-    if (ret != ESP_OK) {
-        if (ret == ESP_FAIL) {
-            ESP_LOGE(TAG, "Failed to mount or format filesystem");
-        } else if (ret == ESP_ERR_NOT_FOUND) {
-            ESP_LOGE(TAG, "Failed to find SPIFFS partition");
-        } else {
-            ESP_LOGE(TAG, "Failed to initialize SPIFFS (%s)", esp_err_to_name(ret));
-        }
+    ESP_LOGI(TAG, "[ 1 ] Mount music partition");
+    // 分区中是打包镜像时直接映射；不能交给SPIFFS挂载，挂载失败会格式化分区
+    esp_err_t ret = music_pack_mount("music");
+    if (ret == ESP_OK) {
+        player->pack_mounted = true;
+    } else if (ret != ESP_ERR_NOT_FOUND) {
+        ESP_LOGE(TAG, "Failed to map music pack (%s)", esp_err_to_name(ret));
         // 设置任务句柄为NULL，触发任务退出
         player->task_handle = NULL;
         // 退出任务
         vTaskDelete(NULL);
         return;
+    } else {
+        ESP_LOGI(TAG, "[1.1] Initialize SPIFFS file system for music resources");
+        esp_vfs_spiffs_conf_t conf = {
+            .base_path = "/spiffs",
+            .partition_label = "music",
+            .max_files = 5,
+            .format_if_mount_failed = true
+        };
+    
+        ret = esp_vfs_spiffs_register(&conf);
+        if (ret != ESP_OK) {
+            if (ret == ESP_FAIL) {
+                ESP_LOGE(TAG, "Failed to mount or format filesystem");
+            } else if (ret == ESP_ERR_NOT_FOUND) {
+                ESP_LOGE(TAG, "Failed to find SPIFFS partition");
+            } else {
+                ESP_LOGE(TAG, "Failed to initialize SPIFFS (%s)", esp_err_to_name(ret));
+            }
+            // 设置任务句柄为NULL，触发任务退出
+            player->task_handle = NULL;
+            // 退出任务
+            vTaskDelete(NULL);
+            return;
+        }
+        player->spiffs_initialized = true;
+    }
+    
+    ESP_LOGI(TAG, "[1.2] Build playlist from %s", player->pack_mounted ? "music pack" : "SPIFFS");
+    if (playlist_build(&player->playlist, player->pack_mounted) != ESP_OK) {
+        ESP_LOGW(TAG, "No music found in music partition");
     }
-    player->spiffs_initialized = true;
     
     // MAX98375A不需要音频解码芯片控制，音量控制通过硬件实现
     player->volume = 100; // 固定音量，MAX98375A不支持软件音量控制
@@ -240,7 +349,16 @@ static void mp3_player_task(void *arg)
     audio_element_set_read_cb(player->mp3_decoder, mp3_music_read_cb, player);
     player->mp3_decoder_initialized = true;
 
-    ESP_LOGI(TAG, "[3.2] Create i2s stream to write data to codec chip");
+    ESP_LOGI(TAG, "[3.2] Create spectrum tap between decoder and i2s stream for audio-reactive effects");
+    player->spectrum_tap = audio_spectrum_tap_init();
+    if (!player->spectrum_tap) {
+        // 频谱只用于灯效和显示，创建失败时照常播放
+        ESP_LOGW(TAG, "Failed to create spectrum tap, playing without spectrum");
+    } else {
+        player->spectrum_tap_initialized = true;
+    }
+
+    ESP_LOGI(TAG, "[3.3] Create i2s stream to write data to codec chip");
     i2s_stream_cfg_t i2s_cfg = I2S_STREAM_CFG_DEFAULT();
     player->i2s_writer = i2s_stream_init(&i2s_cfg);
     if (!player->i2s_writer) {
@@ -253,13 +371,21 @@ static void mp3_player_task(void *arg)
     }
     player->i2s_stream_initialized = true;
 
-    ESP_LOGI(TAG, "[3.3] Register all elements to audio pipeline");
+    ESP_LOGI(TAG, "[3.4] Register all elements to audio pipeline");
     audio_pipeline_register(player->pipeline, player->mp3_decoder, "mp3");
     audio_pipeline_register(player->pipeline, player->i2s_writer, "i2s");
 
-    ESP_LOGI(TAG, "[3.4] Link it together [mp3_music_read_cb]-->mp3_decoder-->i2s_stream-->[MAX98375A]");
-    const char *link_tag[2] = {"mp3", "i2s"};
-    audio_pipeline_link(player->pipeline, &link_tag[0], 2);
+    if (player->spectrum_tap_initialized) {
+        audio_pipeline_register(player->pipeline, player->spectrum_tap, "spectrum");
+
+        ESP_LOGI(TAG, "[3.5] Link it together [mp3_music_read_cb]-->mp3_decoder-->spectrum-->i2s_stream-->[MAX98375A]");
+        const char *link_tag[3] = {"mp3", "spectrum", "i2s"};
+        audio_pipeline_link(player->pipeline, &link_tag[0], 3);
+    } else {
+        ESP_LOGI(TAG, "[3.5] Link it together [mp3_music_read_cb]-->mp3_decoder-->i2s_stream-->[MAX98375A]");
+        const char *link_tag[2] = {"mp3", "i2s"};
+        audio_pipeline_link(player->pipeline, &link_tag[0], 2);
+    }
 
     ESP_LOGI(TAG, "[ 4 ] Set up event listener");
     audio_event_iface_cfg_t evt_cfg = AUDIO_EVENT_IFACE_DEFAULT_CFG();
@@ -279,8 +405,8 @@ static void mp3_player_task(void *arg)
 
     
     // 设置初始状态为暂停，不自动播放
-    set_next_file_marker(player);
-    player->is_playing = false;
+    set_file_marker(player, 0);
+    set_playing(player, false);
     
 
     while (1) {
@@ -290,6 +416,9 @@ static void mp3_player_task(void *arg)
             break;
         }
         
+        // 当前歌曲快读完时预读下一首
+        prefetch_next_track(player);
+        
         audio_event_iface_msg_t msg;
         esp_err_t ret = audio_event_iface_listen(player->evt, &msg, 10 / portTICK_PERIOD_MS);
         if (ret != ESP_OK) {
@@ -303,11 +432,22 @@ static void mp3_player_task(void *arg)
             audio_element_info_t music_info = {0};
             audio_element_getinfo(player->mp3_decoder, &music_info);
             i2s_stream_set_clk(player->i2s_writer, music_info.sample_rates, music_info.bits, music_info.channels);
+            // 从第一次取数据到解出第一帧的耗时
+            if (player->first_read_us > 0) {
+                ESP_LOGI(TAG, "[ * ] First frame decoded %d us after first read (%s)",
+                         (int)(esp_timer_get_time() - player->first_read_us), player->pack_mounted ? "mapped" : "spiffs");
+                player->first_read_us = 0;
+            }
+            // 频谱分析按同样的格式解析PCM
+            if (player->spectrum_tap_initialized) {
+                audio_element_setinfo(player->spectrum_tap, &music_info);
+            }
             continue;
         }
 
         if (msg.source_type == AUDIO_ELEMENT_TYPE_ELEMENT && msg.source == (void *) player->mp3_decoder
             && msg.cmd == AEL_MSG_CMD_FINISH) {
+            // 没有无缝衔接（最后一首或采样格式不同）时解码器才会结束
             ESP_LOGI(TAG, "[ * ] MP3 decoder finished, switching to next song");
             
             // 停止管道并等待完全停止
@@ -318,15 +458,19 @@ static void mp3_player_task(void *arg)
             audio_pipeline_reset_elements(player->pipeline);
             audio_pipeline_reset_ringbuffer(player->pipeline);
             
-            // 切换到下一个文件
-            set_next_file_marker(player);
+            // 按播放列表切换到下一个文件，列表播完时回到第一首并停止
+            xSemaphoreTake(player->stream_lock, portMAX_DELAY);
+            if (playlist_advance(&player->playlist, 1, false) < 0) {
+                ESP_LOGI(TAG, "[ * ] End of playlist");
+                playlist_rewind(&player->playlist);
+                set_playing(player, false);
+            }
+            xSemaphoreGive(player->stream_lock);
+            set_file_marker(player, 0);
             
             // 只在当前是播放状态时才重新启动管道
             if (player->is_playing) {
-                audio_element_state_t state = audio_element_get_state(player->mp3_decoder);
-                if (state == AEL_STATE_RUNNING || state == AEL_STATE_PAUSED) {
-                    audio_pipeline_run(player->pipeline);
-                }
+                audio_pipeline_run(player->pipeline);
             }
             continue;
         }
@@ -378,6 +522,22 @@ MP3Player* mp3_player_init()
     player->current_song_idx = 0;
     player->volume = 100;
     
+    // 创建文件预读对象，文件在选择歌曲时打开；第二个用于无缝播放时预读下一首
+    player->stream = mp3_stream_create();
+    player->next_stream = mp3_stream_create();
+    player->stream_lock = xSemaphoreCreateMutex();
+    if (player->stream == NULL || player->next_stream == NULL || player->stream_lock == NULL) {
+        ESP_LOGE(TAG, "Failed to create MP3 read-ahead stream");
+        mp3_stream_destroy(player->stream);
+        mp3_stream_destroy(player->next_stream);
+        if (player->stream_lock) {
+            vSemaphoreDelete(player->stream_lock);
+        }
+        free(player);
+        xSemaphoreGive(s_mp3_player_mutex);
+        return NULL;
+    }
+    
     // 创建任务
     xTaskCreate(mp3_player_task, "mp3_player_task", 3*4096, player, 5, &player->task_handle);
     
@@ -398,15 +558,7 @@ static void mp3_player_cleanup(MP3Player* player)
     // 清理资源，按照初始化顺序的相反顺序释放
     ESP_LOGI(TAG, "[ 5 ] Stop audio_pipeline and clean up resources in reverse order");
     
-    // 1. 关闭当前打开的文件
-    if (player->current_file != NULL) {
-        fclose(player->current_file);
-        player->current_file = NULL;
-        player->current_file_size = 0;
-        player->current_file_pos = 0;
-    }
-    
-    // 2. 停止并清理音频管道
+    // 1. 停止并清理音频管道
     if (player->pipeline_initialized && player->pipeline) {
         // 停止管道
         if (player->i2s_stream_initialized && player->i2s_writer) {
@@ -417,6 +569,10 @@ static void mp3_player_cleanup(MP3Player* player)
             }
         }
         
+        // 2. 解码器已停止，关闭当前打开的文件和预读的下一首
+        mp3_stream_close(player->stream);
+        mp3_stream_close(player->next_stream);
+        
         // 移除监听器
         if (player->evt_initialized && player->evt) {
             audio_pipeline_remove_listener(player->pipeline);
@@ -428,6 +584,9 @@ static void mp3_player_cleanup(MP3Player* player)
         if (player->mp3_decoder_initialized) {
             audio_pipeline_unregister(player->pipeline, player->mp3_decoder);
         }
+        if (player->spectrum_tap_initialized) {
+            audio_pipeline_unregister(player->pipeline, player->spectrum_tap);
+        }
         if (player->i2s_stream_initialized) {
             audio_pipeline_unregister(player->pipeline, player->i2s_writer);
         }
@@ -452,6 +611,13 @@ static void mp3_player_cleanup(MP3Player* player)
         player->mp3_decoder_initialized = false;
     }
     
+    if (player->spectrum_tap_initialized && player->spectrum_tap) {
+        // 直接释放元素，不需要状态检查
+        audio_element_deinit(player->spectrum_tap);
+        player->spectrum_tap = NULL;
+        player->spectrum_tap_initialized = false;
+    }
+    
     if (player->i2s_stream_initialized && player->i2s_writer) {
         // 直接释放元素，不需要状态检查
         audio_element_deinit(player->i2s_writer);
@@ -464,6 +630,10 @@ static void mp3_player_cleanup(MP3Player* player)
         esp_vfs_spiffs_unregister("music");
         player->spiffs_initialized = false;
     }
+    if (player->pack_mounted) {
+        music_pack_unmount();
+        player->pack_mounted = false;
+    }
     
     // 6. 去初始化音频板
     if (player->audio_board_initialized && player->board_handle) {
@@ -473,7 +643,7 @@ static void mp3_player_cleanup(MP3Player* player)
     }
     
     // 7. 重置播放状态
-    player->is_playing = false;
+    set_playing(player, false);
 }
 
 void mp3_player_deinit(MP3Player* player)
@@ -516,6 +686,9 @@ void mp3_player_deinit(MP3Player* player)
     }
     
     // 释放内存
+    mp3_stream_destroy(player->stream);
+    mp3_stream_destroy(player->next_stream);
+    vSemaphoreDelete(player->stream_lock);
     free(player);
 }
 
@@ -527,7 +700,7 @@ void mp3_player_play_pause(MP3Player* player)
     }
     
     // 确保有音乐文件打开
-    if (player->current_file == NULL) {
+    if (!mp3_stream_is_open(player->stream)) {
         ESP_LOGI(TAG, "[ * ] No music file open, setting default file");
         set_file_marker(player, 0); // 使用当前歌曲或默认歌曲
     }
@@ -537,17 +710,17 @@ void mp3_player_play_pause(MP3Player* player)
         case AEL_STATE_INIT :
             ESP_LOGI(TAG, "[ * ] Starting audio pipeline");
             audio_pipeline_run(player->pipeline);
-            player->is_playing = true;
+            set_playing(player, true);
             break;
         case AEL_STATE_RUNNING :
             ESP_LOGI(TAG, "[ * ] Pausing audio pipeline");
             audio_pipeline_pause(player->pipeline);
-            player->is_playing = false;
+            set_playing(player, false);
             break;
         case AEL_STATE_PAUSED :
             ESP_LOGI(TAG, "[ * ] Resuming audio pipeline");
             audio_pipeline_resume(player->pipeline);
-            player->is_playing = true;
+            set_playing(player, true);
             break;
         case AEL_STATE_FINISHED :
             ESP_LOGI(TAG, "[ * ] Restarting audio pipeline");
@@ -555,11 +728,11 @@ void mp3_player_play_pause(MP3Player* player)
             audio_pipeline_reset_elements(player->pipeline);
             audio_pipeline_change_state(player->pipeline, AEL_STATE_INIT);
             // 确保有音乐文件打开
-            if (player->current_file == NULL) {
+            if (!mp3_stream_is_open(player->stream)) {
                 set_file_marker(player, 0);
             }
             audio_pipeline_run(player->pipeline);
-            player->is_playing = true;
+            set_playing(player, true);
             break;
         default :
             ESP_LOGI(TAG, "[ * ] Not supported state %d", el_state);
@@ -586,7 +759,7 @@ void mp3_player_stop_playback(MP3Player* player)
     
     // 只更新播放状态，不重置管道和元素
     // 管道和元素的清理工作由 mp3_player_cleanup 统一处理
-    player->is_playing = false;
+    set_playing(player, false);
 }
 
 void mp3_player_next_song(MP3Player* player)
@@ -601,12 +774,6 @@ void mp3_player_next_song(MP3Player* player)
     
     ESP_LOGI(TAG, "[ * ] Switching to next song");
     
-    // 关闭当前打开的文件（如果有）
-    if (player->current_file != NULL) {
-        fclose(player->current_file);
-        player->current_file = NULL;
-    }
-    
     // 停止当前播放，无论是否在运行状态
     audio_element_state_t state = audio_element_get_state(player->i2s_writer);
     if (state == AEL_STATE_RUNNING || state == AEL_STATE_PAUSED) {
@@ -614,6 +781,9 @@ void mp3_player_next_song(MP3Player* player)
         audio_pipeline_wait_for_stop(player->pipeline);
     }
     
+    // 解码器停止后再关闭当前打开的文件（如果有）
+    mp3_stream_close(player->stream);
+    
     // 重置管道
     audio_pipeline_reset_ringbuffer(player->pipeline);
     audio_pipeline_reset_elements(player->pipeline);
@@ -630,9 +800,9 @@ void mp3_player_next_song(MP3Player* player)
         if (current_state != AEL_STATE_RUNNING && current_state != AEL_STATE_PAUSED) {
             audio_pipeline_run(player->pipeline);
         }
-        player->is_playing = true;
+        set_playing(player, true);
     } else {
-        player->is_playing = false;
+        set_playing(player, false);
     }
 }
 
@@ -653,12 +823,6 @@ void mp3_player_prev_song(MP3Player* player)
     
     ESP_LOGI(TAG, "[ * ] Switching to previous song");
     
-    // 关闭当前打开的文件（如果有）
-    if (player->current_file != NULL) {
-        fclose(player->current_file);
-        player->current_file = NULL;
-    }
-    
     // 停止当前播放，无论是否在运行状态
     audio_element_state_t state = audio_element_get_state(player->i2s_writer);
     if (state == AEL_STATE_RUNNING || state == AEL_STATE_PAUSED) {
@@ -666,6 +830,9 @@ void mp3_player_prev_song(MP3Player* player)
         audio_pipeline_wait_for_stop(player->pipeline);
     }
     
+    // 解码器停止后再关闭当前打开的文件（如果有）
+    mp3_stream_close(player->stream);
+    
     // 重置管道
     audio_pipeline_reset_ringbuffer(player->pipeline);
     audio_pipeline_reset_elements(player->pipeline);
@@ -682,10 +849,37 @@ void mp3_player_prev_song(MP3Player* player)
         if (current_state != AEL_STATE_RUNNING && current_state != AEL_STATE_PAUSED) {
             audio_pipeline_run(player->pipeline);
         }
-        player->is_playing = true;
+        set_playing(player, true);
     } else {
-        player->is_playing = false;
+        set_playing(player, false);
+    }
+}
+
+void mp3_player_set_shuffle(MP3Player* player, bool shuffle)
+{
+    if (player == NULL) {
+        return;
+    }
+    
+    // 播放顺序改变，已预读的下一首歌可能不再是下一首
+    xSemaphoreTake(player->stream_lock, portMAX_DELAY);
+    playlist_set_shuffle(&player->playlist, shuffle);
+    drop_prefetch(player);
+    xSemaphoreGive(player->stream_lock);
+    ESP_LOGI(TAG, "[ * ] Shuffle %s", shuffle ? "on" : "off");
+}
+
+void mp3_player_set_repeat(MP3Player* player, playlist_repeat_t repeat)
+{
+    if (player == NULL) {
+        return;
     }
+    
+    xSemaphoreTake(player->stream_lock, portMAX_DELAY);
+    playlist_set_repeat(&player->playlist, repeat);
+    drop_prefetch(player);
+    xSemaphoreGive(player->stream_lock);
+    ESP_LOGI(TAG, "[ * ] Repeat mode %d", repeat);
 }
 
 void mp3_player_volume_up(MP3Player* player)
@@ -744,3 +938,19 @@ int mp3_player_get_volume(MP3Player* player)
     return player->volume;
 }
 
+bool mp3_player_get_shuffle(MP3Player* player)
+{
+    if (player == NULL) {
+        return false;
+    }
+    return player->playlist.shuffle;
+}
+
+playlist_repeat_t mp3_player_get_repeat(MP3Player* player)
+{
+    if (player == NULL) {
+        return PLAYLIST_REPEAT_OFF;
+    }
+    return player->playlist.repeat;
+}
+
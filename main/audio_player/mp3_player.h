@@ -13,14 +13,13 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "audio_pipeline.h"
 #include "audio_element.h"
 #include "audio_event_iface.h"
 #include "board.h"
-
-// 音乐文件路径定义
-#define MUSIC_FILE_1 "/spiffs/song1.mp3"
-#define MUSIC_FILE_2 "/spiffs/song2.mp3"
+#include "mp3_stream.h"
+#include "playlist.h"
 
 /**
  * @brief MP3 Player 结构体定义，使用面向对象思想封装
@@ -32,6 +31,7 @@ typedef struct {
     // 音频管道相关
     audio_pipeline_handle_t pipeline;  /*!< 音频管道句柄 */
     audio_element_handle_t mp3_decoder;/*!< MP3解码器句柄 */
+    audio_element_handle_t spectrum_tap;/*!< 频谱分析透传元素句柄 */
     audio_element_handle_t i2s_writer;/*!< I2S流写入器句柄 */
     audio_event_iface_handle_t evt;    /*!< 音频事件接口句柄 */
     
@@ -40,19 +40,25 @@ typedef struct {
     
     // 状态相关
     bool is_playing;                  /*!< 播放状态标志 */
-    int current_song_idx;             /*!< 当前歌曲索引，0:第一首, 1:第二首 */
+    int current_song_idx;             /*!< 当前歌曲在播放列表中的序号 */
     int volume;                       /*!< 音量值(0-100) */
     
     // 文件相关
-    FILE *current_file;               /*!< 当前打开的音乐文件句柄 */
-    size_t current_file_size;         /*!< 当前文件大小 */
-    size_t current_file_pos;          /*!< 当前文件读取位置 */
+    playlist_t playlist;              /*!< 挂载音乐分区时建立的播放列表 */
+    mp3_stream_t *stream;             /*!< 当前音乐文件的预读对象 */
+    mp3_stream_t *next_stream;        /*!< 无缝播放时预读下一首的对象 */
+    SemaphoreHandle_t stream_lock;    /*!< 保护播放列表位置和两个预读对象的交换 */
+    bool next_ready;                  /*!< 下一首已打开并开始预读 */
+    bool prefetch_tried;              /*!< 本首歌已尝试过预读下一首 */
+    int64_t first_read_us;            /*!< 本首歌第一次取数据的时刻，解出第一帧后清零，-1表示不统计 */
     
     // 资源初始化标志
     bool audio_board_initialized;     /*!< 音频板初始化标志 */
     bool spiffs_initialized;          /*!< SPIFFS初始化标志 */
+    bool pack_mounted;                /*!< 打包音乐分区映射标志 */
     bool pipeline_initialized;        /*!< 音频管道初始化标志 */
     bool mp3_decoder_initialized;     /*!< MP3解码器初始化标志 */
+    bool spectrum_tap_initialized;    /*!< 频谱分析元素初始化标志 */
     bool i2s_stream_initialized;      /*!< I2S流初始化标志 */
     bool evt_initialized;             /*!< 事件接口初始化标志 */
 } MP3Player;
@@ -99,6 +105,22 @@ void mp3_player_next_song(MP3Player* player);
  */
 void mp3_player_prev_song(MP3Player* player);
 
+/**
+ * @brief 打开或关闭随机播放
+ * 
+ * @param player MP3Player指针
+ * @param shuffle true为随机播放
+ */
+void mp3_player_set_shuffle(MP3Player* player, bool shuffle);
+
+/**
+ * @brief 设置循环模式
+ * 
+ * @param player MP3Player指针
+ * @param repeat 循环模式
+ */
+void mp3_player_set_repeat(MP3Player* player, playlist_repeat_t repeat);
+
 /**
  * @brief 增加音量
  * 
@@ -137,4 +159,20 @@ int mp3_player_get_current_song(MP3Player* player);
  */
 int mp3_player_get_volume(MP3Player* player);
 
+/**
+ * @brief 是否为随机播放
+ * 
+ * @param player MP3Player指针
+ * @return bool true为随机播放
+ */
+bool mp3_player_get_shuffle(MP3Player* player);
+
+/**
+ * @brief 获取循环模式
+ * 
+ * @param player MP3Player指针
+ * @return playlist_repeat_t 当前循环模式
+ */
+playlist_repeat_t mp3_player_get_repeat(MP3Player* player);
+
 #endif /* MP3_PLAYER_MAX98375A_H */
@@ -0,0 +1,304 @@
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mp3_stream.h"
+
+static const char *TAG = "mp3_stream";
+
+_Static_assert(MP3_STREAM_RING_SIZE % MP3_STREAM_CHUNK_SIZE == 0, "ring size must be a multiple of the chunk size");
+
+// 读取任务参数，优先级低于解码器，缓冲区有数据时不抢占解码
+#define READER_TASK_STACK       (3 * 1024)
+#define READER_TASK_PRIO        4
+
+// 缓冲区已满时读取任务最长的休眠时间，到时检查是否需要退出
+#define READER_POLL_MS          100
+
+struct mp3_stream {
+    uint8_t *ring;                      // 第一次打开文件时分配，只打开映射数据时为NULL
+    int fd;                             // 打开的文件，-1表示没有
+    const uint8_t *mapped;              // 已映射的数据，不为NULL时不使用文件和读取任务
+    size_t size;                        // 文件大小
+    size_t pos;                         // 解码器已取走的字节数
+    _Atomic uint32_t head;              // 已写入的总字节数，只由读取任务修改
+    _Atomic uint32_t tail;              // 已取走的总字节数，只由解码器修改
+    _Atomic bool eof;                   // 读取任务已结束（文件末尾或出错）
+    _Atomic bool error;
+    _Atomic bool stop;                  // 请求读取任务退出
+    _Atomic bool reader_waiting;        // 读取任务在等待缓冲区降到低水位
+    _Atomic bool consumer_waiting;      // 解码器在等待数据
+    TaskHandle_t reader;
+    SemaphoreHandle_t data_ready;       // 读取任务写入数据后通知正在等待的解码器
+    SemaphoreHandle_t reader_done;      // 读取任务退出前给出
+    mp3_stream_stats_t stats;
+};
+
+// 唤醒正在等待数据的解码器
+static void wake_consumer(mp3_stream_t *stream)
+{
+    if (atomic_exchange(&stream->consumer_waiting, false)) {
+        xSemaphoreGive(stream->data_ready);
+    }
+}
+
+static void reader_task(void *arg)
+{
+    mp3_stream_t *stream = arg;
+
+    while (!atomic_load_explicit(&stream->stop, memory_order_relaxed)) {
+        uint32_t head = atomic_load_explicit(&stream->head, memory_order_relaxed);
+        uint32_t space = MP3_STREAM_RING_SIZE - (head - atomic_load(&stream->tail));
+
+        if (space < MP3_STREAM_CHUNK_SIZE) {
+            // 缓冲区已满，等解码器取到低水位以下再连续读取
+            atomic_store(&stream->reader_waiting, true);
+            if (head - atomic_load(&stream->tail) > MP3_STREAM_LOW_WATER) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(READER_POLL_MS));
+            }
+            atomic_store(&stream->reader_waiting, false);
+            continue;
+        }
+
+        // 写入位置按块对齐时一次读一整块，文件读取不完整时读到缓冲区末尾为止
+        uint32_t offset = head % MP3_STREAM_RING_SIZE;
+        size_t length = MIN(MP3_STREAM_CHUNK_SIZE, MP3_STREAM_RING_SIZE - offset);
+
+        int64_t start = esp_timer_get_time();
+        ssize_t n = read(stream->fd, stream->ring + offset, length);
+        uint32_t read_us = (uint32_t)(esp_timer_get_time() - start);
+        stream->stats.reads++;
+        stream->stats.read_us += read_us;
+        if (read_us > stream->stats.max_read_us) {
+            stream->stats.max_read_us = read_us;
+        }
+
+        if (n < 0) {
+            ESP_LOGE(TAG, "Failed to read file at %" PRIu32 " bytes", head);
+            atomic_store(&stream->error, true);
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        atomic_store(&stream->head, head + (uint32_t)n);
+        wake_consumer(stream);
+    }
+
+    atomic_store(&stream->eof, true);
+    wake_consumer(stream);
+    xSemaphoreGive(stream->reader_done);
+    vTaskDelete(NULL);
+}
+
+mp3_stream_t *mp3_stream_create(void)
+{
+    mp3_stream_t *stream = calloc(1, sizeof(mp3_stream_t));
+    if (stream == NULL) {
+        return NULL;
+    }
+    stream->fd = -1;
+    stream->data_ready = xSemaphoreCreateBinary();
+    stream->reader_done = xSemaphoreCreateBinary();
+
+    if (stream->data_ready == NULL || stream->reader_done == NULL) {
+        ESP_LOGE(TAG, "Failed to create semaphores");
+        mp3_stream_destroy(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+void mp3_stream_destroy(mp3_stream_t *stream)
+{
+    if (stream == NULL) {
+        return;
+    }
+    mp3_stream_close(stream);
+    if (stream->data_ready) {
+        vSemaphoreDelete(stream->data_ready);
+    }
+    if (stream->reader_done) {
+        vSemaphoreDelete(stream->reader_done);
+    }
+    heap_caps_free(stream->ring);
+    free(stream);
+}
+
+esp_err_t mp3_stream_open(mp3_stream_t *stream, const char *path, size_t offset)
+{
+    mp3_stream_close(stream);
+
+    // 环形缓冲区只有读文件时才需要，第一次打开文件时分配，之后一直保留到销毁
+    // 有PSRAM时放在PSRAM中，节省内部RAM
+    if (stream->ring == NULL) {
+        stream->ring = heap_caps_malloc(MP3_STREAM_RING_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (stream->ring == NULL) {
+            stream->ring = heap_caps_malloc(MP3_STREAM_RING_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        }
+        if (stream->ring == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate read-ahead buffer");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    int64_t start = esp_timer_get_time();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        ESP_LOGE(TAG, "Failed to open %s", path);
+        return ESP_FAIL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < offset || lseek(fd, offset, SEEK_SET) < 0) {
+        ESP_LOGE(TAG, "Failed to seek %s to %u", path, (unsigned)offset);
+        close(fd);
+        return ESP_FAIL;
+    }
+
+    stream->fd = fd;
+    stream->size = st.st_size - offset;
+    stream->pos = 0;
+    atomic_store(&stream->head, 0);
+    atomic_store(&stream->tail, 0);
+    atomic_store(&stream->eof, false);
+    atomic_store(&stream->error, false);
+    atomic_store(&stream->stop, false);
+    atomic_store(&stream->reader_waiting, false);
+    atomic_store(&stream->consumer_waiting, false);
+    memset(&stream->stats, 0, sizeof(stream->stats));
+    stream->stats.min_level = MP3_STREAM_RING_SIZE;
+    stream->stats.open_us = (uint32_t)(esp_timer_get_time() - start);
+    xSemaphoreTake(stream->data_ready, 0);
+
+    if (xTaskCreate(reader_task, "mp3_reader", READER_TASK_STACK, stream, READER_TASK_PRIO, &stream->reader) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create reader task");
+        stream->reader = NULL;
+        close(fd);
+        stream->fd = -1;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mp3_stream_open_mapped(mp3_stream_t *stream, const void *data, size_t size)
+{
+    mp3_stream_close(stream);
+
+    stream->mapped = data;
+    stream->size = size;
+    stream->pos = 0;
+    memset(&stream->stats, 0, sizeof(stream->stats));
+    stream->stats.min_level = MP3_STREAM_RING_SIZE;
+    return ESP_OK;
+}
+
+void mp3_stream_close(mp3_stream_t *stream)
+{
+    stream->mapped = NULL;
+    if (stream->reader) {
+        atomic_store(&stream->stop, true);
+        xTaskNotifyGive(stream->reader);
+        xSemaphoreTake(stream->reader_done, portMAX_DELAY);
+        stream->reader = NULL;
+    }
+    if (stream->fd >= 0) {
+        close(stream->fd);
+        stream->fd = -1;
+    }
+}
+
+bool mp3_stream_is_open(const mp3_stream_t *stream)
+{
+    return stream != NULL && (stream->fd >= 0 || stream->mapped != NULL);
+}
+
+int mp3_stream_read(mp3_stream_t *stream, char *buf, int len, TickType_t wait)
+{
+    if (!mp3_stream_is_open(stream) || len <= 0) {
+        return MP3_STREAM_ERROR;
+    }
+
+    if (stream->mapped) {
+        // 映射的数据直接复制给解码器，读取由Flash缓存完成
+        size_t n = MIN((size_t)len, stream->size - stream->pos);
+        memcpy(buf, stream->mapped + stream->pos, n);
+        stream->pos += n;
+        return (int)n;
+    }
+
+    uint32_t tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+    uint32_t head = atomic_load(&stream->head);
+
+    if (head == tail && !atomic_load(&stream->eof)) {
+        // 欠载：文件还没读完，缓冲区却空了
+        stream->stats.underruns++;
+        int64_t start = esp_timer_get_time();
+
+        while (head == tail && !atomic_load(&stream->eof)) {
+            atomic_store(&stream->consumer_waiting, true);
+            head = atomic_load(&stream->head);
+            if (head != tail || atomic_load(&stream->eof)) {
+                break;
+            }
+            if (xSemaphoreTake(stream->data_ready, wait) != pdTRUE) {
+                break;
+            }
+            head = atomic_load(&stream->head);
+        }
+        atomic_store(&stream->consumer_waiting, false);
+        stream->stats.underrun_ms += (uint32_t)((esp_timer_get_time() - start) / 1000);
+    } else if (!atomic_load(&stream->eof) && head - tail < stream->stats.min_level) {
+        stream->stats.min_level = head - tail;
+    }
+
+    if (head == tail) {
+        // 读取任务结束后再确认一次，结束前写入的数据不能丢
+        head = atomic_load(&stream->head);
+        if (head == tail) {
+            if (!atomic_load(&stream->eof)) {
+                return MP3_STREAM_TIMEOUT;
+            }
+            return atomic_load(&stream->error) ? MP3_STREAM_ERROR : MP3_STREAM_EOF;
+        }
+    }
+
+    // 数据可能跨过缓冲区末尾，分两段复制
+    uint32_t n = MIN((uint32_t)len, head - tail);
+    uint32_t offset = tail % MP3_STREAM_RING_SIZE;
+    uint32_t first = MIN(n, MP3_STREAM_RING_SIZE - offset);
+    memcpy(buf, stream->ring + offset, first);
+    memcpy(buf + first, stream->ring, n - first);
+    atomic_store(&stream->tail, tail + n);
+    stream->pos += n;
+
+    // 取到低水位以下时唤醒读取任务
+    if (head - (tail + n) <= MP3_STREAM_LOW_WATER && atomic_exchange(&stream->reader_waiting, false)) {
+        xTaskNotifyGive(stream->reader);
+    }
+    return (int)n;
+}
+
+size_t mp3_stream_size(const mp3_stream_t *stream)
+{
+    return stream->size;
+}
+
+size_t mp3_stream_pos(const mp3_stream_t *stream)
+{
+    return stream->pos;
+}
+
+void mp3_stream_get_stats(const mp3_stream_t *stream, mp3_stream_stats_t *stats)
+{
+    *stats = stream->stats;
+}
@@ -0,0 +1,98 @@
+#ifndef _MP3_STREAM_H_
+#define _MP3_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+/*
+ * MP3文件预读
+ * 读取任务按固定大小的块把文件从SPIFFS直接读进环形缓冲区，解码器的读回调只从缓冲区取数据：
+ *   1. 每次读取一整块，写入位置始终按块对齐，数据直接读进缓冲区，不经过stdio缓冲
+ *   2. 缓冲区写满后读取任务休眠，解码器取到只剩一半时再唤醒它连续读满，SPIFFS的读取集中成几次突发
+ *   3. 缓冲区只有一个写方和一个读方，读写指针用原子变量，不加锁
+ *   4. 解码器取数据时缓冲区为空（文件尚未读完）记为一次欠载
+ * 也可以直接打开已映射到地址空间的数据（打包音乐分区），此时不启动读取任务，解码器直接从映射的Flash取数据
+ */
+
+// 环形缓冲区大小，必须是读取块大小的整数倍
+#define MP3_STREAM_RING_SIZE        (16 * 1024)
+
+// 每次从文件读取的块大小
+#define MP3_STREAM_CHUNK_SIZE       (4 * 1024)
+
+// 缓冲区中的数据降到这个量以下时唤醒读取任务
+#define MP3_STREAM_LOW_WATER        (MP3_STREAM_RING_SIZE / 2)
+
+// mp3_stream_read的特殊返回值
+#define MP3_STREAM_EOF              0       // 文件已读完
+#define MP3_STREAM_TIMEOUT          (-1)    // 等待超时，缓冲区仍为空
+#define MP3_STREAM_ERROR            (-2)    // 没有打开文件或读取出错
+
+typedef struct mp3_stream mp3_stream_t;
+
+// 统计信息，打开文件时清零
+typedef struct {
+    uint32_t open_us;           // 打开文件的耗时
+    uint32_t reads;             // 从文件读取的次数
+    uint32_t read_us;           // 从文件读取的总耗时
+    uint32_t max_read_us;       // 最慢的一次读取耗时
+    uint32_t underruns;         // 解码器取数据时缓冲区为空的次数
+    uint32_t underrun_ms;       // 因欠载等待的总时长
+    uint32_t min_level;         // 解码器取数据前缓冲区中最少的数据量（不含文件末尾）
+} mp3_stream_stats_t;
+
+/**
+ * @brief 创建预读对象，环形缓冲区在第一次打开文件时才分配（优先使用PSRAM）
+ * @return 失败返回NULL
+ */
+mp3_stream_t *mp3_stream_create(void);
+
+/**
+ * @brief 关闭文件并释放预读对象
+ */
+void mp3_stream_destroy(mp3_stream_t *stream);
+
+/**
+ * @brief 打开文件并启动读取任务，已打开的文件先关闭
+ * @param offset 从文件的这个位置开始读（跳过ID3v2标签），大小和位置都从这里算起
+ * @return 环形缓冲区分配失败时返回ESP_ERR_NO_MEM
+ */
+esp_err_t mp3_stream_open(mp3_stream_t *stream, const char *path, size_t offset);
+
+/**
+ * @brief 打开已映射到地址空间的数据，已打开的文件先关闭
+ * @param data 在关闭前必须一直有效
+ */
+esp_err_t mp3_stream_open_mapped(mp3_stream_t *stream, const void *data, size_t size);
+
+/**
+ * @brief 停止读取任务并关闭文件，不能与mp3_stream_read并发调用
+ */
+void mp3_stream_close(mp3_stream_t *stream);
+
+/**
+ * @brief 是否有打开的文件
+ */
+bool mp3_stream_is_open(const mp3_stream_t *stream);
+
+/**
+ * @brief 从缓冲区取数据，缓冲区为空时最多等待wait个节拍
+ * @return 取到的字节数，或MP3_STREAM_EOF/MP3_STREAM_TIMEOUT/MP3_STREAM_ERROR
+ */
+int mp3_stream_read(mp3_stream_t *stream, char *buf, int len, TickType_t wait);
+
+/**
+ * @brief 文件大小和解码器已取走的字节数
+ */
+size_t mp3_stream_size(const mp3_stream_t *stream);
+size_t mp3_stream_pos(const mp3_stream_t *stream);
+
+/**
+ * @brief 获取统计信息
+ */
+void mp3_stream_get_stats(const mp3_stream_t *stream, mp3_stream_stats_t *stats);
+
+#endif
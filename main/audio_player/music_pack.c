@@ -0,0 +1,116 @@
+#include <inttypes.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "music_pack.h"
+
+static const char *TAG = "music_pack";
+
+static const uint8_t *s_base;                   // 映射后的分区起始地址
+static const music_pack_entry_t *s_entries;
+static uint16_t s_track_count;
+static esp_partition_mmap_handle_t s_mmap_handle;
+
+// 检查目录项都落在数据区内，曲目名以'\0'结尾
+static bool check_entries(const music_pack_entry_t *entries, uint16_t count, uint32_t data_start, uint32_t data_end)
+{
+    for (int i = 0; i < count; i++) {
+        const music_pack_entry_t *entry = &entries[i];
+        if (entry->offset < data_start || entry->offset > data_end || entry->size > data_end - entry->offset) {
+            ESP_LOGE(TAG, "Track %d out of range: offset 0x%" PRIx32 ", size %" PRIu32, i, entry->offset, entry->size);
+            return false;
+        }
+        if (memchr(entry->name, '\0', MUSIC_PACK_NAME_LEN) == NULL) {
+            ESP_LOGE(TAG, "Track %d name is not terminated", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t music_pack_mount(const char *partition_label)
+{
+    if (s_base != NULL) {
+        return ESP_OK;
+    }
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, partition_label);
+    if (partition == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // 先只读文件头判断格式，SPIFFS分区不映射
+    music_pack_header_t header;
+    esp_err_t ret = esp_partition_read(partition, 0, &header, sizeof(header));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (header.magic != MUSIC_PACK_MAGIC) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (header.version != MUSIC_PACK_VERSION) {
+        ESP_LOGE(TAG, "Unsupported pack version %d", header.version);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    uint32_t data_start = sizeof(music_pack_header_t) + header.track_count * sizeof(music_pack_entry_t);
+    if (header.track_count == 0 || header.data_end < data_start || header.data_end > partition->size) {
+        ESP_LOGE(TAG, "Invalid pack header: %d tracks, data end 0x%" PRIx32, header.track_count, header.data_end);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // 只映射用到的部分，映射按MMU页对齐由esp_partition_mmap处理
+    const void *base;
+    ret = esp_partition_mmap(partition, 0, header.data_end, ESP_PARTITION_MMAP_DATA, &base, &s_mmap_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map %" PRIu32 " bytes (%s)", header.data_end, esp_err_to_name(ret));
+        return ret;
+    }
+
+    const music_pack_entry_t *entries = (const music_pack_entry_t *)((const uint8_t *)base + sizeof(music_pack_header_t));
+    if (!check_entries(entries, header.track_count, data_start, header.data_end)) {
+        esp_partition_munmap(s_mmap_handle);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_base = base;
+    s_entries = entries;
+    s_track_count = header.track_count;
+    ESP_LOGI(TAG, "Mapped %d tracks, %" PRIu32 " bytes", s_track_count, header.data_end);
+    return ESP_OK;
+}
+
+void music_pack_unmount(void)
+{
+    if (s_base == NULL) {
+        return;
+    }
+    esp_partition_munmap(s_mmap_handle);
+    s_base = NULL;
+    s_entries = NULL;
+    s_track_count = 0;
+}
+
+bool music_pack_is_mounted(void)
+{
+    return s_base != NULL;
+}
+
+uint16_t music_pack_track_count(void)
+{
+    return s_track_count;
+}
+
+esp_err_t music_pack_get_track(uint16_t index, const uint8_t **data, size_t *size, const char **name)
+{
+    if (index >= s_track_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const music_pack_entry_t *entry = &s_entries[index];
+    *data = s_base + entry->offset;
+    *size = entry->size;
+    if (name) {
+        *name = entry->name;
+    }
+    return ESP_OK;
+}
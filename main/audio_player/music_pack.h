@@ -0,0 +1,67 @@
+#ifndef _MUSIC_PACK_H_
+#define _MUSIC_PACK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/*
+ * 打包音乐分区
+ * music分区除了SPIFFS，也可以直接烧录tools/music_pack.py生成的打包镜像：
+ *   1. 分区开头是文件头和目录，之后是按MUSIC_PACK_ALIGN对齐、连续存放的MP3数据
+ *   2. 挂载时把目录和全部数据一次映射到地址空间，解码器直接从Flash缓存取数据，不经过文件系统
+ *   3. 切换曲目只是查目录取指针，不需要打开文件
+ * 所有字段为小端序，格式修改时必须同步修改打包工具并增加版本号
+ */
+
+#define MUSIC_PACK_MAGIC            0x4B504D4B      // "KMPK"
+#define MUSIC_PACK_VERSION          1
+#define MUSIC_PACK_NAME_LEN         32
+#define MUSIC_PACK_ALIGN            16
+
+// 文件头，位于分区偏移0处
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t track_count;
+    uint32_t data_end;          // 最后一首曲目数据的结束位置（相对分区起始）
+    uint32_t reserved;
+} music_pack_header_t;
+
+// 目录项，紧跟在文件头之后
+typedef struct __attribute__((packed)) {
+    uint32_t offset;            // 曲目数据的位置（相对分区起始）
+    uint32_t size;              // 曲目数据的字节数
+    char name[MUSIC_PACK_NAME_LEN];     // 以'\0'结尾的曲目名
+} music_pack_entry_t;
+
+/**
+ * @brief 检查分区中的打包镜像并映射到地址空间
+ * @param partition_label 分区名
+ * @return 分区中不是打包镜像时返回ESP_ERR_NOT_FOUND，调用方可改用SPIFFS挂载
+ */
+esp_err_t music_pack_mount(const char *partition_label);
+
+/**
+ * @brief 解除映射
+ */
+void music_pack_unmount(void);
+
+/**
+ * @brief 是否已挂载打包镜像
+ */
+bool music_pack_is_mounted(void);
+
+/**
+ * @brief 曲目数量，未挂载时为0
+ */
+uint16_t music_pack_track_count(void);
+
+/**
+ * @brief 获取曲目数据，返回的指针在解除映射前一直有效
+ * @param name 可为NULL
+ */
+esp_err_t music_pack_get_track(uint16_t index, const uint8_t **data, size_t *size, const char **name);
+
+#endif
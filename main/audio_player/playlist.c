@@ -0,0 +1,401 @@
+#include <dirent.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_random.h"
+#include "music_pack.h"
+#include "playlist.h"
+
+static const char *TAG = "playlist";
+
+// NVS缓存，键名和格式版本，格式修改时增加版本号让旧缓存失效
+#define PLAYLIST_NVS_KEY            "playlist"
+#define PLAYLIST_CACHE_VERSION      1
+
+// 解析时长读取的文件头长度，足够找到第一帧和其中的Xing/VBRI信息
+#define PROBE_LEN                   1024
+
+typedef struct {
+    uint16_t version;
+    uint16_t count;
+    playlist_track_t tracks[PLAYLIST_MAX_TRACKS];
+} playlist_cache_t;
+
+#define CACHE_HEADER_SIZE           offsetof(playlist_cache_t, tracks)
+
+static unified_nvs_manager_t *nvs_manager = NULL;
+
+// Layer III码率表（kbps），按MPEG1和MPEG2/2.5区分
+static const uint16_t bitrate_table[2][15] = {
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+};
+static const uint16_t sample_rate_table[3] = {44100, 48000, 32000};
+
+void playlist_set_nvs_manager(unified_nvs_manager_t *manager)
+{
+    nvs_manager = manager;
+}
+
+void playlist_track_path(const playlist_t *playlist, int index, char *path, size_t len)
+{
+    snprintf(path, len, PLAYLIST_SPIFFS_BASE "/%s", playlist->tracks[index].name);
+}
+
+/**
+ * @brief 从曲目的offset处读取数据，返回实际读取的字节数
+ */
+static size_t read_track(const playlist_t *playlist, int index, uint32_t offset, uint8_t *buf, size_t len)
+{
+    const playlist_track_t *track = &playlist->tracks[index];
+    if (offset >= track->size) {
+        return 0;
+    }
+    len = MIN(len, track->size - offset);
+
+    if (playlist->packed) {
+        const uint8_t *data;
+        size_t size;
+        if (music_pack_get_track(index, &data, &size, NULL) != ESP_OK) {
+            return 0;
+        }
+        memcpy(buf, data + offset, len);
+        return len;
+    }
+
+    char path[sizeof(PLAYLIST_SPIFFS_BASE) + PLAYLIST_NAME_LEN];
+    playlist_track_path(playlist, index, path, sizeof(path));
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    size_t n = 0;
+    if (fseek(file, offset, SEEK_SET) == 0) {
+        n = fread(buf, 1, len, file);
+    }
+    fclose(file);
+    return n;
+}
+
+static uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/**
+ * @brief 解析曲目的起始位置、采样格式和时长
+ *
+ * 先跳过ID3v2标签，再找第一个Layer III帧头；有Xing/Info或VBRI信息时按总帧数计算时长，
+ * 否则按第一帧的码率当作CBR估算
+ */
+static void probe_track(const playlist_t *playlist, int index, playlist_track_t *track)
+{
+    uint8_t buf[PROBE_LEN];
+    uint32_t offset = 0;
+
+    track->audio_offset = 0;
+    track->duration_ms = 0;
+    track->sample_rate = 0;
+    track->channels = 0;
+
+    if (read_track(playlist, index, 0, buf, 10) == 10 && memcmp(buf, "ID3", 3) == 0) {
+        // 标签大小为4个7位字节，不含10字节的标签头，有页脚时再加10字节
+        offset = 10 + (((uint32_t)buf[6] & 0x7F) << 21 | ((uint32_t)buf[7] & 0x7F) << 14 |
+                       ((uint32_t)buf[8] & 0x7F) << 7 | (buf[9] & 0x7F));
+        if (buf[5] & 0x10) {
+            offset += 10;
+        }
+    }
+
+    size_t len = read_track(playlist, index, offset, buf, sizeof(buf));
+    for (size_t i = 0; i + 4 <= len; i++) {
+        if (buf[i] != 0xFF || (buf[i + 1] & 0xE0) != 0xE0) {
+            continue;
+        }
+        uint8_t version = (buf[i + 1] >> 3) & 0x03;         // 3: MPEG1, 2: MPEG2, 0: MPEG2.5
+        uint8_t layer = (buf[i + 1] >> 1) & 0x03;           // 1: Layer III
+        uint8_t bitrate_index = buf[i + 2] >> 4;
+        uint8_t rate_index = (buf[i + 2] >> 2) & 0x03;
+        if (version == 1 || layer != 1 || bitrate_index == 0 || bitrate_index == 15 || rate_index == 3) {
+            continue;
+        }
+
+        bool mpeg1 = version == 3;
+        bool mono = (buf[i + 3] >> 6) == 3;
+        uint32_t sample_rate = sample_rate_table[rate_index] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+        uint32_t samples_per_frame = mpeg1 ? 1152 : 576;
+        uint32_t bitrate = bitrate_table[mpeg1 ? 0 : 1][bitrate_index];
+
+        track->audio_offset = offset + i;
+        track->sample_rate = sample_rate;
+        track->channels = mono ? 1 : 2;
+
+        // Xing/Info位于边信息之后，VBRI固定在帧头后32字节
+        size_t xing = i + 4 + (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17));
+        size_t vbri = i + 4 + 32;
+        uint32_t frames = 0;
+        if (xing + 12 <= len && (memcmp(buf + xing, "Xing", 4) == 0 || memcmp(buf + xing, "Info", 4) == 0) &&
+            (read_be32(buf + xing + 4) & 0x01)) {
+            frames = read_be32(buf + xing + 8);
+        } else if (vbri + 18 <= len && memcmp(buf + vbri, "VBRI", 4) == 0) {
+            frames = read_be32(buf + vbri + 14);
+        }
+
+        if (frames != 0) {
+            track->duration_ms = (uint64_t)frames * samples_per_frame * 1000 / sample_rate;
+        } else {
+            // 字节数 * 8 / kbps 即为毫秒数
+            track->duration_ms = (uint64_t)(track->size - track->audio_offset) * 8 / bitrate;
+        }
+        return;
+    }
+
+    ESP_LOGW(TAG, "No MP3 frame found in %s", track->name);
+}
+
+static bool has_mp3_suffix(const char *name)
+{
+    size_t len = strlen(name);
+    return len > 4 && strcasecmp(name + len - 4, ".mp3") == 0;
+}
+
+static int compare_tracks(const void *a, const void *b)
+{
+    return strcmp(((const playlist_track_t *)a)->name, ((const playlist_track_t *)b)->name);
+}
+
+/**
+ * @brief 扫描/spiffs下的.mp3文件，按文件名排序
+ */
+static void collect_spiffs(playlist_t *playlist)
+{
+    DIR *dir = opendir(PLAYLIST_SPIFFS_BASE);
+    if (dir == NULL) {
+        ESP_LOGE(TAG, "Failed to open %s", PLAYLIST_SPIFFS_BASE);
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!has_mp3_suffix(entry->d_name) || strlen(entry->d_name) >= PLAYLIST_NAME_LEN) {
+            continue;
+        }
+        if (playlist->count == PLAYLIST_MAX_TRACKS) {
+            ESP_LOGW(TAG, "More than %d tracks, ignoring the rest", PLAYLIST_MAX_TRACKS);
+            break;
+        }
+
+        playlist_track_t *track = &playlist->tracks[playlist->count];
+        strcpy(track->name, entry->d_name);
+        char path[sizeof(PLAYLIST_SPIFFS_BASE) + PLAYLIST_NAME_LEN];
+        playlist_track_path(playlist, playlist->count, path, sizeof(path));
+        struct stat st;
+        if (stat(path, &st) != 0) {
+            continue;
+        }
+        track->size = st.st_size;
+        playlist->count++;
+    }
+    closedir(dir);
+
+    qsort(playlist->tracks, playlist->count, sizeof(playlist_track_t), compare_tracks);
+}
+
+/**
+ * @brief 按打包镜像的目录顺序收集曲目，曲目序号与目录序号一致
+ */
+static void collect_pack(playlist_t *playlist)
+{
+    uint16_t count = MIN(music_pack_track_count(), PLAYLIST_MAX_TRACKS);
+    if (music_pack_track_count() > PLAYLIST_MAX_TRACKS) {
+        ESP_LOGW(TAG, "More than %d tracks, ignoring the rest", PLAYLIST_MAX_TRACKS);
+    }
+
+    for (int i = 0; i < count; i++) {
+        const uint8_t *data;
+        size_t size;
+        const char *name;
+        music_pack_get_track(i, &data, &size, &name);
+        playlist_track_t *track = &playlist->tracks[i];
+        strncpy(track->name, name, sizeof(track->name) - 1);
+        track->name[sizeof(track->name) - 1] = '\0';
+        track->size = size;
+    }
+    playlist->count = count;
+}
+
+/**
+ * @brief 从NVS缓存中取出文件名和大小都相同的曲目信息，其余曲目解析文件头
+ * @return 有曲目需要解析或曲目数量变化时返回true，需要更新缓存
+ */
+static bool load_track_info(playlist_t *playlist, const playlist_cache_t *cache, uint16_t cached)
+{
+    bool changed = cached != playlist->count;
+
+    for (int i = 0; i < playlist->count; i++) {
+        playlist_track_t *track = &playlist->tracks[i];
+        int hit = -1;
+        for (int j = 0; j < cached; j++) {
+            if (cache->tracks[j].size == track->size && strcmp(cache->tracks[j].name, track->name) == 0) {
+                hit = j;
+                break;
+            }
+        }
+
+        if (hit >= 0) {
+            *track = cache->tracks[hit];
+        } else {
+            probe_track(playlist, i, track);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+esp_err_t playlist_build(playlist_t *playlist, bool packed)
+{
+    memset(playlist, 0, sizeof(playlist_t));
+    playlist->packed = packed;
+
+    if (packed) {
+        collect_pack(playlist);
+    } else {
+        collect_spiffs(playlist);
+    }
+    if (playlist->count == 0) {
+        ESP_LOGW(TAG, "No tracks found");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    playlist_cache_t *cache = calloc(1, sizeof(playlist_cache_t));
+    if (cache == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint16_t cached = 0;
+    size_t size = sizeof(playlist_cache_t);
+    if (nvs_manager != NULL &&
+        unified_nvs_manager_load(nvs_manager, NVS_NAMESPACE_CUSTOM, PLAYLIST_NVS_KEY,
+                                 cache, UNIFIED_NVS_TYPE_BLOB, &size) == ESP_OK &&
+        cache->version == PLAYLIST_CACHE_VERSION && cache->count <= PLAYLIST_MAX_TRACKS &&
+        size == CACHE_HEADER_SIZE + cache->count * sizeof(playlist_track_t)) {
+        cached = cache->count;
+    }
+
+    if (load_track_info(playlist, cache, cached) && nvs_manager != NULL) {
+        cache->version = PLAYLIST_CACHE_VERSION;
+        cache->count = playlist->count;
+        memcpy(cache->tracks, playlist->tracks, playlist->count * sizeof(playlist_track_t));
+        esp_err_t ret = unified_nvs_manager_save(nvs_manager, NVS_NAMESPACE_CUSTOM, PLAYLIST_NVS_KEY, cache,
+                                                 UNIFIED_NVS_TYPE_BLOB, CACHE_HEADER_SIZE + cache->count * sizeof(playlist_track_t));
+        if (ret == ESP_OK) {
+            ret = unified_nvs_manager_commit(nvs_manager);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to save playlist cache: %s", esp_err_to_name(ret));
+        }
+    }
+    free(cache);
+
+    for (int i = 0; i < playlist->count; i++) {
+        playlist->order[i] = i;
+        ESP_LOGI(TAG, "%2d: %s, %lu bytes, %lu.%03lu s, %u Hz x %u", i, playlist->tracks[i].name,
+                 (unsigned long)playlist->tracks[i].size, (unsigned long)playlist->tracks[i].duration_ms / 1000,
+                 (unsigned long)playlist->tracks[i].duration_ms % 1000, playlist->tracks[i].sample_rate,
+                 playlist->tracks[i].channels);
+    }
+    return ESP_OK;
+}
+
+int playlist_current(const playlist_t *playlist)
+{
+    return playlist->count ? playlist->order[playlist->position] : -1;
+}
+
+/**
+ * @brief 计算移动后的播放顺序位置，不能移动时返回-1
+ */
+static int step_position(const playlist_t *playlist, int direction, bool user)
+{
+    if (playlist->count == 0) {
+        return -1;
+    }
+    if (!user && playlist->repeat == PLAYLIST_REPEAT_ONE) {
+        return playlist->position;
+    }
+
+    int position = playlist->position + direction;
+    if (position < 0 || position >= playlist->count) {
+        if (playlist->repeat != PLAYLIST_REPEAT_ALL) {
+            return -1;
+        }
+        position = (position + playlist->count) % playlist->count;
+    }
+    return position;
+}
+
+int playlist_peek(const playlist_t *playlist, int direction, bool user)
+{
+    int position = step_position(playlist, direction, user);
+    return position < 0 ? -1 : playlist->order[position];
+}
+
+int playlist_advance(playlist_t *playlist, int direction, bool user)
+{
+    int position = step_position(playlist, direction, user);
+    if (position < 0) {
+        return -1;
+    }
+    playlist->position = position;
+    return playlist->order[position];
+}
+
+void playlist_rewind(playlist_t *playlist)
+{
+    playlist->position = 0;
+}
+
+void playlist_set_shuffle(playlist_t *playlist, bool shuffle)
+{
+    int current = playlist_current(playlist);
+    playlist->shuffle = shuffle;
+    if (current < 0) {
+        return;
+    }
+
+    for (int i = 0; i < playlist->count; i++) {
+        playlist->order[i] = i;
+    }
+    if (!shuffle) {
+        playlist->position = current;
+        return;
+    }
+
+    // 当前曲目放在第一位，其余曲目洗牌
+    playlist->order[current] = 0;
+    playlist->order[0] = current;
+    for (int i = playlist->count - 1; i > 1; i--) {
+        int j = 1 + esp_random() % i;
+        uint8_t tmp = playlist->order[i];
+        playlist->order[i] = playlist->order[j];
+        playlist->order[j] = tmp;
+    }
+    playlist->position = 0;
+}
+
+void playlist_set_repeat(playlist_t *playlist, playlist_repeat_t repeat)
+{
+    playlist->repeat = repeat;
+}
+
+bool playlist_same_format(const playlist_t *playlist, int a, int b)
+{
+    const playlist_track_t *ta = &playlist->tracks[a];
+    const playlist_track_t *tb = &playlist->tracks[b];
+    return ta->sample_rate != 0 && ta->sample_rate == tb->sample_rate && ta->channels == tb->channels;
+}
@@ -0,0 +1,104 @@
+#ifndef _PLAYLIST_H_
+#define _PLAYLIST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "unified_nvs_manager.h"
+
+/*
+ * 播放列表
+ * 挂载音乐分区后建立一次，来源是打包镜像的目录或/spiffs下的.mp3文件（按文件名排序）：
+ *   1. 每首歌记录大小、音频数据起始位置（跳过ID3v2标签）、时长和采样格式
+ *   2. 时长和格式需要读文件头解析，结果缓存在NVS中，文件名和大小都没变的歌直接用缓存
+ *   3. 播放顺序单独保存，随机播放时打乱顺序，切歌只在顺序表中移动位置
+ */
+
+#define PLAYLIST_MAX_TRACKS         32
+#define PLAYLIST_NAME_LEN           32
+
+// SPIFFS挂载点
+#define PLAYLIST_SPIFFS_BASE        "/spiffs"
+
+typedef enum {
+    PLAYLIST_REPEAT_OFF = 0,        // 播完最后一首停止
+    PLAYLIST_REPEAT_ALL,            // 播完最后一首从头开始
+    PLAYLIST_REPEAT_ONE,            // 自动切歌时重复当前曲目，手动切歌不受影响
+} playlist_repeat_t;
+
+typedef struct {
+    char name[PLAYLIST_NAME_LEN];   // SPIFFS文件名或打包目录中的曲目名
+    uint32_t size;                  // 文件大小
+    uint32_t audio_offset;          // 第一帧的位置，ID3v2标签之后
+    uint32_t duration_ms;           // 0表示无法解析
+    uint16_t sample_rate;           // 第一帧的采样率，0表示无法解析
+    uint8_t channels;
+    uint8_t reserved;
+} playlist_track_t;
+
+typedef struct {
+    uint16_t count;
+    uint16_t position;              // 当前曲目在播放顺序中的位置
+    bool packed;                    // 曲目来自打包镜像
+    bool shuffle;
+    playlist_repeat_t repeat;
+    uint8_t order[PLAYLIST_MAX_TRACKS];     // 播放顺序，元素为曲目序号
+    playlist_track_t tracks[PLAYLIST_MAX_TRACKS];
+} playlist_t;
+
+/**
+ * @brief 设置统一NVS管理器，用于缓存曲目信息
+ */
+void playlist_set_nvs_manager(unified_nvs_manager_t *manager);
+
+/**
+ * @brief 建立播放列表，packed为true时读取打包镜像的目录，否则扫描/spiffs
+ * @return 没有找到曲目时返回ESP_ERR_NOT_FOUND
+ */
+esp_err_t playlist_build(playlist_t *playlist, bool packed);
+
+/**
+ * @brief 当前曲目序号，列表为空时返回-1
+ */
+int playlist_current(const playlist_t *playlist);
+
+/**
+ * @brief 查看向前或向后移动一首后的曲目序号，不改变当前位置
+ * @param direction 1为下一首，-1为上一首
+ * @param user 手动切歌为true，忽略单曲重复；自动切歌为false
+ * @return 已到列表一端且不循环时返回-1
+ */
+int playlist_peek(const playlist_t *playlist, int direction, bool user);
+
+/**
+ * @brief 移动到下一首或上一首，规则同playlist_peek
+ * @return 新的曲目序号；返回-1时当前位置不变
+ */
+int playlist_advance(playlist_t *playlist, int direction, bool user);
+
+/**
+ * @brief 回到播放顺序的第一首
+ */
+void playlist_rewind(playlist_t *playlist);
+
+/**
+ * @brief 打开或关闭随机播放，当前曲目保持不变
+ */
+void playlist_set_shuffle(playlist_t *playlist, bool shuffle);
+
+/**
+ * @brief 设置循环模式
+ */
+void playlist_set_repeat(playlist_t *playlist, playlist_repeat_t repeat);
+
+/**
+ * @brief 两首歌的采样格式是否相同，格式相同时才能无缝衔接
+ */
+bool playlist_same_format(const playlist_t *playlist, int a, int b);
+
+/**
+ * @brief 生成SPIFFS曲目的完整路径
+ */
+void playlist_track_path(const playlist_t *playlist, int index, char *path, size_t len);
+
+#endif
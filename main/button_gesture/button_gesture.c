@@ -0,0 +1,122 @@
+#include <stddef.h>
+#include "button_gesture.h"
+
+// 内部状态
+enum {
+    GESTURE_IDLE = 0,       // 松开，没有未完成的点击
+    GESTURE_PRESSED,        // 按下，尚未达到长按时间
+    GESTURE_RELEASED,       // 松开，等待下一次点击
+    GESTURE_HOLDING         // 长按中
+};
+
+#define MS_TO_US(ms)    ((int64_t)(ms) * 1000)
+
+/**
+ * @brief 上报手势
+ */
+static void emit(button_gesture_t *gesture, button_gesture_type_t type, uint8_t count, int64_t time_us)
+{
+    if (gesture->callback != NULL) {
+        button_gesture_event_t event = {
+            .type = type,
+            .count = count,
+            .timestamp_us = time_us,
+        };
+        gesture->callback(&event, gesture->user_ctx);
+    }
+}
+
+void button_gesture_init(button_gesture_t *gesture, const button_gesture_config_t *config,
+                         button_gesture_cb_t callback, void *user_ctx)
+{
+    gesture->config = *config;
+    if (gesture->config.max_taps == 0) {
+        gesture->config.max_taps = 1;
+    }
+    gesture->callback = callback;
+    gesture->user_ctx = user_ctx;
+    gesture->deadline_us = BUTTON_GESTURE_NO_DEADLINE;
+    gesture->state = GESTURE_IDLE;
+    gesture->taps = 0;
+    gesture->repeats = 0;
+}
+
+void button_gesture_expire(button_gesture_t *gesture, int64_t now_us)
+{
+    const button_gesture_config_t *config = &gesture->config;
+
+    while (gesture->deadline_us <= now_us) {
+        int64_t deadline = gesture->deadline_us;
+
+        switch (gesture->state) {
+        case GESTURE_PRESSED:
+            // 按住超过长按时间
+            gesture->state = GESTURE_HOLDING;
+            gesture->repeats = 0;
+            gesture->deadline_us = (config->repeat_ms != 0) ? deadline + MS_TO_US(config->repeat_ms)
+                                                            : BUTTON_GESTURE_NO_DEADLINE;
+            emit(gesture, BUTTON_GESTURE_HOLD, gesture->taps, deadline);
+            break;
+
+        case GESTURE_RELEASED:
+            // 连击间隔超时，这组点击结束
+            gesture->state = GESTURE_IDLE;
+            gesture->deadline_us = BUTTON_GESTURE_NO_DEADLINE;
+            emit(gesture, BUTTON_GESTURE_TAP, gesture->taps, deadline);
+            gesture->taps = 0;
+            break;
+
+        case GESTURE_HOLDING:
+            // 长按重复；处理不及时落后超过一个间隔时从现在重新计时，不补发积压的重复
+            if (gesture->repeats < UINT8_MAX) {
+                gesture->repeats++;
+            }
+            gesture->deadline_us = deadline + MS_TO_US(config->repeat_ms);
+            if (gesture->deadline_us <= now_us) {
+                gesture->deadline_us = now_us + MS_TO_US(config->repeat_ms);
+            }
+            emit(gesture, BUTTON_GESTURE_REPEAT, gesture->repeats, deadline);
+            break;
+
+        default:
+            gesture->deadline_us = BUTTON_GESTURE_NO_DEADLINE;
+            break;
+        }
+    }
+}
+
+void button_gesture_input(button_gesture_t *gesture, bool pressed, int64_t time_us)
+{
+    const button_gesture_config_t *config = &gesture->config;
+
+    // 边沿之前到期的状态先处理，保证手势按实际发生的顺序上报
+    button_gesture_expire(gesture, time_us);
+
+    if (pressed) {
+        if (gesture->state == GESTURE_IDLE || gesture->state == GESTURE_RELEASED) {
+            gesture->state = GESTURE_PRESSED;
+            gesture->deadline_us = (config->hold_ms != 0) ? time_us + MS_TO_US(config->hold_ms)
+                                                          : BUTTON_GESTURE_NO_DEADLINE;
+        }
+        return;
+    }
+
+    if (gesture->state == GESTURE_PRESSED) {
+        // 完成一次点击，达到最多连击次数时不必再等待
+        gesture->taps++;
+        if (gesture->taps >= config->max_taps) {
+            gesture->state = GESTURE_IDLE;
+            gesture->deadline_us = BUTTON_GESTURE_NO_DEADLINE;
+            emit(gesture, BUTTON_GESTURE_TAP, gesture->taps, time_us);
+            gesture->taps = 0;
+        } else {
+            gesture->state = GESTURE_RELEASED;
+            gesture->deadline_us = time_us + MS_TO_US(config->tap_gap_ms);
+        }
+    } else if (gesture->state == GESTURE_HOLDING) {
+        gesture->state = GESTURE_IDLE;
+        gesture->deadline_us = BUTTON_GESTURE_NO_DEADLINE;
+        emit(gesture, BUTTON_GESTURE_RELEASE, gesture->taps, time_us);
+        gesture->taps = 0;
+    }
+}
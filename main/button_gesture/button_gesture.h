@@ -0,0 +1,98 @@
+#ifndef _BUTTON_GESTURE_H_
+#define _BUTTON_GESTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * 按键手势识别状态机
+ * 只根据"按下/松开"边沿和到期时刻推进状态，不读取硬件、不依赖时钟，可以在主机上按时间线测试：
+ *   1. 连击：松开后tap_gap_ms内再次按下计入同一组点击，超时或达到max_taps时上报点击次数
+ *   2. 长按：按住超过hold_ms上报长按，count为长按前已完成的点击次数（0为普通长按，1为单击后长按）
+ *   3. 长按重复：repeat_ms不为0时，长按后每隔repeat_ms上报一次重复
+ * 状态机只在有未到期的时刻时需要再次调用，空闲时没有任何开销；定时和去抖由button_gesture_driver负责
+ */
+
+// 没有待处理的到期时刻
+#define BUTTON_GESTURE_NO_DEADLINE  INT64_MAX
+
+// 手势类型
+typedef enum {
+    BUTTON_GESTURE_TAP = 0,     // 一组点击结束，count为点击次数
+    BUTTON_GESTURE_HOLD,        // 按住超过hold_ms，count为之前完成的点击次数
+    BUTTON_GESTURE_REPEAT,      // 长按期间的重复，count为重复序号（从1开始，最大255）
+    BUTTON_GESTURE_RELEASE      // 长按后松开，count与对应的BUTTON_GESTURE_HOLD相同
+} button_gesture_type_t;
+
+// 手势事件
+typedef struct {
+    button_gesture_type_t type;
+    uint8_t count;
+    int64_t timestamp_us;       // 手势成立的时刻（边沿或到期时刻）
+} button_gesture_event_t;
+
+/**
+ * @brief 手势回调，在调用状态机的上下文中执行，不能阻塞
+ */
+typedef void (*button_gesture_cb_t)(const button_gesture_event_t *event, void *user_ctx);
+
+// 手势参数，时间单位为毫秒
+typedef struct {
+    uint16_t debounce_ms;       // 去抖时间，边沿稳定这么久才被接受（由驱动使用）
+    uint16_t tap_gap_ms;        // 两次点击之间允许的最长松开时间
+    uint16_t hold_ms;           // 长按时间，0表示不识别长按
+    uint16_t repeat_ms;         // 长按重复间隔，0表示不重复
+    uint8_t max_taps;           // 最多识别的连击次数，达到后立即上报，不再等待tap_gap_ms
+} button_gesture_config_t;
+
+// 默认参数：单击/双击、1秒长按、不重复
+#define BUTTON_GESTURE_CONFIG_DEFAULT() {   \
+    .debounce_ms = 20,                      \
+    .tap_gap_ms = 400,                      \
+    .hold_ms = 1000,                        \
+    .repeat_ms = 0,                         \
+    .max_taps = 2,                          \
+}
+
+// 手势状态机，可静态分配，每个按键一个实例
+typedef struct {
+    button_gesture_config_t config;
+    button_gesture_cb_t callback;
+    void *user_ctx;
+    int64_t deadline_us;        // 下一个到期时刻，BUTTON_GESTURE_NO_DEADLINE表示没有
+    uint8_t state;              // 内部状态
+    uint8_t taps;               // 当前这组已完成的点击次数
+    uint8_t repeats;            // 当前长按已上报的重复次数
+} button_gesture_t;
+
+/**
+ * @brief 初始化状态机，初始状态为松开
+ * @param config 手势参数，max_taps为0时按1处理
+ * @param callback 手势回调
+ * @param user_ctx 传给回调的参数
+ */
+void button_gesture_init(button_gesture_t *gesture, const button_gesture_config_t *config,
+                         button_gesture_cb_t callback, void *user_ctx);
+
+/**
+ * @brief 输入一个已经去抖的边沿，先处理该时刻之前到期的状态
+ * @param pressed true为按下，false为松开，与当前状态相同的边沿被忽略
+ * @param time_us 边沿发生的时刻，不得早于之前输入的时刻
+ */
+void button_gesture_input(button_gesture_t *gesture, bool pressed, int64_t time_us);
+
+/**
+ * @brief 处理now_us及之前到期的状态（连击超时、长按、长按重复）
+ */
+void button_gesture_expire(button_gesture_t *gesture, int64_t now_us);
+
+/**
+ * @brief 获取下一个到期时刻，调用者应在该时刻调用button_gesture_expire
+ * @return 没有待处理的时刻时返回BUTTON_GESTURE_NO_DEADLINE
+ */
+static inline int64_t button_gesture_next_deadline(const button_gesture_t *gesture)
+{
+    return gesture->deadline_us;
+}
+
+#endif
@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "button_gesture_driver.h"
+
+static const char *TAG = "button_gesture";
+
+// 软件按键没有引脚
+#define GPIO_NONE   (-1)
+
+struct button_gesture_button {
+    button_gesture_t gesture;           // 状态机，只由定时器回调访问
+    esp_timer_handle_t timer;           // 去抖和到期时刻共用的单次定时器
+    int gpio;                           // GPIO按键的引脚，软件按键为GPIO_NONE
+    bool active_low;
+    bool stable_pressed;                // 已经交给状态机的状态，只由定时器回调访问
+    uint32_t debounce_us;
+    _Atomic uint32_t raw_pressed;       // 软件按键最近一次报告的状态
+    _Atomic uint32_t last_edge;         // 最近一次边沿的时刻（esp_timer_get_time的低32位）
+};
+
+/**
+ * @brief 读取按键当前是否按下
+ */
+static bool read_pressed(struct button_gesture_button *button)
+{
+    if (button->gpio == GPIO_NONE) {
+        return atomic_load(&button->raw_pressed) != 0;
+    }
+    return (gpio_get_level(button->gpio) == 0) == button->active_low;
+}
+
+/**
+ * @brief 把定时器设到wake时刻，定时器正在运行时先停止
+ * @param seen_edge 回调开始时读到的边沿时刻
+ *
+ * 回调运行期间中断可能已经为新边沿重启了去抖定时器，停止定时器会把它一起取消，
+ * 所以出现新边沿时到期时刻不晚于该边沿的去抖结束时刻；启动后再检查一次边沿，
+ * 停止之前来的边沿重新计算，启动之后来的边沿由中断自己重启定时器
+ */
+static void rearm_timer(struct button_gesture_button *button, int64_t wake, uint32_t seen_edge)
+{
+    while (true) {
+        uint32_t edge = atomic_load(&button->last_edge);
+        int64_t now = esp_timer_get_time();
+        if (edge != seen_edge) {
+            int64_t edge_wake = now - (uint32_t)((uint32_t)now - edge) + button->debounce_us;
+            if (edge_wake < wake) {
+                wake = edge_wake;
+            }
+        }
+        if (wake == BUTTON_GESTURE_NO_DEADLINE) {
+            return;
+        }
+
+        esp_timer_stop(button->timer);
+        esp_timer_start_once(button->timer, (wake > now) ? (uint64_t)(wake - now) : 0);
+        if (atomic_load(&button->last_edge) == edge) {
+            return;
+        }
+        seen_edge = edge;
+    }
+}
+
+/**
+ * @brief 定时器回调 - 接受稳定的边沿，处理到期的手势，再把定时器设到下一个需要处理的时刻
+ */
+static void gesture_timer_callback(void *arg)
+{
+    struct button_gesture_button *button = arg;
+    int64_t now = esp_timer_get_time();
+    bool pressed = read_pressed(button);
+    uint32_t last_edge = atomic_load(&button->last_edge);
+    uint32_t since_edge = (uint32_t)now - last_edge;
+    int64_t wake = BUTTON_GESTURE_NO_DEADLINE;
+
+    if (pressed != button->stable_pressed) {
+        if (since_edge >= button->debounce_us) {
+            // 电平已稳定，按最后一次边沿的时刻输入状态机
+            button->stable_pressed = pressed;
+            button_gesture_input(&button->gesture, pressed, now - since_edge);
+        } else {
+            // 仍在抖动，去抖时间结束后再检查
+            wake = now + (button->debounce_us - since_edge);
+        }
+    }
+
+    button_gesture_expire(&button->gesture, now);
+
+    int64_t deadline = button_gesture_next_deadline(&button->gesture);
+    if (deadline < wake) {
+        wake = deadline;
+    }
+    rearm_timer(button, wake, last_edge);
+}
+
+/**
+ * @brief GPIO任意边沿中断 - 只记录边沿时刻并重新开始去抖计时，电平在定时器回调中读取
+ */
+static void IRAM_ATTR gesture_gpio_isr(void *arg)
+{
+    struct button_gesture_button *button = arg;
+
+    atomic_store(&button->last_edge, (uint32_t)esp_timer_get_time());
+    esp_timer_stop(button->timer);
+    esp_timer_start_once(button->timer, button->debounce_us);
+}
+
+/**
+ * @brief 分配按键并创建定时器
+ */
+static esp_err_t button_create(int gpio, bool active_low, const button_gesture_config_t *config,
+                               button_gesture_cb_t callback, void *user_ctx,
+                               struct button_gesture_button **ret_button)
+{
+    if (config == NULL || ret_button == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct button_gesture_button *button = calloc(1, sizeof(*button));
+    if (button == NULL) {
+        ESP_LOGE(TAG, "No memory for button");
+        return ESP_ERR_NO_MEM;
+    }
+    button_gesture_init(&button->gesture, config, callback, user_ctx);
+    button->gpio = gpio;
+    button->active_low = active_low;
+    button->debounce_us = (uint32_t)config->debounce_ms * 1000;
+    atomic_init(&button->raw_pressed, 0);
+    atomic_init(&button->last_edge, 0);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = gesture_timer_callback,
+        .arg = button,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "button_gesture",
+    };
+    esp_err_t ret = esp_timer_create(&timer_args, &button->timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(ret));
+        free(button);
+        return ret;
+    }
+
+    *ret_button = button;
+    return ESP_OK;
+}
+
+esp_err_t button_gesture_new_gpio(gpio_num_t gpio, bool active_low, const button_gesture_config_t *config,
+                                  button_gesture_cb_t callback, void *user_ctx,
+                                  button_gesture_handle_t *ret_handle)
+{
+    struct button_gesture_button *button = NULL;
+    esp_err_t ret = button_create(gpio, active_low, config, callback, user_ctx, &button);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = active_low ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+        .pull_down_en = active_low ? GPIO_PULLDOWN_DISABLE : GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_ANYEDGE,
+    };
+    ret = gpio_config(&io_conf);
+
+    // 中断服务可能已由其他模块安装
+    if (ret == ESP_OK) {
+        ret = gpio_install_isr_service(0);
+        if (ret == ESP_ERR_INVALID_STATE) {
+            ret = ESP_OK;
+        }
+    }
+
+    // 上电时已经按住的按键不产生手势，从下一次边沿开始识别
+    button->stable_pressed = read_pressed(button);
+
+    if (ret == ESP_OK) {
+        ret = gpio_isr_handler_add(gpio, gesture_gpio_isr, button);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up GPIO %d: %s", gpio, esp_err_to_name(ret));
+        esp_timer_delete(button->timer);
+        free(button);
+        return ret;
+    }
+
+    *ret_handle = button;
+    return ESP_OK;
+}
+
+esp_err_t button_gesture_new_source(const button_gesture_config_t *config,
+                                    button_gesture_cb_t callback, void *user_ctx,
+                                    button_gesture_handle_t *ret_handle)
+{
+    struct button_gesture_button *button = NULL;
+    esp_err_t ret = button_create(GPIO_NONE, false, config, callback, user_ctx, &button);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    *ret_handle = button;
+    return ESP_OK;
+}
+
+void button_gesture_set_pressed(button_gesture_handle_t handle, bool pressed)
+{
+    if (handle == NULL || handle->gpio != GPIO_NONE) {
+        return;
+    }
+    if (atomic_exchange(&handle->raw_pressed, pressed) == (uint32_t)pressed) {
+        return;
+    }
+
+    // 与GPIO中断相同：记录边沿时刻，去抖时间后由定时器回调读取状态
+    int64_t now = esp_timer_get_time();
+    uint32_t edge = (uint32_t)now;
+    atomic_store(&handle->last_edge, edge);
+    rearm_timer(handle, now + handle->debounce_us, edge);
+}
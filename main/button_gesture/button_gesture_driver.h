@@ -0,0 +1,47 @@
+#ifndef _BUTTON_GESTURE_DRIVER_H_
+#define _BUTTON_GESTURE_DRIVER_H_
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "button_gesture.h"
+
+/*
+ * 按键手势驱动
+ * 把button_gesture状态机接到实际的按键上，每个按键一个实例：
+ *   1. GPIO按键：任意边沿中断只记录时刻并重启该按键的单次esp_timer，去抖时间后在定时器回调中读取电平
+ *   2. 其他按键（如矩阵键盘）：由扫描任务调用button_gesture_set_pressed报告状态，同样交给定时器回调处理
+ *   3. 定时器回调是状态机唯一的调用者，处理完后把定时器设到下一个到期时刻；没有到期时刻时不再启动定时器
+ * 按键空闲时既没有中断也没有定时器，不占用CPU；手势回调在esp_timer任务中执行，不能阻塞
+ * 按键创建后一直存在，不提供删除
+ */
+
+typedef struct button_gesture_button *button_gesture_handle_t;
+
+/**
+ * @brief 创建GPIO按键，配置引脚为输入并开启任意边沿中断
+ * @param gpio 按键引脚
+ * @param active_low true表示按下为低电平（同时开启内部上拉）
+ * @param config 手势参数
+ * @param callback 手势回调
+ * @param user_ctx 传给回调的参数
+ * @param ret_handle 返回创建的按键
+ * @return ESP_OK成功，其他值为错误码
+ */
+esp_err_t button_gesture_new_gpio(gpio_num_t gpio, bool active_low, const button_gesture_config_t *config,
+                                  button_gesture_cb_t callback, void *user_ctx,
+                                  button_gesture_handle_t *ret_handle);
+
+/**
+ * @brief 创建由软件报告状态的按键，初始状态为松开
+ * @param config 手势参数，状态来自已经去抖的扫描结果时debounce_ms可为0
+ */
+esp_err_t button_gesture_new_source(const button_gesture_config_t *config,
+                                    button_gesture_cb_t callback, void *user_ctx,
+                                    button_gesture_handle_t *ret_handle);
+
+/**
+ * @brief 报告软件按键的状态，只在状态变化时需要调用，不能在中断中调用
+ */
+void button_gesture_set_pressed(button_gesture_handle_t handle, bool pressed);
+
+#endif
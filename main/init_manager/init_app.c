@@ -11,6 +11,7 @@
 #include "wifi_app/wifi_app.h"
 #include "nvs_manager/unified_nvs_manager.h"
 #include "audio_player/mp3_player.h"
+#include "audio_player/playlist.h"
 #include "esp_log.h"
 
 // 全局统一NVS管理器句柄
@@ -132,9 +133,10 @@ static esp_err_t init_oled(void) {
  */
 static esp_err_t apply_oled_config(void) {
     
-    // 设置统一NVS管理器实例到OLED菜单模块
+    // 设置统一NVS管理器实例到OLED菜单模块和摇杆模块（保存摇杆校准数据）
     if (g_unified_nvs_manager) {
         set_unified_nvs_manager(g_unified_nvs_manager);
+        joystick_set_nvs_manager(g_unified_nvs_manager);
     }
     
     // 启动OLED菜单系统
@@ -208,7 +210,10 @@ static esp_err_t init_mp3_player(void) {
  */
 static esp_err_t apply_mp3_player_config(void) {
     // MP3播放器不再在系统初始化时自动启动，而是由OLED菜单控制
-    // 只做初始化准备，不启动播放任务
+    // 只做初始化准备，不启动播放任务；播放列表的曲目信息缓存在NVS中
+    if (g_unified_nvs_manager) {
+        playlist_set_nvs_manager(g_unified_nvs_manager);
+    }
     ESP_LOGI(INIT_APP_TAG, "MP3 player initialized, ready to be started by menu");
     return ESP_OK;
 }
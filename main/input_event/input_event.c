@@ -0,0 +1,234 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "input_event.h"
+
+static const char *TAG = "input_event";
+
+// 环形缓冲区的槽位，seq用于判断槽位是否可写或可读（Vyukov有界队列）
+typedef struct {
+    _Atomic uint32_t seq;
+    input_event_t event;
+} input_slot_t;
+
+struct input_subscriber {
+    _Atomic uint32_t mask;          // 事件类型过滤掩码
+    _Atomic uint32_t head;          // 下一个写入位置，多个发布者通过CAS竞争
+    uint32_t tail;                  // 下一个读取位置，只由订阅者任务访问
+    uint32_t capacity_mask;         // 容量减1
+    input_slot_t *slots;
+    TaskHandle_t task;              // 订阅者所属任务，有新事件时通知
+    _Atomic uint32_t delivered;
+    _Atomic uint32_t dropped;
+};
+
+// 订阅者表只增不减，发布者读取数量后遍历，无需加锁
+static struct input_subscriber s_subscribers[INPUT_EVENT_MAX_SUBSCRIBERS];
+static _Atomic uint32_t s_subscriber_count = 0;
+static portMUX_TYPE s_subscribe_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief 把事件放入订阅者的缓冲区
+ * @return 成功返回true，缓冲区满返回false
+ */
+static bool input_ring_push(struct input_subscriber *sub, const input_event_t *event)
+{
+    uint32_t pos = atomic_load_explicit(&sub->head, memory_order_relaxed);
+    input_slot_t *slot;
+
+    for (;;) {
+        slot = &sub->slots[pos & sub->capacity_mask];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            // 槽位可写，抢占写入位置；失败时pos被更新为最新的写入位置
+            uint32_t expected = pos;
+            if (atomic_compare_exchange_weak_explicit(&sub->head, &expected, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+            pos = expected;
+        } else if (diff < 0) {
+            // 槽位中的事件还没有被订阅者取走，缓冲区已满
+            return false;
+        } else {
+            // 其他发布者已经抢先写入该槽位
+            pos = atomic_load_explicit(&sub->head, memory_order_relaxed);
+        }
+    }
+
+    slot->event = *event;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief 从订阅者的缓冲区取出一个事件，只由订阅者任务调用
+ * @return 取到事件返回true，缓冲区为空返回false
+ */
+static bool input_ring_pop(struct input_subscriber *sub, input_event_t *event)
+{
+    input_slot_t *slot = &sub->slots[sub->tail & sub->capacity_mask];
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+    // 发布者已占用但尚未写完的槽位同样视为空
+    if ((int32_t)(seq - (sub->tail + 1)) < 0) {
+        return false;
+    }
+
+    *event = slot->event;
+    atomic_store_explicit(&slot->seq, sub->tail + sub->capacity_mask + 1, memory_order_release);
+    sub->tail++;
+    return true;
+}
+
+/**
+ * @brief 把事件分发给所有订阅了该类型的订阅者
+ * @param from_isr 是否在中断中调用
+ */
+static void input_event_dispatch(input_event_type_t type, uint16_t code, bool from_isr)
+{
+    input_event_t event = {
+        .timestamp_us = esp_timer_get_time(),
+        .code = code,
+        .type = (uint8_t)type,
+    };
+    uint32_t bit = INPUT_EVENT_MASK(type);
+    uint32_t count = atomic_load_explicit(&s_subscriber_count, memory_order_acquire);
+    BaseType_t woken = pdFALSE;
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct input_subscriber *sub = &s_subscribers[i];
+        if (!(atomic_load_explicit(&sub->mask, memory_order_relaxed) & bit)) {
+            continue;
+        }
+
+        if (!input_ring_push(sub, &event)) {
+            atomic_fetch_add_explicit(&sub->dropped, 1, memory_order_relaxed);
+            continue;
+        }
+        atomic_fetch_add_explicit(&sub->delivered, 1, memory_order_relaxed);
+
+        if (from_isr) {
+            vTaskNotifyGiveFromISR(sub->task, &woken);
+        } else {
+            xTaskNotifyGive(sub->task);
+        }
+    }
+
+    if (from_isr) {
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+input_subscriber_t *input_event_subscribe(uint32_t mask, uint32_t capacity)
+{
+    // 容量向上取整为2的幂，位置对容量取模只需一次与运算
+    uint32_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    input_slot_t *slots = calloc(size, sizeof(input_slot_t));
+    if (slots == NULL) {
+        ESP_LOGE(TAG, "No memory for %lu event slots", (unsigned long)size);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        atomic_init(&slots[i].seq, i);
+    }
+
+    // 先填好订阅者的全部字段，再增加订阅者数量，发布者不会看到未初始化的订阅者
+    taskENTER_CRITICAL(&s_subscribe_lock);
+    uint32_t index = atomic_load_explicit(&s_subscriber_count, memory_order_relaxed);
+    if (index >= INPUT_EVENT_MAX_SUBSCRIBERS) {
+        taskEXIT_CRITICAL(&s_subscribe_lock);
+        free(slots);
+        ESP_LOGE(TAG, "Too many subscribers");
+        return NULL;
+    }
+    struct input_subscriber *sub = &s_subscribers[index];
+    atomic_init(&sub->mask, mask);
+    atomic_init(&sub->head, 0);
+    sub->tail = 0;
+    sub->capacity_mask = size - 1;
+    sub->slots = slots;
+    sub->task = xTaskGetCurrentTaskHandle();
+    atomic_init(&sub->delivered, 0);
+    atomic_init(&sub->dropped, 0);
+    atomic_store_explicit(&s_subscriber_count, index + 1, memory_order_release);
+    taskEXIT_CRITICAL(&s_subscribe_lock);
+
+    return sub;
+}
+
+void input_event_set_filter(input_subscriber_t *sub, uint32_t mask)
+{
+    if (sub == NULL) {
+        return;
+    }
+    atomic_store_explicit(&sub->mask, mask, memory_order_relaxed);
+}
+
+void input_event_publish(input_event_type_t type, uint16_t code)
+{
+    if (type >= INPUT_EVENT_TYPE_MAX) {
+        return;
+    }
+    input_event_dispatch(type, code, false);
+}
+
+void input_event_publish_from_isr(input_event_type_t type, uint16_t code)
+{
+    if (type >= INPUT_EVENT_TYPE_MAX) {
+        return;
+    }
+    input_event_dispatch(type, code, true);
+}
+
+bool input_event_receive(input_subscriber_t *sub, input_event_t *event, TickType_t timeout)
+{
+    if (sub == NULL || event == NULL) {
+        return false;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    for (;;) {
+        if (input_ring_pop(sub, event)) {
+            return true;
+        }
+
+        // 已经取走的事件也会留下通知，醒来后缓冲区仍可能为空，需要按剩余时间继续等待
+        TickType_t remaining = timeout;
+        if (timeout != portMAX_DELAY) {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= timeout) {
+                return false;
+            }
+            remaining = timeout - elapsed;
+        }
+        ulTaskNotifyTake(pdTRUE, remaining);
+    }
+}
+
+void input_event_flush(input_subscriber_t *sub)
+{
+    input_event_t event;
+
+    if (sub == NULL) {
+        return;
+    }
+    while (input_ring_pop(sub, &event)) {
+    }
+}
+
+void input_event_get_stats(const input_subscriber_t *sub, input_event_stats_t *stats)
+{
+    if (sub == NULL || stats == NULL) {
+        return;
+    }
+    stats->delivered = atomic_load_explicit(&sub->delivered, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&sub->dropped, memory_order_relaxed);
+    stats->capacity = sub->capacity_mask + 1;
+}
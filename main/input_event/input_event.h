@@ -0,0 +1,115 @@
+#ifndef _INPUT_EVENT_H_
+#define _INPUT_EVENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 输入事件总线
+ * 摇杆、键盘、USB状态和音频播放变化统一以带时间戳的事件发布，每个订阅者拥有一个无锁的多生产者单消费者环形缓冲区：
+ *   1. 发布者（摇杆任务、扫描任务、USB任务、中断）只做一次CAS和一次任务通知，缓冲区满时丢弃事件并计数，永不阻塞
+ *   2. 订阅者按事件类型掩码过滤，只接收自己关心的事件，掩码可以随时修改
+ *   3. 订阅者阻塞等待时使用所属任务的任务通知，该任务不应再把任务通知用于其他用途
+ */
+
+// 事件类型
+typedef enum {
+    INPUT_EVENT_JOYSTICK = 0,   // 摇杆菜单操作，code为MenuOperation
+    INPUT_EVENT_KEY,            // 键盘按键，code为键码，按住期间每次扫描都会上报
+    INPUT_EVENT_USB,            // USB状态变化，code为input_usb_state_t
+    INPUT_EVENT_STICK_DIRECTION,// 摇杆方向变化，code为joystick_direction_t，只在方向改变时发布
+    INPUT_EVENT_STICK_BUTTON,   // 摇杆按键，code为button_press_type_t
+    INPUT_EVENT_AUDIO,          // 音频播放状态或频谱变化，code为input_audio_event_t
+    INPUT_EVENT_TYPE_MAX
+} input_event_type_t;
+
+// USB状态
+typedef enum {
+    INPUT_USB_MOUNTED = 0,      // 设备被主机枚举
+    INPUT_USB_UNMOUNTED,        // 设备被移除
+    INPUT_USB_SUSPENDED,        // 总线挂起
+    INPUT_USB_RESUMED           // 总线恢复
+} input_usb_state_t;
+
+// 音频事件
+typedef enum {
+    INPUT_AUDIO_PLAYER_STATE = 0,   // 播放/暂停/停止状态改变
+    INPUT_AUDIO_SPECTRUM            // 频谱分析结果有变化，静音后不再发布
+} input_audio_event_t;
+
+// 事件类型对应的过滤掩码
+#define INPUT_EVENT_MASK(type)      (1u << (type))
+#define INPUT_EVENT_MASK_ALL        ((1u << INPUT_EVENT_TYPE_MAX) - 1)
+
+// 最多同时存在的订阅者数量
+#define INPUT_EVENT_MAX_SUBSCRIBERS 4
+
+// 输入事件
+typedef struct {
+    int64_t timestamp_us;       // 发布时刻（esp_timer_get_time）
+    uint16_t code;              // 事件参数，含义由type决定
+    uint8_t type;               // input_event_type_t
+} input_event_t;
+
+// 订阅者统计信息
+typedef struct {
+    uint32_t delivered;         // 成功放入缓冲区的事件数
+    uint32_t dropped;           // 缓冲区满被丢弃的事件数
+    uint32_t capacity;          // 缓冲区容量
+} input_event_stats_t;
+
+typedef struct input_subscriber input_subscriber_t;
+
+/**
+ * @brief 创建订阅者，订阅者归调用任务所有，只能由该任务接收事件
+ * @param mask 事件类型过滤掩码
+ * @param capacity 缓冲区容量，向上取整为2的幂
+ * @return 订阅者句柄，内存不足或订阅者数量已满时返回NULL
+ */
+input_subscriber_t *input_event_subscribe(uint32_t mask, uint32_t capacity);
+
+/**
+ * @brief 修改订阅者的事件类型过滤掩码，已经放入缓冲区的事件不受影响
+ */
+void input_event_set_filter(input_subscriber_t *sub, uint32_t mask);
+
+/**
+ * @brief 发布事件，可在任意任务中调用，不会阻塞
+ */
+void input_event_publish(input_event_type_t type, uint16_t code);
+
+/**
+ * @brief 在中断中发布事件
+ */
+void input_event_publish_from_isr(input_event_type_t type, uint16_t code);
+
+/**
+ * @brief 接收一个事件
+ * @param sub 订阅者句柄
+ * @param event 输出事件
+ * @param timeout 最长等待时间（节拍），0表示不等待，portMAX_DELAY表示一直等待
+ * @return 收到事件返回true，超时返回false
+ */
+bool input_event_receive(input_subscriber_t *sub, input_event_t *event, TickType_t timeout);
+
+/**
+ * @brief 丢弃订阅者缓冲区中的所有事件，只能由订阅者所属任务调用
+ */
+void input_event_flush(input_subscriber_t *sub);
+
+/**
+ * @brief 获取订阅者的统计信息
+ */
+void input_event_get_stats(const input_subscriber_t *sub, input_event_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
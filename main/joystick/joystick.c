@@ -1,4 +1,8 @@
 #include "joystick.h"
+#include "joystick_filter.h"
+#include "joystick_mouse.h"
+#include "input_event.h"
+#include "button_gesture_driver.h"
 
 
 
@@ -6,269 +10,280 @@
 static const char *TAG = "app_joystick";
 
 
-// 中值滤波参数定义
-#define FILTER_WINDOW_SIZE  5       // 减小滤波窗口大小以提高响应速度
-#define NUM_ADC_CHANNELS    2       // ADC通道数量
+#define NUM_ADC_CHANNELS    JOYSTICK_AXIS_COUNT     // ADC通道数量
 
-// 按键检测参数定义
-#define SHORT_PRESS_TIMEOUT_MS 500  // 短按超时时间
-#define LONG_PRESS_TIMEOUT_MS 1000  // 长按超时时间
-#define DOUBLE_PRESS_TIMEOUT_MS 400 // 双击超时时间，已延长以提高双击识别率
+// 校准数据在NVS中的位置
+#define CALIBRATION_NVS_KEY         "joy_cal"
+#define CALIBRATION_SAVE_INTERVAL_MS 30000  // 两次保存校准数据的最短间隔，减少Flash擦写
 
-// ADC句柄和校准句柄
-static adc_oneshot_unit_handle_t adc1_handle;
-static adc_cali_handle_t adc1_cali_handle = NULL;
+// 连续采样缓冲区参数
+#define ADC_FRAME_BYTES     (JOYSTICK_ADC_BATCH_SIZE * SOC_ADC_DIGI_RESULT_BYTES)  // 一批转换结果的字节数
+#define ADC_POOL_FRAMES     4       // 驱动内部缓冲的批数，采样任务来不及处理时暂存
 
-// 滤波缓冲区和索引
-static int adc_filter_buffers[NUM_ADC_CHANNELS][FILTER_WINDOW_SIZE] = {0};
-static int adc_filter_index[NUM_ADC_CHANNELS] = {0};
-static int adc_filter_initialized = 0;
+// 摇杆使用的ADC通道，下标与滤波缓冲区的通道下标一致
+static const adc_channel_t adc_channels[NUM_ADC_CHANNELS] = {ADC_CHANNEL_1, ADC_CHANNEL_2};
 
-// 按键状态变量
-static int32_t button_press_start_time = 0;
-static int32_t last_button_release_time = 0;
-static bool button_pressed = false;
-static bool button_released = false;
-static int press_count = 0;
-static button_press_type_t detected_press_type = BUTTON_NONE;
+// ADC句柄
+static adc_continuous_handle_t adc1_handle = NULL;
+
+// 采样任务句柄，转换完成中断通过任务通知唤醒
+static TaskHandle_t sample_task_handle = NULL;
+
+// 最近一批样本判断出的摇杆方向
+static volatile joystick_direction_t current_direction = JOYSTICK_CENTER;
+
+// 每个通道的中值滤波器和方向判断器，只由采样任务访问
+static joystick_median_t adc_filters[NUM_ADC_CHANNELS];
+static joystick_classifier_t classifier;
+
+// 校准数据的保存位置和上次保存时间
+static unified_nvs_manager_t *nvs_manager = NULL;
+static int64_t last_calibration_save_time = 0;
+
+// 摇杆按键的手势识别，由边沿中断和定时器驱动，不随采样批次轮询
+static button_gesture_handle_t sw_button = NULL;
+
+/**
+ * @brief 摇杆按键手势回调 - 在esp_timer任务中执行，把手势转换为按键类型发布
+ *
+ * 单击为短按，双击为双击，按住1秒为长按（单击后长按同样视为长按）
+ */
+static void sw_gesture_callback(const button_gesture_event_t *event, void *user_ctx)
+{
+    button_press_type_t press_type = BUTTON_NONE;
+
+    if (event->type == BUTTON_GESTURE_TAP) {
+        press_type = (event->count >= 2) ? BUTTON_DOUBLE_PRESS : BUTTON_SHORT_PRESS;
+    } else if (event->type == BUTTON_GESTURE_HOLD) {
+        press_type = BUTTON_LONG_PRESS;
+    }
+
+    if (press_type != BUTTON_NONE) {
+        update_last_activity_time();
+        input_event_publish(INPUT_EVENT_STICK_BUTTON, press_type);
+    }
+}
 
 void sw_gpio_init(void) {
-    gpio_config_t io_conf = {
-            .pin_bit_mask = 1ULL << JOYSTICK_SW_PIN,
-                            .mode = GPIO_MODE_INPUT,
-                            .pull_down_en = 0,
-                            .pull_up_en = GPIO_PULLUP_ENABLE,
-    };
-    gpio_config(&io_conf);
+    // 摇杆按键低电平有效：单击/双击，1秒长按
+    button_gesture_config_t gesture_config = BUTTON_GESTURE_CONFIG_DEFAULT();
+    esp_err_t err = button_gesture_new_gpio(JOYSTICK_SW_PIN, true, &gesture_config,
+                                            sw_gesture_callback, NULL, &sw_button);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up joystick button: %s", esp_err_to_name(err));
+    }
     
-    // 初始化ADC
-    adc_oneshot_unit_init_cfg_t init_config1 = {
-        .unit_id = ADC_UNIT_1,
-        .clk_src = ADC_RTC_CLK_SRC_DEFAULT,
-        .ulp_mode = ADC_ULP_MODE_DISABLE,
+    // 初始化ADC连续转换，两个通道按固定采样率轮流转换，结果由DMA写入驱动缓冲区
+    adc_continuous_handle_cfg_t handle_config = {
+        .max_store_buf_size = ADC_FRAME_BYTES * ADC_POOL_FRAMES,
+        .conv_frame_size = ADC_FRAME_BYTES,
     };
-    ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_config1, &adc1_handle));
+    ESP_ERROR_CHECK(adc_continuous_new_handle(&handle_config, &adc1_handle));
     
     // 配置ADC通道
-    adc_oneshot_chan_cfg_t channel_config = {
-        .atten = ADC_ATTEN_DB_12,
-        .bitwidth = ADC_BITWIDTH_DEFAULT,
-    };
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, ADC_CHANNEL_1, &channel_config));
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, ADC_CHANNEL_2, &channel_config));
-    
-    // 初始化ADC校准
-    adc_cali_curve_fitting_config_t cali_config = {
-        .unit_id = ADC_UNIT_1,
-        .atten = ADC_ATTEN_DB_12,
-        .bitwidth = ADC_BITWIDTH_DEFAULT,
+    adc_digi_pattern_config_t pattern[NUM_ADC_CHANNELS];
+    for (int i = 0; i < NUM_ADC_CHANNELS; i++) {
+        pattern[i].atten = ADC_ATTEN_DB_12;
+        pattern[i].channel = adc_channels[i];
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+    adc_continuous_config_t dig_config = {
+        .pattern_num = NUM_ADC_CHANNELS,
+        .adc_pattern = pattern,
+        .sample_freq_hz = JOYSTICK_ADC_SAMPLE_FREQ_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
     };
-    ESP_ERROR_CHECK(adc_cali_create_scheme_curve_fitting(&cali_config, &adc1_cali_handle));
+    ESP_ERROR_CHECK(adc_continuous_config(adc1_handle, &dig_config));
 }
 
-// 中值滤波函数
-static int median_filter(int channel_idx, int new_value) {
-    // 初始化缓冲区（首次调用时）
-    if (!adc_filter_initialized) {
-        // 使用更稳健的方式初始化：先收集一定数量的有效样本
-        static int init_count[NUM_ADC_CHANNELS] = {0};
-        if (init_count[channel_idx] < FILTER_WINDOW_SIZE) {
-            adc_filter_buffers[channel_idx][init_count[channel_idx]] = new_value;
-            init_count[channel_idx]++;
-            if (init_count[0] >= FILTER_WINDOW_SIZE && init_count[1] >= FILTER_WINDOW_SIZE) {
-                adc_filter_initialized = 1;
-            }
-            return new_value;
-        }
+/**
+ * @brief 设置保存校准数据使用的NVS管理器，需在joystick_start_sampling之前调用
+ */
+void joystick_set_nvs_manager(unified_nvs_manager_t *manager)
+{
+    nvs_manager = manager;
+}
+
+/**
+ * @brief 从NVS加载校准数据，不存在或数据不合理时使用默认值
+ */
+static void load_calibration(void)
+{
+    joystick_calibration_t cal;
+    size_t size = sizeof(cal);
+
+    if (nvs_manager != NULL &&
+        unified_nvs_manager_load(nvs_manager, NVS_NAMESPACE_SYSTEM, CALIBRATION_NVS_KEY,
+                                 &cal, UNIFIED_NVS_TYPE_BLOB, &size) == ESP_OK &&
+        size == sizeof(cal) && joystick_calibration_valid(&cal)) {
+        ESP_LOGI(TAG, "Calibration loaded: center %u/%u", cal.center[0], cal.center[1]);
+        joystick_classifier_init(&classifier, &cal);
+        return;
     }
 
-    // 替换最旧的值
-    adc_filter_buffers[channel_idx][adc_filter_index[channel_idx]] = new_value;
-    adc_filter_index[channel_idx] = (adc_filter_index[channel_idx] + 1) % FILTER_WINDOW_SIZE;
+    joystick_classifier_init(&classifier, NULL);
+}
 
-    // 创建临时数组用于排序
-    int temp_buffer[FILTER_WINDOW_SIZE];
-    for (int i = 0; i < FILTER_WINDOW_SIZE; i++) {
-        temp_buffer[i] = adc_filter_buffers[channel_idx][i];
+/**
+ * @brief 校准数据有明显变化时保存到NVS
+ * 
+ * 只在摇杆回中时保存，并限制保存间隔，避免频繁擦写Flash
+ */
+static void save_calibration_if_needed(void)
+{
+    if (nvs_manager == NULL || classifier.direction != JOYSTICK_CENTER ||
+        !joystick_classifier_needs_save(&classifier)) {
+        return;
     }
 
-    // 冒泡排序
-    for (int i = 0; i < FILTER_WINDOW_SIZE - 1; i++) {
-        for (int j = 0; j < FILTER_WINDOW_SIZE - i - 1; j++) {
-            if (temp_buffer[j] > temp_buffer[j + 1]) {
-                // 交换元素
-                int temp = temp_buffer[j];
-                temp_buffer[j] = temp_buffer[j + 1];
-                temp_buffer[j + 1] = temp;
-            }
-        }
+    int64_t now = esp_timer_get_time() / 1000;
+    if (last_calibration_save_time != 0 && now - last_calibration_save_time < CALIBRATION_SAVE_INTERVAL_MS) {
+        return;
     }
+    last_calibration_save_time = now;
 
-    // 返回中值
-    return temp_buffer[FILTER_WINDOW_SIZE / 2];
+    esp_err_t ret = unified_nvs_manager_save(nvs_manager, NVS_NAMESPACE_SYSTEM, CALIBRATION_NVS_KEY,
+                                             &classifier.cal, UNIFIED_NVS_TYPE_BLOB, sizeof(classifier.cal));
+    if (ret == ESP_OK) {
+        ret = unified_nvs_manager_commit(nvs_manager);
+    }
+    if (ret == ESP_OK) {
+        joystick_classifier_mark_saved(&classifier);
+    } else {
+        ESP_LOGW(TAG, "Failed to save calibration: %s", esp_err_to_name(ret));
+    }
 }
 
-
-// 获取摇杆方向和旋转状态
-// 用于跟踪最后摇杆方向的静态变量
-static joystick_direction_t last_joystick_direction = JOYSTICK_CENTER;
-
-joystick_state_t get_joystick_direction()
+/**
+ * @brief 处理一批转换结果：按通道求平均后送入中值滤波，更新校准并判断方向，方向改变时发布事件
+ * @param buf DMA写入的转换结果
+ * @param length 结果字节数
+ */
+static void process_adc_batch(const uint8_t *buf, uint32_t length)
 {
-    joystick_state_t state;
-    
-    // 读取原始ADC值
-    int raw_1, raw_2;
-    esp_err_t ret1 = adc_oneshot_read(adc1_handle, ADC_CHANNEL_1, &raw_1);
-    esp_err_t ret2 = adc_oneshot_read(adc1_handle, ADC_CHANNEL_2, &raw_2);
-    vTaskDelay(5 / portTICK_PERIOD_MS);
-
-    // 处理ADC读取错误
-    if (ret1 != ESP_OK || ret2 != ESP_OK) {
-        ESP_LOGW(TAG, "ADC read failed: %s, %s", esp_err_to_name(ret1), esp_err_to_name(ret2));
-        // 返回中心位置，避免系统崩溃
-        state.direction = JOYSTICK_CENTER;
-        state.press_type = detect_button_press();
-        return state;
+    int32_t sum[NUM_ADC_CHANNELS] = {0};
+    int count[NUM_ADC_CHANNELS] = {0};
+
+    // 一批样本中两个通道交替出现，按通道号累加
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t *result = (const adc_digi_output_data_t *)&buf[i];
+        for (int ch = 0; ch < NUM_ADC_CHANNELS; ch++) {
+            if (result->type2.channel == adc_channels[ch]) {
+                sum[ch] += result->type2.data;
+                count[ch]++;
+                break;
+            }
+        }
     }
 
-    // 应用中值滤波
-    int filtered_1 = median_filter(0, raw_1);
-    int filtered_2 = median_filter(1, raw_2);
+    if (count[0] == 0 || count[1] == 0) {
+        ESP_LOGW(TAG, "ADC batch missing channel data: %d, %d", count[0], count[1]);
+        return;
+    }
 
-    // ESP_LOGI(TAG, "ADC原始值: %d, %d | 滤波后值: %d, %d", raw_1, raw_2, filtered_1, filtered_2);
+    // 批内平均抑制高频噪声，中值滤波在批与批之间剔除突变
+    uint16_t filtered_1 = joystick_median_update(&adc_filters[0], sum[0] / count[0]);
+    uint16_t filtered_2 = joystick_median_update(&adc_filters[1], sum[1] / count[1]);
 
-    // 检测按键按下的类型
-    state.press_type = detect_button_press();
+    // ESP_LOGI(TAG, "滤波后值: %u, %u", filtered_1, filtered_2);
 
-    // 如果滤波器未初始化完成，返回中心位置
-    if (!adc_filter_initialized) {
-        state.direction = JOYSTICK_CENTER;
-        return state;
+    // 滤波窗口填满之前视为中心位置
+    if (!joystick_median_full(&adc_filters[0])) {
+        return;
     }
 
-    // 根据实际ADC值动态调整判断逻辑，提高准确性和灵活性
-    // (4095,2183)为上、(0,2183)为下、(2041,0)为左、(2041,4095)为右
-    // 定义各方向的参考值
-    const int up_x = 4095;
-    const int up_y = 2183;
-    const int down_x = 0;
-    const int down_y = 2183;
-    const int left_x = 2041;
-    const int left_y = 0;
-    const int right_x = 2041;
-    const int right_y = 4095;
-    
-    // 使用欧几里得距离判断最接近的方向
-    int distance_up = (filtered_1 - up_x) * (filtered_1 - up_x) + (filtered_2 - up_y) * (filtered_2 - up_y);
-    int distance_down = (filtered_1 - down_x) * (filtered_1 - down_x) + (filtered_2 - down_y) * (filtered_2 - down_y);
-    int distance_left = (filtered_1 - left_x) * (filtered_1 - left_x) + (filtered_2 - left_y) * (filtered_2 - left_y);
-    int distance_right = (filtered_1 - right_x) * (filtered_1 - right_x) + (filtered_2 - right_y) * (filtered_2 - right_y);
-    
-    // 定义一个阈值，当距离小于该阈值时才认为是有效方向
-    const int threshold = 200 * 200; // 增大阈值以提高灵敏度
-    
-    // 如果所有方向的距离都大于阈值，则返回中心位置
-    if (distance_up > threshold && distance_down > threshold && distance_left > threshold && distance_right > threshold) {
-        state.direction = JOYSTICK_CENTER;
-    } else {
-        // 找到距离最小的方向
-        int min_distance = distance_up;
-        state.direction = JOYSTICK_UP;
-        
-        if (distance_down < min_distance) {
-            min_distance = distance_down;
-            state.direction = JOYSTICK_DOWN;
-        }
-        
-        if (distance_left < min_distance) {
-            min_distance = distance_left;
-            state.direction = JOYSTICK_LEFT;
-        }
-        
-        if (distance_right < min_distance) {
-            min_distance = distance_right;
-            state.direction = JOYSTICK_RIGHT;
-        }
+    joystick_direction_t direction = joystick_classifier_update(&classifier, filtered_1, filtered_2);
+
+    // 摇杆鼠标开启时把偏移量交给鼠标模块换算速度
+    if (joystick_mouse_get_mode() != JOYSTICK_MOUSE_OFF) {
+        joystick_mouse_update_axes(classifier.offset[0], classifier.offset[1]);
     }
-    
-    // 如果摇杆方向改变，更新最后活动时间以防止设备进入睡眠模式
-    if (state.direction != last_joystick_direction) {
+
+    // 如果摇杆方向改变，发布事件并更新最后活动时间以防止设备进入睡眠模式
+    if (direction != current_direction) {
+        current_direction = direction;
         update_last_activity_time();
-        last_joystick_direction = state.direction;
+        input_event_publish(INPUT_EVENT_STICK_DIRECTION, direction);
     }
-    
-    return state;
+
+    save_calibration_if_needed();
+}
+
+/**
+ * @brief 转换完成中断回调，一批结果写满后唤醒采样任务
+ */
+static bool IRAM_ATTR adc_conv_done_callback(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *user_data)
+{
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(sample_task_handle, &woken);
+    return woken == pdTRUE;
 }
 
-// 检测按键按下的类型
-button_press_type_t detect_button_press() {
-    int current_sw_state = (gpio_get_level(JOYSTICK_SW_PIN) == 0);
-    int64_t current_time = esp_timer_get_time() / 1000; // 转换为毫秒
+/**
+ * @brief 采样任务 - 每批转换结果就绪时被唤醒，处理完驱动缓冲区中的所有批次后继续阻塞
+ */
+static void joystick_sample_task(void *arg)
+{
+    static uint8_t frame[ADC_FRAME_BYTES];
 
-    // 检测按键按下
-    if (current_sw_state && !button_pressed) {
-        button_pressed = true;
-        button_press_start_time = current_time;
-        button_released = false;
-    }
-    
-    // 检测长按事件（在按键按下期间检测）
-    if (button_pressed && !button_released) {
-        int64_t press_duration = current_time - button_press_start_time;
-        if (press_duration >= LONG_PRESS_TIMEOUT_MS && detected_press_type != BUTTON_LONG_PRESS) {
-            detected_press_type = BUTTON_LONG_PRESS;
-            // 不重置计数器，允许在释放后继续处理短按或双击
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        uint32_t length = 0;
+        while (adc_continuous_read(adc1_handle, frame, sizeof(frame), &length, 0) == ESP_OK) {
+            process_adc_batch(frame, length);
         }
     }
-    
-    // 检测按键释放
-    if (!current_sw_state && button_pressed) {
-        button_pressed = false;
-        button_released = true;
-        last_button_release_time = current_time;
-        
-        // 只有在未检测到长按的情况下才增加按压计数
-        if (detected_press_type != BUTTON_LONG_PRESS) {
-            press_count++;
-        }
-    
-        // 如果之前未检测到长按，则检查短按或双击
-        if (detected_press_type != BUTTON_LONG_PRESS) {
-            if (press_count == 1) {
-                // 等待可能的双击
-                // 不立即返回，等待超时或再次按下
-            } else if (press_count == 2) {
-                detected_press_type = BUTTON_DOUBLE_PRESS;
-                press_count = 0; // 重置计数器
-            }
-        }
+}
+
+/**
+ * @brief 启动摇杆连续采样，需在sw_gpio_init之后调用
+ * 
+ * 方向变化和按键类型通过输入事件总线发布（INPUT_EVENT_STICK_DIRECTION、INPUT_EVENT_STICK_BUTTON）
+ * @return ESP_OK成功，其他值为错误码
+ */
+esp_err_t joystick_start_sampling(void)
+{
+    if (adc1_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (sample_task_handle != NULL) {
+        return ESP_OK;
     }
 
-    // 处理短按超时
-    if (button_released && (current_time - last_button_release_time >= SHORT_PRESS_TIMEOUT_MS)) {
-        if (press_count == 1) {
-            // 只有在未检测到长按的情况下才触发短按
-            if (detected_press_type != BUTTON_LONG_PRESS) {
-                detected_press_type = BUTTON_SHORT_PRESS;
-            }
-            press_count = 0; // 重置计数器
-        }
-        button_released = false; // 重置释放状态
+    for (int ch = 0; ch < NUM_ADC_CHANNELS; ch++) {
+        joystick_median_init(&adc_filters[ch]);
     }
+    load_calibration();
 
-    // 处理双击超时
-    if (press_count == 1 && (current_time - last_button_release_time >= DOUBLE_PRESS_TIMEOUT_MS)) {
-        // 只有在未检测到长按的情况下才触发短按（作为双击超时后的单击）
-        if (detected_press_type != BUTTON_LONG_PRESS) {
-            detected_press_type = BUTTON_SHORT_PRESS;
-        }
-        press_count = 0; // 重置计数器
+    if (xTaskCreate(joystick_sample_task, "joystick_sample", 3*1024, NULL, 5, &sample_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create sample task");
+        return ESP_ERR_NO_MEM;
     }
 
-    button_press_type_t result = detected_press_type;
-    detected_press_type = BUTTON_NONE; // 清除已检测到的按键类型
-    return result;
+    adc_continuous_evt_cbs_t cbs = {
+        .on_conv_done = adc_conv_done_callback,
+    };
+    esp_err_t ret = adc_continuous_register_event_callbacks(adc1_handle, &cbs, NULL);
+    if (ret == ESP_OK) {
+        ret = adc_continuous_start(adc1_handle);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start ADC sampling: %s", esp_err_to_name(ret));
+        vTaskDelete(sample_task_handle);
+        sample_task_handle = NULL;
+    }
+    return ret;
+}
+
+/**
+ * @brief 获取最近一批样本判断出的摇杆方向，不会阻塞
+ */
+joystick_direction_t get_joystick_current_direction(void)
+{
+    return current_direction;
 }
 
 /**
@@ -9,14 +9,18 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
-#include "esp_adc/adc_oneshot.h"
-#include "esp_adc/adc_cali.h"
-#include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_continuous.h"
 #include "esp_timer.h"
+#include "nvs_manager/unified_nvs_manager.h"
 
 
 #define JOYSTICK_SW_PIN 1
 
+// 连续采样参数：ADC1通道1和通道2轮流转换，由DMA搬运结果
+// 每批JOYSTICK_ADC_BATCH_SIZE个转换结果（两个通道合计）产生一次中断，批次周期 = 批大小 / 采样率
+#define JOYSTICK_ADC_SAMPLE_FREQ_HZ 2000    // 两个通道合计的转换频率
+#define JOYSTICK_ADC_BATCH_SIZE     32      // 每批转换结果数，2000Hz下每16ms处理一批
+
 // 定义方向和旋转的枚举类型
 // 采用欧几里得距离动态判断方向，提高准确性和灵活性
 typedef enum {
@@ -42,9 +46,10 @@ typedef struct {
 } joystick_state_t;
 
 // 函数声明
-joystick_state_t get_joystick_direction();
 void sw_gpio_init(void);
-button_press_type_t detect_button_press();
+void joystick_set_nvs_manager(unified_nvs_manager_t *manager);
+esp_err_t joystick_start_sampling(void);
+joystick_direction_t get_joystick_current_direction(void);
 void update_last_activity_time();
 
 
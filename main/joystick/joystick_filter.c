@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <string.h>
+#include "joystick_filter.h"
+
+// 出厂测得的静止值：(4095,2183)为上、(0,2183)为下、(2041,0)为左、(2041,4095)为右
+#define DEFAULT_CENTER_AXIS0    2041
+#define DEFAULT_CENTER_AXIS1    2183
+// 默认行程取中心两侧的保守范围，推到底后按实际极值扩展
+#define DEFAULT_HALF_SPAN       1600
+// 有效校准数据中心两侧至少应有的行程
+#define MIN_HALF_SPAN           256
+#define ADC_MAX_VALUE           4095
+
+void joystick_median_init(joystick_median_t *filter)
+{
+    memset(filter, 0, sizeof(*filter));
+}
+
+uint16_t joystick_median_update(joystick_median_t *filter, uint16_t sample)
+{
+    // 窗口未满：直接插入有序窗口
+    if (filter->count < JOYSTICK_MEDIAN_WINDOW) {
+        int pos = filter->count;
+        while (pos > 0 && filter->sorted[pos - 1] > sample) {
+            filter->sorted[pos] = filter->sorted[pos - 1];
+            pos--;
+        }
+        filter->sorted[pos] = sample;
+        filter->ring[filter->count++] = sample;
+        return filter->sorted[(filter->count - 1) / 2];
+    }
+
+    // 用新样本替换最旧样本
+    uint16_t old = filter->ring[filter->oldest];
+    filter->ring[filter->oldest] = sample;
+    filter->oldest = (filter->oldest + 1) % JOYSTICK_MEDIAN_WINDOW;
+
+    // 在有序窗口中找到最旧样本的位置，向新样本应在的方向移动相邻元素，最后写入新样本
+    int pos = 0;
+    while (filter->sorted[pos] != old) {
+        pos++;
+    }
+    if (sample > old) {
+        while (pos + 1 < JOYSTICK_MEDIAN_WINDOW && filter->sorted[pos + 1] < sample) {
+            filter->sorted[pos] = filter->sorted[pos + 1];
+            pos++;
+        }
+    } else {
+        while (pos > 0 && filter->sorted[pos - 1] > sample) {
+            filter->sorted[pos] = filter->sorted[pos - 1];
+            pos--;
+        }
+    }
+    filter->sorted[pos] = sample;
+
+    return filter->sorted[JOYSTICK_MEDIAN_WINDOW / 2];
+}
+
+void joystick_calibration_default(joystick_calibration_t *cal)
+{
+    const uint16_t center[JOYSTICK_AXIS_COUNT] = {DEFAULT_CENTER_AXIS0, DEFAULT_CENTER_AXIS1};
+
+    for (int axis = 0; axis < JOYSTICK_AXIS_COUNT; axis++) {
+        cal->center[axis] = center[axis];
+        cal->min[axis] = center[axis] - DEFAULT_HALF_SPAN;
+        cal->max[axis] = center[axis] + DEFAULT_HALF_SPAN;
+    }
+}
+
+bool joystick_calibration_valid(const joystick_calibration_t *cal)
+{
+    for (int axis = 0; axis < JOYSTICK_AXIS_COUNT; axis++) {
+        if (cal->max[axis] > ADC_MAX_VALUE ||
+            cal->max[axis] < cal->center[axis] + MIN_HALF_SPAN ||
+            cal->center[axis] < cal->min[axis] + MIN_HALF_SPAN) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void joystick_classifier_init(joystick_classifier_t *classifier, const joystick_calibration_t *cal)
+{
+    if (cal != NULL) {
+        classifier->cal = *cal;
+    } else {
+        joystick_calibration_default(&classifier->cal);
+    }
+    classifier->saved = classifier->cal;
+    for (int axis = 0; axis < JOYSTICK_AXIS_COUNT; axis++) {
+        classifier->center_q4[axis] = (uint32_t)classifier->cal.center[axis] << 4;
+    }
+    classifier->offset[0] = 0;
+    classifier->offset[1] = 0;
+    classifier->direction = JOYSTICK_CENTER;
+}
+
+/**
+ * @brief 把ADC值换算为相对中心的千分比，中心两侧分别按各自的行程归一化
+ */
+static int32_t normalize_axis(const joystick_calibration_t *cal, int axis, uint16_t value)
+{
+    int32_t offset = (int32_t)value - cal->center[axis];
+    int32_t span = (offset >= 0) ? cal->max[axis] - cal->center[axis] : cal->center[axis] - cal->min[axis];
+    // 中心跟踪可能漂到行程端点附近，行程过小时按最小行程计算，避免除零
+    if (span < MIN_HALF_SPAN) {
+        span = MIN_HALF_SPAN;
+    }
+    int32_t permille = offset * 1000 / span;
+
+    if (permille > 1000) {
+        permille = 1000;
+    } else if (permille < -1000) {
+        permille = -1000;
+    }
+    return permille;
+}
+
+/**
+ * @brief 按角度扇区判断方向：哪个轴的分量大就属于哪个轴上的扇区
+ * @param current 当前方向，另一个轴的分量须超出迟滞比例才切换
+ */
+static joystick_direction_t classify_sector(int32_t up, int32_t right, joystick_direction_t current)
+{
+    int32_t abs_up = abs(up);
+    int32_t abs_right = abs(right);
+
+    if (current == JOYSTICK_UP || current == JOYSTICK_DOWN) {
+        if (abs_right * JOYSTICK_SECTOR_HYSTERESIS_DEN <= abs_up * JOYSTICK_SECTOR_HYSTERESIS_NUM) {
+            return (up >= 0) ? JOYSTICK_UP : JOYSTICK_DOWN;
+        }
+    } else if (current == JOYSTICK_LEFT || current == JOYSTICK_RIGHT) {
+        if (abs_up * JOYSTICK_SECTOR_HYSTERESIS_DEN <= abs_right * JOYSTICK_SECTOR_HYSTERESIS_NUM) {
+            return (right >= 0) ? JOYSTICK_RIGHT : JOYSTICK_LEFT;
+        }
+    }
+
+    if (abs_up >= abs_right) {
+        return (up >= 0) ? JOYSTICK_UP : JOYSTICK_DOWN;
+    }
+    return (right >= 0) ? JOYSTICK_RIGHT : JOYSTICK_LEFT;
+}
+
+joystick_direction_t joystick_classifier_update(joystick_classifier_t *classifier, uint16_t axis0, uint16_t axis1)
+{
+    joystick_calibration_t *cal = &classifier->cal;
+    const uint16_t value[JOYSTICK_AXIS_COUNT] = {axis0, axis1};
+
+    // 行程随观测到的极值扩展
+    for (int axis = 0; axis < JOYSTICK_AXIS_COUNT; axis++) {
+        if (value[axis] < cal->min[axis]) {
+            cal->min[axis] = value[axis];
+        } else if (value[axis] > cal->max[axis]) {
+            cal->max[axis] = value[axis];
+        }
+    }
+
+    int32_t up = normalize_axis(cal, 0, axis0);
+    int32_t right = normalize_axis(cal, 1, axis1);
+    int32_t radius2 = up * up + right * right;
+    classifier->offset[0] = (int16_t)up;
+    classifier->offset[1] = (int16_t)right;
+
+    // 死区迟滞：已经离开中心时用较小的半径判断是否回到中心
+    int32_t deadzone = (classifier->direction == JOYSTICK_CENTER) ?
+                       JOYSTICK_DEADZONE_ENTER_PERMILLE : JOYSTICK_DEADZONE_EXIT_PERMILLE;
+    if (radius2 >= deadzone * deadzone) {
+        classifier->direction = classify_sector(up, right, classifier->direction);
+        return classifier->direction;
+    }
+
+    classifier->direction = JOYSTICK_CENTER;
+
+    // 摇杆静止时以1/16的系数跟踪中心点零漂
+    if (radius2 < JOYSTICK_CENTER_TRACK_PERMILLE * JOYSTICK_CENTER_TRACK_PERMILLE) {
+        for (int axis = 0; axis < JOYSTICK_AXIS_COUNT; axis++) {
+            int32_t error = ((int32_t)value[axis] << 4) - (int32_t)classifier->center_q4[axis];
+            classifier->center_q4[axis] += error / 16;
+            cal->center[axis] = (classifier->center_q4[axis] + 8) >> 4;
+        }
+    }
+
+    return JOYSTICK_CENTER;
+}
+
+bool joystick_classifier_needs_save(const joystick_classifier_t *classifier)
+{
+    const joystick_calibration_t *cal = &classifier->cal;
+    const joystick_calibration_t *saved = &classifier->saved;
+
+    for (int axis = 0; axis < JOYSTICK_AXIS_COUNT; axis++) {
+        if (abs((int)cal->center[axis] - saved->center[axis]) >= JOYSTICK_CAL_SAVE_DELTA ||
+            abs((int)cal->min[axis] - saved->min[axis]) >= JOYSTICK_CAL_SAVE_DELTA ||
+            abs((int)cal->max[axis] - saved->max[axis]) >= JOYSTICK_CAL_SAVE_DELTA) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void joystick_classifier_mark_saved(joystick_classifier_t *classifier)
+{
+    classifier->saved = classifier->cal;
+}
@@ -0,0 +1,111 @@
+#ifndef _JOYSTICK_FILTER_H_
+#define _JOYSTICK_FILTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "joystick.h"
+
+/*
+ * 摇杆滤波与方向判断
+ *   1. 滑动中值滤波：维护按到达顺序的环形窗口和一份有序窗口，每个新样本只需移出最旧样本、
+ *      在有序窗口中就地移动到新位置，不再每次复制和排序整个窗口
+ *   2. 自动校准：中心点在摇杆静止时缓慢跟踪零漂，行程上下限随观测到的极值扩展
+ *   3. 方向判断：按校准结果把两个轴归一化为千分比，死区判断带迟滞，
+ *      死区外按角度划分为四个90度扇区，扇区边界同样带迟滞，避免斜推时方向来回跳变
+ * 本模块不访问硬件和NVS，校准结果的保存由调用者负责
+ */
+
+// 中值滤波窗口大小（批次数）
+#define JOYSTICK_MEDIAN_WINDOW          5
+
+// 轴数量：轴0为ADC通道1（向上为正），轴1为ADC通道2（向右为正）
+#define JOYSTICK_AXIS_COUNT             2
+
+// 死区半径（千分比），离开中心需超过ENTER，回到中心需低于EXIT
+#define JOYSTICK_DEADZONE_ENTER_PERMILLE    500
+#define JOYSTICK_DEADZONE_EXIT_PERMILLE     350
+
+// 低于该半径（千分比）视为摇杆静止，此时跟踪中心点零漂
+#define JOYSTICK_CENTER_TRACK_PERMILLE      120
+
+// 扇区迟滞：另一个轴的分量超过当前方向所在轴分量的5/4倍（约51度）才切换方向
+#define JOYSTICK_SECTOR_HYSTERESIS_NUM      5
+#define JOYSTICK_SECTOR_HYSTERESIS_DEN      4
+
+// 校准结果与已保存值的差异超过该值（ADC计数）时需要重新保存
+#define JOYSTICK_CAL_SAVE_DELTA         16
+
+// 滑动中值滤波器
+typedef struct {
+    uint16_t ring[JOYSTICK_MEDIAN_WINDOW];      // 按到达顺序保存的样本
+    uint16_t sorted[JOYSTICK_MEDIAN_WINDOW];    // 升序排列的同一批样本
+    uint8_t count;                              // 已收到的样本数，最多为窗口大小
+    uint8_t oldest;                             // 窗口满后ring中最旧样本的位置
+} joystick_median_t;
+
+// 校准数据，整体作为二进制数据保存在NVS中
+typedef struct {
+    uint16_t center[JOYSTICK_AXIS_COUNT];       // 静止时的ADC值
+    uint16_t min[JOYSTICK_AXIS_COUNT];          // 观测到的最小ADC值
+    uint16_t max[JOYSTICK_AXIS_COUNT];          // 观测到的最大ADC值
+} joystick_calibration_t;
+
+// 方向判断器
+typedef struct {
+    joystick_calibration_t cal;                 // 当前校准数据
+    joystick_calibration_t saved;               // 最近一次保存（或加载）的校准数据
+    uint32_t center_q4[JOYSTICK_AXIS_COUNT];    // 中心点的Q4定点值，用于零漂跟踪的指数平均
+    int16_t offset[JOYSTICK_AXIS_COUNT];        // 最近一次输入归一化后的偏移（千分比），轴0向上为正，轴1向右为正
+    joystick_direction_t direction;             // 当前方向
+} joystick_classifier_t;
+
+/**
+ * @brief 初始化中值滤波器
+ */
+void joystick_median_init(joystick_median_t *filter);
+
+/**
+ * @brief 加入一个样本并返回窗口中值，窗口未满时返回已有样本的中值
+ */
+uint16_t joystick_median_update(joystick_median_t *filter, uint16_t sample);
+
+/**
+ * @brief 窗口是否已经填满，填满之前的中值不足以剔除突变
+ */
+static inline bool joystick_median_full(const joystick_median_t *filter)
+{
+    return filter->count >= JOYSTICK_MEDIAN_WINDOW;
+}
+
+/**
+ * @brief 填入默认校准数据：中心为出厂测得的静止值，行程取中心两侧的保守范围，使用中随极值扩展
+ */
+void joystick_calibration_default(joystick_calibration_t *cal);
+
+/**
+ * @brief 检查校准数据是否合理（用于校验从NVS加载的数据）
+ */
+bool joystick_calibration_valid(const joystick_calibration_t *cal);
+
+/**
+ * @brief 初始化方向判断器
+ * @param cal 初始校准数据，NULL时使用默认值
+ */
+void joystick_classifier_init(joystick_classifier_t *classifier, const joystick_calibration_t *cal);
+
+/**
+ * @brief 输入一组滤波后的ADC值，更新校准数据并返回方向
+ */
+joystick_direction_t joystick_classifier_update(joystick_classifier_t *classifier, uint16_t axis0, uint16_t axis1);
+
+/**
+ * @brief 校准数据是否与已保存的数据有明显差异
+ */
+bool joystick_classifier_needs_save(const joystick_classifier_t *classifier);
+
+/**
+ * @brief 记录当前校准数据已经保存
+ */
+void joystick_classifier_mark_saved(joystick_classifier_t *classifier);
+
+#endif
@@ -0,0 +1,224 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "esp_timer.h"
+#include "tinyusb_hid.h"
+#include "joystick_mouse.h"
+
+// 两次报告之间积分的最长时间，主机暂停轮询后恢复时指针不会跳变
+#define MAX_REPORT_INTERVAL_US  20000
+// 位移累加器的单位：速度(单位/秒) × 时间(微秒)
+#define ACCUMULATOR_SCALE       1000000LL
+
+const joystick_mouse_curve_t joystick_mouse_curve_linear = {
+    {0, 0, 150, 300, 450, 600, 750, 900, 1050, 1200, 1350, 1500, 1650, 1800, 1950, 2100, 2250}
+};
+
+const joystick_mouse_curve_t joystick_mouse_curve_quadratic = {
+    {0, 0, 20, 60, 120, 200, 300, 420, 560, 720, 900, 1100, 1320, 1560, 1820, 2100, 2400}
+};
+
+const joystick_mouse_curve_t joystick_mouse_curve_precision = {
+    {0, 0, 15, 30, 45, 60, 80, 110, 160, 240, 360, 520, 720, 960, 1240, 1560, 1920}
+};
+
+const joystick_mouse_curve_t joystick_mouse_curve_scroll = {
+    {0, 0, 4, 8, 16, 24, 36, 48, 64, 84, 108, 136, 168, 204, 244, 284, 320}
+};
+
+// 模式与曲线，由UI任务修改
+static _Atomic uint32_t s_mode = JOYSTICK_MOUSE_OFF;
+static const joystick_mouse_curve_t *s_pointer_curve = &joystick_mouse_curve_quadratic;
+static const joystick_mouse_curve_t *s_scroll_curve = &joystick_mouse_curve_scroll;
+
+// 目标速度，由采样任务写入：指针模式为x/y，滚轮模式为pan/wheel
+static _Atomic int32_t s_velocity[2] = {0, 0};
+
+// 待发送的按键点击和主机设置的分辨率倍数
+static _Atomic uint32_t s_pending_buttons = 0;
+static _Atomic uint32_t s_resolution = 0;
+
+// 以下状态只由HID任务访问
+static int64_t s_accumulator[2] = {0, 0};   // 尚未发送的位移余量
+static int64_t s_last_report_time = 0;      // 上一份报告的生成时刻，0表示报告流已停止
+static uint8_t s_held_buttons = 0;          // 已按下、下一份报告需要松开的按键
+
+/**
+ * @brief 按加速曲线把偏移量换算为速度，保留符号
+ */
+static int32_t curve_speed(const joystick_mouse_curve_t *curve, int16_t offset)
+{
+    int32_t magnitude = abs(offset);
+    if (magnitude >= 1000) {
+        magnitude = 1000;
+    }
+
+    // 偏移量在曲线上的位置，整数部分为点序号，余数用于插值
+    int32_t position = magnitude * (JOYSTICK_MOUSE_CURVE_POINTS - 1);
+    int32_t index = position / 1000;
+    int32_t fraction = position % 1000;
+    int32_t speed = curve->speed[index];
+    if (index + 1 < JOYSTICK_MOUSE_CURVE_POINTS) {
+        speed += ((int32_t)curve->speed[index + 1] - speed) * fraction / 1000;
+    }
+
+    return (offset < 0) ? -speed : speed;
+}
+
+/**
+ * @brief 取出累加器中的整数位移，余量留在累加器中
+ * @param divisor 每个输出单位对应的速度单位数
+ */
+static int32_t take_accumulated(int64_t *accumulator, int32_t divisor, int32_t limit)
+{
+    int64_t unit = ACCUMULATOR_SCALE * divisor;
+    int64_t value = *accumulator / unit;
+
+    if (value > limit) {
+        value = limit;
+    } else if (value < -limit) {
+        value = -limit;
+    }
+    *accumulator -= value * unit;
+    return (int32_t)value;
+}
+
+void joystick_mouse_set_mode(joystick_mouse_mode_t mode)
+{
+    atomic_store(&s_velocity[0], 0);
+    atomic_store(&s_velocity[1], 0);
+    if (mode == JOYSTICK_MOUSE_OFF) {
+        atomic_store(&s_pending_buttons, 0);
+    }
+    atomic_store(&s_mode, mode);
+}
+
+joystick_mouse_mode_t joystick_mouse_get_mode(void)
+{
+    return (joystick_mouse_mode_t)atomic_load(&s_mode);
+}
+
+void joystick_mouse_set_curve(joystick_mouse_mode_t mode, const joystick_mouse_curve_t *curve)
+{
+    if (curve == NULL) {
+        return;
+    }
+    if (mode == JOYSTICK_MOUSE_POINTER) {
+        s_pointer_curve = curve;
+    } else if (mode == JOYSTICK_MOUSE_SCROLL) {
+        s_scroll_curve = curve;
+    }
+}
+
+void joystick_mouse_update_axes(int16_t up, int16_t right)
+{
+    joystick_mouse_mode_t mode = joystick_mouse_get_mode();
+    int32_t horizontal = 0;
+    int32_t vertical = 0;
+
+    if (mode == JOYSTICK_MOUSE_POINTER) {
+        horizontal = curve_speed(s_pointer_curve, right);
+        vertical = -curve_speed(s_pointer_curve, up);       // HID的Y轴向下为正
+    } else if (mode == JOYSTICK_MOUSE_SCROLL) {
+        horizontal = curve_speed(s_scroll_curve, right);
+        vertical = curve_speed(s_scroll_curve, up);         // 滚轮向上为正
+    } else {
+        return;
+    }
+
+    bool was_idle = atomic_load(&s_velocity[0]) == 0 && atomic_load(&s_velocity[1]) == 0;
+    atomic_store(&s_velocity[0], horizontal);
+    atomic_store(&s_velocity[1], vertical);
+
+    // 从静止开始移动时唤醒HID任务，之后由IN传输完成驱动
+    if (was_idle && (horizontal != 0 || vertical != 0)) {
+        tinyusb_hid_mouse_wakeup();
+    }
+}
+
+void joystick_mouse_click(uint8_t buttons)
+{
+    if (joystick_mouse_get_mode() == JOYSTICK_MOUSE_OFF) {
+        return;
+    }
+    atomic_fetch_or(&s_pending_buttons, buttons);
+    tinyusb_hid_mouse_wakeup();
+}
+
+void joystick_mouse_set_resolution(uint8_t feature)
+{
+    atomic_store(&s_resolution, feature & 0x0F);
+}
+
+uint8_t joystick_mouse_get_resolution(void)
+{
+    return (uint8_t)atomic_load(&s_resolution);
+}
+
+bool joystick_mouse_is_active(void)
+{
+    if (joystick_mouse_get_mode() == JOYSTICK_MOUSE_OFF) {
+        return s_held_buttons != 0;
+    }
+    return atomic_load(&s_velocity[0]) != 0 || atomic_load(&s_velocity[1]) != 0 ||
+           atomic_load(&s_pending_buttons) != 0 || s_held_buttons != 0;
+}
+
+bool joystick_mouse_build_report(joystick_mouse_report_t *report)
+{
+    joystick_mouse_mode_t mode = joystick_mouse_get_mode();
+    int32_t horizontal = atomic_load(&s_velocity[0]);
+    int32_t vertical = atomic_load(&s_velocity[1]);
+    int64_t now = esp_timer_get_time();
+
+    report->buttons = 0;
+    report->x = 0;
+    report->y = 0;
+    report->wheel = 0;
+    report->pan = 0;
+
+    // 按键：上一份报告按下的按键在这一份中松开，新的点击在松开之后再发送
+    bool buttons_changed = false;
+    if (s_held_buttons != 0) {
+        s_held_buttons = 0;
+        buttons_changed = true;
+    } else {
+        uint8_t pending = (uint8_t)atomic_exchange(&s_pending_buttons, 0);
+        if (pending != 0) {
+            report->buttons = pending;
+            s_held_buttons = pending;
+            buttons_changed = true;
+        }
+    }
+
+    // 摇杆回中：清除余量并停止报告流
+    if (mode == JOYSTICK_MOUSE_OFF || (horizontal == 0 && vertical == 0)) {
+        s_accumulator[0] = 0;
+        s_accumulator[1] = 0;
+        s_last_report_time = 0;
+        return buttons_changed;
+    }
+
+    // 按两次报告之间的实际时间积分，报告流刚开始时按一个轮询间隔计算
+    int64_t interval = (s_last_report_time == 0) ? 1000 : now - s_last_report_time;
+    if (interval > MAX_REPORT_INTERVAL_US) {
+        interval = MAX_REPORT_INTERVAL_US;
+    }
+    s_last_report_time = now;
+    s_accumulator[0] += (int64_t)horizontal * interval;
+    s_accumulator[1] += (int64_t)vertical * interval;
+
+    if (mode == JOYSTICK_MOUSE_POINTER) {
+        report->x = (int16_t)take_accumulated(&s_accumulator[0], 1, INT16_MAX);
+        report->y = (int16_t)take_accumulated(&s_accumulator[1], 1, INT16_MAX);
+    } else {
+        // 主机未启用高分辨率滚动时，每个报告单位为一个完整刻度
+        uint8_t resolution = joystick_mouse_get_resolution();
+        int32_t pan_divisor = (resolution & 0x0C) ? 1 : HID_MOUSE_SCROLL_RESOLUTION;
+        int32_t wheel_divisor = (resolution & 0x03) ? 1 : HID_MOUSE_SCROLL_RESOLUTION;
+        report->pan = (int8_t)take_accumulated(&s_accumulator[0], pan_divisor, INT8_MAX);
+        report->wheel = (int8_t)take_accumulated(&s_accumulator[1], wheel_divisor, INT8_MAX);
+    }
+
+    // 速度不为零时每个轮询间隔都发送报告，位移为零的报告用于维持发送节奏
+    return true;
+}
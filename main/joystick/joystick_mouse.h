@@ -0,0 +1,101 @@
+#ifndef _JOYSTICK_MOUSE_H_
+#define _JOYSTICK_MOUSE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * 摇杆鼠标
+ * 开启后摇杆偏移量经加速曲线换算为速度，由HID任务在每次IN传输完成后生成下一份鼠标报告：
+ *   1. 采样任务每批样本更新一次目标速度，HID任务按两次报告之间的实际时间积分出位移，不足一个单位的余量保留到下一份报告
+ *   2. 报告只在上一份报告发送完成后生成，发送节奏由USB轮询间隔（1ms）决定，不使用定时器
+ *   3. 摇杆回中且没有待发送的按键时停止生成报告，HID任务恢复阻塞
+ * 所有状态都是静态变量，生成报告不分配内存
+ */
+
+// 加速曲线的点数，覆盖偏移0~1000‰，相邻两点间隔62.5‰，点之间线性插值
+#define JOYSTICK_MOUSE_CURVE_POINTS     17
+
+// 鼠标按键
+#define JOYSTICK_MOUSE_BUTTON_LEFT      0x01
+#define JOYSTICK_MOUSE_BUTTON_RIGHT     0x02
+#define JOYSTICK_MOUSE_BUTTON_MIDDLE    0x04
+
+// 摇杆鼠标模式
+typedef enum {
+    JOYSTICK_MOUSE_OFF = 0,     // 关闭，摇杆只用于菜单导航
+    JOYSTICK_MOUSE_POINTER,     // 移动指针
+    JOYSTICK_MOUSE_SCROLL       // 上下为垂直滚轮，左右为水平滚轮
+} joystick_mouse_mode_t;
+
+// 加速曲线：偏移量到速度的查找表
+// 指针模式单位为计数/秒，滚轮模式单位为(1/HID_MOUSE_SCROLL_RESOLUTION)刻度/秒
+typedef struct {
+    uint16_t speed[JOYSTICK_MOUSE_CURVE_POINTS];
+} joystick_mouse_curve_t;
+
+// 预置加速曲线
+extern const joystick_mouse_curve_t joystick_mouse_curve_linear;     // 线性
+extern const joystick_mouse_curve_t joystick_mouse_curve_quadratic;  // 二次，小偏移精细、大偏移快速（指针默认）
+extern const joystick_mouse_curve_t joystick_mouse_curve_precision;  // 前半程保持低速，适合精确定位
+extern const joystick_mouse_curve_t joystick_mouse_curve_scroll;     // 滚轮默认
+
+// 鼠标输入报告，与usb_descriptors.h中的TUD_HID_REPORT_DESC_JOYSTICK_MOUSE对应
+typedef struct __attribute__((packed)) {
+    uint8_t buttons;            // 按键位图
+    int16_t x;                  // 水平位移，向右为正
+    int16_t y;                  // 垂直位移，向下为正
+    int8_t wheel;               // 垂直滚轮，向上为正
+    int8_t pan;                 // 水平滚轮，向右为正
+} joystick_mouse_report_t;
+
+/**
+ * @brief 切换摇杆鼠标模式，关闭时清除速度和未发送的按键
+ */
+void joystick_mouse_set_mode(joystick_mouse_mode_t mode);
+
+/**
+ * @brief 获取当前摇杆鼠标模式
+ */
+joystick_mouse_mode_t joystick_mouse_get_mode(void);
+
+/**
+ * @brief 设置指定模式使用的加速曲线
+ * @param curve 曲线，须在使用期间一直有效（通常为常量）
+ */
+void joystick_mouse_set_curve(joystick_mouse_mode_t mode, const joystick_mouse_curve_t *curve);
+
+/**
+ * @brief 由采样任务调用，根据两个轴的偏移量（千分比）更新目标速度
+ * @param up 向上为正
+ * @param right 向右为正
+ */
+void joystick_mouse_update_axes(int16_t up, int16_t right);
+
+/**
+ * @brief 点击鼠标按键，按下和松开分别在相邻两份报告中发送
+ */
+void joystick_mouse_click(uint8_t buttons);
+
+/**
+ * @brief 主机设置的滚轮分辨率倍数（功能报告），bit0~1为垂直滚轮，bit2~3为水平滚轮
+ */
+void joystick_mouse_set_resolution(uint8_t feature);
+
+/**
+ * @brief 获取滚轮分辨率倍数功能报告
+ */
+uint8_t joystick_mouse_get_resolution(void);
+
+/**
+ * @brief 是否有需要发送的鼠标报告
+ */
+bool joystick_mouse_is_active(void);
+
+/**
+ * @brief 由HID任务在发送前调用，生成下一份鼠标报告
+ * @return 没有需要发送的内容时返回false
+ */
+bool joystick_mouse_build_report(joystick_mouse_report_t *report);
+
+#endif
@@ -1,5 +1,12 @@
 #include "keyboard_led.h"
 #include "rgb_matrix_nvs.h"
+#include "rgb_effect_tables.h"
+#include "rgb_key_events.h"
+#include "lamp_array_buffer.h"
+#include "led_output.h"
+#include "ws2812_spi.h"
+#include "led_effect.h"
+#include "esp_timer.h"
 #include "nvs_manager/unified_nvs_manager.h"
 #include <inttypes.h>
 
@@ -22,11 +29,9 @@ led_config_t g_led_config =
     },
     {
         // LED Index to Physical Position
-        {0, 0}, {9, 0}, {27, 0}, {45, 0},        // 第一行
-        {0, 9}, {9, 9}, {27, 9}, {45, 13},        // 第二行
-        {0, 27}, {9, 27}, {27, 27},              // 第三行
-        {0, 45}, {9, 45}, {27, 45},              // 第四行
-        {13, 63}, {27, 63}, {45, 54}               // 第五行
+#define LED_POINT(x, y) {x, y},
+        KOB_LED_POINTS(LED_POINT)
+#undef LED_POINT
     },
     {
         // LED Index to Flag
@@ -165,129 +170,224 @@ esp_err_t kob_rgb_load_config(void)
 // Windows Lighting相关定义
 // 使用WS2812B_NUM常量代替定义MAX_LAMPS，避免宏定义冲突
 
-// 声明外部变量，用于访问Windows Lighting的颜色数据
-extern uint8_t lamp_colors[WS2812B_NUM][4];
+// 声明外部变量，用于访问Windows Lighting的自主模式标志
 extern bool autonomous_mode;
 
-// 用于保护共享资源的互斥锁，声明为全局变量以便tinyusb_hid.c访问
-SemaphoreHandle_t g_windows_lighting_mutex = NULL;
-
-// Windows Lighting模式的LED更新函数
-static void windows_lighting_update(void)
+// 后台缓冲区：每帧开始时送出上一帧渲染好的颜色，再渲染下一帧，渲染耗时不影响送出的时刻
+static uint8_t s_back_buffer[WS2812B_NUM][3];
+static bool s_back_buffer_ready = false;
+
+// 已送到后台缓冲区的Windows Lighting颜色代数，主机没有提交新的一帧时不重复渲染和刷新
+#define LAMP_GENERATION_NONE    UINT32_MAX
+static uint32_t s_lamp_generation = LAMP_GENERATION_NONE;
+
+// 帧调度
+static TaskHandle_t s_led_task_handle = NULL;
+static esp_timer_handle_t s_frame_timer = NULL;
+static uint32_t s_frame_period_us = 1000000 / KOB_LED_DEFAULT_FPS;
+static uint32_t s_requested_fps = KOB_LED_DEFAULT_FPS;     // 用户设置的帧率，降帧后切换灯效时恢复
+static led_frame_stats_t s_frame_stats;
+
+// 当前渲染的本地灯效，模式变化时在LED任务中切换
+#define ACTIVE_MODE_NONE    UINT16_MAX
+static uint16_t s_active_mode = ACTIVE_MODE_NONE;
+static const led_effect_t *s_active_effect = NULL;
+static uint8_t s_overrun_frames = 0;
+
+// 把后台缓冲区送到灯带
+static void present_back_buffer(void)
 {
-    if (!kob_ws2812_is_enable()) {
+    if (!s_back_buffer_ready || !s_led_strip) {
         return;
     }
-    
-    // 检查是否处于Windows Lighting模式且不在自主模式
-    if (g_led_effect_config.mode == RGB_MODE_WINDOWS_LIGHTING && !autonomous_mode) {
-        // 检查s_led_strip是否有效，避免空指针访问
-        if (!s_led_strip) {
-            ESP_LOGE(TAG, "s_led_strip is NULL in windows_lighting_update");
-            return;
-        }
-        
-        // 创建一个本地缓冲区，用于临时存储颜色数据，减少对共享资源的锁定时间
-        // 使用__attribute__((aligned(4)))确保4字节对齐，避免SPI传输时的内存问题
-        uint8_t local_colors[WS2812B_NUM][4] __attribute__((aligned(4)));
-        
-        // 获取互斥锁，保护共享资源访问
-        if (g_windows_lighting_mutex && xSemaphoreTake(g_windows_lighting_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            // 复制颜色数据到本地缓冲区
-            memcpy(local_colors, lamp_colors, sizeof(lamp_colors));
-            // 释放互斥锁
-            xSemaphoreGive(g_windows_lighting_mutex);
-        } else {
-            // 如果无法获取锁，跳过本轮更新
-            ESP_LOGW(TAG, "Failed to acquire mutex for Windows Lighting update");
-            return;
-        }
-        
-        // 使用本地缓冲区的数据更新LED，避免在操作LED时持有锁
-        for (uint8_t i = 0; i < WS2812B_NUM; i++) {
-            // 应用Windows Lighting的颜色设置
-            uint8_t red = local_colors[i][0];
-            uint8_t green = local_colors[i][1];
-            uint8_t blue = local_colors[i][2];
-            uint8_t intensity = local_colors[i][3];
-            
-            // 考虑亮度设置
-            red = (uint8_t)((red * intensity) / 255);
-            green = (uint8_t)((green * intensity) / 255);
-            blue = (uint8_t)((blue * intensity) / 255);
-            
-            // 设置LED颜色
-            led_strip_set_pixel(s_led_strip, i, red, green, blue);
-        }
-        
-        // 添加增强的错误处理和重试机制，防止SPI传输失败导致崩溃
-        esp_err_t err;
-        int retry_count = 0;
-        const int max_retries = 2;
-        
-        do {
-            err = led_strip_refresh(s_led_strip);
-            if (err == ESP_OK) {
-                break;  // 传输成功，退出循环
-            }
-            
-            ESP_LOGE(TAG, "Failed to refresh LED strip (attempt %d/%d): %s", 
-                     retry_count + 1, max_retries, esp_err_to_name(err));
-            
-            // 短暂延时后重试
-            if (retry_count < max_retries - 1) {
-                vTaskDelay(1 / portTICK_PERIOD_MS);
-            }
-        } while (++retry_count < max_retries);
-        
-        // 如果多次尝试后仍然失败，考虑重新初始化LED strip
+
+    for (uint8_t i = 0; i < WS2812B_NUM; i++) {
+        led_strip_set_pixel(s_led_strip, i, s_back_buffer[i][0], s_back_buffer[i][1], s_back_buffer[i][2]);
+    }
+
+    esp_err_t err = led_strip_refresh(s_led_strip);
+    if (err == ESP_OK) {
+        s_back_buffer_ready = false;
+        return;
+    }
+
+    // 刷新失败时保留这一帧，下一帧开始时再送出，不在这里重试或阻塞；
+    // 主机的静态帧不会重新渲染，清除标志会让这一帧永远送不出去
+    s_frame_stats.refresh_errors++;
+    if (err != ESP_ERR_TIMEOUT) {
+        // 上一帧仍在传输时返回ESP_ERR_TIMEOUT，属于正常情况，不打印
+        ESP_LOGE(TAG, "Failed to refresh LED strip: %s", esp_err_to_name(err));
+    }
+}
+
+// 查表灯效或rgb_matrix渲染一帧，查表灯效写入后台缓冲区时返回true
+static bool device_effect_update(const led_frame_ctx_t *ctx, uint8_t colors[][3]);
+
+// 切换到Windows Lighting时清除当前显示，为主机控制做准备
+static void windows_lighting_effect_init(void)
+{
+    s_lamp_generation = LAMP_GENERATION_NONE;
+
+    esp_err_t err = kob_ws2812_clear();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to clear WS2812: %s", esp_err_to_name(err));
+    }
+}
+
+// Windows Lighting模式的渲染函数，主机没有提交新的一帧时不写入
+static bool windows_lighting_render(const led_frame_ctx_t *ctx, uint8_t colors[][3])
+{
+    if (autonomous_mode) {
+        // 主机允许自主模式时使用设备自身的灯效，离开后需要重新送出主机的颜色
+        s_lamp_generation = LAMP_GENERATION_NONE;
+        return device_effect_update(ctx, colors);
+    }
+
+    // 无锁读取主机最近一次提交的完整颜色，USB任务正在发布时本帧不更新
+    uint8_t local_colors[WS2812B_NUM][LAMP_CHANNELS];
+    uint32_t generation;
+    if (!lamp_array_try_read(local_colors, &generation) || generation == s_lamp_generation) {
+        return false;
+    }
+    s_lamp_generation = generation;
+
+    for (uint8_t i = 0; i < WS2812B_NUM; i++) {
+        // 应用Windows Lighting的颜色设置，考虑亮度设置
+        uint8_t intensity = local_colors[i][3];
+        colors[i][0] = led_output_scale8(local_colors[i][0], intensity);
+        colors[i][1] = led_output_scale8(local_colors[i][1], intensity);
+        colors[i][2] = led_output_scale8(local_colors[i][2], intensity);
+    }
+    return true;
+}
+
+const led_effect_t led_effect_windows_lighting = {
+    .name = "Windows Lighting",
+    .init = windows_lighting_effect_init,
+    .render = windows_lighting_render,
+};
+
+_Static_assert(LED_EFFECT_ID_windows_lighting == 0, "Windows Lighting must keep mode RGB_MATRIX_EFFECT_MAX");
+
+static bool device_effect_update(const led_frame_ctx_t *ctx, uint8_t colors[][3])
+{
+    if (!rgb_effect_is_active()) {
+        // 其他模式调用标准的RGB矩阵任务，由rgb_matrix直接刷新灯带
+        rgb_matrix_task();
+        return false;
+    }
+
+    // 与位置相关的灯效使用预先算好的表渲染
+    rgb_effect_params_t params = {
+        .hue = ctx->hue,
+        .sat = ctx->sat,
+        .val = ctx->val,
+        .speed = ctx->speed,
+    };
+    rgb_effect_render(ctx->time_ms, &params, colors);
+    return true;
+}
+
+// 帧定时器回调，每个帧周期唤醒LED任务一次
+static void frame_timer_callback(void *arg)
+{
+    xTaskNotifyGive(s_led_task_handle);
+}
+
+// 修改帧周期并重启帧定时器
+static esp_err_t apply_frame_rate(uint32_t fps)
+{
+    s_frame_period_us = 1000000 / fps;
+    if (s_frame_timer) {
+        esp_timer_stop(s_frame_timer);
+        esp_err_t err = esp_timer_start_periodic(s_frame_timer, s_frame_period_us);
         if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Multiple failed attempts to refresh LED strip, reinitializing...");
-            // 尝试重新初始化，但不阻塞主循环
-            led_strip_handle_t temp_strip;
-            if (kob_ws2812b_init(&temp_strip) == ESP_OK) {
-                ESP_LOGI(TAG, "Successfully reinitialized LED strip");
-            }
+            ESP_LOGE(TAG, "Failed to restart frame timer: %s", esp_err_to_name(err));
+            return err;
         }
     }
+    return ESP_OK;
 }
 
-// 外部声明Windows Lighting初始化函数
-extern void windows_lighting_init(void);
+esp_err_t kob_led_set_frame_rate(uint32_t fps)
+{
+    if (fps < KOB_LED_MIN_FPS || fps > KOB_LED_MAX_FPS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_requested_fps = fps;
+    s_overrun_frames = 0;
+    esp_err_t err = apply_frame_rate(fps);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    ESP_LOGI(TAG, "LED frame rate set to %" PRIu32 " fps", fps);
+    return ESP_OK;
+}
 
-// 初始化Windows Lighting功能，包括创建互斥锁
-void kob_windows_lighting_init(void)
+// 检查灯效的渲染耗时，连续超出预算时帧率减半，直到满足预算或降到最低帧率
+// 查表灯效和rgb_matrix不在本地灯效注册表中，budget_pct传0使用默认预算
+static void check_effect_budget(const char *name, uint8_t budget_pct, uint32_t render_us)
 {
-    // 创建互斥锁，用于保护共享资源访问
-    if (!g_windows_lighting_mutex) {
-        g_windows_lighting_mutex = xSemaphoreCreateMutex();
-        if (!g_windows_lighting_mutex) {
-            ESP_LOGE(TAG, "Failed to create Windows Lighting mutex");
-        }
+    if (budget_pct == 0) {
+        budget_pct = LED_EFFECT_DEFAULT_BUDGET_PCT;
+    }
+    if ((uint64_t)render_us * 100 <= (uint64_t)s_frame_period_us * budget_pct) {
+        s_overrun_frames = 0;
+        return;
+    }
+    if (++s_overrun_frames < LED_EFFECT_OVERRUN_FRAMES) {
+        return;
+    }
+    s_overrun_frames = 0;
+
+    uint32_t fps = 1000000 / s_frame_period_us;
+    if (fps <= KOB_LED_MIN_FPS) {
+        return;
+    }
+    fps /= 2;
+    if (fps < KOB_LED_MIN_FPS) {
+        fps = KOB_LED_MIN_FPS;
+    }
+    if (apply_frame_rate(fps) == ESP_OK) {
+        s_frame_stats.downgrades++;
+        ESP_LOGW(TAG, "Effect %s took %" PRIu32 " us, frame rate lowered to %" PRIu32 " fps",
+                 name, render_us, fps);
+    }
+}
+
+// 在LED任务中切换到当前模式对应的灯效，切换时恢复用户设置的帧率
+static void switch_effect(uint16_t mode)
+{
+    s_active_mode = mode;
+    s_active_effect = led_effect_get(mode);
+    s_overrun_frames = 0;
+
+    if (s_frame_period_us != 1000000 / s_requested_fps) {
+        apply_frame_rate(s_requested_fps);
+    }
+    if (s_active_effect && s_active_effect->init) {
+        s_active_effect->init();
     }
 }
 
+void kob_led_get_frame_stats(led_frame_stats_t *stats)
+{
+    *stats = s_frame_stats;
+    stats->period_us = s_frame_period_us;
+}
+
 // 设置灯效模式
 esp_err_t kob_rgb_matrix_set_mode(uint16_t mode)
 {
-    // 检查是否为Windows Lighting模式
-    if (mode == RGB_MODE_WINDOWS_LIGHTING) {
+    const led_effect_t *effect = led_effect_get(mode);
+    if (effect) {
+        // 本地灯效由LED任务在下一帧切换
         g_led_effect_config.mode = mode;
-        ESP_LOGI(TAG, "RGB matrix mode set to Windows Lighting");
-        
-        // 初始化我们自己的Windows Lighting功能，包括互斥锁
-        kob_windows_lighting_init();
-        
-        // 清除当前LED显示，为Windows控制做准备
-        if (kob_ws2812_is_enable()) {
-            // 添加错误处理
-            esp_err_t err = kob_ws2812_clear();
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to clear WS2812: %s", esp_err_to_name(err));
-            }
-        }
+        ESP_LOGI(TAG, "RGB matrix mode set to %s", effect->name);
     } else {
-        // 对于其他模式，进行范围检查
+        // 对于rgb_matrix的模式，进行范围检查
         uint16_t max_mode = RGB_MATRIX_EFFECT_MAX - 1; // 假设MAX是包含上限的，所以减1
         if (mode < 1 || mode > max_mode) {
             ESP_LOGW(TAG, "Invalid mode index %d, using default: %d", mode, DEFAULT_RGB_MODE);
@@ -300,6 +400,9 @@ esp_err_t kob_rgb_matrix_set_mode(uint16_t mode)
         rgb_matrix_mode(mode);
     }
     
+    // 与位置相关的灯效改用查表渲染，切换模式时算好每个LED的参数
+    rgb_effect_select(g_led_effect_config.mode);
+    
     // 自动保存配置
     kob_rgb_save_config();
     
@@ -336,22 +439,12 @@ esp_err_t kob_rgb_matrix_set_speed(uint8_t speed)
     return ESP_OK;
 }
 
-// 下一个灯效模式
+// 下一个灯效模式，rgb_matrix的模式之后依次是本地灯效，最后一个之后回到第一个
 esp_err_t kob_rgb_matrix_next_mode(void)
 {
-    uint16_t next_mode;
-    uint16_t max_mode = RGB_MATRIX_EFFECT_MAX - 1;
-    
-    // 如果当前是Windows Lighting模式，切换到第一个标准模式
-    if (g_led_effect_config.mode == RGB_MODE_WINDOWS_LIGHTING) {
+    uint16_t next_mode = g_led_effect_config.mode + 1;
+    if (next_mode > LED_EFFECT_MODE_LAST) {
         next_mode = 1;
-    } else {
-        // 标准模式的递增逻辑
-        next_mode = g_led_effect_config.mode + 1;
-        if (next_mode > max_mode) {
-            // 如果已经是最后一个标准模式，切换到Windows Lighting模式
-            next_mode = RGB_MODE_WINDOWS_LIGHTING;
-        }
     }
     
     return kob_rgb_matrix_set_mode(next_mode);
@@ -360,19 +453,9 @@ esp_err_t kob_rgb_matrix_next_mode(void)
 // 上一个灯效模式
 esp_err_t kob_rgb_matrix_prev_mode(void)
 {
-    uint16_t prev_mode;
-    uint16_t max_mode = RGB_MATRIX_EFFECT_MAX - 1;
-    
-    // 如果当前是Windows Lighting模式，切换到最后一个标准模式
-    if (g_led_effect_config.mode == RGB_MODE_WINDOWS_LIGHTING) {
-        prev_mode = max_mode;
-    } else {
-        // 标准模式的递减逻辑
-        prev_mode = g_led_effect_config.mode - 1;
-        if (prev_mode < 1) {
-            // 如果已经是第一个标准模式，切换到Windows Lighting模式
-            prev_mode = RGB_MODE_WINDOWS_LIGHTING;
-        }
+    uint16_t prev_mode = g_led_effect_config.mode - 1;
+    if (g_led_effect_config.mode <= 1 || g_led_effect_config.mode > LED_EFFECT_MODE_LAST) {
+        prev_mode = LED_EFFECT_MODE_LAST;
     }
     
     return kob_rgb_matrix_set_mode(prev_mode);
@@ -452,11 +535,35 @@ esp_err_t kob_rgb_matrix_decrease_speed(void)
 extern void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed);
 void kob_rgb_process_key_event(uint8_t row, uint8_t col, bool pressed)
 {
-    // 调用RGB矩阵库的按键处理函数
-    process_rgb_matrix(row, col, pressed);
-    
-    // 这里可以添加额外的按键响应逻辑
-    // 例如特定按键组合可以切换灯效或修改参数
+    // 在扫描任务中调用，只写入环形缓冲区，由LED任务在下一帧开始时处理
+    rgb_key_event_push(row, col, pressed);
+}
+
+// 在每帧开始时处理扫描任务写入的按键事件
+static void drain_key_events(void)
+{
+    rgb_key_event_t event;
+
+    while (rgb_key_event_pop(&event)) {
+        // 调用RGB矩阵库的按键处理函数
+        process_rgb_matrix(event.row, event.col, event.pressed);
+
+        if (event.row >= CONFIG_MATRIX_ROWS || event.col >= CONFIG_MATRIX_COLS) {
+            continue;
+        }
+        uint8_t led = g_led_config.matrix_co[event.row][event.col];
+        if (led == NO_LED) {
+            continue;
+        }
+
+        // 按下时记录到命中表，供按键响应灯效使用
+        if (event.pressed) {
+            rgb_key_hits_record(led, event.time_ms);
+        }
+        if (s_active_effect && s_active_effect->on_key) {
+            s_active_effect->on_key(led, event.pressed, event.time_ms);
+        }
+    }
 }
 
 //函数定义
@@ -478,23 +585,20 @@ esp_err_t kob_ws2812b_init(led_strip_handle_t *led_strip)
     gpio_config(&io_conf);
 
     /* LED strip initialization with the GPIO and pixels number*/
-    led_strip_config_t strip_config = {
-        .strip_gpio_num = WS2812B_DATA_PIN, // The GPIO that connected to the LED strip's data line
-        .max_leds = WS2812B_NUM, // The number of LEDs in the strip,
-        .led_pixel_format = LED_PIXEL_FORMAT_GRB, // Pixel format of your LED strip
-        .led_model = LED_MODEL_WS2812, // LED strip model
-        .flags.invert_out = false, // whether to invert the output signal (useful when your hardware has a level inverter)
-    };
-
-    // LED strip backend configuration: SPI
-    led_strip_spi_config_t spi_config = {
-        .clk_src = SOC_MOD_CLK_XTAL, // different clock source can lead to different power consumption
-        .flags.with_dma = true,         // Using DMA can improve performance and help drive more LEDs
-        .spi_bus = SPI2_HOST,           // SPI bus ID
+    // 直接编码的SPI驱动：编码结果常驻DMA缓冲区，只重新编码变化的灯珠，刷新时不等待传输完成
+    ws2812_spi_config_t spi_config = {
+        .gpio_num = WS2812B_DATA_PIN,   // The GPIO that connected to the LED strip's data line
+        .led_count = WS2812B_NUM,       // The number of LEDs in the strip
+        .spi_host = SPI2_HOST,          // SPI bus ID
+        .clk_src = SPI_CLK_SRC_XTAL,    // different clock source can lead to different power consumption
     };
 
     // LED Strip object handle
-    ESP_ERROR_CHECK(led_strip_new_spi_device(&strip_config, &spi_config, &s_led_strip));
+    led_strip_handle_t hw_strip = NULL;
+    ESP_ERROR_CHECK(ws2812_spi_new(&spi_config, &hw_strip));
+
+    // 所有输出都经过LED输出层，统一做伽马校正和电流限制
+    ESP_ERROR_CHECK(led_output_new(hw_strip, WS2812B_NUM, &s_led_strip));
 
     if (led_strip) {
         *led_strip = s_led_strip;
@@ -571,8 +675,8 @@ esp_err_t kob_rgb_matrix_init(void)
         rgb_matrix_driver_init(s_led_strip, WS2812B_NUM);
         rgb_matrix_init();
         
-        // 初始化Windows Lighting的互斥锁
-        kob_windows_lighting_init();
+        // 按LED物理位置建立查表灯效使用的几何表
+        rgb_effect_tables_init(&g_led_config);
         
         // 添加错误处理
         esp_err_t err = led_strip_clear(s_led_strip);
@@ -612,9 +716,10 @@ static void app_led_task(void *arg)
     }
     
     // 应用加载的配置到RGB矩阵（不触发自动保存）
-    if (g_led_effect_config.mode == RGB_MODE_WINDOWS_LIGHTING) {
-        ESP_LOGI(TAG, "RGB matrix initialized in Windows Lighting mode");
-        // 在Windows Lighting模式下也需要设置HSV和速度值
+    const led_effect_t *effect = led_effect_get(g_led_effect_config.mode);
+    if (effect) {
+        ESP_LOGI(TAG, "RGB matrix initialized in %s mode", effect->name);
+        // 在本地灯效模式下也需要设置HSV和速度值
         rgb_matrix_sethsv_noeeprom(g_led_effect_config.hue, g_led_effect_config.sat, g_led_effect_config.val);
         rgb_matrix_set_speed_noeeprom(g_led_effect_config.speed);
     } else {
@@ -626,20 +731,98 @@ static void app_led_task(void *arg)
         // 设置速度
         rgb_matrix_set_speed_noeeprom(g_led_effect_config.speed);
     }
+    rgb_effect_select(g_led_effect_config.mode);
+    
+    // 帧定时器按绝对周期唤醒LED任务，帧周期不再包含渲染耗时和节拍误差
+    s_led_task_handle = xTaskGetCurrentTaskHandle();
+    const esp_timer_create_args_t timer_args = {
+        .callback = frame_timer_callback,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "led_frame",
+    };
+    err = esp_timer_create(&timer_args, &s_frame_timer);
+    if (err == ESP_OK) {
+        err = esp_timer_start_periodic(s_frame_timer, s_frame_period_us);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start frame timer: %s", esp_err_to_name(err));
+        if (s_frame_timer) {
+            esp_timer_delete(s_frame_timer);
+            s_frame_timer = NULL;
+        }
+    }
     
     while (1)
     {
+        uint32_t ticks = 1;
+        if (s_frame_timer) {
+            ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else {
+            // 定时器不可用时退回固定延时
+            vTaskDelay(pdMS_TO_TICKS(s_frame_period_us / 1000));
+        }
+        int64_t frame_start = esp_timer_get_time();
+        if (ticks > 1) {
+            // 上一帧处理超过一个周期，期间错过的帧不再补
+            s_frame_stats.missed += ticks - 1;
+        }
+
+        // 先在帧的起点送出上一帧渲染好的数据
+        if (kob_ws2812_is_enable()) {
+            present_back_buffer();
+        } else {
+            s_back_buffer_ready = false;
+        }
+
+        // LED关闭时同样取出按键事件，避免缓冲区被旧事件占满
+        drain_key_events();
+
         if (kob_ws2812_is_enable())
         {
-            if (g_led_effect_config.mode == RGB_MODE_WINDOWS_LIGHTING) {
-                // 在Windows Lighting模式下调用特定的更新函数
-                windows_lighting_update();
+            uint16_t mode = g_led_effect_config.mode;
+            if (mode != s_active_mode) {
+                switch_effect(mode);
+            }
+
+            led_frame_ctx_t ctx = {
+                // 按下一帧送出的时刻渲染
+                .time_ms = (uint32_t)((esp_timer_get_time() + s_frame_period_us) / 1000),
+                .period_us = s_frame_period_us,
+                .hue = g_led_effect_config.hue,
+                .sat = g_led_effect_config.sat,
+                .val = g_led_effect_config.val,
+                .speed = g_led_effect_config.speed,
+            };
+
+            // 本地灯效、查表灯效和rgb_matrix_task都计入渲染耗时，按同样的预算降帧
+            int64_t render_start = esp_timer_get_time();
+            bool rendered;
+            if (s_active_effect) {
+                rendered = s_active_effect->render(&ctx, s_back_buffer);
+            } else {
+                rendered = device_effect_update(&ctx, s_back_buffer);
+            }
+            uint32_t render_us = (uint32_t)(esp_timer_get_time() - render_start);
+            if (rendered) {
+                s_back_buffer_ready = true;
+            }
+            s_frame_stats.effect_us = render_us;
+            if (s_active_effect) {
+                check_effect_budget(s_active_effect->name, s_active_effect->cpu_budget_pct, render_us);
             } else {
-                // 其他模式下调用标准的RGB矩阵任务
-                rgb_matrix_task();
+                check_effect_budget(rgb_effect_is_active() ? "table effect" : "rgb_matrix", 0, render_us);
             }
+        } else {
+            // 重新开启时重新初始化灯效
+            s_active_mode = ACTIVE_MODE_NONE;
+        }
+
+        uint32_t frame_us = (uint32_t)(esp_timer_get_time() - frame_start);
+        s_frame_stats.frames++;
+        s_frame_stats.last_us = frame_us;
+        if (frame_us > s_frame_stats.max_us) {
+            s_frame_stats.max_us = frame_us;
         }
-        vTaskDelay(20 / portTICK_PERIOD_MS);
     }
     vTaskDelete(NULL);
 }
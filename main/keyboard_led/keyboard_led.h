@@ -20,6 +20,14 @@
 #define WS2812B_DATA_PIN    46
 #define WS2812B_NUM         17
 
+// LED物理位置（rgb_matrix坐标，按LED索引排列），g_led_config和Windows Lighting的灯属性都由此生成
+#define KOB_LED_POINTS(P)                                       \
+    P(0, 0)   P(9, 0)   P(27, 0)  P(45, 0)    /* 第一行 */    \
+    P(0, 9)   P(9, 9)   P(27, 9)  P(45, 13)   /* 第二行 */    \
+    P(0, 27)  P(9, 27)  P(27, 27)             /* 第三行 */    \
+    P(0, 45)  P(9, 45)  P(27, 45)             /* 第四行 */    \
+    P(13, 63) P(27, 63) P(45, 54)             /* 第五行 */
+
 // 使用软件控制灯珠亮度为0代替关闭电源
 #define KOB_WS2812_USE_SOFTWARE_POWER_OFF 1
 
@@ -30,7 +38,12 @@
 #define DEFAULT_RGB_VAL      128
 #define DEFAULT_RGB_SPEED    100
 
-// 添加Windows Lighting模式
+// 灯效帧率，由帧定时器按绝对周期驱动
+#define KOB_LED_DEFAULT_FPS  50
+#define KOB_LED_MIN_FPS      10
+#define KOB_LED_MAX_FPS      200
+
+// 添加Windows Lighting模式，是本地灯效注册表（led_effect.h）中的第一个灯效
 #define RGB_MODE_WINDOWS_LIGHTING  RGB_MATRIX_EFFECT_MAX  
 
 // LED灯效配置结构体
@@ -43,6 +56,18 @@ typedef struct {
     bool enabled;        // 是否启用
 } led_effect_config_t;
 
+// 帧统计信息
+typedef struct {
+    uint32_t frames;         // 已处理的帧数
+    uint32_t missed;         // 因上一帧处理超时而错过的帧数
+    uint32_t refresh_errors; // 刷新灯带失败的次数
+    uint32_t last_us;        // 最近一帧的处理耗时
+    uint32_t max_us;         // 最长的一帧处理耗时
+    uint32_t period_us;      // 当前帧周期
+    uint32_t effect_us;      // 最近一帧灯效（本地灯效、查表灯效或rgb_matrix）的渲染耗时
+    uint32_t downgrades;     // 灯效超出CPU预算而降低帧率的次数
+} led_frame_stats_t;
+
 //函数定义位置
 esp_err_t kob_ws2812b_init(led_strip_handle_t *led_strip);
 esp_err_t kob_ws2812_enable(bool enable);
@@ -58,6 +83,10 @@ esp_err_t kob_rgb_matrix_set_speed(uint8_t speed);
 esp_err_t kob_rgb_matrix_next_mode(void);
 esp_err_t kob_rgb_matrix_prev_mode(void);
 
+// 帧率控制函数
+esp_err_t kob_led_set_frame_rate(uint32_t fps);
+void kob_led_get_frame_stats(led_frame_stats_t *stats);
+
 // 配置管理函数
 esp_err_t kob_rgb_save_config(void);
 esp_err_t kob_rgb_load_config(void);
@@ -74,7 +103,7 @@ esp_err_t kob_rgb_matrix_decrease_val(void);
 esp_err_t kob_rgb_matrix_increase_speed(void);
 esp_err_t kob_rgb_matrix_decrease_speed(void);
 
-// 键盘响应处理函数
+// 键盘响应处理函数，在扫描任务中调用，只写入按键事件缓冲区，不会阻塞
 void kob_rgb_process_key_event(uint8_t row, uint8_t col, bool pressed);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "seqlock.h"
+#include "lamp_array_buffer.h"
+
+// 暂存区，只由USB任务访问
+static uint32_t s_staged[WS2812B_NUM];
+
+// 已发布的颜色，每个灯打包为一个32位字
+static _Atomic uint32_t s_published[WS2812B_NUM];
+static seqlock_t s_lock;
+
+static inline uint32_t pack_rgbi(const uint8_t rgbi[LAMP_CHANNELS])
+{
+    return (uint32_t)rgbi[0] | ((uint32_t)rgbi[1] << 8) | ((uint32_t)rgbi[2] << 16) | ((uint32_t)rgbi[3] << 24);
+}
+
+void lamp_array_stage(uint16_t lamp_id, const uint8_t rgbi[LAMP_CHANNELS])
+{
+    if (lamp_id >= WS2812B_NUM) {
+        return;
+    }
+    s_staged[lamp_id] = pack_rgbi(rgbi);
+}
+
+void lamp_array_commit(void)
+{
+    seqlock_publish(&s_lock, s_published, s_staged, WS2812B_NUM);
+}
+
+bool lamp_array_try_read(uint8_t colors[WS2812B_NUM][LAMP_CHANNELS], uint32_t *ret_generation)
+{
+    uint32_t words[WS2812B_NUM];
+
+    if (!seqlock_try_read(&s_lock, s_published, words, WS2812B_NUM, ret_generation)) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < WS2812B_NUM; i++) {
+        colors[i][0] = (uint8_t)words[i];
+        colors[i][1] = (uint8_t)(words[i] >> 8);
+        colors[i][2] = (uint8_t)(words[i] >> 16);
+        colors[i][3] = (uint8_t)(words[i] >> 24);
+    }
+    return true;
+}
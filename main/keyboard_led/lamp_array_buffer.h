@@ -0,0 +1,43 @@
+#ifndef _LAMP_ARRAY_BUFFER_H_
+#define _LAMP_ARRAY_BUFFER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard_led.h"
+
+/*
+ * Windows Lighting（HID LampArray）颜色缓冲区
+ * USB回调写、LED任务读，双方都不加锁：
+ *   1. USB任务把主机发来的颜色写入只有它访问的暂存区，收到带LAMP_UPDATE_COMPLETE标志的报告时一次性发布
+ *   2. 发布使用顺序锁（seqlock.h）：写入前后各递增一次序号，序号为奇数表示正在发布
+ *   3. LED任务读取前后序号一致时得到完整的一帧，写方从不等待读方，主机的更新不会被丢弃；
+ *      读方也不等待写方，写方正在发布时本帧不更新，下一帧再读
+ */
+
+// LampUpdateFlags中的LampUpdateComplete位
+#define LAMP_UPDATE_COMPLETE    0x01
+
+// 每个灯的颜色通道：红、绿、蓝、亮度
+#define LAMP_CHANNELS           4
+
+/**
+ * @brief 把一个灯的颜色写入暂存区，只能由USB任务调用
+ * @param lamp_id 灯ID，超出范围时忽略
+ * @param rgbi 红、绿、蓝、亮度
+ */
+void lamp_array_stage(uint16_t lamp_id, const uint8_t rgbi[LAMP_CHANNELS]);
+
+/**
+ * @brief 把暂存区发布给读方，只能由USB任务调用
+ */
+void lamp_array_commit(void);
+
+/**
+ * @brief 读取最近一次发布的颜色，不阻塞、不休眠，可在渲染回调中调用
+ * @param colors 输出每个灯的颜色
+ * @param ret_generation 返回发布的代数，每次发布加1，调用者可据此判断颜色是否变化
+ * @return 读到完整的一帧时返回true，写方正在发布时返回false
+ */
+bool lamp_array_try_read(uint8_t colors[WS2812B_NUM][LAMP_CHANNELS], uint32_t *ret_generation);
+
+#endif
@@ -0,0 +1,17 @@
+#include <stddef.h>
+#include "led_effect.h"
+
+// 按KOB_LED_EFFECTS的顺序生成注册表
+static const led_effect_t *const s_effects[LED_EFFECT_COUNT] = {
+#define LED_EFFECT_ENTRY(name)      &led_effect_##name,
+    KOB_LED_EFFECTS(LED_EFFECT_ENTRY)
+#undef LED_EFFECT_ENTRY
+};
+
+const led_effect_t *led_effect_get(uint16_t mode)
+{
+    if (mode < LED_EFFECT_MODE_FIRST || mode > LED_EFFECT_MODE_LAST) {
+        return NULL;
+    }
+    return s_effects[mode - LED_EFFECT_MODE_FIRST];
+}
@@ -0,0 +1,68 @@
+#ifndef _LED_EFFECT_H_
+#define _LED_EFFECT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rgb_matrix.h"
+
+/*
+ * 本地灯效注册表
+ * rgb_matrix自带的灯效之后依次排列本地实现的灯效，模式编号为RGB_MATRIX_EFFECT_MAX + 注册序号：
+ *   1. 灯效在KOB_LED_EFFECTS中登记一次即可参与模式切换，模式切换和LED任务不再按模式写分支
+ *   2. init在LED任务切换到该灯效时调用，render每帧调用，on_key在LED任务取出按键事件时调用
+ *   3. 每个灯效声明占帧周期的CPU预算，连续超出时LED任务降低帧率，避免挤占扫描任务
+ */
+
+// 帧上下文，每帧由LED任务填写
+typedef struct {
+    uint32_t time_ms;           // 本帧送出的时刻（毫秒）
+    uint32_t period_us;         // 当前帧周期
+    uint8_t hue;                // 用户设置的色相、饱和度、亮度和速度
+    uint8_t sat;
+    uint8_t val;
+    uint8_t speed;
+} led_frame_ctx_t;
+
+// 灯效描述
+typedef struct {
+    const char *name;
+    uint8_t cpu_budget_pct;     // 单帧渲染耗时占帧周期的上限（百分比），0使用默认值
+    void (*init)(void);         // 切换到该灯效时调用，可为NULL
+    bool (*render)(const led_frame_ctx_t *ctx, uint8_t colors[][3]);    // 写入新的一帧时返回true
+    void (*on_key)(uint8_t led, bool pressed, uint32_t time_ms);        // 可为NULL
+} led_effect_t;
+
+// 默认的CPU预算（百分比）
+#define LED_EFFECT_DEFAULT_BUDGET_PCT   25
+
+// 连续超出预算多少帧后降低帧率
+#define LED_EFFECT_OVERRUN_FRAMES       3
+
+// 已注册的本地灯效，顺序即模式顺序；Windows Lighting必须排在第一个，保持原有的模式编号
+#define KOB_LED_EFFECTS(E)      \
+    E(windows_lighting)         \
+    E(splash)                   \
+    E(spectrum)
+
+#define LED_EFFECT_DECLARE(name)    extern const led_effect_t led_effect_##name;
+KOB_LED_EFFECTS(LED_EFFECT_DECLARE)
+#undef LED_EFFECT_DECLARE
+
+enum {
+#define LED_EFFECT_ID(name)         LED_EFFECT_ID_##name,
+    KOB_LED_EFFECTS(LED_EFFECT_ID)
+#undef LED_EFFECT_ID
+    LED_EFFECT_COUNT
+};
+
+// 本地灯效的模式编号
+#define LED_EFFECT_MODE_FIRST       RGB_MATRIX_EFFECT_MAX
+#define LED_EFFECT_MODE_LAST        (RGB_MATRIX_EFFECT_MAX + LED_EFFECT_COUNT - 1)
+
+/**
+ * @brief 按模式编号查找本地灯效
+ * @return 该模式由本地灯效实现时返回灯效描述，否则返回NULL（由rgb_matrix渲染）
+ */
+const led_effect_t *led_effect_get(uint16_t mode);
+
+#endif
@@ -0,0 +1,60 @@
+#include <sys/param.h>
+#include "led_effect.h"
+#include "led_output.h"
+#include "rgb_effect_tables.h"
+#include "audio_spectrum.h"
+
+/*
+ * 音乐频谱灯效：从左到右为低频到高频，每列按频段能量从下往上点亮，色相随频段变化
+ * 没有播放时显示用户设置颜色的低亮度底色
+ */
+
+// 每个LED对应的频段和点亮门限，切换到该灯效时按LED位置计算
+static uint8_t s_band[RGB_EFFECT_LED_COUNT];
+static uint8_t s_threshold[RGB_EFFECT_LED_COUNT];
+
+static void spectrum_init(void)
+{
+    const rgb_effect_geometry_t *geo = rgb_effect_get_geometry();
+    int min_x = INT8_MAX, max_x = INT8_MIN, min_y = INT8_MAX, max_y = INT8_MIN;
+
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        min_x = MIN(min_x, geo->dx[i]);
+        max_x = MAX(max_x, geo->dx[i]);
+        min_y = MIN(min_y, geo->dy[i]);
+        max_y = MAX(max_y, geo->dy[i]);
+    }
+
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        // 横向位置决定频段，最下面一行门限为0
+        s_band[i] = (geo->dx[i] - min_x) * AUDIO_SPECTRUM_BANDS / (max_x - min_x + 1);
+        s_threshold[i] = (max_y - geo->dy[i]) * 256 / (max_y - min_y + 1);
+    }
+}
+
+static bool spectrum_render(const led_frame_ctx_t *ctx, uint8_t colors[][3])
+{
+    // 保留上一帧的结果，分析任务正在发布时沿用
+    static audio_spectrum_t spectrum;
+    bool playing = audio_spectrum_read(&spectrum);
+
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        uint8_t band = s_band[i];
+        uint8_t level = spectrum.bands[band];
+        uint8_t val = ctx->val >> 4;
+
+        if (playing && level > s_threshold[i]) {
+            // 超过门限的部分在四分之一格内渐亮，条形顶端不会突然跳变
+            uint32_t over = (uint32_t)(level - s_threshold[i]) * 4;
+            val = led_output_scale8(ctx->val, over > 255 ? 255 : (uint8_t)over);
+        }
+        rgb_effect_hsv_to_rgb(ctx->hue + band * (256 / AUDIO_SPECTRUM_BANDS), ctx->sat, val, colors[i]);
+    }
+    return true;
+}
+
+const led_effect_t led_effect_spectrum = {
+    .name = "Spectrum",
+    .init = spectrum_init,
+    .render = spectrum_render,
+};
@@ -0,0 +1,93 @@
+#include <math.h>
+#include <stdlib.h>
+#include "led_effect.h"
+#include "led_output.h"
+#include "rgb_effect_tables.h"
+#include "rgb_key_events.h"
+
+/*
+ * 按键水波灯效：按下的按键常亮，每次按下从该按键向外扩散一圈光环
+ * 底色为用户设置颜色的四分之一亮度
+ */
+
+// 光环的宽度（坐标单位）和持续时间
+#define SPLASH_RING_WIDTH   12
+#define SPLASH_LIFE_MS      1000
+
+_Static_assert(RGB_EFFECT_LED_COUNT <= 32, "held mask holds at most 32 LEDs");
+
+// LED两两之间的距离，切换到该灯效时计算
+static uint8_t s_distance[RGB_EFFECT_LED_COUNT][RGB_EFFECT_LED_COUNT];
+
+// 正在按下的按键对应的LED
+static uint32_t s_held;
+
+static void splash_init(void)
+{
+    const rgb_effect_geometry_t *geo = rgb_effect_get_geometry();
+
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        for (int j = 0; j < RGB_EFFECT_LED_COUNT; j++) {
+            float dx = geo->dx[i] - geo->dx[j];
+            float dy = geo->dy[i] - geo->dy[j];
+            float d = sqrtf(dx * dx + dy * dy) + 0.5f;
+            s_distance[i][j] = d > UINT8_MAX ? UINT8_MAX : (uint8_t)d;
+        }
+    }
+    s_held = 0;
+}
+
+static bool splash_render(const led_frame_ctx_t *ctx, uint8_t colors[][3])
+{
+    const rgb_key_hits_t *hits = rgb_key_hits_get();
+    // 速度为0时光环也会缓慢扩散
+    uint32_t speed = ctx->speed + 32;
+
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        uint8_t hue = ctx->hue;
+        uint8_t val = ctx->val >> 2;
+
+        if (s_held & (1u << i)) {
+            hue += 128;
+            val = ctx->val;
+        } else {
+            for (uint8_t h = 0; h < hits->count; h++) {
+                uint32_t elapsed = ctx->time_ms - hits->time_ms[h];
+                if (elapsed >= SPLASH_LIFE_MS) {
+                    continue;
+                }
+                int radius = (int)((elapsed * speed) >> 10);
+                int offset = abs((int)s_distance[hits->led[h]][i] - radius);
+                if (offset >= SPLASH_RING_WIDTH) {
+                    continue;
+                }
+                // 离光环中线越远越暗，时间越久越暗
+                uint8_t ring = 255 - offset * 255 / SPLASH_RING_WIDTH;
+                uint8_t fade = 255 - elapsed * 255 / SPLASH_LIFE_MS;
+                uint8_t ring_val = led_output_scale8(led_output_scale8(ctx->val, ring), fade);
+                if (ring_val > val) {
+                    val = ring_val;
+                    hue = ctx->hue + (uint8_t)(elapsed >> 3);
+                }
+            }
+        }
+        rgb_effect_hsv_to_rgb(hue, ctx->sat, val, colors[i]);
+    }
+    return true;
+}
+
+static void splash_on_key(uint8_t led, bool pressed, uint32_t time_ms)
+{
+    if (pressed) {
+        s_held |= 1u << led;
+    } else {
+        s_held &= ~(1u << led);
+    }
+}
+
+const led_effect_t led_effect_splash = {
+    .name = "Splash",
+    .init = splash_init,
+    .render = splash_render,
+    .on_key = splash_on_key,
+};
@@ -0,0 +1,195 @@
+#include <string.h>
+#include "esp_log.h"
+#include "led_strip_interface.h"
+#include "keyboard_led.h"
+#include "led_output.h"
+
+static const char *TAG = "led_output";
+
+// 伽马校正表（gamma = 2.2）
+static const uint8_t gamma_table[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+
+// 虚拟灯带
+typedef struct {
+    led_strip_t base;                   // led_strip接口，必须是第一个成员
+    led_strip_handle_t hw_strip;        // 实际的灯带
+    uint32_t led_count;
+    uint8_t frame[WS2812B_NUM][3];      // 后处理之前的颜色
+    uint8_t sent[WS2812B_NUM][3];       // 上一次成功送到灯带的颜色
+    bool sent_valid;                    // sent是否与灯带上的实际颜色一致
+} led_output_t;
+
+static led_output_t s_output;
+static bool s_gamma_enabled = true;
+static uint16_t s_budget_ma = LED_OUTPUT_DEFAULT_BUDGET_MA;
+static led_output_stats_t s_stats;
+
+/**
+ * @brief 按电流预算计算整帧缩放系数
+ * @param channel_sum 伽马校正后所有通道之和
+ */
+static uint8_t current_limit_scale(uint32_t channel_sum, uint32_t led_count)
+{
+    uint32_t idle_ma = led_count * LED_OUTPUT_IDLE_MA;
+    uint32_t budget = s_budget_ma;
+
+    if (budget == 0) {
+        return 255;
+    }
+    if (budget <= idle_ma) {
+        return 0;
+    }
+
+    // 估算电流 = 静态电流 + 通道和 * 单通道电流 / 255，两边都乘255避免除法
+    uint32_t lit_budget = (budget - idle_ma) * 255;
+    uint32_t lit = channel_sum * LED_OUTPUT_CHANNEL_MA;
+    if (lit <= lit_budget) {
+        return 255;
+    }
+    return (uint8_t)(lit_budget * 255 / lit);
+}
+
+static esp_err_t output_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_output_t *output = (led_output_t *)strip;
+    if (index >= output->led_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    output->frame[index][0] = (uint8_t)red;
+    output->frame[index][1] = (uint8_t)green;
+    output->frame[index][2] = (uint8_t)blue;
+    return ESP_OK;
+}
+
+static esp_err_t output_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    // WS2812没有白色通道
+    return output_set_pixel(strip, index, red, green, blue);
+}
+
+static esp_err_t output_refresh(led_strip_t *strip)
+{
+    led_output_t *output = (led_output_t *)strip;
+    uint8_t out[WS2812B_NUM][3];
+    uint32_t channel_sum = 0;
+
+    // 伽马校正
+    for (uint32_t i = 0; i < output->led_count; i++) {
+        for (int ch = 0; ch < 3; ch++) {
+            uint8_t value = output->frame[i][ch];
+            out[i][ch] = s_gamma_enabled ? gamma_table[value] : value;
+            channel_sum += out[i][ch];
+        }
+    }
+
+    // 电流限制：整帧等比例缩小，保持颜色不变
+    uint8_t scale = current_limit_scale(channel_sum, output->led_count);
+    if (scale != 255) {
+        channel_sum = 0;
+        for (uint32_t i = 0; i < output->led_count; i++) {
+            for (int ch = 0; ch < 3; ch++) {
+                out[i][ch] = led_output_scale8(out[i][ch], scale);
+                channel_sum += out[i][ch];
+            }
+        }
+        s_stats.limited++;
+    }
+
+    s_stats.last_scale = scale;
+    s_stats.last_ma = (uint16_t)(output->led_count * LED_OUTPUT_IDLE_MA + channel_sum * LED_OUTPUT_CHANNEL_MA / 255);
+
+    // 与灯带上的颜色相同时不必再传输
+    size_t size = output->led_count * sizeof(out[0]);
+    if (output->sent_valid && memcmp(out, output->sent, size) == 0) {
+        s_stats.skipped++;
+        return ESP_OK;
+    }
+
+    for (uint32_t i = 0; i < output->led_count; i++) {
+        led_strip_set_pixel(output->hw_strip, i, out[i][0], out[i][1], out[i][2]);
+    }
+
+    esp_err_t err = led_strip_refresh(output->hw_strip);
+    if (err == ESP_OK) {
+        memcpy(output->sent, out, size);
+        s_stats.frames++;
+    }
+    // 刷新失败时灯带状态未知，下一帧无论是否变化都重新传输
+    output->sent_valid = (err == ESP_OK);
+    return err;
+}
+
+static esp_err_t output_clear(led_strip_t *strip)
+{
+    led_output_t *output = (led_output_t *)strip;
+    memset(output->frame, 0, sizeof(output->frame));
+    memset(output->sent, 0, sizeof(output->sent));
+
+    esp_err_t err = led_strip_clear(output->hw_strip);
+    output->sent_valid = (err == ESP_OK);
+    return err;
+}
+
+static esp_err_t output_del(led_strip_t *strip)
+{
+    led_output_t *output = (led_output_t *)strip;
+    esp_err_t err = led_strip_del(output->hw_strip);
+    output->hw_strip = NULL;
+    return err;
+}
+
+esp_err_t led_output_new(led_strip_handle_t hw_strip, uint32_t led_count, led_strip_handle_t *ret_strip)
+{
+    if (hw_strip == NULL || ret_strip == NULL || led_count == 0 || led_count > WS2812B_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_output.hw_strip != NULL) {
+        ESP_LOGE(TAG, "LED output already created");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memset(&s_output, 0, sizeof(s_output));
+    s_output.base.set_pixel = output_set_pixel;
+    s_output.base.set_pixel_rgbw = output_set_pixel_rgbw;
+    s_output.base.refresh = output_refresh;
+    s_output.base.clear = output_clear;
+    s_output.base.del = output_del;
+    s_output.hw_strip = hw_strip;
+    s_output.led_count = led_count;
+
+    *ret_strip = &s_output.base;
+    return ESP_OK;
+}
+
+void led_output_set_gamma(bool enable)
+{
+    s_gamma_enabled = enable;
+}
+
+void led_output_set_current_budget(uint16_t budget_ma)
+{
+    s_budget_ma = budget_ma;
+    ESP_LOGI(TAG, "LED current budget set to %u mA", budget_ma);
+}
+
+void led_output_get_stats(led_output_stats_t *stats)
+{
+    *stats = s_stats;
+}
@@ -0,0 +1,66 @@
+#ifndef _LED_OUTPUT_H_
+#define _LED_OUTPUT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "led_strip.h"
+
+/*
+ * LED输出层
+ * 在灯带驱动前面包一层与led_strip接口相同的虚拟灯带，rgb_matrix、查表灯效和Windows Lighting都经过它输出：
+ *   1. set_pixel只把颜色写入帧缓冲区，refresh时统一做后处理再送到灯带
+ *   2. 后处理依次为伽马校正和电流限制：按整帧各通道之和估算电流，超出预算时整帧等比例缩小
+ *   3. 缩放统一使用带舍入的8位乘法，不做除法
+ *   4. 后处理的结果与上一次送出的完全相同时跳过刷新，静态灯效不再占用SPI传输
+ */
+
+// 电流估算参数：单个通道满亮度时的电流和每颗灯珠的静态电流（毫安）
+#define LED_OUTPUT_CHANNEL_MA       20
+#define LED_OUTPUT_IDLE_MA          1
+
+// 默认的灯带电流预算（毫安），USB供电时需给其他电路留出余量
+#define LED_OUTPUT_DEFAULT_BUDGET_MA    400
+
+// 输出统计信息
+typedef struct {
+    uint32_t frames;            // 送到灯带的帧数
+    uint32_t skipped;           // 与上一帧相同而跳过刷新的帧数
+    uint32_t limited;           // 被电流限制缩小的帧数
+    uint16_t last_ma;           // 最近一帧限制后的估算电流
+    uint8_t last_scale;         // 最近一帧的整体缩放系数，255表示未缩小
+} led_output_stats_t;
+
+/**
+ * @brief 8位缩放：value * scale / 255，四舍五入，scale为255时保持不变
+ */
+static inline uint8_t led_output_scale8(uint8_t value, uint8_t scale)
+{
+    uint16_t product = (uint16_t)value * scale + 128;
+    return (uint8_t)((product + (product >> 8)) >> 8);
+}
+
+/**
+ * @brief 在实际的灯带外面创建虚拟灯带
+ * @param hw_strip 实际的灯带
+ * @param led_count 灯珠数量，不超过WS2812B_NUM
+ * @param ret_strip 返回虚拟灯带，可以像普通led_strip一样使用
+ */
+esp_err_t led_output_new(led_strip_handle_t hw_strip, uint32_t led_count, led_strip_handle_t *ret_strip);
+
+/**
+ * @brief 开启或关闭伽马校正，默认开启
+ */
+void led_output_set_gamma(bool enable);
+
+/**
+ * @brief 设置电流预算，0表示不限制
+ */
+void led_output_set_current_budget(uint16_t budget_ma);
+
+/**
+ * @brief 获取输出统计信息
+ */
+void led_output_get_stats(led_output_stats_t *stats);
+
+#endif
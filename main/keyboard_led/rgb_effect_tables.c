@@ -0,0 +1,304 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rgb_effect_tables.h"
+#include "led_output.h"
+
+#define MATRIX_ROW_COUNT    CONFIG_MATRIX_ROWS
+#define MATRIX_COL_COUNT    CONFIG_MATRIX_COLS
+
+// 色相表：饱和度和亮度均为255时各色相的RGB值，六个扇区线性插值
+static const uint8_t hue_table[256][3] = {
+    {255,   0,   0}, {255,   6,   0}, {255,  12,   0}, {255,  18,   0}, {255,  24,   0}, {255,  30,   0}, {255,  36,   0}, {255,  42,   0},
+    {255,  48,   0}, {255,  54,   0}, {255,  60,   0}, {255,  66,   0}, {255,  72,   0}, {255,  78,   0}, {255,  84,   0}, {255,  90,   0},
+    {255,  96,   0}, {255, 102,   0}, {255, 108,   0}, {255, 114,   0}, {255, 120,   0}, {255, 126,   0}, {255, 132,   0}, {255, 138,   0},
+    {255, 144,   0}, {255, 150,   0}, {255, 156,   0}, {255, 162,   0}, {255, 168,   0}, {255, 174,   0}, {255, 180,   0}, {255, 186,   0},
+    {255, 192,   0}, {255, 198,   0}, {255, 204,   0}, {255, 210,   0}, {255, 216,   0}, {255, 222,   0}, {255, 228,   0}, {255, 234,   0},
+    {255, 240,   0}, {255, 246,   0}, {255, 252,   0}, {253, 255,   0}, {247, 255,   0}, {241, 255,   0}, {235, 255,   0}, {229, 255,   0},
+    {223, 255,   0}, {217, 255,   0}, {211, 255,   0}, {205, 255,   0}, {199, 255,   0}, {193, 255,   0}, {187, 255,   0}, {181, 255,   0},
+    {175, 255,   0}, {169, 255,   0}, {163, 255,   0}, {157, 255,   0}, {151, 255,   0}, {145, 255,   0}, {139, 255,   0}, {133, 255,   0},
+    {127, 255,   0}, {121, 255,   0}, {115, 255,   0}, {109, 255,   0}, {103, 255,   0}, { 97, 255,   0}, { 91, 255,   0}, { 85, 255,   0},
+    { 79, 255,   0}, { 73, 255,   0}, { 67, 255,   0}, { 61, 255,   0}, { 55, 255,   0}, { 49, 255,   0}, { 43, 255,   0}, { 37, 255,   0},
+    { 31, 255,   0}, { 25, 255,   0}, { 19, 255,   0}, { 13, 255,   0}, {  7, 255,   0}, {  1, 255,   0}, {  0, 255,   4}, {  0, 255,  10},
+    {  0, 255,  16}, {  0, 255,  22}, {  0, 255,  28}, {  0, 255,  34}, {  0, 255,  40}, {  0, 255,  46}, {  0, 255,  52}, {  0, 255,  58},
+    {  0, 255,  64}, {  0, 255,  70}, {  0, 255,  76}, {  0, 255,  82}, {  0, 255,  88}, {  0, 255,  94}, {  0, 255, 100}, {  0, 255, 106},
+    {  0, 255, 112}, {  0, 255, 118}, {  0, 255, 124}, {  0, 255, 130}, {  0, 255, 136}, {  0, 255, 142}, {  0, 255, 148}, {  0, 255, 154},
+    {  0, 255, 160}, {  0, 255, 166}, {  0, 255, 172}, {  0, 255, 178}, {  0, 255, 184}, {  0, 255, 190}, {  0, 255, 196}, {  0, 255, 202},
+    {  0, 255, 208}, {  0, 255, 214}, {  0, 255, 220}, {  0, 255, 226}, {  0, 255, 232}, {  0, 255, 238}, {  0, 255, 244}, {  0, 255, 250},
+    {  0, 255, 255}, {  0, 249, 255}, {  0, 243, 255}, {  0, 237, 255}, {  0, 231, 255}, {  0, 225, 255}, {  0, 219, 255}, {  0, 213, 255},
+    {  0, 207, 255}, {  0, 201, 255}, {  0, 195, 255}, {  0, 189, 255}, {  0, 183, 255}, {  0, 177, 255}, {  0, 171, 255}, {  0, 165, 255},
+    {  0, 159, 255}, {  0, 153, 255}, {  0, 147, 255}, {  0, 141, 255}, {  0, 135, 255}, {  0, 129, 255}, {  0, 123, 255}, {  0, 117, 255},
+    {  0, 111, 255}, {  0, 105, 255}, {  0,  99, 255}, {  0,  93, 255}, {  0,  87, 255}, {  0,  81, 255}, {  0,  75, 255}, {  0,  69, 255},
+    {  0,  63, 255}, {  0,  57, 255}, {  0,  51, 255}, {  0,  45, 255}, {  0,  39, 255}, {  0,  33, 255}, {  0,  27, 255}, {  0,  21, 255},
+    {  0,  15, 255}, {  0,   9, 255}, {  0,   3, 255}, {  2,   0, 255}, {  8,   0, 255}, { 14,   0, 255}, { 20,   0, 255}, { 26,   0, 255},
+    { 32,   0, 255}, { 38,   0, 255}, { 44,   0, 255}, { 50,   0, 255}, { 56,   0, 255}, { 62,   0, 255}, { 68,   0, 255}, { 74,   0, 255},
+    { 80,   0, 255}, { 86,   0, 255}, { 92,   0, 255}, { 98,   0, 255}, {104,   0, 255}, {110,   0, 255}, {116,   0, 255}, {122,   0, 255},
+    {128,   0, 255}, {134,   0, 255}, {140,   0, 255}, {146,   0, 255}, {152,   0, 255}, {158,   0, 255}, {164,   0, 255}, {170,   0, 255},
+    {176,   0, 255}, {182,   0, 255}, {188,   0, 255}, {194,   0, 255}, {200,   0, 255}, {206,   0, 255}, {212,   0, 255}, {218,   0, 255},
+    {224,   0, 255}, {230,   0, 255}, {236,   0, 255}, {242,   0, 255}, {248,   0, 255}, {254,   0, 255}, {255,   0, 251}, {255,   0, 245},
+    {255,   0, 239}, {255,   0, 233}, {255,   0, 227}, {255,   0, 221}, {255,   0, 215}, {255,   0, 209}, {255,   0, 203}, {255,   0, 197},
+    {255,   0, 191}, {255,   0, 185}, {255,   0, 179}, {255,   0, 173}, {255,   0, 167}, {255,   0, 161}, {255,   0, 155}, {255,   0, 149},
+    {255,   0, 143}, {255,   0, 137}, {255,   0, 131}, {255,   0, 125}, {255,   0, 119}, {255,   0, 113}, {255,   0, 107}, {255,   0, 101},
+    {255,   0,  95}, {255,   0,  89}, {255,   0,  83}, {255,   0,  77}, {255,   0,  71}, {255,   0,  65}, {255,   0,  59}, {255,   0,  53},
+    {255,   0,  47}, {255,   0,  41}, {255,   0,  35}, {255,   0,  29}, {255,   0,  23}, {255,   0,  17}, {255,   0,  11}, {255,   0,   5}
+};
+
+// 正弦表：一圈为256，幅度为127
+static const int8_t sin_table[256] = {
+      0,   3,   6,   9,  12,  16,  19,  22,  25,  28,  31,  34,  37,  40,  43,  46,
+     49,  51,  54,  57,  60,  63,  65,  68,  71,  73,  76,  78,  81,  83,  85,  88,
+     90,  92,  94,  96,  98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116,
+    117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127,
+    127, 127, 127, 127, 126, 126, 126, 125, 125, 124, 123, 122, 122, 121, 120, 118,
+    117, 116, 115, 113, 112, 111, 109, 107, 106, 104, 102, 100,  98,  96,  94,  92,
+     90,  88,  85,  83,  81,  78,  76,  73,  71,  68,  65,  63,  60,  57,  54,  51,
+     49,  46,  43,  40,  37,  34,  31,  28,  25,  22,  19,  16,  12,   9,   6,   3,
+      0,  -3,  -6,  -9, -12, -16, -19, -22, -25, -28, -31, -34, -37, -40, -43, -46,
+    -49, -51, -54, -57, -60, -63, -65, -68, -71, -73, -76, -78, -81, -83, -85, -88,
+    -90, -92, -94, -96, -98, -100, -102, -104, -106, -107, -109, -111, -112, -113, -115, -116,
+    -117, -118, -120, -121, -122, -122, -123, -124, -125, -125, -126, -126, -126, -127, -127, -127,
+    -127, -127, -127, -127, -126, -126, -126, -125, -125, -124, -123, -122, -122, -121, -120, -118,
+    -117, -116, -115, -113, -112, -111, -109, -107, -106, -104, -102, -100, -98, -96, -94, -92,
+    -90, -88, -85, -83, -81, -78, -76, -73, -71, -68, -65, -63, -60, -57, -54, -51,
+    -49, -46, -43, -40, -37, -34, -31, -28, -25, -22, -19, -16, -12,  -9,  -6,  -3
+};
+
+// 查表灯效的每LED参数，色相 = 基础色相 + phase + 时间 + (cos_gain * cos + sin_gain * sin) / 128
+typedef struct {
+    int16_t phase[RGB_EFFECT_LED_COUNT];        // 固定的色相偏移
+    int16_t cos_gain[RGB_EFFECT_LED_COUNT];     // 旋转分量的系数，旋转角度随时间变化
+    int16_t sin_gain[RGB_EFFECT_LED_COUNT];
+    bool use_base_hue;                          // 是否叠加用户设置的色相
+    bool rotating;                              // 是否有旋转分量
+    int8_t time_sign;                           // 色相随时间增加(1)、减少(-1)或不变(0)
+} rgb_effect_table_t;
+
+static rgb_effect_geometry_t s_geometry;
+static rgb_effect_table_t s_table;
+static bool s_active = false;
+
+void rgb_effect_hsv_to_rgb(uint8_t hue, uint8_t sat, uint8_t val, uint8_t rgb[3])
+{
+    const uint8_t *full = hue_table[hue];
+
+    // 饱和度把颜色向白色拉近，亮度整体缩放，伽马校正由LED输出层统一完成
+    for (int ch = 0; ch < 3; ch++) {
+        uint8_t desaturated = 255 - led_output_scale8(255 - full[ch], sat);
+        rgb[ch] = led_output_scale8(desaturated, val);
+    }
+}
+
+void rgb_effect_tables_init(const led_config_t *config)
+{
+    rgb_effect_geometry_t *geo = &s_geometry;
+    uint8_t min_x = UINT8_MAX, max_x = 0, min_y = UINT8_MAX, max_y = 0;
+
+    memset(geo, 0, sizeof(*geo));
+
+    // 以所有LED的外接矩形中心为灯效中心
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        uint8_t x = config->point[i].x;
+        uint8_t y = config->point[i].y;
+        if (x < min_x) min_x = x;
+        if (x > max_x) max_x = x;
+        if (y < min_y) min_y = y;
+        if (y > max_y) max_y = y;
+    }
+    geo->center_x = (min_x + max_x) / 2;
+    geo->center_y = (min_y + max_y) / 2;
+
+    // 相对中心的偏移、距离和角度
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        int dx = config->point[i].x - geo->center_x;
+        int dy = config->point[i].y - geo->center_y;
+        geo->dx[i] = (int8_t)dx;
+        geo->dy[i] = (int8_t)dy;
+        geo->distance[i] = (uint8_t)lroundf(sqrtf((float)(dx * dx + dy * dy)));
+        geo->angle[i] = (uint8_t)(int)lroundf(atan2f((float)dy, (float)dx) * 128.0f / (float)M_PI);
+        geo->row[i] = UINT8_MAX;
+        geo->col[i] = UINT8_MAX;
+    }
+
+    // 按键矩阵反查每个LED所在的行列
+    for (int row = 0; row < MATRIX_ROW_COUNT; row++) {
+        for (int col = 0; col < MATRIX_COL_COUNT; col++) {
+            uint8_t led = config->matrix_co[row][col];
+            if (led < RGB_EFFECT_LED_COUNT) {
+                geo->row[led] = row;
+                geo->col[led] = col;
+            }
+        }
+    }
+
+    // 每个LED最近的几个LED，插入排序保持从近到远
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        uint8_t count = 0;
+        for (int j = 0; j < RGB_EFFECT_LED_COUNT; j++) {
+            if (j == i) {
+                continue;
+            }
+            int dx = config->point[j].x - config->point[i].x;
+            int dy = config->point[j].y - config->point[i].y;
+            uint8_t distance = (uint8_t)lroundf(sqrtf((float)(dx * dx + dy * dy)));
+
+            int pos = count;
+            if (count < RGB_EFFECT_MAX_NEIGHBORS) {
+                count++;
+            } else if (distance >= geo->neighbors[i][RGB_EFFECT_MAX_NEIGHBORS - 1].distance) {
+                continue;
+            } else {
+                pos = RGB_EFFECT_MAX_NEIGHBORS - 1;
+            }
+            while (pos > 0 && geo->neighbors[i][pos - 1].distance > distance) {
+                geo->neighbors[i][pos] = geo->neighbors[i][pos - 1];
+                pos--;
+            }
+            geo->neighbors[i][pos].index = (uint8_t)j;
+            geo->neighbors[i][pos].distance = distance;
+        }
+        geo->neighbor_count[i] = count;
+    }
+}
+
+const rgb_effect_geometry_t *rgb_effect_get_geometry(void)
+{
+    return &s_geometry;
+}
+
+bool rgb_effect_select(uint16_t mode)
+{
+    const rgb_effect_geometry_t *geo = &s_geometry;
+    rgb_effect_table_t *table = &s_table;
+    int half_width = 0;
+
+    memset(table, 0, sizeof(*table));
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        if (abs(geo->dx[i]) > half_width) {
+            half_width = abs(geo->dx[i]);
+        }
+    }
+
+    // 各灯效的色相公式与rgb_matrix库中的同名灯效一致，坐标相关的部分在这里一次算好
+    switch (mode) {
+#ifdef CONFIG_ENABLE_RGB_MATRIX_RAINBOW_BEACON
+    case RGB_MATRIX_RAINBOW_BEACON:
+        // 彩虹以中心为轴旋转
+        table->use_base_hue = true;
+        table->rotating = true;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            table->cos_gain[i] = 2 * geo->dy[i];
+            table->sin_gain[i] = 2 * geo->dx[i];
+        }
+        break;
+#endif
+#ifdef CONFIG_ENABLE_RGB_MATRIX_RAINBOW_PINWHEELS
+    case RGB_MATRIX_RAINBOW_PINWHEELS:
+        // 左右两个对称的风车
+        table->use_base_hue = true;
+        table->rotating = true;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            table->cos_gain[i] = 3 * geo->dy[i];
+            table->sin_gain[i] = 3 * (half_width / 2 - abs(geo->dx[i]));
+        }
+        break;
+#endif
+#ifdef CONFIG_ENABLE_RGB_MATRIX_RAINBOW_MOVING_CHEVRON
+    case RGB_MATRIX_RAINBOW_MOVING_CHEVRON:
+        // V形彩虹从左向右移动
+        table->use_base_hue = true;
+        table->time_sign = -1;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            table->phase[i] = abs(geo->dy[i]) + geo->dx[i] + geo->center_x;
+        }
+        break;
+#endif
+#ifdef CONFIG_ENABLE_RGB_MATRIX_CYCLE_LEFT_RIGHT
+    case RGB_MATRIX_CYCLE_LEFT_RIGHT:
+        table->time_sign = -1;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            table->phase[i] = geo->dx[i] + geo->center_x;
+        }
+        break;
+#endif
+#ifdef CONFIG_ENABLE_RGB_MATRIX_CYCLE_UP_DOWN
+    case RGB_MATRIX_CYCLE_UP_DOWN:
+        table->time_sign = -1;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            table->phase[i] = geo->dy[i] + geo->center_y;
+        }
+        break;
+#endif
+#ifdef CONFIG_ENABLE_RGB_MATRIX_CYCLE_OUT_IN
+    case RGB_MATRIX_CYCLE_OUT_IN:
+        table->time_sign = 1;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            table->phase[i] = 3 * geo->distance[i] / 2;
+        }
+        break;
+#endif
+#ifdef CONFIG_ENABLE_RGB_MATRIX_CYCLE_OUT_IN_DUAL
+    case RGB_MATRIX_CYCLE_OUT_IN_DUAL:
+        // 以左右两侧的中点为圆心
+        table->time_sign = 1;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            int dx = half_width / 2 - abs(geo->dx[i]);
+            int dy = geo->dy[i];
+            table->phase[i] = 3 * (int)lroundf(sqrtf((float)(dx * dx + dy * dy)));
+        }
+        break;
+#endif
+#ifdef CONFIG_ENABLE_RGB_MATRIX_CYCLE_PINWHEEL
+    case RGB_MATRIX_CYCLE_PINWHEEL:
+        table->time_sign = 1;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            table->phase[i] = geo->angle[i];
+        }
+        break;
+#endif
+#ifdef CONFIG_ENABLE_RGB_MATRIX_CYCLE_SPIRAL
+    case RGB_MATRIX_CYCLE_SPIRAL:
+        table->time_sign = -1;
+        for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+            table->phase[i] = geo->distance[i] - geo->angle[i];
+        }
+        break;
+#endif
+    default:
+        s_active = false;
+        return false;
+    }
+
+    s_active = true;
+    return true;
+}
+
+bool rgb_effect_is_active(void)
+{
+    return s_active;
+}
+
+void rgb_effect_render(uint32_t time_ms, const rgb_effect_params_t *params, uint8_t colors[][3])
+{
+    const rgb_effect_table_t *table = &s_table;
+
+    // 与rgb_matrix库相同的时间基准：速度越大色相变化越快
+    uint8_t time = (uint8_t)((time_ms * (uint32_t)(params->speed / 4 + 1)) >> 8);
+    int base = table->use_base_hue ? params->hue : 0;
+    base += table->time_sign * time;
+
+    // 旋转角度每帧只查一次表
+    int cos_value = 0;
+    int sin_value = 0;
+    if (table->rotating) {
+        cos_value = sin_table[(uint8_t)(time + 64)];
+        sin_value = sin_table[time];
+    }
+
+    for (int i = 0; i < RGB_EFFECT_LED_COUNT; i++) {
+        int hue = base + table->phase[i];
+        if (table->rotating) {
+            hue += (table->cos_gain[i] * cos_value + table->sin_gain[i] * sin_value) >> 7;
+        }
+        rgb_effect_hsv_to_rgb((uint8_t)hue, params->sat, params->val, colors[i]);
+    }
+}
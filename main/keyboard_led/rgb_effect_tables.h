@@ -0,0 +1,87 @@
+#ifndef _RGB_EFFECT_TABLES_H_
+#define _RGB_EFFECT_TABLES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "rgb_matrix.h"
+
+/*
+ * 查表灯效
+ * 与LED物理位置有关的灯效不再每帧从g_led_config的坐标重新计算：
+ *   1. 几何表：初始化时按坐标算出每个LED相对中心的偏移、距离、角度、所在行列和相邻LED列表
+ *   2. 灯效表：切换模式时把当前灯效需要的每LED色相偏移和旋转系数算好
+ *   3. 每帧只需一次正弦查表，每个LED做几次整数乘加得到色相，再查色相表得到RGB
+ * 色相表和正弦表为常量，编译后存放在Flash中；伽马校正由LED输出层（led_output）统一完成
+ */
+
+// LED数量，与g_led_config一致
+#define RGB_EFFECT_LED_COUNT        CONFIG_MATRIX_LED_COUNT
+
+// 每个LED最多记录的相邻LED数量
+#define RGB_EFFECT_MAX_NEIGHBORS    6
+
+// 相邻LED
+typedef struct {
+    uint8_t index;              // LED索引
+    uint8_t distance;           // 两个LED之间的距离（坐标单位）
+} rgb_effect_neighbor_t;
+
+// 按g_led_config算出的几何表
+typedef struct {
+    uint8_t center_x;                                   // 所有LED外接矩形的中心
+    uint8_t center_y;
+    int8_t dx[RGB_EFFECT_LED_COUNT];                    // 相对中心的水平偏移，向右为正
+    int8_t dy[RGB_EFFECT_LED_COUNT];                    // 相对中心的垂直偏移，向下为正
+    uint8_t distance[RGB_EFFECT_LED_COUNT];             // 到中心的距离
+    uint8_t angle[RGB_EFFECT_LED_COUNT];                // 相对中心的角度，一圈为256
+    uint8_t row[RGB_EFFECT_LED_COUNT];                  // 所在的按键行，没有对应按键时为UINT8_MAX
+    uint8_t col[RGB_EFFECT_LED_COUNT];                  // 所在的按键列，没有对应按键时为UINT8_MAX
+    uint8_t neighbor_count[RGB_EFFECT_LED_COUNT];
+    rgb_effect_neighbor_t neighbors[RGB_EFFECT_LED_COUNT][RGB_EFFECT_MAX_NEIGHBORS];  // 按距离从近到远排列
+} rgb_effect_geometry_t;
+
+// 每帧渲染参数
+typedef struct {
+    uint8_t hue;
+    uint8_t sat;
+    uint8_t val;
+    uint8_t speed;
+} rgb_effect_params_t;
+
+/**
+ * @brief 按LED配置建立几何表，LED布局不变时只需调用一次
+ */
+void rgb_effect_tables_init(const led_config_t *config);
+
+/**
+ * @brief 获取几何表，供按键响应类灯效使用
+ */
+const rgb_effect_geometry_t *rgb_effect_get_geometry(void);
+
+/**
+ * @brief 切换模式时调用，模式有查表实现时算好该灯效的每LED参数
+ * @param mode 灯效模式（rgb_matrix的模式编号）
+ * @return 该模式由查表实现渲染时返回true，否则仍由rgb_matrix_task渲染
+ */
+bool rgb_effect_select(uint16_t mode);
+
+/**
+ * @brief 当前模式是否由查表实现渲染
+ */
+bool rgb_effect_is_active(void);
+
+/**
+ * @brief 渲染一帧
+ * @param time_ms 当前时间（毫秒）
+ * @param params 色相、饱和度、亮度和速度
+ * @param colors 输出每个LED的RGB值
+ */
+void rgb_effect_render(uint32_t time_ms, const rgb_effect_params_t *params, uint8_t colors[][3]);
+
+/**
+ * @brief 通过查表把HSV转换为RGB
+ */
+void rgb_effect_hsv_to_rgb(uint8_t hue, uint8_t sat, uint8_t val, uint8_t rgb[3]);
+
+#endif
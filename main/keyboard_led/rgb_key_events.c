@@ -0,0 +1,75 @@
+#include <stdatomic.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "rgb_key_events.h"
+
+#define RING_MASK   (RGB_KEY_EVENT_CAPACITY - 1)
+
+_Static_assert((RGB_KEY_EVENT_CAPACITY & RING_MASK) == 0, "RGB_KEY_EVENT_CAPACITY must be a power of 2");
+
+static rgb_key_event_t s_ring[RGB_KEY_EVENT_CAPACITY];
+static _Atomic uint32_t s_head;         // 写指针，只由扫描任务修改
+static _Atomic uint32_t s_tail;         // 读指针，只由LED任务修改
+static _Atomic uint32_t s_dropped;
+
+static rgb_key_hits_t s_hits;
+
+bool rgb_key_event_push(uint8_t row, uint8_t col, bool pressed)
+{
+    uint32_t head = atomic_load_explicit(&s_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&s_tail, memory_order_acquire);
+
+    if (head - tail >= RGB_KEY_EVENT_CAPACITY) {
+        atomic_fetch_add_explicit(&s_dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    rgb_key_event_t *slot = &s_ring[head & RING_MASK];
+    slot->time_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    slot->row = row;
+    slot->col = col;
+    slot->pressed = pressed;
+
+    // 事件内容写完后再发布写指针
+    atomic_store_explicit(&s_head, head + 1, memory_order_release);
+    return true;
+}
+
+bool rgb_key_event_pop(rgb_key_event_t *event)
+{
+    uint32_t tail = atomic_load_explicit(&s_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&s_head, memory_order_acquire);
+
+    if (tail == head) {
+        return false;
+    }
+
+    *event = s_ring[tail & RING_MASK];
+
+    // 读完后再释放该位置给扫描任务
+    atomic_store_explicit(&s_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t rgb_key_event_dropped(void)
+{
+    return atomic_load_explicit(&s_dropped, memory_order_relaxed);
+}
+
+void rgb_key_hits_record(uint8_t led, uint32_t time_ms)
+{
+    if (s_hits.count == RGB_KEY_HIT_MAX) {
+        // 丢弃最旧的记录
+        memmove(&s_hits.led[0], &s_hits.led[1], RGB_KEY_HIT_MAX - 1);
+        memmove(&s_hits.time_ms[0], &s_hits.time_ms[1], (RGB_KEY_HIT_MAX - 1) * sizeof(s_hits.time_ms[0]));
+        s_hits.count--;
+    }
+    s_hits.led[s_hits.count] = led;
+    s_hits.time_ms[s_hits.count] = time_ms;
+    s_hits.count++;
+}
+
+const rgb_key_hits_t *rgb_key_hits_get(void)
+{
+    return &s_hits;
+}
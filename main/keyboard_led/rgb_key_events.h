@@ -0,0 +1,63 @@
+#ifndef _RGB_KEY_EVENTS_H_
+#define _RGB_KEY_EVENTS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * 按键响应灯效的按键事件缓冲
+ * 扫描任务不再同步调用rgb_matrix的按键处理，只把按键变化写入单生产者单消费者的无锁环形缓冲区：
+ *   1. 扫描任务（唯一的生产者）写入一个带时间戳的事件后发布写指针，缓冲区满时丢弃事件并计数，永不阻塞
+ *   2. LED任务（唯一的消费者）在每帧开始时取出全部事件，交给rgb_matrix并记录到按键命中表
+ *   3. 命中表只保留最近RGB_KEY_HIT_MAX次按下，供涟漪、溅射等按键响应灯效按时间戳计算扩散
+ */
+
+// 环形缓冲区容量，必须为2的幂
+#define RGB_KEY_EVENT_CAPACITY  32
+
+// 命中表保留的最近按下次数
+#define RGB_KEY_HIT_MAX         8
+
+// 按键变化事件
+typedef struct {
+    uint32_t time_ms;           // 扫描到变化的时刻
+    uint8_t row;
+    uint8_t col;
+    bool pressed;
+} rgb_key_event_t;
+
+// 最近的按键命中，按时间从旧到新排列
+typedef struct {
+    uint8_t count;
+    uint8_t led[RGB_KEY_HIT_MAX];       // 按键对应的LED索引
+    uint32_t time_ms[RGB_KEY_HIT_MAX];  // 按下的时刻
+} rgb_key_hits_t;
+
+/**
+ * @brief 写入一个按键变化，只能由扫描任务调用
+ * @return 缓冲区满丢弃事件时返回false
+ */
+bool rgb_key_event_push(uint8_t row, uint8_t col, bool pressed);
+
+/**
+ * @brief 取出一个按键变化，只能由LED任务调用
+ * @return 缓冲区为空时返回false
+ */
+bool rgb_key_event_pop(rgb_key_event_t *event);
+
+/**
+ * @brief 获取因缓冲区满被丢弃的事件数
+ */
+uint32_t rgb_key_event_dropped(void);
+
+/**
+ * @brief 记录一次按下，命中表已满时覆盖最旧的记录，只能由LED任务调用
+ */
+void rgb_key_hits_record(uint8_t led, uint32_t time_ms);
+
+/**
+ * @brief 获取命中表，只能由LED任务读取
+ */
+const rgb_key_hits_t *rgb_key_hits_get(void);
+
+#endif
@@ -0,0 +1,215 @@
+#include <string.h>
+#include <stdatomic.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "led_strip_interface.h"
+#include "keyboard_led.h"
+#include "ws2812_spi.h"
+
+static const char *TAG = "ws2812_spi";
+
+// 与led_strip的SPI后端相同，实际时钟需在2.2MHz到2.8MHz之间
+#define CLOCK_TOLERANCE_HZ  (300 * 1000)
+
+// 脏标记每颗灯珠占一位
+_Static_assert(WS2812B_NUM <= 32, "dirty mask holds at most 32 LEDs");
+
+// 半字节编码表：4个数据位编码为12个SPI位，数据位0为100，1为110，高位在前
+static const uint16_t nibble_table[16] = {
+    0x924, 0x926, 0x934, 0x936, 0x9a4, 0x9a6, 0x9b4, 0x9b6,
+    0xd24, 0xd26, 0xd34, 0xd36, 0xda4, 0xda6, 0xdb4, 0xdb6
+};
+
+typedef struct {
+    led_strip_t base;                   // led_strip接口，必须是第一个成员
+    spi_device_handle_t spi_device;
+    spi_host_device_t spi_host;
+    uint32_t led_count;
+    spi_transaction_t trans;            // 常驻的传输描述，只有一个在队列中
+    bool queued;                        // 传输已放入队列，结果尚未取回
+    _Atomic bool busy;                  // 正在传输，由传输完成回调清除
+    uint8_t pixels[WS2812B_NUM][3];     // 当前颜色（RGB）
+    uint32_t dirty;                     // 颜色变化、尚未重新编码的灯珠
+} ws2812_spi_t;
+
+static ws2812_spi_t s_strip;
+
+// 编码后的波形，DMA直接从这里读取
+DMA_ATTR static uint8_t s_dma_buffer[WS2812B_NUM * WS2812_SPI_BYTES_PER_LED];
+
+void ws2812_spi_encode_byte(uint8_t data, uint8_t out[WS2812_SPI_BYTES_PER_COLOR])
+{
+    uint32_t bits = ((uint32_t)nibble_table[data >> 4] << 12) | nibble_table[data & 0x0f];
+    out[0] = (uint8_t)(bits >> 16);
+    out[1] = (uint8_t)(bits >> 8);
+    out[2] = (uint8_t)bits;
+}
+
+/**
+ * @brief 传输完成回调，在中断中执行
+ */
+static void IRAM_ATTR ws2812_spi_post_cb(spi_transaction_t *trans)
+{
+    ws2812_spi_t *strip = trans->user;
+    atomic_store(&strip->busy, false);
+}
+
+static esp_err_t ws2812_spi_set_pixel(led_strip_t *base, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    ws2812_spi_t *strip = (ws2812_spi_t *)base;
+    if (index >= strip->led_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t *pixel = strip->pixels[index];
+    if (pixel[0] != red || pixel[1] != green || pixel[2] != blue) {
+        pixel[0] = (uint8_t)red;
+        pixel[1] = (uint8_t)green;
+        pixel[2] = (uint8_t)blue;
+        strip->dirty |= 1u << index;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t ws2812_spi_set_pixel_rgbw(led_strip_t *base, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    // WS2812没有白色通道
+    return ws2812_spi_set_pixel(base, index, red, green, blue);
+}
+
+static esp_err_t ws2812_spi_refresh(led_strip_t *base)
+{
+    ws2812_spi_t *strip = (ws2812_spi_t *)base;
+
+    // 上一帧还在传输时不修改DMA缓冲区，也不等待
+    if (atomic_load(&strip->busy)) {
+        return ESP_ERR_TIMEOUT;
+    }
+    if (strip->queued) {
+        spi_transaction_t *done = NULL;
+        if (spi_device_get_trans_result(strip->spi_device, &done, 0) != ESP_OK) {
+            return ESP_ERR_TIMEOUT;
+        }
+        strip->queued = false;
+    }
+
+    // 只重新编码颜色变化的灯珠，按GRB顺序
+    uint32_t dirty = strip->dirty;
+    strip->dirty = 0;
+    while (dirty) {
+        uint32_t index = __builtin_ctz(dirty);
+        dirty &= dirty - 1;
+
+        const uint8_t *pixel = strip->pixels[index];
+        uint8_t *out = &s_dma_buffer[index * WS2812_SPI_BYTES_PER_LED];
+        ws2812_spi_encode_byte(pixel[1], out);
+        ws2812_spi_encode_byte(pixel[0], out + WS2812_SPI_BYTES_PER_COLOR);
+        ws2812_spi_encode_byte(pixel[2], out + WS2812_SPI_BYTES_PER_COLOR * 2);
+    }
+
+    atomic_store(&strip->busy, true);
+    esp_err_t err = spi_device_queue_trans(strip->spi_device, &strip->trans, 0);
+    if (err != ESP_OK) {
+        atomic_store(&strip->busy, false);
+        ESP_LOGE(TAG, "Failed to queue transfer: %s", esp_err_to_name(err));
+        return err;
+    }
+    strip->queued = true;
+    return ESP_OK;
+}
+
+static esp_err_t ws2812_spi_clear(led_strip_t *base)
+{
+    ws2812_spi_t *strip = (ws2812_spi_t *)base;
+    for (uint32_t i = 0; i < strip->led_count; i++) {
+        ws2812_spi_set_pixel(base, i, 0, 0, 0);
+    }
+    return ws2812_spi_refresh(base);
+}
+
+static esp_err_t ws2812_spi_del(led_strip_t *base)
+{
+    ws2812_spi_t *strip = (ws2812_spi_t *)base;
+    if (strip->queued) {
+        spi_transaction_t *done = NULL;
+        spi_device_get_trans_result(strip->spi_device, &done, portMAX_DELAY);
+        strip->queued = false;
+    }
+    spi_bus_remove_device(strip->spi_device);
+    spi_bus_free(strip->spi_host);
+    strip->spi_device = NULL;
+    return ESP_OK;
+}
+
+esp_err_t ws2812_spi_new(const ws2812_spi_config_t *config, led_strip_handle_t *ret_strip)
+{
+    if (config == NULL || ret_strip == NULL || config->led_count == 0 || config->led_count > WS2812B_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_strip.spi_device != NULL) {
+        ESP_LOGE(TAG, "WS2812 SPI driver already created");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memset(&s_strip, 0, sizeof(s_strip));
+    size_t length = config->led_count * WS2812_SPI_BYTES_PER_LED;
+
+    spi_bus_config_t bus_config = {
+        .mosi_io_num = config->gpio_num,
+        .miso_io_num = -1,
+        .sclk_io_num = -1,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = length,
+    };
+    esp_err_t err = spi_bus_initialize(config->spi_host, &bus_config, SPI_DMA_CH_AUTO);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize SPI bus: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    spi_device_interface_config_t dev_config = {
+        .clock_source = config->clk_src,
+        .clock_speed_hz = WS2812_SPI_CLOCK_HZ,
+        .mode = 0,
+        .spics_io_num = -1,
+        .queue_size = 1,
+        .post_cb = ws2812_spi_post_cb,
+    };
+    err = spi_bus_add_device(config->spi_host, &dev_config, &s_strip.spi_device);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to add SPI device: %s", esp_err_to_name(err));
+        spi_bus_free(config->spi_host);
+        return err;
+    }
+
+    int freq_khz = 0;
+    spi_device_get_actual_freq(s_strip.spi_device, &freq_khz);
+    if (freq_khz * 1000 < WS2812_SPI_CLOCK_HZ - CLOCK_TOLERANCE_HZ ||
+        freq_khz * 1000 > WS2812_SPI_CLOCK_HZ + CLOCK_TOLERANCE_HZ) {
+        ESP_LOGE(TAG, "Unsupported SPI clock %d kHz", freq_khz);
+        spi_bus_remove_device(s_strip.spi_device);
+        spi_bus_free(config->spi_host);
+        s_strip.spi_device = NULL;
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    s_strip.base.set_pixel = ws2812_spi_set_pixel;
+    s_strip.base.set_pixel_rgbw = ws2812_spi_set_pixel_rgbw;
+    s_strip.base.refresh = ws2812_spi_refresh;
+    s_strip.base.clear = ws2812_spi_clear;
+    s_strip.base.del = ws2812_spi_del;
+    s_strip.spi_host = config->spi_host;
+    s_strip.led_count = config->led_count;
+    atomic_init(&s_strip.busy, false);
+
+    s_strip.trans.length = length * 8;
+    s_strip.trans.tx_buffer = s_dma_buffer;
+    s_strip.trans.user = &s_strip;
+
+    // 所有灯珠先编码为熄灭
+    s_strip.dirty = (config->led_count == 32) ? UINT32_MAX : (1u << config->led_count) - 1;
+
+    *ret_strip = &s_strip.base;
+    return ESP_OK;
+}
@@ -0,0 +1,47 @@
+#ifndef _WS2812_SPI_H_
+#define _WS2812_SPI_H_
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/spi_master.h"
+#include "led_strip.h"
+
+/*
+ * WS2812 SPI直接编码驱动
+ * 实现led_strip接口，替代led_strip的SPI后端，波形与其逐字节相同：
+ *   1. SPI时钟2.5MHz，每个数据位编码为3个SPI位（0为100，1为110），一个颜色字节占3个SPI字节，按GRB顺序发送
+ *   2. 编码结果常驻在一块DMA缓冲区中，set_pixel只记录颜色，refresh时只重新编码颜色变化的灯珠
+ *   3. refresh把传输放入SPI队列后立即返回，传输完成回调在中断中标记空闲；上一帧仍在传输时返回ESP_ERR_TIMEOUT，不等待
+ */
+
+// 每个颜色字节编码后占用的SPI字节数
+#define WS2812_SPI_BYTES_PER_COLOR  3
+
+// 每颗灯珠编码后占用的SPI字节数（GRB三个颜色）
+#define WS2812_SPI_BYTES_PER_LED    (3 * WS2812_SPI_BYTES_PER_COLOR)
+
+// SPI时钟，与led_strip的SPI后端相同
+#define WS2812_SPI_CLOCK_HZ         (2500 * 1000)
+
+// 驱动配置
+typedef struct {
+    int gpio_num;                   // 数据引脚
+    uint32_t led_count;             // 灯珠数量，不超过WS2812B_NUM
+    spi_host_device_t spi_host;     // SPI主机
+    spi_clock_source_t clk_src;     // SPI时钟源
+} ws2812_spi_config_t;
+
+/**
+ * @brief 创建WS2812 SPI驱动，初始化SPI总线和设备
+ * @param config 驱动配置
+ * @param ret_strip 返回灯带句柄，通过led_strip_*函数使用
+ * @return ESP_OK成功，其他值为错误码
+ */
+esp_err_t ws2812_spi_new(const ws2812_spi_config_t *config, led_strip_handle_t *ret_strip);
+
+/**
+ * @brief 把一个颜色字节编码为3个SPI字节
+ */
+void ws2812_spi_encode_byte(uint8_t data, uint8_t out[WS2812_SPI_BYTES_PER_COLOR]);
+
+#endif
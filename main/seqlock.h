@@ -0,0 +1,79 @@
+#ifndef _SEQLOCK_H_
+#define _SEQLOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+/*
+ * 按32位字发布的顺序锁
+ * 一个写方发布、任意多个读方读取，双方都不加锁：
+ *   1. 写方先把序号加1（变为奇数）再逐字写入数据，写完再加1（变回偶数）
+ *   2. 读方读取前后序号一致且为偶数时得到完整的一份数据，否则重读
+ *   3. 读方最多重读SEQLOCK_READ_ATTEMPTS次，不休眠也不等待写方；
+ *      写方在同一核上被读方抢占时重读也不会成功，此时返回false，由调用者沿用上一次读到的数据
+ * 数据逐字原子读写，读方即使读到写了一半的数据也不是未定义行为，只是会被序号检查丢弃
+ */
+
+// 读方连续重读的次数上限，写方在另一个核上发布时几次之内就能读到完整的数据
+#define SEQLOCK_READ_ATTEMPTS   4
+
+typedef struct {
+    _Atomic uint32_t sequence;      // 偶数为已发布的次数的两倍，奇数表示正在发布
+} seqlock_t;
+
+/**
+ * @brief 发布一份数据，只能由唯一的写方调用
+ * @param lock 顺序锁
+ * @param words 读方读取的发布区
+ * @param data 要发布的数据
+ * @param count 字数
+ */
+static inline void seqlock_publish(seqlock_t *lock, _Atomic uint32_t *words, const uint32_t *data, size_t count)
+{
+    uint32_t seq = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+
+    // 序号变为奇数后再写数据，读方看到奇数或序号变化时重读
+    atomic_store_explicit(&lock->sequence, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (size_t i = 0; i < count; i++) {
+        atomic_store_explicit(&words[i], data[i], memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&lock->sequence, seq + 2, memory_order_release);
+}
+
+/**
+ * @brief 读取最近一次发布的数据，不阻塞、不休眠，可在渲染回调中调用
+ * @param lock 顺序锁
+ * @param words 发布区
+ * @param data 输出数据，返回false时内容无意义
+ * @param count 字数
+ * @param ret_published 返回已发布的次数，0表示从未发布，可为NULL
+ * @return 读到完整的数据时返回true，写方正在发布时返回false
+ */
+static inline bool seqlock_try_read(seqlock_t *lock, _Atomic uint32_t *words, uint32_t *data, size_t count,
+                                    uint32_t *ret_published)
+{
+    for (int attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; attempt++) {
+        uint32_t begin = atomic_load_explicit(&lock->sequence, memory_order_acquire);
+        if (begin & 1) {
+            continue;
+        }
+        for (size_t i = 0; i < count; i++) {
+            data[i] = atomic_load_explicit(&words[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&lock->sequence, memory_order_relaxed) == begin) {
+            if (ret_published != NULL) {
+                *ret_published = begin / 2;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include "keyboard_led/keyboard_led.h"
 #include "spi_keyboard_config.h" // 合并后的SPI和按键映射配置文件
 #include "keymap_manager.h" // 添加组合键支持
+#include "input_event.h" // 输入事件总线
 
 // 外部声明当前映射层变量
 extern uint8_t current_keymap_layer;
@@ -137,11 +138,8 @@ static hid_report_t build_hid_report(uint8_t _layer)
         uint8_t key = keymap->key_pressed_data[i];
         uint16_t kc = keymaps[_layer][key];
 
-        // 将按键代码发送到键盘队列
-        QueueHandle_t keyboard_queue = get_keyboard_queue();
-        if (keyboard_queue != NULL) {
-            xQueueSend(keyboard_queue, &kc, 0);
-        }
+        // 将按键代码发布到输入事件总线，没有订阅者或缓冲区满时立即返回，不会阻塞扫描
+        input_event_publish(INPUT_EVENT_KEY, kc);
 
         // 检查是否为组合键
         if (is_combo_key(kc)) {
@@ -53,10 +53,14 @@ static calculator_state_t calc_state = {
 };
 
 // 从oled_menu_display.c获取的函数声明
-extern QueueHandle_t get_keyboard_queue(void);
-extern QueueHandle_t get_joystick_queue(void);
 extern MenuManager* get_menu_manager(void);
 
+// 计算器活动状态
+static uint16_t calc_last_keycode = 0;       // 上一次处理的按键，用于消抖
+static TickType_t calc_last_key_time = 0;    // 上一次处理按键的时刻
+static uint8_t calc_original_layer = 0;      // 进入计算器前的映射层
+static bool calc_exiting = false;            // 是否正在显示退出提示
+
 // 函数声明
 static bool is_input_overflow(const char* value_str);
 static void string_to_double_for_display(const char* str, double* result);
@@ -728,8 +732,6 @@ static void display_calculator(void) {
     
     // 底部状态栏 - 简洁设计
     OLED_DrawLine(0, 28, 127, 28); // 分隔线
-    
-    OLED_Update();
 }
 
 /**
@@ -776,82 +778,108 @@ static bool process_calculator_key(uint16_t keycode) {
 }
 
 /**
- * @brief 计算器功能主函数
- * 使用键盘按键进行输入，在使用计算器时中断tinyusb的发送报告
+ * @brief 计算器活动 - 进入
+ * 切换到映射层0（小键盘布局），并禁用HID报告发送，避免计算器输入被发送到主机
  */
-void menuActionCalculator(void) {
-    // 主循环
-    bool exit_calculator = false;
-    uint16_t last_keycode = 0;
-    TickType_t last_key_time = 0;
-    const TickType_t debounce_delay = 200 / portTICK_PERIOD_MS; // 200ms消抖延时
-        // 保存当前映射层
+static bool calculator_enter(void) {
     extern uint8_t current_keymap_layer;
-    uint8_t original_layer = current_keymap_layer;
-    // 切换到映射层0（小键盘布局）
+    
+    // 保存当前映射层，切换到映射层0（小键盘布局）
+    calc_original_layer = current_keymap_layer;
     current_keymap_layer = 0;
-
-    OLED_Clear();
+    
     // 初始化计算器状态
     handle_clear();
+    calc_last_keycode = 0;
+    calc_last_key_time = 0;
+    calc_exiting = false;
+    
     // 禁用HID报告发送，避免计算器输入被发送到主机
     tinyusb_hid_enable_report(false);
-    // 显示计算器界面
-    display_calculator();
-    
+    return true;
+}
 
+/**
+ * @brief 计算器活动 - 键盘按键输入，摇杆长按或双击退出
+ */
+static MenuActivityResult calculator_event(const MenuEvent* event) {
+    extern uint8_t current_keymap_layer;
+    const TickType_t debounce_delay = 200 / portTICK_PERIOD_MS; // 200ms消抖延时
     
-    while (!exit_calculator ) {
-        uint16_t keycode = 0;
-        uint8_t joystick_op = 0;
-        
-        // 同时监听键盘队列和摇杆队列
-        if (xQueueReceive(get_keyboard_queue(), &keycode, 0) == pdTRUE) {
+    if (calc_exiting) {
+        // 退出提示显示结束后返回菜单
+        return (event->type == MENU_EVENT_TIMER) ? MENU_ACTIVITY_EXIT : MENU_ACTIVITY_IDLE;
+    }
+    
+    switch (event->type) {
+        case MENU_EVENT_KEY: {
             TickType_t current_time = xTaskGetTickCount();
             
             // 按键消抖处理：相同按键在消抖时间内只处理一次
-            if (keycode == last_keycode && (current_time - last_key_time) < debounce_delay) {
-                continue; // 忽略重复按键
+            if (event->code == calc_last_keycode && (current_time - calc_last_key_time) < debounce_delay) {
+                return MENU_ACTIVITY_IDLE; // 忽略重复按键
             }
-            
-            last_keycode = keycode;
-            last_key_time = current_time;
+            calc_last_keycode = event->code;
+            calc_last_key_time = current_time;
             
             // 处理计算器按键
-            if (process_calculator_key(keycode)) {
-                display_calculator();
-            }
+            return process_calculator_key(event->code) ? MENU_ACTIVITY_REDRAW : MENU_ACTIVITY_IDLE;
         }
         
-        // 独立监听摇杆队列，确保及时处理摇杆事件
-        if (xQueueReceive(get_joystick_queue(), &joystick_op, 0) == pdTRUE) {
-            // 处理摇杆队列事件
-            if (joystick_op == MENU_OP_BACK) {
-                // 摇杆长按或双击事件，退出计算器
-                exit_calculator = true;
+        case MENU_EVENT_JOYSTICK:
+            if (event->code != MENU_OP_BACK) {
+                return MENU_ACTIVITY_IDLE;
             }
-        }
+            // 摇杆长按或双击事件，退出计算器：重新启用HID报告发送并恢复原始映射层
+            tinyusb_hid_enable_report(true);
+            current_keymap_layer = calc_original_layer;
+            
+            // 显示退出信息500ms
+            calc_exiting = true;
+            MenuManager_SetActivityTimer(get_menu_manager(), 500);
+            return MENU_ACTIVITY_REDRAW;
         
-        // 添加短暂延时，避免过度占用CPU
-        vTaskDelay(10 / portTICK_PERIOD_MS);
+        default:
+            return MENU_ACTIVITY_IDLE;
     }
+}
+
+/**
+ * @brief 计算器活动 - 绘制计算器界面或退出提示
+ */
+static void calculator_render(void) {
+    if (calc_exiting) {
+        OLED_Clear();
+        OLED_ShowString(44, 12, "Exiting", OLED_8X16_HALF);
+        return;
+    }
+    display_calculator();
+}
+
+/**
+ * @brief 计算器活动 - 退出
+ * 正常退出时已在显示退出提示前恢复，这里只处理活动被直接结束的情况
+ */
+static void calculator_exit(void) {
+    extern uint8_t current_keymap_layer;
     
-    // 重新启用HID报告发送
-    tinyusb_hid_enable_report(true);
-    
-    // 恢复原始映射层
-    current_keymap_layer = original_layer;
-    
-    // 显示退出信息
-    OLED_Clear();
-    OLED_ShowString(44, 12, "Exiting", OLED_8X16_HALF);
-    OLED_Update();
-    vTaskDelay(500 / portTICK_PERIOD_MS);
-    
-    // 返回主菜单
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
+    if (!calc_exiting) {
+        tinyusb_hid_enable_report(true);
+        current_keymap_layer = calc_original_layer;
+    }
 }
 
+/**
+ * @brief 计算器功能
+ * 使用键盘按键进行输入，在使用计算器时中断tinyusb的发送报告
+ */
+const MenuActivity menuActivityCalculator = {
+    .on_enter  = calculator_enter,
+    .on_event  = calculator_event,
+    .on_render = calculator_render,
+    .on_exit   = calculator_exit,
+};
+
 /**
  * @brief 获取计算器状态（用于测试）
  * @return calculator_state_t* 计算器状态指针
@@ -3,6 +3,13 @@
 
 #include <stdbool.h>
 #include "../oled_driver/OLED_driver.h"
+#include "oled_menu.h"
+
+/*
+ * 以下菜单活动由菜单项引用，所有回调都在UI任务中执行，不会阻塞等待输入，
+ * 提示信息的显示时长通过MenuManager_SetActivityTimer实现
+ */
+
 /**
  * @brief 键盘相关功能声明
  */
@@ -21,10 +28,10 @@ void display_keymap_layer(int current_keymap_layer_val);
 bool is_layer1_empty(void);
 
 /**
- * @brief 映射层菜单操作函数
+ * @brief 映射层菜单活动
  * 用于显示和切换当前的映射层
  */
-void menuActionMappingLayer(void);
+extern const MenuActivity menuActivityMappingLayer;
 
 /**
  * @brief 灯效相关功能声明
@@ -33,23 +40,23 @@ void menuActionMappingLayer(void);
 /**
  * @brief 切换灯效开关
  */
-void menuActionRgbToggle(void);
+extern const MenuActivity menuActivityRgbToggle;
 
 /**
  * @brief 选择灯效模式
  */
-void menuActionRgbModeSelect(void);
+extern const MenuActivity menuActivityRgbModeSelect;
 
 /**
  * @brief 调节灯效速度
  */
-void menuActionRgbSpeedAdjust(void);
+extern const MenuActivity menuActivityRgbSpeedAdjust;
 
 /**
  * @brief HSV调控统一函数
  * 集成色调(0-360)、饱和度(0-100%)和亮度(0-100%)的调节
  */
-void menuActionRgbHsvAdjust(void);
+extern const MenuActivity menuActivityRgbHsvAdjust;
 
 /**
  * @brief 计算器相关功能声明
@@ -59,7 +66,7 @@ void menuActionRgbHsvAdjust(void);
  * @brief 计算器功能
  * 使用键盘按键进行输入，在使用计算器时中断tinyusb的发送报告
  */
-void menuActionCalculator(void);
+extern const MenuActivity menuActivityCalculator;
 
 /**
  * @brief WiFi相关功能声明
@@ -68,21 +75,21 @@ void menuActionCalculator(void);
 /**
  * @brief 显示WiFi状态和详细信息（支持摇杆滚动查看）
  */
-void menuActionWifiStatus(void);
+extern const MenuActivity menuActivityWifiStatus;
 
 /**
  * @brief 切换WiFi开关
  */
-void menuActionWifiToggle(void);
+extern const MenuActivity menuActivityWifiToggle;
 
 /**
  * @brief 显示HTML网址
  */
-void menuActionHtmlUrl(void);
+extern const MenuActivity menuActivityHtmlUrl;
 
 /**
- * @brief 清除WiFi密码动作函数
+ * @brief 清除WiFi密码
  */
-void menuActionClearWifiPassword(void);
+extern const MenuActivity menuActivityClearWifiPassword;
 
 #endif /* OLED_MENU_COMBINED_H */
\ No newline at end of file
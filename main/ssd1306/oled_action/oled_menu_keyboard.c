@@ -23,15 +23,41 @@
 extern uint8_t current_keymap_layer; // 在oled_menu_display.c中定义
 
 // 从oled_menu_display.c获取的函数声明
-extern QueueHandle_t get_joystick_queue(void);
 extern MenuManager* get_menu_manager(void);
 extern unified_nvs_manager_t* get_unified_nvs_manager(void);
 
+// 提示信息（"Saved!"等）的显示时长
+#define KEYBOARD_MESSAGE_MS     500
+
+// 映射层活动的界面
+typedef enum {
+    KEYMAP_SCREEN_LAYER,    // 显示当前映射层
+    KEYMAP_SCREEN_SAVED,    // 已保存，提示结束后退出
+    KEYMAP_SCREEN_EMPTY     // 层为空，提示结束后回到映射层显示
+} KeymapScreen;
+
+// HSV调节的选中项
+typedef enum {
+    HSV_ADJUST_HUE,
+    HSV_ADJUST_SAT,
+    HSV_ADJUST_VAL
+} HsvAdjustMode;
+
+// 活动状态
+static KeymapScreen keymap_screen = KEYMAP_SCREEN_LAYER;
+static bool rgb_saved = false;            // 灯效设置活动是否正在显示"Saved!"
+static bool rgb_toggle_enabled = false;   // 灯效开关切换后的状态
+static uint8_t rgb_display_speed = 0;     // 显示用速度百分比(0-100)
+static HsvAdjustMode hsv_mode = HSV_ADJUST_HUE;
+static uint16_t hsv_display_hue = 0;      // 显示用色调(0-360)
+static uint8_t hsv_display_sat = 0;       // 显示用饱和度(0-100%)
+static uint8_t hsv_display_val = 0;       // 显示用亮度(0-100%)
+
 /**
- * @brief 显示当前映射层信息
+ * @brief 绘制映射层信息，只写显存
  * @param current_keymap_layer_val 当前映射层值
  */
-void display_keymap_layer(int current_keymap_layer_val) {
+static void draw_keymap_layer(int current_keymap_layer_val) {
     OLED_Clear();
     
     // 标题栏 - 居中显示
@@ -41,7 +67,14 @@ void display_keymap_layer(int current_keymap_layer_val) {
     char layer_str[10];  // 增加数组大小防止溢出
     sprintf(layer_str, "Layer %d", current_keymap_layer_val);
     OLED_ShowString(30, 10, layer_str, OLED_8X16_HALF);
-    
+}
+
+/**
+ * @brief 显示当前映射层信息
+ * @param current_keymap_layer_val 当前映射层值
+ */
+void display_keymap_layer(int current_keymap_layer_val) {
+    draw_keymap_layer(current_keymap_layer_val);
     OLED_Update();
 }
 
@@ -62,104 +95,125 @@ bool is_layer_empty(uint8_t layer) {
 }
 
 /**
- * @brief 映射层菜单操作函数
- * 用于显示和切换当前的映射层
+ * @brief 显示"Saved!"提示
+ * @param x 提示文字的起始X坐标
  */
-void menuActionMappingLayer(void) {
+static void draw_saved(uint8_t x) {
     OLED_Clear();
+    OLED_ShowString(x, 4, "Saved!", OLED_8X16_HALF);
+}
+
+/**
+ * @brief 映射层活动 - 进入时显示当前映射层
+ */
+static bool mapping_layer_enter(void) {
+    keymap_screen = KEYMAP_SCREEN_LAYER;
+    return true;
+}
+
+/**
+ * @brief 映射层活动 - 上下切换映射层，确认保存，返回不保存退出
+ */
+static MenuActivityResult mapping_layer_event(const MenuEvent* event) {
+    if (event->type == MENU_EVENT_TIMER) {
+        // 提示信息显示结束：保存成功后退出，层为空时回到映射层显示
+        if (keymap_screen == KEYMAP_SCREEN_SAVED) {
+            return MENU_ACTIVITY_EXIT;
+        }
+        keymap_screen = KEYMAP_SCREEN_LAYER;
+        return MENU_ACTIVITY_REDRAW;
+    }
     
-    // 显示初始图层信息
-    display_keymap_layer(current_keymap_layer);
+    // 显示提示信息期间忽略输入
+    if (event->type != MENU_EVENT_JOYSTICK || keymap_screen != KEYMAP_SCREEN_LAYER) {
+        return MENU_ACTIVITY_IDLE;
+    }
     
-    // 等待用户输入
-    bool confirmed = false;
-    while (!confirmed) {
-        uint8_t op; // 改为uint8_t类型，与joystick_task中发送的数据类型匹配
-        if (xQueueReceive(get_joystick_queue(), &op, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-            switch (op) {
-                case MENU_OP_UP:
-                    // 向上切换到前一层（循环切换）
-                    if (current_keymap_layer == 0) {
-                        current_keymap_layer = TOTAL_LAYERS - 1; // 从层0切换到最后一层
-                    } else {
-                        current_keymap_layer--;
-                    }
-                    display_keymap_layer(current_keymap_layer);
-                    break;
-                case MENU_OP_DOWN:
-                    // 向下切换到下一层（循环切换）
-                    if (current_keymap_layer == TOTAL_LAYERS - 1) {
-                        current_keymap_layer = 0; // 从最后一层切换到层0
-                    } else {
-                        current_keymap_layer++;
-                    }
-                    display_keymap_layer(current_keymap_layer);
-                    break;
-                case MENU_OP_ENTER:
-                    // 检查选择的层是否为空，只有非空层才保存
-                    if (!is_layer_empty(current_keymap_layer)) {
-                        // 保存选择并退出
-                        OLED_Clear();
-                        // "Saved!" 居中显示：字符数6，字体宽度8px，总宽度48px，起始x=(128-48)/2=40
-                        OLED_ShowString(40, 4, "Saved!", OLED_8X16_HALF);
-                        OLED_Update();
-                        
-                        // 保存当前映射层选择到NVS
-                        unified_nvs_manager_t* nvs_manager = get_unified_nvs_manager();
-                        if (nvs_manager) {
-                            // 只保存当前层信息，WS2812状态在灯效菜单中单独保存
-                            unified_nvs_save_menu_config(nvs_manager, current_keymap_layer, false);
-                        }
-                        
-                        // 保存当前层的键盘映射到NVS
-                        esp_err_t save_err = save_keymap_to_nvs(current_keymap_layer, &keymaps[current_keymap_layer][0]);
-                        if (save_err != ESP_OK) {
-                            ESP_LOGE("OLED_MENU", "Failed to save keymap for layer %d", current_keymap_layer);
-                        } else {
-                            ESP_LOGI("OLED_MENU", "Successfully saved keymap for layer %d", current_keymap_layer);
-                        }
-                        
-                        vTaskDelay(500 / portTICK_PERIOD_MS); // 缩短等待时间
-                        confirmed = true;
-                        
-                    } else {
-                        // 层为空，显示提示信息
-                        OLED_Clear();
-                        // "Layer Empty!" 使用OLED_6X8_HALF字体：字符数11，字体宽度6px，总宽度66px，起始x=(128-66)/2=31
-                        OLED_ShowString(31, 8, "Layer Empty!", OLED_6X8_HALF);
-                        // "No key mappings" 使用OLED_6X8_HALF字体：字符数14，字体宽度6px，总宽度84px，起始x=(128-84)/2=22
-                        OLED_ShowString(22, 16, "No key mappings", OLED_6X8_HALF);
-                        OLED_Update();
-                        vTaskDelay(500 / portTICK_PERIOD_MS); // 缩短等待时间
-                        display_keymap_layer(current_keymap_layer);
-                    }
-                    break;
-                    case MENU_OP_BACK:
-                    // 不保存退出
-                    confirmed = true;
-                    break;
-                default:
-                    break;
+    switch (event->code) {
+        case MENU_OP_UP:
+            // 向上切换到前一层（循环切换）
+            if (current_keymap_layer == 0) {
+                current_keymap_layer = TOTAL_LAYERS - 1; // 从层0切换到最后一层
+            } else {
+                current_keymap_layer--;
             }
-        }
+            return MENU_ACTIVITY_REDRAW;
+        case MENU_OP_DOWN:
+            // 向下切换到下一层（循环切换）
+            if (current_keymap_layer == TOTAL_LAYERS - 1) {
+                current_keymap_layer = 0; // 从最后一层切换到层0
+            } else {
+                current_keymap_layer++;
+            }
+            return MENU_ACTIVITY_REDRAW;
+        case MENU_OP_ENTER:
+            // 检查选择的层是否为空，只有非空层才保存
+            if (!is_layer_empty(current_keymap_layer)) {
+                // 保存当前映射层选择到NVS
+                unified_nvs_manager_t* nvs_manager = get_unified_nvs_manager();
+                if (nvs_manager) {
+                    // 只保存当前层信息，WS2812状态在灯效菜单中单独保存
+                    unified_nvs_save_menu_config(nvs_manager, current_keymap_layer, false);
+                }
+                
+                // 保存当前层的键盘映射到NVS
+                esp_err_t save_err = save_keymap_to_nvs(current_keymap_layer, &keymaps[current_keymap_layer][0]);
+                if (save_err != ESP_OK) {
+                    ESP_LOGE("OLED_MENU", "Failed to save keymap for layer %d", current_keymap_layer);
+                } else {
+                    ESP_LOGI("OLED_MENU", "Successfully saved keymap for layer %d", current_keymap_layer);
+                }
+                
+                keymap_screen = KEYMAP_SCREEN_SAVED;
+            } else {
+                // 层为空，显示提示信息
+                keymap_screen = KEYMAP_SCREEN_EMPTY;
+            }
+            MenuManager_SetActivityTimer(get_menu_manager(), KEYBOARD_MESSAGE_MS);
+            return MENU_ACTIVITY_REDRAW;
+        case MENU_OP_BACK:
+            // 不保存退出
+            return MENU_ACTIVITY_EXIT;
+        default:
+            return MENU_ACTIVITY_IDLE;
     }
-    
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
 }
 
 /**
- * @brief 切换灯效开关
+ * @brief 映射层活动 - 绘制当前界面
  */
-void menuActionRgbToggle(void) {
-    OLED_Clear();
-    if(kob_ws2812_is_enable() == false){
-        kob_ws2812_enable(true);
-        OLED_ShowString(20, 8, "RGB Enabled", OLED_8X16_HALF);
-    }else{
-        kob_ws2812_enable(false);
-        OLED_ShowString(16, 8, "RGB Disabled", OLED_8X16_HALF);
+static void mapping_layer_render(void) {
+    switch (keymap_screen) {
+        case KEYMAP_SCREEN_SAVED:
+            // "Saved!" 居中显示：字符数6，字体宽度8px，总宽度48px，起始x=(128-48)/2=40
+            draw_saved(40);
+            break;
+        case KEYMAP_SCREEN_EMPTY:
+            OLED_Clear();
+            // "Layer Empty!" 使用OLED_6X8_HALF字体：字符数11，字体宽度6px，总宽度66px，起始x=(128-66)/2=31
+            OLED_ShowString(31, 8, "Layer Empty!", OLED_6X8_HALF);
+            // "No key mappings" 使用OLED_6X8_HALF字体：字符数14，字体宽度6px，总宽度84px，起始x=(128-84)/2=22
+            OLED_ShowString(22, 16, "No key mappings", OLED_6X8_HALF);
+            break;
+        default:
+            draw_keymap_layer(current_keymap_layer);
+            break;
     }
-    OLED_Update();
+}
+
+const MenuActivity menuActivityMappingLayer = {
+    .on_enter  = mapping_layer_enter,
+    .on_event  = mapping_layer_event,
+    .on_render = mapping_layer_render,
+    .on_exit   = NULL,
+};
+
+/**
+ * @brief 切换灯效开关，保存到NVS后显示1秒
+ */
+static bool rgb_toggle_enter(void) {
+    rgb_toggle_enabled = !kob_ws2812_is_enable();
+    kob_ws2812_enable(rgb_toggle_enabled);
     
     // 保存WS2812状态到NVS
     unified_nvs_manager_t* nvs_manager = get_unified_nvs_manager();
@@ -167,294 +221,285 @@ void menuActionRgbToggle(void) {
         unified_nvs_save_menu_config(nvs_manager, current_keymap_layer, kob_ws2812_is_enable());
     }
     
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
+    MenuManager_SetActivityTimer(get_menu_manager(), 1000);
+    return true;
 }
 
 /**
- * @brief 选择灯效模式
+ * @brief 显示灯效开关切换结果
  */
-void menuActionRgbModeSelect(void) {
+static void rgb_toggle_render(void) {
     OLED_Clear();
+    if (rgb_toggle_enabled) {
+        OLED_ShowString(20, 8, "RGB Enabled", OLED_8X16_HALF);
+    } else {
+        OLED_ShowString(16, 8, "RGB Disabled", OLED_8X16_HALF);
+    }
+}
+
+const MenuActivity menuActivityRgbToggle = {
+    .on_enter  = rgb_toggle_enter,
+    .on_event  = MenuActivity_ExitOnTimer,
+    .on_render = rgb_toggle_render,
+    .on_exit   = NULL,
+};
+
+/**
+ * @brief 灯效设置活动的公共事件处理：确认后显示"Saved!"并在提示结束后退出，返回直接退出
+ * @param event 菜单事件
+ * @param result 输出处理结果
+ * @return 事件已被处理返回true，否则由调用者继续处理调节操作
+ */
+static bool rgb_setting_common_event(const MenuEvent* event, MenuActivityResult* result) {
+    if (event->type == MENU_EVENT_TIMER) {
+        *result = rgb_saved ? MENU_ACTIVITY_EXIT : MENU_ACTIVITY_IDLE;
+        return true;
+    }
+    
+    // 显示"Saved!"期间忽略输入
+    if (event->type != MENU_EVENT_JOYSTICK || rgb_saved) {
+        *result = MENU_ACTIVITY_IDLE;
+        return true;
+    }
+    
+    if (event->code == MENU_OP_ENTER) {
+        // 保存选择并退出
+        rgb_saved = true;
+        MenuManager_SetActivityTimer(get_menu_manager(), KEYBOARD_MESSAGE_MS);
+        *result = MENU_ACTIVITY_REDRAW;
+        return true;
+    }
+    if (event->code == MENU_OP_BACK) {
+        // 不保存退出
+        *result = MENU_ACTIVITY_EXIT;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 选择灯效模式 - 进入
+ */
+static bool rgb_mode_enter(void) {
+    rgb_saved = false;
+    return true;
+}
+
+/**
+ * @brief 选择灯效模式 - 上下切换模式
+ */
+static MenuActivityResult rgb_mode_event(const MenuEvent* event) {
+    MenuActivityResult result;
+    if (rgb_setting_common_event(event, &result)) {
+        return result;
+    }
+    
+    switch (event->code) {
+        case MENU_OP_UP:
+            kob_rgb_matrix_prev_mode();
+            return MENU_ACTIVITY_REDRAW;
+        case MENU_OP_DOWN:
+            kob_rgb_matrix_next_mode();
+            return MENU_ACTIVITY_REDRAW;
+        default:
+            return MENU_ACTIVITY_IDLE;
+    }
+}
+
+/**
+ * @brief 选择灯效模式 - 显示当前模式
+ */
+static void rgb_mode_render(void) {
+    if (rgb_saved) {
+        draw_saved(44);
+        return;
+    }
     
     // 获取当前灯效模式
     led_effect_config_t* config = kob_rgb_get_config();
     
-    // 显示当前模式
     char mode_str[30];
     sprintf(mode_str, "Mode: %d", config->mode);
+    OLED_Clear();
     OLED_ShowString(10, 4, mode_str, OLED_6X8_HALF);
     OLED_ShowString(10, 16, "Up/Down: Change", OLED_6X8_HALF);
     OLED_ShowString(10, 24, "Enter: Save", OLED_6X8_HALF);
-    OLED_Update();
-    
-    // 等待用户输入
-    bool confirmed = false;
-    while (!confirmed) {
-        uint8_t op; // 改为uint8_t类型，与joystick_task中发送的数据类型匹配
-        if (xQueueReceive(get_joystick_queue(), &op, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-            switch (op) {
-                case MENU_OP_UP:
-                    kob_rgb_matrix_prev_mode();
-                    break;
-                case MENU_OP_DOWN:
-                    kob_rgb_matrix_next_mode();
-                    break;
-                case MENU_OP_ENTER:
-                    // 保存选择并退出
-                    OLED_Clear();
-                    OLED_ShowString(44, 4, "Saved!", OLED_8X16_HALF);
-                    OLED_Update();
-                    vTaskDelay(500 / portTICK_PERIOD_MS);
-                    confirmed = true;
-                    break;
-                case MENU_OP_BACK:
-                    // 不保存退出
-                    confirmed = true;
-                    break;
-                default:
-                    break;
-            }
-            
-            // 更新显示
-            if (op == MENU_OP_UP || op == MENU_OP_DOWN) {
-                config = kob_rgb_get_config();
-                sprintf(mode_str, "Mode: %d", config->mode);
-                OLED_Clear();
-                OLED_ShowString(10, 4, mode_str, OLED_6X8_HALF);
-                OLED_ShowString(10, 16, "Up/Down: Change", OLED_6X8_HALF);
-                OLED_ShowString(10, 24, "Enter: Save", OLED_6X8_HALF);
-                OLED_Update();
-            }
-        }
-    }
+}
+
+const MenuActivity menuActivityRgbModeSelect = {
+    .on_enter  = rgb_mode_enter,
+    .on_event  = rgb_mode_event,
+    .on_render = rgb_mode_render,
+    .on_exit   = NULL,
+};
+
+/**
+ * @brief 调节灯效速度 - 进入时读取当前速度
+ */
+static bool rgb_speed_enter(void) {
+    led_effect_config_t* config = kob_rgb_get_config();
     
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
+    // 从内部0-255转换为显示0-100%
+    rgb_display_speed = (config->speed * 100 + 127) / 255;  // 使用四舍五入
+    rgb_saved = false;
+    return true;
 }
 
 /**
- * @brief 调节灯效速度
+ * @brief 调节灯效速度 - 上下每次调节1%
  */
-void menuActionRgbSpeedAdjust(void) {
-    OLED_Clear();
+static MenuActivityResult rgb_speed_event(const MenuEvent* event) {
+    MenuActivityResult result;
+    if (rgb_setting_common_event(event, &result)) {
+        return result;
+    }
     
-    // 获取当前速度值
     led_effect_config_t* config = kob_rgb_get_config();
+    switch (event->code) {
+        case MENU_OP_UP:
+            // 增加1%的速度
+            rgb_display_speed = (rgb_display_speed >= 100) ? 100 : (rgb_display_speed + 1);
+            break;
+        case MENU_OP_DOWN:
+            // 减少1%的速度
+            rgb_display_speed = (rgb_display_speed == 0) ? 0 : (rgb_display_speed - 1);
+            break;
+        default:
+            return MENU_ACTIVITY_IDLE;
+    }
     
-    // 从内部0-255转换为显示0-100%
-    uint8_t display_speed = (config->speed * 100 + 127) / 255;  // 使用四舍五入
+    // 转换回内部0-255值并设置
+    config->speed = (rgb_display_speed * 255) / 100;
+    kob_rgb_matrix_set_speed(config->speed);
+    return MENU_ACTIVITY_REDRAW;
+}
+
+/**
+ * @brief 调节灯效速度 - 显示当前速度百分比
+ */
+static void rgb_speed_render(void) {
+    if (rgb_saved) {
+        draw_saved(44);
+        return;
+    }
     
-    // 显示当前速度百分比
     char speed_str[30];
-    sprintf(speed_str, "Speed: %d%%", display_speed);
+    sprintf(speed_str, "Speed: %d%%", rgb_display_speed);
+    OLED_Clear();
     OLED_ShowString(10, 4, speed_str, OLED_6X8_HALF);
     OLED_ShowString(10, 16, "Up: Increase 1%%", OLED_6X8_HALF);
     OLED_ShowString(10, 24, "Down: Decrease 1%%", OLED_6X8_HALF);
-    OLED_Update();
+}
+
+const MenuActivity menuActivityRgbSpeedAdjust = {
+    .on_enter  = rgb_speed_enter,
+    .on_event  = rgb_speed_event,
+    .on_render = rgb_speed_render,
+    .on_exit   = NULL,
+};
+
+/**
+ * @brief HSV调控 - 进入时把内部值转换为显示值
+ */
+static bool rgb_hsv_enter(void) {
+    led_effect_config_t* config = kob_rgb_get_config();
     
-    // 等待用户输入
-    bool confirmed = false;
-    while (!confirmed) {
-        uint8_t op; // 改为uint8_t类型，与joystick_task中发送的数据类型匹配
-        if (xQueueReceive(get_joystick_queue(), &op, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-            switch (op) {
-                case MENU_OP_UP:
-                    // 增加1%的速度
-                    display_speed = (display_speed >= 100) ? 100 : (display_speed + 1);
-                    // 转换回内部0-255值并设置
-                    config->speed = (display_speed * 255) / 100;
-                    kob_rgb_matrix_set_speed(config->speed);
+    hsv_mode = HSV_ADJUST_HUE;
+    hsv_display_hue = (config->hue * 360) / 255; // 内部0-255转为显示0-360
+    hsv_display_sat = (config->sat * 100 + 127) / 255;  // 内部0-255转为显示0-100%，使用四舍五入
+    hsv_display_val = (config->val * 100 + 127) / 255;  // 内部0-255转为显示0-100%，使用四舍五入
+    rgb_saved = false;
+    return true;
+}
+
+/**
+ * @brief HSV调控 - 上下切换选中项，左右调节选中参数
+ * 使用固定步长1，由底层摇杆任务的长拉功能提供调节速度
+ */
+static MenuActivityResult rgb_hsv_event(const MenuEvent* event) {
+    MenuActivityResult result;
+    if (rgb_setting_common_event(event, &result)) {
+        return result;
+    }
+    
+    led_effect_config_t* config = kob_rgb_get_config();
+    switch (event->code) {
+        case MENU_OP_UP:
+            // 向上切换选中项
+            hsv_mode = (hsv_mode > 0) ? (hsv_mode - 1) : HSV_ADJUST_VAL;
+            break;
+        case MENU_OP_DOWN:
+            // 向下切换选中项
+            hsv_mode = (hsv_mode < HSV_ADJUST_VAL) ? (hsv_mode + 1) : HSV_ADJUST_HUE;
+            break;
+        case MENU_OP_LEFT:
+            // 减少选中参数的值，转换回内部值并设置
+            switch (hsv_mode) {
+                case HSV_ADJUST_HUE:
+                    hsv_display_hue = (hsv_display_hue > 1) ? (hsv_display_hue - 1) : (360 - (1 - hsv_display_hue - 1)); // 0-360度循环
+                    kob_rgb_matrix_set_hsv((hsv_display_hue * 255) / 360, config->sat, config->val);
                     break;
-                case MENU_OP_DOWN:
-                    // 减少1%的速度
-                    display_speed = (display_speed == 0) ? 0 : (display_speed - 1);
-                    // 转换回内部0-255值并设置
-                    config->speed = (display_speed * 255) / 100;
-                    kob_rgb_matrix_set_speed(config->speed);
+                case HSV_ADJUST_SAT:
+                    hsv_display_sat = (hsv_display_sat > 1) ? (hsv_display_sat - 1) : 0; // 0-100%
+                    kob_rgb_matrix_set_hsv(config->hue, (hsv_display_sat * 255) / 100, config->val);
                     break;
-                case MENU_OP_ENTER:
-                    // 保存选择并退出
-                    OLED_Clear();
-                    OLED_ShowString(44, 4, "Saved!", OLED_8X16_HALF);
-                    OLED_Update();
-                    vTaskDelay(500 / portTICK_PERIOD_MS);
-                    confirmed = true;
+                case HSV_ADJUST_VAL:
+                    hsv_display_val = (hsv_display_val > 1) ? (hsv_display_val - 1) : 0; // 0-100%
+                    kob_rgb_matrix_set_hsv(config->hue, config->sat, (hsv_display_val * 255) / 100);
                     break;
-                case MENU_OP_BACK:
-                    // 不保存退出
-                    confirmed = true;
+            }
+            break;
+        case MENU_OP_RIGHT:
+            // 增加选中参数的值，转换回内部值并设置
+            switch (hsv_mode) {
+                case HSV_ADJUST_HUE:
+                    hsv_display_hue = (hsv_display_hue + 1) % 361; // 0-360度
+                    kob_rgb_matrix_set_hsv((hsv_display_hue * 255) / 360, config->sat, config->val);
                     break;
-                default:
+                case HSV_ADJUST_SAT:
+                    hsv_display_sat = (hsv_display_sat + 1 > 100) ? 100 : (hsv_display_sat + 1); // 0-100%
+                    kob_rgb_matrix_set_hsv(config->hue, (hsv_display_sat * 255) / 100, config->val);
+                    break;
+                case HSV_ADJUST_VAL:
+                    hsv_display_val = (hsv_display_val + 1 > 100) ? 100 : (hsv_display_val + 1); // 0-100%
+                    kob_rgb_matrix_set_hsv(config->hue, config->sat, (hsv_display_val * 255) / 100);
                     break;
             }
-            
-            // 更新显示
-            if (op == MENU_OP_UP || op == MENU_OP_DOWN) {
-                sprintf(speed_str, "Speed: %d%%", display_speed);
-                OLED_Clear();
-                OLED_ShowString(10, 4, speed_str, OLED_6X8_HALF);
-                OLED_ShowString(10, 16, "Up: Increase 1%%", OLED_6X8_HALF);
-                OLED_ShowString(10, 24, "Down: Decrease 1%%", OLED_6X8_HALF);
-                OLED_Update();
-            }
-        }
+            break;
+        default:
+            break;
     }
     
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
+    // 除确认和返回外的摇杆操作都刷新显示
+    return MENU_ACTIVITY_REDRAW;
 }
 
 /**
- * @brief HSV调控统一函数
- * 集成色调(0-360)、饱和度(0-100%)和亮度(0-100%)の调节
+ * @brief HSV调控 - 显示三个参数和选中项标记
  */
-void menuActionRgbHsvAdjust(void) {
-    OLED_Clear();
-    
-    // 获取当前配置
-    led_effect_config_t* config = kob_rgb_get_config();
-    
-    // 定义HSV调节状态
-    typedef enum {
-        HSV_ADJUST_HUE,
-        HSV_ADJUST_SAT,
-        HSV_ADJUST_VAL
-    } HsvAdjustMode;
+static void rgb_hsv_render(void) {
+    if (rgb_saved) {
+        draw_saved(44);
+        return;
+    }
     
-    HsvAdjustMode currentMode = HSV_ADJUST_HUE;
+    // 使用display值而不是直接从config获取，确保显示值与用户调整的一致
     char hsv_str[3][30];
+    sprintf(hsv_str[0], "H: %d", hsv_display_hue);
+    sprintf(hsv_str[1], "S: %d%%", hsv_display_sat);
+    sprintf(hsv_str[2], "V: %d%%", hsv_display_val);
     
-    // 从内部值转换为标准显示值
-    uint16_t display_hue = (config->hue * 360) / 255; // 内部0-255转为显示0-360
-    uint8_t display_sat = (config->sat * 100 + 127) / 255;  // 内部0-255转为显示0-100%，使用四舍五入
-    uint8_t display_val = (config->val * 100 + 127) / 255;  // 内部0-255转为显示0-100%，使用四舍五入
-    
-    // 使用简洁标签缩短文本长度，避免超出屏幕
-    sprintf(hsv_str[0], "H: %d", display_hue);
-    sprintf(hsv_str[1], "S: %d%%", display_sat);
-    sprintf(hsv_str[2], "V: %d%%", display_val);
-    
+    OLED_Clear();
     // 考虑">"符号占用12个像素，设置适当的x坐标
     OLED_ShowString(12, 8, hsv_str[0], OLED_6X8_HALF);
     OLED_ShowString(12, 16, hsv_str[1], OLED_6X8_HALF);
     OLED_ShowString(12, 24, hsv_str[2], OLED_6X8_HALF);
-    OLED_ShowString(0, 8 + currentMode * 8, " >", OLED_6X8_HALF); // 显示选中项标记
-    
-    OLED_Update();
-    
-    // 等待用户输入
-    bool confirmed = false;
-    while (!confirmed) {
-        uint8_t op; // 直接使用uint8_t类型，与joystick_task中发送的数据类型匹配
-        uint8_t h, s, v; // 在条件外声明变量，确保在所有使用场景中都可用
-        if (xQueueReceive(get_joystick_queue(), &op, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-            // 使用固定步长1，由底层摇杆任务的长拉功能提供调节速度
-            
-            switch (op) {
-                case MENU_OP_UP:
-                    // 向上切换选中项
-                    currentMode = (currentMode > 0) ? (currentMode - 1) : HSV_ADJUST_VAL;
-                    break;
-                case MENU_OP_DOWN:
-                    // 向下切换选中项
-                    currentMode = (currentMode < HSV_ADJUST_VAL) ? (currentMode + 1) : HSV_ADJUST_HUE;
-                    break;
-                case MENU_OP_LEFT:
-                    // 减少选中参数的值
-                    switch (currentMode) {
-                        case HSV_ADJUST_HUE:
-                            // 处理显示值的调整，使用固定步长1
-                            display_hue = (display_hue > 1) ? (display_hue - 1) : (360 - (1 - display_hue - 1)); // 0-360度循环
-                            // 转换回内部值并设置
-                            h = (display_hue * 255) / 360;
-                            kob_rgb_matrix_set_hsv(h, config->sat, config->val);
-                            // 重新获取配置以确保一致性
-                            config = kob_rgb_get_config();
-                            break;
-                        case HSV_ADJUST_SAT:
-                            // 处理显示值的调整，使用固定步长1
-                            display_sat = (display_sat > 1) ? (display_sat - 1) : 0; // 0-100%
-                            // 转换回内部值并设置
-                            s = (display_sat * 255) / 100;
-                            kob_rgb_matrix_set_hsv(config->hue, s, config->val);
-                            // 重新获取配置以确保一致性
-                            config = kob_rgb_get_config();
-                            break;
-                        case HSV_ADJUST_VAL:
-                            // 处理显示值的调整，使用固定步长1
-                            display_val = (display_val > 1) ? (display_val - 1) : 0; // 0-100%
-                            // 转换回内部值并设置
-                            v = (display_val * 255) / 100;
-                            kob_rgb_matrix_set_hsv(config->hue, config->sat, v);
-                            // 重新获取配置以确保一致性
-                            config = kob_rgb_get_config();
-                            break;
-                    }
-                    break;
-                case MENU_OP_RIGHT:
-                    // 增加选中参数的值
-                    switch (currentMode) {
-                        case HSV_ADJUST_HUE:
-                            // 处理显示值的调整，使用固定步长1
-                            display_hue = (display_hue + 1) % 361; // 0-360度
-                            // 转换回内部值并设置
-                            h = (display_hue * 255) / 360;
-                            kob_rgb_matrix_set_hsv(h, config->sat, config->val);
-                            // 重新获取配置以确保一致性
-                            config = kob_rgb_get_config();
-                            break;
-                        case HSV_ADJUST_SAT:
-                            // 处理显示值的调整，使用固定步长1
-                            display_sat = (display_sat + 1 > 100) ? 100 : (display_sat + 1); // 0-100%
-                            // 转换回内部值并设置
-                            s = (display_sat * 255) / 100;
-                            kob_rgb_matrix_set_hsv(config->hue, s, config->val);
-                            // 重新获取配置以确保一致性
-                            config = kob_rgb_get_config();
-                            break;
-                        case HSV_ADJUST_VAL:
-                            // 处理显示值的调整，使用固定步长1
-                            display_val = (display_val + 1 > 100) ? 100 : (display_val + 1); // 0-100%
-                            // 转换回内部值并设置
-                            v = (display_val * 255) / 100;
-                            kob_rgb_matrix_set_hsv(config->hue, config->sat, v);
-                            // 重新获取配置以确保一致性
-                            config = kob_rgb_get_config();
-                            break;
-                    }
-                    break;
-                case MENU_OP_ENTER:
-                    // 保存选择并退出
-                    OLED_Clear();
-                    OLED_ShowString(44, 4, "Saved!", OLED_8X16_HALF);
-                    OLED_Update();
-                    vTaskDelay(500 / portTICK_PERIOD_MS);
-                    confirmed = true;
-                    break;
-                case MENU_OP_BACK:
-                    // 不保存退出
-                    confirmed = true;
-                    break;
-                default:
-                    break;
-            }
-            
-            // 更新显示
-            if (op != MENU_OP_ENTER && op != MENU_OP_BACK) {
-                // 使用display_hue/sat/val变量而不是直接从config获取，确保显示值与用户调整的一致
-                sprintf(hsv_str[0], "H: %d", display_hue);
-                sprintf(hsv_str[1], "S: %d%%", display_sat);
-                sprintf(hsv_str[2], "V: %d%%", display_val);
-                
-                OLED_Clear();
-                // 根据OLED_6X8_HALF字体的建议垂直布局设置y坐标
-                OLED_ShowString(12, 8, hsv_str[0], OLED_6X8_HALF);
-                OLED_ShowString(12, 16, hsv_str[1], OLED_6X8_HALF);
-                OLED_ShowString(12, 24, hsv_str[2], OLED_6X8_HALF);
-                OLED_ShowString(0, 8 + currentMode * 8, " >", OLED_6X8_HALF); // 显示选中项标记
-                OLED_Update();
-            }
-        }
-    }
-    
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
-}
\ No newline at end of file
+    OLED_ShowString(0, 8 + hsv_mode * 8, " >", OLED_6X8_HALF); // 显示选中项标记
+}
+
+const MenuActivity menuActivityRgbHsvAdjust = {
+    .on_enter  = rgb_hsv_enter,
+    .on_event  = rgb_hsv_event,
+    .on_render = rgb_hsv_render,
+    .on_exit   = NULL,
+};
@@ -17,164 +17,177 @@
 #include "wifi_app/wifi_app.h" // 访问WiFi功能接口
 
 // 从oled_menu_display.c获取的函数声明
-extern QueueHandle_t get_joystick_queue(void);
 extern MenuManager* get_menu_manager(void);
 
+// WiFi信息的总页数和自动刷新间隔
+#define WIFI_STATUS_TOTAL_PAGES     2
+#define WIFI_STATUS_REFRESH_MS      3000
+
+// 活动状态
+static uint8_t wifi_status_page = 0;      // WiFi信息当前页码
+static bool wifi_toggle_enable = false;   // WiFi开关切换的目标状态
+static esp_err_t wifi_toggle_result = ESP_OK; // WiFi开关切换结果
+static esp_err_t wifi_clear_result = ESP_OK;  // 清除WiFi密码结果
+
+/**
+ * @brief WiFi信息活动 - 进入时显示第一页，并启动自动刷新定时器
+ */
+static bool wifi_status_enter(void) {
+    wifi_status_page = 0;
+    MenuManager_SetActivityTimer(get_menu_manager(), WIFI_STATUS_REFRESH_MS);
+    return true;
+}
+
 /**
- * @brief 显示WiFi状态和详细信息（重构版，支持状态机模型）
+ * @brief WiFi信息活动 - 上下翻页，确认或返回退出，超时自动刷新
  */
-void menuActionWifiStatus(void) {
-    uint8_t page = 0;          // 当前页码
-    const uint8_t total_pages = 2; // 总页数
-    bool exit_flag = false;    // 退出标志位
+static MenuActivityResult wifi_status_event(const MenuEvent* event) {
+    if (event->type == MENU_EVENT_JOYSTICK) {
+        switch (event->code) {
+            case MENU_OP_UP:
+                // 上翻页（循环）
+                wifi_status_page = (wifi_status_page > 0) ? (wifi_status_page - 1) : (WIFI_STATUS_TOTAL_PAGES - 1);
+                break;
+            case MENU_OP_DOWN:
+                // 下翻页（循环）
+                wifi_status_page = (wifi_status_page < WIFI_STATUS_TOTAL_PAGES - 1) ? (wifi_status_page + 1) : 0;
+                break;
+            case MENU_OP_ENTER:
+            case MENU_OP_BACK:
+                // 退出显示
+                return MENU_ACTIVITY_EXIT;
+            default:
+                break;
+        }
+    } else if (event->type != MENU_EVENT_TIMER) {
+        return MENU_ACTIVITY_IDLE;
+    }
     
-    while (!exit_flag) {
-        OLED_Clear();
-        
-        // 获取WiFi状态结构体
-        extern wifi_state_t wifi_state;
-        
-        // 检查WiFi是否已启动（基于WiFi任务句柄和模式）
-        wifi_mode_t current_mode;
-        bool wifi_enabled = (wifi_state.wifi_task_handle != NULL) && 
-                           (esp_wifi_get_mode(&current_mode) == ESP_OK) && 
-                           (current_mode != WIFI_MODE_NULL);
-        
-        if (wifi_enabled) {
-            // 第一页：显示WiFi状态和模式
-            if (page == 0) {
-                // 标题栏
-                OLED_ShowString(30, 0, "WiFi Info", OLED_6X8_HALF);
-                
-                // 显示WiFi状态（基于连接状态）
-                char status_str[20];
-                if (wifi_is_connected()) {
-                    strcpy(status_str, "Status: Connected");
-                } else if (current_mode & WIFI_MODE_STA) {
-                    strcpy(status_str, "Status: Connecting");
-                } else if (current_mode & WIFI_MODE_APSTA) {
-                    strcpy(status_str, "Status: AP+STA");
-                } else {
-                    strcpy(status_str, "Status: Unknown");
-                }
-                OLED_ShowString(10, 9, status_str, OLED_6X8_HALF);
-                
-                // 显示WiFi模式（从底层获取）
-                wifi_mode_t mode;
-                char mode_str[20];
-                if (esp_wifi_get_mode(&mode) == ESP_OK) {
-                    if (mode == WIFI_MODE_STA) {
-                        strcpy(mode_str, "Mode: STA");
-                    } else if (mode == WIFI_MODE_APSTA) {
-                        strcpy(mode_str, "Mode: AP+STA");
-                    } else {
-                        strcpy(mode_str, "Mode: Unknown");
-                    }
-                } else {
-                    strcpy(mode_str, "Mode: Error");
-                }
-                OLED_ShowString(10, 17, mode_str, OLED_6X8_HALF);
+    // 有摇杆操作或3秒超时都刷新显示，并重新开始计时
+    MenuManager_SetActivityTimer(get_menu_manager(), WIFI_STATUS_REFRESH_MS);
+    return MENU_ACTIVITY_REDRAW;
+}
+
+/**
+ * @brief 显示WiFi状态和详细信息（支持摇杆翻页查看）
+ */
+static void wifi_status_render(void) {
+    OLED_Clear();
+    
+    // 获取WiFi状态结构体
+    extern wifi_state_t wifi_state;
+    
+    // 检查WiFi是否已启动（基于WiFi任务句柄和模式）
+    wifi_mode_t current_mode;
+    bool wifi_enabled = (wifi_state.wifi_task_handle != NULL) && 
+                       (esp_wifi_get_mode(&current_mode) == ESP_OK) && 
+                       (current_mode != WIFI_MODE_NULL);
+    
+    if (wifi_enabled) {
+        // 第一页：显示WiFi状态和模式
+        if (wifi_status_page == 0) {
+            // 标题栏
+            OLED_ShowString(30, 0, "WiFi Info", OLED_6X8_HALF);
+            
+            // 显示WiFi状态（基于连接状态）
+            char status_str[20];
+            if (wifi_is_connected()) {
+                strcpy(status_str, "Status: Connected");
+            } else if (current_mode & WIFI_MODE_STA) {
+                strcpy(status_str, "Status: Connecting");
+            } else if (current_mode & WIFI_MODE_APSTA) {
+                strcpy(status_str, "Status: AP+STA");
+            } else {
+                strcpy(status_str, "Status: Unknown");
             }
-            // 第二页：显示连接状态和详细信息
-            else if (page == 1) {
-                // 标题栏
-                OLED_ShowString(30, 0, "WiFi Info", OLED_6X8_HALF);
-                
-                // 显示连接状态
-                if (wifi_is_connected()) {
-                    OLED_ShowString(10, 9, "Connected", OLED_6X8_HALF);
-                } else {
-                    OLED_ShowString(10, 9, "Disconnected", OLED_6X8_HALF);
-                }
-                
-                uint8_t ip_y_position = 17; // 默认IP地址位置
-                
-                // 显示当前IP地址
-                OLED_ShowString(10, ip_y_position, "IP:", OLED_6X8_HALF);
-                if (strlen(wifi_state.client_ip) > 0) {
-                    OLED_ShowString(22, ip_y_position, wifi_state.client_ip, OLED_6X8_HALF);
+            OLED_ShowString(10, 9, status_str, OLED_6X8_HALF);
+            
+            // 显示WiFi模式（从底层获取）
+            wifi_mode_t mode;
+            char mode_str[20];
+            if (esp_wifi_get_mode(&mode) == ESP_OK) {
+                if (mode == WIFI_MODE_STA) {
+                    strcpy(mode_str, "Mode: STA");
+                } else if (mode == WIFI_MODE_APSTA) {
+                    strcpy(mode_str, "Mode: AP+STA");
                 } else {
-                    OLED_ShowString(22, ip_y_position, "0.0.0.0", OLED_6X8_HALF);
+                    strcpy(mode_str, "Mode: Unknown");
                 }
+            } else {
+                strcpy(mode_str, "Mode: Error");
             }
-        } else {
-            // WiFi未启用时显示简单信息
-            OLED_ShowString(30, 0, "WiFi Info", OLED_6X8_HALF);
-            OLED_ShowString(10, 18, "WiFi is Off", OLED_6X8_HALF);
-        }
-        
-        // 显示翻页提示（如果有多页）
-        if (total_pages > 1) {
-            char page_info[10];
-            sprintf(page_info, "%d/%d", page + 1, total_pages);
-            OLED_ShowString(95, 0, page_info, OLED_6X8_HALF);
+            OLED_ShowString(10, 17, mode_str, OLED_6X8_HALF);
         }
-        
-        OLED_Update();
-        
-        // 等待摇杆操作或超时（3秒）
-        uint8_t key_event = 0;
-        TickType_t start_time = xTaskGetTickCount();
-        const TickType_t timeout = 3000 / portTICK_PERIOD_MS;
-        
-        while ((xTaskGetTickCount() - start_time) < timeout) {
-            if (xQueueReceive(get_joystick_queue(), &key_event, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-                switch (key_event) {
-                    case MENU_OP_UP:
-                        // 上翻页（循环）
-                        page = (page > 0) ? (page - 1) : (total_pages - 1);
-                        break;
-                    case MENU_OP_DOWN:
-                        // 下翻页（循环）
-                        page = (page < total_pages - 1) ? (page + 1) : 0;
-                        break;
-                    case MENU_OP_ENTER:
-                    case MENU_OP_BACK:
-                        // 退出显示
-                        exit_flag = true;
-                        break;
-                    default:
-                        break;
-                }
-                break; // 有按键事件，跳出循环刷新显示
+        // 第二页：显示连接状态和详细信息
+        else if (wifi_status_page == 1) {
+            // 标题栏
+            OLED_ShowString(30, 0, "WiFi Info", OLED_6X8_HALF);
+            
+            // 显示连接状态
+            if (wifi_is_connected()) {
+                OLED_ShowString(10, 9, "Connected", OLED_6X8_HALF);
+            } else {
+                OLED_ShowString(10, 9, "Disconnected", OLED_6X8_HALF);
+            }
+            
+            uint8_t ip_y_position = 17; // 默认IP地址位置
+            
+            // 显示当前IP地址
+            OLED_ShowString(10, ip_y_position, "IP:", OLED_6X8_HALF);
+            if (strlen(wifi_state.client_ip) > 0) {
+                OLED_ShowString(22, ip_y_position, wifi_state.client_ip, OLED_6X8_HALF);
+            } else {
+                OLED_ShowString(22, ip_y_position, "0.0.0.0", OLED_6X8_HALF);
             }
         }
+    } else {
+        // WiFi未启用时显示简单信息
+        OLED_ShowString(30, 0, "WiFi Info", OLED_6X8_HALF);
+        OLED_ShowString(10, 18, "WiFi is Off", OLED_6X8_HALF);
     }
     
-    // 返回到主菜单
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
+    // 显示翻页提示（如果有多页）
+    if (WIFI_STATUS_TOTAL_PAGES > 1) {
+        char page_info[10];
+        sprintf(page_info, "%d/%d", wifi_status_page + 1, WIFI_STATUS_TOTAL_PAGES);
+        OLED_ShowString(95, 0, page_info, OLED_6X8_HALF);
+    }
 }
 
+const MenuActivity menuActivityWifiStatus = {
+    .on_enter  = wifi_status_enter,
+    .on_event  = wifi_status_event,
+    .on_render = wifi_status_render,
+    .on_exit   = NULL,
+};
+
 /**
  * @brief 切换WiFi开关状态（使用WiFi总开关函数，与初始化管理器保持一致）
  */
-void menuActionWifiToggle(void) {
-    OLED_Clear();
-    
+static bool wifi_toggle_enter(void) {
     // 获取WiFi状态结构体
     extern wifi_state_t wifi_state;
     
-    // 优化状态判断逻辑：基于NVS中保存的持久化状态
-    bool enable_wifi;
-    
-    // 检查WiFi任务是否正在运行
-    if (wifi_state.wifi_task_handle != NULL) {
-        // WiFi任务正在运行，说明WiFi已启用
-        enable_wifi = false;  // 禁用WiFi
-    } else {
-        // WiFi任务未运行，说明WiFi已禁用
-        enable_wifi = true;   // 启用WiFi
-    }
+    // 检查WiFi任务是否正在运行：正在运行说明WiFi已启用，切换为禁用，反之启用
+    wifi_toggle_enable = (wifi_state.wifi_task_handle == NULL);
     
     // 切换WiFi状态 - 使用与初始化管理器相同的WiFi总开关函数
-    esp_err_t result;
-    result = wifi_station_change(enable_wifi);
+    wifi_toggle_result = wifi_station_change(wifi_toggle_enable);
     
-    // 显示切换结果
+    // 切换结果显示1秒后返回菜单
+    MenuManager_SetActivityTimer(get_menu_manager(), 1000);
+    return true;
+}
+
+/**
+ * @brief 显示WiFi开关切换结果
+ */
+static void wifi_toggle_render(void) {
+    OLED_Clear();
     OLED_ShowString(30, 0, "WiFi Toggle", OLED_6X8_HALF);
     
-    if (result == ESP_OK) {
-        if (enable_wifi) {
+    if (wifi_toggle_result == ESP_OK) {
+        if (wifi_toggle_enable) {
             OLED_ShowString(10, 18, "WiFi Enabled", OLED_6X8_HALF);
         } else {
             OLED_ShowString(10, 18, "WiFi Disabled", OLED_6X8_HALF);
@@ -182,19 +195,28 @@ void menuActionWifiToggle(void) {
     } else {
         OLED_ShowString(10, 18, "Toggle Failed", OLED_6X8_HALF);
     }
-    
-    OLED_Update();
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
-    
-    // 返回到主菜单
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
+}
+
+const MenuActivity menuActivityWifiToggle = {
+    .on_enter  = wifi_toggle_enter,
+    .on_event  = MenuActivity_ExitOnTimer,
+    .on_render = wifi_toggle_render,
+    .on_exit   = NULL,
+};
+
+/**
+ * @brief HTML网址活动 - 显示2秒后返回菜单
+ */
+static bool html_url_enter(void) {
+    MenuManager_SetActivityTimer(get_menu_manager(), 2000);
+    return true;
 }
 
 /**
  * @brief 显示HTML服务器访问网址
  *        显示设备的IP地址和端口号，用于在浏览器中访问设备的Web界面
  */
-void menuActionHtmlUrl(void) {
+static void html_url_render(void) {
     OLED_Clear();
     
     // 标题栏
@@ -234,38 +256,49 @@ void menuActionHtmlUrl(void) {
         // WiFi未开启
         OLED_ShowString(10, 10, "WiFi is Off", OLED_8X16_HALF);
     }
-    
-    OLED_Update();
-    vTaskDelay(2000 / portTICK_PERIOD_MS);
-    
-    // 返回到主菜单
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
 }
 
+const MenuActivity menuActivityHtmlUrl = {
+    .on_enter  = html_url_enter,
+    .on_event  = MenuActivity_ExitOnTimer,
+    .on_render = html_url_render,
+    .on_exit   = NULL,
+};
+
 /**
  * @brief 清除WiFi密码配置
  *        清除保存的WiFi连接信息，并将WiFi模式设置为APSTA模式
  */
-void menuActionClearWifiPassword(void) {
+static bool clear_wifi_password_enter(void) {
+    // 调用WiFi接口清除WiFi密码
+    wifi_clear_result = wifi_clear_password();
+    
+    // 操作结果显示2秒后返回菜单
+    MenuManager_SetActivityTimer(get_menu_manager(), 2000);
+    return true;
+}
+
+/**
+ * @brief 显示清除WiFi密码的结果
+ */
+static void clear_wifi_password_render(void) {
     OLED_Clear();
     
     // 显示操作标题
     OLED_ShowString(10, 8, "Clear WiFi PW", OLED_6X8_HALF);
     
-    // 调用WiFi接口清除WiFi密码
-    esp_err_t err = wifi_clear_password();
-    
     // 显示操作结果
-    if (err == ESP_OK) {
+    if (wifi_clear_result == ESP_OK) {
         OLED_ShowString(10, 16, "Success", OLED_6X8_HALF);
         OLED_ShowString(10, 24, "APSTA Mode", OLED_6X8_HALF);
     } else {
         OLED_ShowString(10, 16, "Failed", OLED_6X8_HALF);
     }
-    
-    OLED_Update();
-    vTaskDelay(2000 / portTICK_PERIOD_MS);
-    
-    // 返回到主菜单
-    MenuManager_DisplayMenu(get_menu_manager(), 0, 0, OLED_8X16_HALF);
-}
\ No newline at end of file
+}
+
+const MenuActivity menuActivityClearWifiPassword = {
+    .on_enter  = clear_wifi_password_enter,
+    .on_event  = MenuActivity_ExitOnTimer,
+    .on_render = clear_wifi_password_render,
+    .on_exit   = NULL,
+};
@@ -3,6 +3,7 @@
  * 在此文件当中，部分是b站up江协科技的函数，在此诚挚感谢。
 */
 #include "OLED.h"
+#include "OLED_Blit.h"
 /**
   * 声明OLED显存数组，此数组已经在OLED_Driver.c中定义
   * 所有的显示函数，都只是对此显存数组进行读写
@@ -89,34 +90,264 @@ float numabs(float num){
 	return 0;
 }
 
+/**
+  * 角度门限表：第k项为角度门限k*3.14/180弧度的余弦和正弦，Q30定点数，k=0~180
+  * 原实现用atan2(Y, X) / 3.14 * 180计算点的角度并截断为整数，
+  * "截断后的角度 >= k"等价于"点的弧度 >= k*3.14/180"，
+  * 因此只需用叉积比较点与门限方向的先后，即可得到与浮点实现完全相同的判断结果
+  */
+static const int32_t OLED_AngleCos[181] = {
+	1073741824, 1073578454, 1073088392, 1072271789, 1071128893, 1069660051, 1067865711, 1065746418,
+	1063302817, 1060535653, 1057445766, 1054034098, 1050301686, 1046249667, 1041879272, 1037191833,
+	1032188776, 1026871622, 1021241991, 1015301594, 1009052240, 1002495831, 995634362, 988469920,
+	981004685, 973240930, 965181017, 956827398, 948182616, 939249301, 930030172, 920528034,
+	910745778, 900686381, 890352905, 879748493, 868876373, 857739854, 846342323, 834687249,
+	822778179, 810618738, 798212624, 785563613, 772675555, 759552370, 746198054, 732616668,
+	718812347, 704789290, 690551765, 676104105, 661450705, 646596026, 631544587, 616300968,
+	600869808, 585255803, 569463704, 553498317, 537364499, 521067161, 504611262, 488001810,
+	471243858, 454342506, 437302897, 420130216, 402829689, 385406581, 367866194, 350213864,
+	332454964, 314594898, 296639100, 278593034, 260462193, 242252092, 223968274, 205616302,
+	187201761, 168730255, 150207403, 131638844, 113030226, 94387213, 75715478, 57020703,
+	38308577, 19584793, 855049, -17874954, -36599519, -55312946, -74009541, -92683616,
+	-111329486, -129941479, -148513930, -167041189, -185517617, -203937591, -222295508, -240585779,
+	-258802840, -276941147, -294995181, -312959447, -330828479, -348596841, -366259123, -383809953,
+	-401243989, -418555926, -435740496, -452792470, -469706659, -486477915, -503101136, -519571263,
+	-535883284, -552032235, -568013202, -583821322, -599451784, -614899833, -630160768, -645229943,
+	-660102775, -674774737, -689241365, -703498255, -717541071, -731365537, -744967449, -758342667,
+	-771487120, -784396809, -797067805, -809496253, -821678370, -833610450, -845288861, -856710050,
+	-867870542, -878766939, -889395927, -899754272, -909838820, -919646503, -929174337, -938419422,
+	-947378946, -956050181, -964430489, -972517320, -980308213, -987800798, -994992794, -1001882012,
+	-1008466357, -1014743825, -1020712505, -1026370581, -1031716332, -1036748131, -1041464446, -1045863843,
+	-1049944982, -1053706623, -1057147619, -1060266924, -1063063589, -1065536763, -1067685693, -1069509725,
+	-1071008305, -1072180975, -1073027380, -1073547262, -1073740462,
+};
+static const int32_t OLED_AngleSin[181] = {
+	0, 18729880, 37454060, 56166843, 74862534, 93535444, 112179892, 130790203,
+	149360714, 167885775, 186359748, 204777012, 223131962, 241419012, 259632599, 277767179,
+	295817234, 313777272, 331641827, 349405463, 367062775, 384608389, 402036967, 419343204,
+	436521835, 453567632, 470475407, 487240017, 503856359, 520319377, 536624062, 552765451,
+	568738633, 584538748, 600160986, 615600596, 630852877, 645913189, 660776950, 675439635,
+	689896784, 704143996, 718176936, 731991335, 745582988, 758947759, 772081582, 784980460,
+	797640467, 810057752, 822228535, 834149114, 845815860, 857225224, 868373733, 879257995,
+	889874698, 900220612, 910292587, 920087560, 929602549, 938834659, 947781081, 956439093,
+	964806059, 972879434, 980656760, 988135672, 995313893, 1002189239, 1008759619, 1015023031,
+	1020977571, 1026621427, 1031952881, 1036970311, 1041672190, 1046057087, 1050123667, 1053870695,
+	1057297028, 1060401625, 1063183540, 1065641928, 1067776040, 1069585227, 1071068938, 1072226722,
+	1073058227, 1073563198, 1073741484, 1073593028, 1073117878, 1072316177, 1071188169, 1069734197,
+	1067954704, 1065850232, 1063421420, 1060669009, 1057593834, 1054196833, 1050479039, 1046441583,
+	1042085694, 1037412698, 1032424016, 1027121166, 1021505762, 1015579513, 1009344222, 1002801787,
+	995954199, 988803540, 981351988, 973601810, 965555363, 957215097, 948583550, 939663348,
+	930457205, 920967924, 911198391, 901151579, 890830547, 880238433, 869378463, 858253939,
+	846868249, 835224855, 823327302, 811179209, 798784274, 786146268, 773269037, 760156500,
+	746812646, 733241537, 719447301, 705434137, 691206309, 676768146, 662124041, 647278452,
+	632235896, 617000949, 601578248, 585972487, 570188414, 554230831, 538104596, 521814615,
+	505365846, 488763293, 472012009, 455117091, 438083681, 420916962, 403622157, 386204529,
+	368669379, 351022043, 333267890, 315412324, 297460777, 279418713, 261291621, 243085019,
+	224804445, 206455463, 188043656, 169574627, 151053997, 132487401, 113880489, 95238923,
+	76568375, 57874528, 39163070, 20439694, 1710098,
+};
+
+/**
+  * 函    数：判断上半平面内的点的弧度是否不小于第K个角度门限
+  * 参    数：X Y 指定点的坐标，Y >= 0，且不能为原点
+  * 参    数：K 角度门限序号，范围：0~180
+  * 返 回 值：1：点的弧度 >= K*3.14/180，0：小于
+  */
+static uint8_t OLED_AngleReaches(int16_t X, int16_t Y, int16_t K)
+{
+	/*点与门限方向都在上半平面，叉积非负即点在门限方向的逆时针一侧*/
+	return (int64_t)OLED_AngleCos[K] * Y - (int64_t)OLED_AngleSin[K] * X >= 0;
+}
+
+/**
+  * 函    数：判断指定点的整数角度是否不小于指定角度
+  * 参    数：X Y 指定点的坐标
+  * 参    数：Angle 指定角度，范围：-180~180
+  * 返 回 值：1：不小于，0：小于
+  */
+static uint8_t OLED_AngleAtLeast(int16_t X, int16_t Y, int16_t Angle)
+{
+	if (X == 0 && Y == 0) {return 0 >= Angle;}	//原点的角度为0
+	if (Y >= 0)			//上半平面，点的角度为0~180
+	{
+		if (Angle <= 0) {return 1;}
+		if (Angle > 180) {return 0;}
+		return OLED_AngleReaches(X, Y, Angle);
+	}
+	/*下半平面，点的角度为关于X轴对称点角度的相反数*/
+	if (Angle > 0) {return 0;}
+	if (1 - Angle > 180) {return 1;}
+	return !OLED_AngleReaches(X, -Y, 1 - Angle);
+}
+
+/**
+  * 函    数：判断指定点的整数角度是否不大于指定角度
+  * 参    数：X Y 指定点的坐标
+  * 参    数：Angle 指定角度，范围：-180~180
+  * 返 回 值：1：不大于，0：大于
+  */
+static uint8_t OLED_AngleAtMost(int16_t X, int16_t Y, int16_t Angle)
+{
+	if (X == 0 && Y == 0) {return 0 <= Angle;}	//原点的角度为0
+	if (Y >= 0)			//上半平面，点的角度为0~180
+	{
+		if (Angle < 0) {return 0;}
+		if (Angle + 1 > 180) {return 1;}
+		return !OLED_AngleReaches(X, Y, Angle + 1);
+	}
+	/*下半平面，点的角度为关于X轴对称点角度的相反数*/
+	if (Angle >= 0) {return 1;}
+	if (-Angle > 180) {return 0;}
+	return OLED_AngleReaches(X, -Y, -Angle);
+}
+
 /**
   * 函    数：判断指定点是否在指定角度内部
   * 参    数：X Y 指定点的坐标
   * 参    数：StartAngle EndAngle 起始角度和终止角度，范围：-180~180
   *           水平向右为0度，水平向左为180度或-180度，下方为正数，上方为负数，顺时针旋转
   * 返 回 值：指定点是否在指定角度内部，1：在内部，0：不在内部
+  * 说    明：使用角度门限表和整数叉积判断，不再逐点计算atan2
   */
 uint8_t OLED_IsInAngle(int16_t X, int16_t Y, int16_t StartAngle, int16_t EndAngle)
 {
-	int16_t PointAngle;
-	PointAngle = atan2(Y, X) / 3.14 * 180;	//计算指定点的弧度，并转换为角度表示
 	if (StartAngle < EndAngle)	//起始角度小于终止角度的情况
 	{
 		/*如果指定角度在起始终止角度之间，则判定指定点在指定角度*/
-		if (PointAngle >= StartAngle && PointAngle <= EndAngle)
-		{
-			return 1;
-		}
+		return OLED_AngleAtLeast(X, Y, StartAngle) && OLED_AngleAtMost(X, Y, EndAngle);
 	}
 	else			//起始角度大于于终止角度的情况
 	{
 		/*如果指定角度大于起始角度或者小于终止角度，则判定指定点在指定角度*/
-		if (PointAngle >= StartAngle || PointAngle <= EndAngle)
+		return OLED_AngleAtLeast(X, Y, StartAngle) || OLED_AngleAtMost(X, Y, EndAngle);
+	}
+}
+
+/**
+  * 图形填充画布：每列用一个32位掩码记录该列32行中需要点亮的像素
+  * 圆、椭圆、圆弧和三角形先把轮廓点和填充线段累积到画布上，
+  * 画完后由OLED_SpanCommit按列一次性写入显存，每列每页只写一个字节
+  */
+#if OLED_HEIGHT > 32
+#error "OLED_SpanCanvas uses one 32-bit mask per column"
+#endif
+static uint32_t OLED_SpanCanvas[OLED_WIDTH];
+static int16_t OLED_SpanX0 = OLED_WIDTH, OLED_SpanX1 = 0;	//画布中被修改过的列范围[X0, X1)
+
+/**
+  * 函    数：在画布上画一个点
+  * 参    数：X Y 指定点的坐标，超出屏幕时忽略
+  */
+static inline void OLED_SpanPoint(int16_t X, int16_t Y)
+{
+	if (X < 0 || Y < 0 || X > OLED_WIDTH - 1 || Y > OLED_HEIGHT - 1) {return;}
+	OLED_SpanCanvas[X] |= 1u << Y;
+	if (X < OLED_SpanX0) {OLED_SpanX0 = X;}
+	if (X >= OLED_SpanX1) {OLED_SpanX1 = X + 1;}
+}
+
+/**
+  * 函    数：在画布上画一段竖线
+  * 参    数：X 列的横坐标
+  * 参    数：Y 竖线起始纵坐标
+  * 参    数：Height 竖线长度，小于等于0时不画
+  * 说    明：超出屏幕的部分自动裁剪，整段竖线只需一次掩码运算
+  */
+static void OLED_FillVSpan(int16_t X, int16_t Y, int16_t Height)
+{
+	int16_t y0 = (Y < 0) ? 0 : Y;
+	int16_t y1 = (Y + Height > OLED_HEIGHT) ? OLED_HEIGHT : Y + Height;
+	if (X < 0 || X > OLED_WIDTH - 1 || y0 >= y1) {return;}
+	
+	uint32_t mask = (y1 - y0 >= 32) ? 0xFFFFFFFFu : ((1u << (y1 - y0)) - 1);
+	OLED_SpanCanvas[X] |= mask << y0;
+	if (X < OLED_SpanX0) {OLED_SpanX0 = X;}
+	if (X >= OLED_SpanX1) {OLED_SpanX1 = X + 1;}
+}
+
+/**
+  * 函    数：在画布上画一段横线
+  * 参    数：X 横线起始横坐标
+  * 参    数：Y 行的纵坐标
+  * 参    数：Width 横线长度，小于等于0时不画
+  */
+static void OLED_FillHSpan(int16_t X, int16_t Y, int16_t Width)
+{
+	int16_t x0 = (X < 0) ? 0 : X;
+	int16_t x1 = (X + Width > OLED_WIDTH) ? OLED_WIDTH : X + Width;
+	if (Y < 0 || Y > OLED_HEIGHT - 1 || x0 >= x1) {return;}
+	
+	for (int16_t x = x0; x < x1; x ++)
+	{
+		OLED_SpanCanvas[x] |= 1u << Y;
+	}
+	if (x0 < OLED_SpanX0) {OLED_SpanX0 = x0;}
+	if (x1 > OLED_SpanX1) {OLED_SpanX1 = x1;}
+}
+
+/**
+  * 函    数：把画布内容写入显存并清空画布
+  * 说    明：只处理被修改过的列，每列每页一次按字节置位
+  */
+static void OLED_SpanCommit(void)
+{
+	for (int16_t x = OLED_SpanX0; x < OLED_SpanX1; x ++)
+	{
+		uint32_t mask = OLED_SpanCanvas[x];
+		if (mask == 0) {continue;}
+		for (uint8_t page = 0; page < OLED_HEIGHT / 8; page ++)
 		{
-			return 1;
+			OLED_DisplayBuf[page][x] |= (uint8_t)(mask >> (page * 8));
 		}
+		OLED_SpanCanvas[x] = 0;
+	}
+	OLED_SpanX0 = OLED_WIDTH;
+	OLED_SpanX1 = 0;
+}
+
+/**
+  * 扇形填充时每个屏幕列需要判断的纵向范围[-h, h)，h取该列所有填充线段的最大值
+  * 圆弧算法中同一列会被多次填充，先汇总范围，每个点只做一次角度判断
+  */
+static int16_t OLED_ArcHalfHeight[OLED_WIDTH];
+
+/**
+  * 函    数：记录扇形某一列的填充范围
+  * 参    数：X 列的横坐标（屏幕坐标）
+  * 参    数：Half 该列相对圆心的纵向范围为[-Half, Half)
+  */
+static void OLED_ArcExtendColumn(int16_t X, int16_t Half)
+{
+	if (X < 0 || X > OLED_WIDTH - 1) {return;}
+	if (Half > OLED_ArcHalfHeight[X]) {OLED_ArcHalfHeight[X] = Half;}
+}
+
+/**
+  * 函    数：按记录的各列范围填充扇形
+  * 参    数：X Y 圆心坐标
+  * 参    数：StartAngle EndAngle 扇形的起始角度和终止角度
+  * 说    明：只判断屏幕内的点，判断完成后清空记录
+  */
+static void OLED_ArcFillColumns(int16_t X, int16_t Y, int16_t StartAngle, int16_t EndAngle)
+{
+	for (int16_t x = 0; x < OLED_WIDTH; x ++)
+	{
+		int16_t half = OLED_ArcHalfHeight[x];
+		if (half <= 0) {continue;}
+		OLED_ArcHalfHeight[x] = 0;
+		
+		int16_t j0 = (-half < -Y) ? -Y : -half;
+		int16_t j1 = (half > OLED_HEIGHT - Y) ? OLED_HEIGHT - Y : half;
+		for (int16_t j = j0; j < j1; j ++)
+		{
+			if (OLED_IsInAngle(x - X, j, StartAngle, EndAngle))
+			{
+				OLED_SpanCanvas[x] |= 1u << (Y + j);
+			}
+		}
+		if (x < OLED_SpanX0) {OLED_SpanX0 = x;}
+		if (x >= OLED_SpanX1) {OLED_SpanX1 = x + 1;}
 	}
-	return 0;		//不满足以上条件，则判断判定指定点不在指定角度
 }
 /*********************工具函数↑********************/
 
@@ -141,35 +372,16 @@ void OLED_Clear(void)
   * 说    明：调用此函数后，要想真正地呈现在屏幕上，还需调用更新函数
   */
  
-  void OLED_ClearArea(int16_t X, int16_t Y, int16_t Width, int16_t Height)
-  {
-	  int16_t x_start, y_start, x_end, y_end;
-	  int16_t i, j;
-  
-	  if (Width <= 0 || Height <= 0) return;
-  
-	  // 计算X方向的起始和结束位置
-	  x_start = (X < 0) ? 0 : X;
-	  x_end = X + Width;
-	  if (x_end > OLED_WIDTH) x_end = OLED_WIDTH;
-	  if (x_start >= x_end) return;
-  
-	  // 计算Y方向的起始和结束位置
-	  y_start = (Y < 0) ? 0 : Y;
-	  y_end = Y + Height;
-	  if (y_end > OLED_HEIGHT) y_end = OLED_HEIGHT;
-	  if (y_start >= y_end) return;
-  
-	  // 调整Width和Height为实际需要清除的区域
-	  Width = x_end - x_start;
-	  Height = y_end - y_start;
-  
-	  for (j = y_start; j < y_end; j++) {
-		  for (i = x_start; i < x_end; i++) {
-			  OLED_DisplayBuf[j / 8][i] &= ~(0x01 << (j % 8));
-		  }
-	  }
-  }
+void OLED_ClearArea(int16_t X, int16_t Y, int16_t Width, int16_t Height)
+{
+	OLED_ClipRect_t clip;
+	
+	/*计算指定区域与屏幕的交集，交集为空则不处理*/
+	if (!OLED_Blit_ClipInit(&clip, X, Y, Width, Height)) {return;}
+	
+	/*将交集内的像素清零*/
+	OLED_Blit_FillRect(&clip, OLED_BLIT_ANDNOT);
+}
 
 /**
   * 函    数：将OLED显存数组全部取反
@@ -179,14 +391,9 @@ void OLED_Clear(void)
   */
 void OLED_Reverse(void)
 {
-	uint8_t i, j;
-	for (j = 0; j < OLED_HEIGHT/8; j ++)				//遍历页
-	{
-		for (i = 0; i < OLED_WIDTH; i ++)			//遍历OLED_WIDTH列
-		{
-			OLED_DisplayBuf[j][i] ^= 0xFF;	//将显存数组数据全部取反
-		}
-	}
+	OLED_ClipRect_t clip;
+	OLED_Blit_ClipInit(&clip, 0, 0, OLED_WIDTH, OLED_HEIGHT);
+	OLED_Blit_FillRect(&clip, OLED_BLIT_XOR);	//将显存数组数据全部取反
 }
 
 /**
@@ -200,25 +407,13 @@ void OLED_Reverse(void)
   */
 void OLED_ReverseArea(int16_t X, int16_t Y, int16_t Width, int16_t Height)
 {
-	int16_t i, j, x, y;
-	if(Width <= 0 || Height <= 0) {return; }
+	OLED_ClipRect_t clip;
+	
 	/*参数检查，保证指定区域不会超出屏幕范围*/
-	if (X > OLED_WIDTH-1) {return;}
-	if (Y > OLED_HEIGHT-1) {return;}
-	if (X + Width > OLED_WIDTH) {Width = OLED_WIDTH - X;}
-	if (Y + Height > OLED_HEIGHT) {Height = OLED_HEIGHT - Y;}
-	if (X + Width < 0) {return;}
-	if (Y + Height < 0) {return;}
-	if (X < 0) { x = 0;} else { x = X;}
-	if (Y < 0) { y = 0;} else { y = Y;}
+	if (!OLED_Blit_ClipInit(&clip, X, Y, Width, Height)) {return;}
 	
-	for (j = y; j < Y + Height; j ++)		//遍历指定页
-	{
-		for (i = x; i < X + Width; i ++)	//遍历指定列
-		{
-			OLED_DisplayBuf[j / 8][i] ^= 0x01 << (j % 8);	//将显存数组指定数据取反
-		}
-	}
+	/*将显存数组指定区域取反*/
+	OLED_Blit_FillRect(&clip, OLED_BLIT_XOR);
 }
 
 /**
@@ -233,58 +428,25 @@ void OLED_ReverseArea(int16_t X, int16_t Y, int16_t Width, int16_t Height)
   */
 void OLED_ShowImage(int16_t X, int16_t Y, uint16_t Width, uint16_t Height, const uint8_t *Image)
 {
-      uint8_t i, j;
-    
-    /* 参数检查，保证指定图像不会超出屏幕范围 */
-    if (Width == 0 || Height == 0) {
-        return; // 如果宽度或高度为0，直接返回
-    }
-    
-    if (X > OLED_WIDTH-1) {
-        return; // X 超出右边界，直接返回
-    }
-    if (Y > OLED_HEIGHT-1) {
-        return; // Y 超出下边界，直接返回
-    }
-    
-    /* 将图像所在区域清空 */
-    uint8_t startX = (X < 0) ? 0 : X; // 计算实际起始显示位置的 X 坐标
-    uint8_t startY = (Y < 0) ? 0 : Y; // 计算实际起始显示位置的 Y 坐标
-    uint8_t endX = (X + Width - 1 > OLED_WIDTH-1) ? OLED_WIDTH-1 : X + Width - 1; // 计算实际结束显示位置的 X 坐标
-    uint8_t endY = (Y + Height - 1 > OLED_HEIGHT-1) ? OLED_HEIGHT-1 : Y + Height - 1; // 计算实际结束显示位置的 Y 坐标
-    
-    OLED_ClearArea(startX, startY, endX - startX + 1, endY - startY + 1);
-    
-    /* 遍历指定图像涉及的相关页 */
-    for (j = 0; j < (Height - 1) / 8 + 1; j++)
-    {
-        /* 遍历指定图像涉及的相关列 */
-        for (i = 0; i < Width; i++)
-        {
-            int16_t currX = X + i;
-            int16_t currY = Y + j * 8;
-            
-            /* 超出边界，则跳过显示 */
-            if (currX < 0 || currX > OLED_WIDTH-1 ||currY < 0 || currY > OLED_HEIGHT-1) {
-                continue;
-            }
-			/* 显示图像在当前页的内容 */
-			OLED_DisplayBuf[currY / 8][currX] |= Image[j * Width + i] << (currY % 8);
-			/* 当前页下一页 */
-			if (currY + 8 <= OLED_HEIGHT-1) {
-				OLED_DisplayBuf[currY / 8 + 1][currX] |= Image[j * Width + i] >> (8 - currY % 8);
-			}
-        }
-    }
-	if(Y<0){
-		for (i = 0; i < Width; i++)
-        {
-            int16_t currX = X + i;
-			if (currX < 0 || currX > OLED_WIDTH-1) {
-                continue;
-            }
-			OLED_DisplayBuf[0][currX] |= Image[ -Y/8*Width+i] >> -Y%8;
-		}
+	OLED_ClipRect_t clip;
+	
+	/*参数检查，保证指定图像不会超出屏幕范围，完全在屏幕外时不做任何处理*/
+	if (Width == 0 || Height == 0) {return;}
+	if (!OLED_Blit_ClipInit(&clip, X, Y, Width, Height)) {return;}
+	
+	if (Height % 8 == 0)
+	{
+		/*图像高度为整页时，清除与绘制的范围相同，一次覆盖写入即可*/
+		OLED_Blit_Image(&clip, X, Y, Width, Height, Image, OLED_BLIT_COPY);
+	}
+	else
+	{
+		/*将图像所在区域清空*/
+		OLED_Blit_FillRect(&clip, OLED_BLIT_ANDNOT);
+		
+		/*图像最后一页中超出Height的位同样写入显存，与逐字节移位的实现保持一致*/
+		OLED_Blit_ClipInit(&clip, X, Y, Width, ((Height - 1) / 8 + 1) * 8);
+		OLED_Blit_Image(&clip, X, Y, Width, Height, Image, OLED_BLIT_OR);
 	}
 }
 
@@ -701,29 +863,14 @@ void OLED_PrintfMix(int16_t X, int16_t Y, uint8_t ChineseFontSize,uint8_t ASCIIF
   */
  void OLED_ShowImageArea(int16_t X_Pic, int16_t Y_Pic, int16_t PictureWidth, int16_t PictureHeight, int16_t X_Area, int16_t Y_Area, int16_t AreaWidth, int16_t AreaHeight, const uint8_t *Image)
  {
-	 if (PictureWidth == 0 || PictureHeight == 0 || AreaWidth == 0 || AreaHeight == 0 || X_Pic > OLED_WIDTH-1 || X_Area > OLED_WIDTH-1 || Y_Pic > OLED_HEIGHT-1 || Y_Area > OLED_HEIGHT-1) {return; }
-		 int16_t startX = (X_Pic < X_Area) ? X_Area : X_Pic;
-	 int16_t endX = ((X_Area + AreaWidth - 1) < (X_Pic + PictureWidth - 1)) ? (X_Area + AreaWidth - 1) : (X_Pic + PictureWidth - 1);
-	 int16_t startY = (Y_Pic < Y_Area) ? Y_Area : Y_Pic;
-	 int16_t endY = ((Y_Area + AreaHeight - 1) < (Y_Pic + PictureHeight - 1)) ? (Y_Area + AreaHeight - 1) : (Y_Pic + PictureHeight - 1);
-	 endX = (endX > OLED_WIDTH-1) ? OLED_WIDTH-1 : endX;
-	 endY = (endY > OLED_HEIGHT-1) ? OLED_HEIGHT-1 : endY;
-		 if(startX > endX || startY > endY){return;}
-		 //OLED_ClearArea(startX, startY, endX - startX + 1, endY - startY + 1);
-		 for (uint8_t j = 0; j <= (PictureHeight - 1) / 8; j++) {
-		 for (uint8_t i = 0; i < PictureWidth; i++) {
-			 uint8_t currX = X_Pic + i;
-			 if (currX < startX || currX > endX) {continue;};
-			 for (uint8_t bit = 0; bit < 8; bit++) {
-				 uint8_t currY = Y_Pic + j * 8 + bit;
-				 if (currY < startY || currY > endY) {continue;};
-				 uint8_t page = currY / 8;
-				 uint8_t bit_pos = currY % 8;
-				 uint8_t data = Image[j * PictureWidth + i];
-				 if (data & (1 << bit)) {OLED_DisplayBuf[page][currX] |= (1 << bit_pos); }
-			 }
-		 }
-	 }
+	OLED_ClipRect_t clip;
+	
+	/*裁剪矩形为屏幕、图片和显示区域三者的交集，只需计算一次*/
+	if (!OLED_Blit_ClipInit(&clip, X_Pic, Y_Pic, PictureWidth, PictureHeight)) {return;}
+	if (!OLED_Blit_ClipIntersect(&clip, X_Area, Y_Area, AreaWidth, AreaHeight)) {return;}
+	
+	/*只置位不清除，图片中为0的像素保持显存原样*/
+	OLED_Blit_Image(&clip, X_Pic, Y_Pic, PictureWidth, PictureHeight, Image, OLED_BLIT_OR);
  }
 
 /**
@@ -996,103 +1143,68 @@ uint8_t OLED_GetPoint(uint8_t X, uint8_t Y)
   */
 void OLED_DrawLine(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1)
 {
-	int16_t x, y, dx, dy, d, incrE, incrNE, temp;
-	int16_t x0 = X0, y0 = Y0, x1 = X1, y1 = Y1;
-	uint8_t yflag = 0, xyflag = 0;
+	int16_t temp;
+	OLED_ClipRect_t clip;
 	
-	if (y0 == y1)		//横线单独处理
+	if (Y0 == Y1 || X0 == X1)	//横线和竖线就是宽或高为1的矩形，交给块传输模块整字节填充
 	{
-		/*0号点X坐标大于1号点X坐标，则交换两点X坐标*/
-		if (x0 > x1) {temp = x0; x0 = x1; x1 = temp;}
-		
-		/*遍历X坐标*/
-		for (x = x0; x <= x1; x ++)
+		if (X0 > X1) {temp = X0; X0 = X1; X1 = temp;}
+		if (Y0 > Y1) {temp = Y0; Y0 = Y1; Y1 = temp;}
+		if (OLED_Blit_ClipInit(&clip, X0, Y0, X1 - X0 + 1, Y1 - Y0 + 1))
 		{
-			OLED_DrawPoint(x, y0);	//依次画点
+			OLED_Blit_FillRect(&clip, OLED_BLIT_OR);
 		}
+		return;
 	}
-	else if (x0 == x1)	//竖线单独处理
+	
+	/*使用Bresenham算法画直线，可以避免耗时的浮点运算，效率更高*/
+	/*参考文档：https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf*/
+	/*参考教程：https://www.bilibili.com/video/BV1364y1d7Lo*/
+	
+	/*0号点X坐标大于1号点X坐标时交换两点，之后X方向总是递增*/
+	if (X0 > X1)
 	{
-		/*0号点Y坐标大于1号点Y坐标，则交换两点Y坐标*/
-		if (y0 > y1) {temp = y0; y0 = y1; y1 = temp;}
-		
-		/*遍历Y坐标*/
-		for (y = y0; y <= y1; y ++)
-		{
-			OLED_DrawPoint(x0, y);	//依次画点
-		}
+		temp = X0; X0 = X1; X1 = temp;
+		temp = Y0; Y0 = Y1; Y1 = temp;
 	}
-	else				//斜线
+	
+	/*整条线都在屏幕外时直接返回*/
+	if (X1 < 0 || X0 > OLED_WIDTH - 1) {return;}
+	if ((Y0 < 0 && Y1 < 0) || (Y0 > OLED_HEIGHT - 1 && Y1 > OLED_HEIGHT - 1)) {return;}
+	
+	int32_t dx = X1 - X0;
+	int32_t dy = (Y1 > Y0) ? (Y1 - Y0) : (Y0 - Y1);
+	int16_t stepY = (Y1 > Y0) ? 1 : -1;
+	
+	/*主轴为每一步都前进的坐标轴，副轴只在误差项不小于0时前进*/
+	/*斜率大于1时以Y为主轴，与原先交换XY坐标后再画线得到的点完全相同*/
+	/*两种情况分成两个循环，循环内不再判断方向，直接写显存而不经过OLED_DrawPoint*/
+	int16_t x = X0, y = Y0;
+	if (dy > dx)
 	{
-		/*使用Bresenham算法画直线，可以避免耗时的浮点运算，效率更高*/
-		/*参考文档：https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf*/
-		/*参考教程：https://www.bilibili.com/video/BV1364y1d7Lo*/
-		
-		if (x0 > x1)	//0号点X坐标大于1号点X坐标
-		{
-			/*交换两点坐标*/
-			/*交换后不影响画线，但是画线方向由第一、二、三、四象限变为第一、四象限*/
-			temp = x0; x0 = x1; x1 = temp;
-			temp = y0; y0 = y1; y1 = temp;
-		}
-		
-		if (y0 > y1)	//0号点Y坐标大于1号点Y坐标
+		int32_t incrE = 2 * dx, incrNE = 2 * (dx - dy), d = 2 * dx - dy;
+		for (int32_t i = 0; i <= dy; i ++, y += stepY)
 		{
-			/*将Y坐标取负*/
-			/*取负后影响画线，但是画线方向由第一、四象限变为第一象限*/
-			y0 = -y0;
-			y1 = -y1;
-			
-			/*置标志位yflag，记住当前变换，在后续实际画线时，再将坐标换回来*/
-			yflag = 1;
-		}
-		
-		if (y1 - y0 > x1 - x0)	//画线斜率大于1
-		{
-			/*将X坐标与Y坐标互换*/
-			/*互换后影响画线，但是画线方向由第一象限0~90度范围变为第一象限0~45度范围*/
-			temp = x0; x0 = y0; y0 = temp;
-			temp = x1; x1 = y1; y1 = temp;
-			
-			/*置标志位xyflag，记住当前变换，在后续实际画线时，再将坐标换回来*/
-			xyflag = 1;
-		}
-		
-		/*以下为Bresenham算法画直线*/
-		/*算法要求，画线方向必须为第一象限0~45度范围*/
-		dx = x1 - x0;
-		dy = y1 - y0;
-		incrE = 2 * dy;
-		incrNE = 2 * (dy - dx);
-		d = 2 * dy - dx;
-		x = x0;
-		y = y0;
-		
-		/*画起始点，同时判断标志位，将坐标换回来*/
-		if (yflag && xyflag){OLED_DrawPoint(y, -x);}
-		else if (yflag)		{OLED_DrawPoint(x, -y);}
-		else if (xyflag)	{OLED_DrawPoint(y, x);}
-		else				{OLED_DrawPoint(x, y);}
-		
-		while (x < x1)		//遍历X轴的每个点
-		{
-			x ++;
-			if (d < 0)		//下一个点在当前点东方
+			if ((uint16_t)x < OLED_WIDTH && (uint16_t)y < OLED_HEIGHT)
 			{
-				d += incrE;
+				OLED_DisplayBuf[y >> 3][x] |= 0x01 << (y & 0x07);
 			}
-			else			//下一个点在当前点东北方
+			if (d < 0) {d += incrE;}				//只沿Y方向前进
+			else       {d += incrNE; x ++;}		//沿X和Y方向同时前进
+		}
+	}
+	else
+	{
+		int32_t incrE = 2 * dy, incrNE = 2 * (dy - dx), d = 2 * dy - dx;
+		for (int32_t i = 0; i <= dx; i ++, x ++)
+		{
+			if ((uint16_t)x < OLED_WIDTH && (uint16_t)y < OLED_HEIGHT)
 			{
-				y ++;
-				d += incrNE;
+				OLED_DisplayBuf[y >> 3][x] |= 0x01 << (y & 0x07);
 			}
-			
-			/*画每一个点，同时判断标志位，将坐标换回来*/
-			if (yflag && xyflag){OLED_DrawPoint(y, -x);}
-			else if (yflag)		{OLED_DrawPoint(x, -y);}
-			else if (xyflag)	{OLED_DrawPoint(y, x);}
-			else				{OLED_DrawPoint(x, y);}
-		}	
+			if (d < 0) {d += incrE;}				//只沿X方向前进
+			else       {d += incrNE; y += stepY;}	//沿X和Y方向同时前进
+		}
 	}
 }
 
@@ -1128,36 +1240,21 @@ void OLED_DrawRectangle(int16_t X, int16_t Y, int16_t Width, int16_t Height, uin
     int16_t validHeight = Y_end - Y_start + 1;
     if (validWidth <= 0 || validHeight <= 0) { return; }
 
+    OLED_ClipRect_t clip;
     if (!IsFilled) {
-        // 绘制矩形边框
-        for (int16_t i = X_start; i <= X_end; i++) {
-            OLED_DrawPoint(i, Y_start);
-            OLED_DrawPoint(i, Y_end);
-        }
-        for (int16_t i = Y_start; i <= Y_end; i++) {
-            OLED_DrawPoint(X_start, i);
-            OLED_DrawPoint(X_end, i);
-        }
+        // 绘制矩形边框，上下边为单行，左右边为单列
+        OLED_Blit_ClipInit(&clip, X_start, Y_start, validWidth, 1);
+        OLED_Blit_FillRect(&clip, OLED_BLIT_OR);
+        OLED_Blit_ClipInit(&clip, X_start, Y_end, validWidth, 1);
+        OLED_Blit_FillRect(&clip, OLED_BLIT_OR);
+        OLED_Blit_ClipInit(&clip, X_start, Y_start, 1, validHeight);
+        OLED_Blit_FillRect(&clip, OLED_BLIT_OR);
+        OLED_Blit_ClipInit(&clip, X_end, Y_start, 1, validHeight);
+        OLED_Blit_FillRect(&clip, OLED_BLIT_OR);
     } else {
-        // 计算起始和结束页
-        int16_t start_page = Y_start / 8;
-        int16_t end_page = Y_end / 8;
-
-        // 计算每页的掩码
-        uint8_t start_mask = 0xFF << (Y_start % 8);
-        uint8_t end_mask = 0xFF >> (7 - (Y_end % 8));
-
-        // 遍历每一列，应用掩码
-        for (int16_t x = X_start; x <= X_end; x++) {
-            for (int16_t page = start_page; page <= end_page; page++) {
-                uint8_t mask = 0xFF;
-                if (page == start_page) mask &= start_mask;
-                if (page == end_page) mask &= end_mask;
-                if (page >= 0 && page < OLED_HEIGHT / 8) { // 确保页数有效
-                    OLED_DisplayBuf[page][x] |= mask;
-                }
-            }
-        }
+        // 按页写入整个填充区域
+        OLED_Blit_ClipInit(&clip, X_start, Y_start, validWidth, validHeight);
+        OLED_Blit_FillRect(&clip, OLED_BLIT_OR);
     }
 }
 
@@ -1204,18 +1301,32 @@ void OLED_DrawTriangle(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1, int16_t X
 		if (Y2 > maxy) {maxy = Y2;}
 		
 		/*最小最大坐标之间的矩形为可能需要填充的区域*/
-		/*遍历此区域中所有的点*/
-		/*遍历X坐标*/
-		for (i = minx; i <= maxx; i ++)
+		/*逐行处理，与OLED_pnpoly的判断方法相同：每条跨过该行的边在该行有一个交点横坐标，*/
+		/*点在交点左侧时翻转一次内外状态。三角形每行最多被两条边跨过，*/
+		/*所以在内部的点恰好是两个交点之间的一段横线[左交点, 右交点)*/
+		if (miny < 0) {miny = 0;}
+		if (maxy > OLED_HEIGHT - 1) {maxy = OLED_HEIGHT - 1;}
+		for (j = miny; j <= maxy; j ++)
 		{
-			/*遍历Y坐标*/
-			for (j = miny; j <= maxy; j ++)
+			int32_t cross[2];
+			uint8_t count = 0;
+			for (i = 0; i < 3; i ++)
 			{
-				/*调用OLED_pnpoly，判断指定点是否在指定三角形之中*/
-				/*如果在，则画点，如果不在，则不做处理*/
-				if (OLED_pnpoly(3, vx, vy, i, j)) {OLED_DrawPoint(i, j);}
+				int16_t k = (i + 2) % 3;	//与OLED_pnpoly相同的边顺序
+				if ((vy[i] > j) != (vy[k] > j))
+				{
+					cross[count ++] = (int32_t)(vx[k] - vx[i]) * (j - vy[i]) / (vy[k] - vy[i]) + vx[i];
+				}
 			}
+			if (count != 2) {continue;}
+			
+			int32_t left = (cross[0] < cross[1]) ? cross[0] : cross[1];
+			int32_t right = (cross[0] < cross[1]) ? cross[1] : cross[0];
+			if (left < minx) {left = minx;}
+			if (right > maxx + 1) {right = maxx + 1;}
+			OLED_FillHSpan(left, j, right - left);
 		}
+		OLED_SpanCommit();
 	}
 }
 
@@ -1232,7 +1343,7 @@ void OLED_DrawTriangle(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1, int16_t X
   */
 void OLED_DrawCircle(int16_t X, int16_t Y, int16_t Radius, uint8_t IsFilled)
 {
-	int16_t x, y, d, j;
+	int16_t x, y, d;
 	
 	/*使用Bresenham算法画圆，可以避免耗时的浮点运算，效率更高*/
 	/*参考文档：https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf*/
@@ -1243,19 +1354,15 @@ void OLED_DrawCircle(int16_t X, int16_t Y, int16_t Radius, uint8_t IsFilled)
 	y = Radius;
 	
 	/*画每个八分之一圆弧的起始点*/
-	OLED_DrawPoint(X + x, Y + y);
-	OLED_DrawPoint(X - x, Y - y);
-	OLED_DrawPoint(X + y, Y + x);
-	OLED_DrawPoint(X - y, Y - x);
+	OLED_SpanPoint(X + x, Y + y);
+	OLED_SpanPoint(X - x, Y - y);
+	OLED_SpanPoint(X + y, Y + x);
+	OLED_SpanPoint(X - y, Y - x);
 	
 	if (IsFilled)		//指定圆填充
 	{
-		/*遍历起始点Y坐标*/
-		for (j = -y; j < y; j ++)
-		{
-			/*在指定区域画点，填充部分圆*/
-			OLED_DrawPoint(X, Y + j);
-		}
+		/*起始点所在列，纵向范围[-y, y)整段填充*/
+		OLED_FillVSpan(X, Y - y, 2 * y);
 	}
 	
 	while (x < y)		//遍历X轴的每个点
@@ -1272,34 +1379,29 @@ void OLED_DrawCircle(int16_t X, int16_t Y, int16_t Radius, uint8_t IsFilled)
 		}
 		
 		/*画每个八分之一圆弧的点*/
-		OLED_DrawPoint(X + x, Y + y);
-		OLED_DrawPoint(X + y, Y + x);
-		OLED_DrawPoint(X - x, Y - y);
-		OLED_DrawPoint(X - y, Y - x);
-		OLED_DrawPoint(X + x, Y - y);
-		OLED_DrawPoint(X + y, Y - x);
-		OLED_DrawPoint(X - x, Y + y);
-		OLED_DrawPoint(X - y, Y + x);
+		OLED_SpanPoint(X + x, Y + y);
+		OLED_SpanPoint(X + y, Y + x);
+		OLED_SpanPoint(X - x, Y - y);
+		OLED_SpanPoint(X - y, Y - x);
+		OLED_SpanPoint(X + x, Y - y);
+		OLED_SpanPoint(X + y, Y - x);
+		OLED_SpanPoint(X - x, Y + y);
+		OLED_SpanPoint(X - y, Y + x);
 		
 		if (IsFilled)	//指定圆填充
 		{
-			/*遍历中间部分*/
-			for (j = -y; j < y; j ++)
-			{
-				/*在指定区域画点，填充部分圆*/
-				OLED_DrawPoint(X + x, Y + j);
-				OLED_DrawPoint(X - x, Y + j);
-			}
+			/*中间部分，纵向范围[-y, y)整段填充*/
+			OLED_FillVSpan(X + x, Y - y, 2 * y);
+			OLED_FillVSpan(X - x, Y - y, 2 * y);
 			
-			/*遍历两侧部分*/
-			for (j = -x; j < x; j ++)
-			{
-				/*在指定区域画点，填充部分圆*/
-				OLED_DrawPoint(X - y, Y + j);
-				OLED_DrawPoint(X + y, Y + j);
-			}
+			/*两侧部分，纵向范围[-x, x)整段填充*/
+			OLED_FillVSpan(X - y, Y - x, 2 * x);
+			OLED_FillVSpan(X + y, Y - x, 2 * x);
 		}
 	}
+	
+	/*将画布内容写入显存*/
+	OLED_SpanCommit();
 }
 
 /**
@@ -1316,121 +1418,100 @@ void OLED_DrawCircle(int16_t X, int16_t Y, int16_t Radius, uint8_t IsFilled)
   */
 void OLED_DrawEllipse(int16_t X, int16_t Y, int16_t A, int16_t B, uint8_t IsFilled)
 {
-	int16_t x, y, j;
-	int16_t a = A, b = B;
-	float d1, d2;
+	int16_t x, y;
+	int64_t a2 = (int64_t)A * A, b2 = (int64_t)B * B;
+	int64_t d1, d2;
 	
-	/*使用Bresenham算法画椭圆，可以避免部分耗时的浮点运算，效率更高*/
+	/*使用中点Bresenham算法画椭圆，判别式统一放大4倍，消除0.5带来的小数，全程整数运算*/
 	/*参考链接：https://blog.csdn.net/myf_666/article/details/128167392*/
 	
 	x = 0;
-	y = b;
-	d1 = b * b + a * a * (-b + 0.5);
+	y = B;
+	d1 = 4 * b2 + a2 * (2 - 4 * y);		//4 * (b^2 + a^2 * (-b + 0.5))
 	
 	if (IsFilled)	//指定椭圆填充
 	{
-		/*遍历起始点Y坐标*/
-		for (j = -y; j < y; j ++)
-		{
-			/*在指定区域画点，填充部分椭圆*/
-			OLED_DrawPoint(X, Y + j);
-			OLED_DrawPoint(X, Y + j);
-		}
+		/*起始点所在列，纵向范围[-y, y)整段填充*/
+		OLED_FillVSpan(X, Y - y, 2 * y);
 	}
 	
 	/*画椭圆弧的起始点*/
-	OLED_DrawPoint(X + x, Y + y);
-	OLED_DrawPoint(X - x, Y - y);
-	OLED_DrawPoint(X - x, Y + y);
-	OLED_DrawPoint(X + x, Y - y);
+	OLED_SpanPoint(X + x, Y + y);
+	OLED_SpanPoint(X - x, Y - y);
+	OLED_SpanPoint(X - x, Y + y);
+	OLED_SpanPoint(X + x, Y - y);
 	
-	/*画椭圆中间部分*/
-	while (b * b * (x + 1) < a * a * (y - 0.5))
+	/*画椭圆中间部分，条件b^2 * (x + 1) < a^2 * (y - 0.5)两边同乘2*/
+	while (2 * b2 * (x + 1) < a2 * (2 * y - 1))
 	{
 		if (d1 <= 0)		//下一个点在当前点东方
 		{
-			d1 += b * b * (2 * x + 3);
+			d1 += 4 * b2 * (2 * x + 3);
 		}
 		else				//下一个点在当前点东南方
 		{
-			d1 += b * b * (2 * x + 3) + a * a * (-2 * y + 2);
+			d1 += 4 * b2 * (2 * x + 3) + 4 * a2 * (-2 * y + 2);
 			y --;
 		}
 		x ++;
 		
 		if (IsFilled)	//指定椭圆填充
 		{
-			/*遍历中间部分*/
-			for (j = -y; j < y; j ++)
-			{
-				/*在指定区域画点，填充部分椭圆*/
-				OLED_DrawPoint(X + x, Y + j);
-				OLED_DrawPoint(X - x, Y + j);
-			}
+			/*中间部分，纵向范围[-y, y)整段填充*/
+			OLED_FillVSpan(X + x, Y - y, 2 * y);
+			OLED_FillVSpan(X - x, Y - y, 2 * y);
 		}
 		
 		/*画椭圆中间部分圆弧*/
-		OLED_DrawPoint(X + x, Y + y);
-		OLED_DrawPoint(X - x, Y - y);
-		OLED_DrawPoint(X - x, Y + y);
-		OLED_DrawPoint(X + x, Y - y);
+		OLED_SpanPoint(X + x, Y + y);
+		OLED_SpanPoint(X - x, Y - y);
+		OLED_SpanPoint(X - x, Y + y);
+		OLED_SpanPoint(X + x, Y - y);
 	}
 	
-	/*画椭圆两侧部分*/
-	d2 = b * b * (x + 0.5) * (x + 0.5) + a * a * (y - 1) * (y - 1) - a * a * b * b;
+	/*画椭圆两侧部分，4 * (b^2 * (x + 0.5)^2 + a^2 * (y - 1)^2 - a^2 * b^2)*/
+	d2 = b2 * (2 * x + 1) * (2 * x + 1) + 4 * a2 * (y - 1) * (y - 1) - 4 * a2 * b2;
 	
 	while (y > 0)
 	{
 		if (d2 <= 0)		//下一个点在当前点东方
 		{
-			d2 += b * b * (2 * x + 2) + a * a * (-2 * y + 3);
+			d2 += 4 * b2 * (2 * x + 2) + 4 * a2 * (-2 * y + 3);
 			x ++;
 			
 		}
 		else				//下一个点在当前点东南方
 		{
-			d2 += a * a * (-2 * y + 3);
+			d2 += 4 * a2 * (-2 * y + 3);
 		}
 		y --;
 		
 		if (IsFilled)	//指定椭圆填充
 		{
-			/*遍历两侧部分*/
-			for (j = -y; j < y; j ++)
-			{
-				/*在指定区域画点，填充部分椭圆*/
-				OLED_DrawPoint(X + x, Y + j);
-				OLED_DrawPoint(X - x, Y + j);
-			}
+			/*两侧部分，纵向范围[-y, y)整段填充*/
+			OLED_FillVSpan(X + x, Y - y, 2 * y);
+			OLED_FillVSpan(X - x, Y - y, 2 * y);
 		}
 		
 		/*画椭圆两侧部分圆弧*/
-		OLED_DrawPoint(X + x, Y + y);
-		OLED_DrawPoint(X - x, Y - y);
-		OLED_DrawPoint(X - x, Y + y);
-		OLED_DrawPoint(X + x, Y - y);
+		OLED_SpanPoint(X + x, Y + y);
+		OLED_SpanPoint(X - x, Y - y);
+		OLED_SpanPoint(X - x, Y + y);
+		OLED_SpanPoint(X + x, Y - y);
 	}
+	
+	/*将画布内容写入显存*/
+	OLED_SpanCommit();
 }
 
 /**
-  * 函    数：OLED画圆弧
-  * 参    数：X 指定圆弧的圆心横坐标，范围：0~127
-  * 参    数：Y 指定圆弧的圆心纵坐标，范围：0~63
-  * 参    数：Radius 指定圆弧的半径，范围：0~255
-  * 参    数：StartAngle 指定圆弧的起始角度，范围：-180~180
-  *           水平向右为0度，水平向左为180度或-180度，下方为正数，上方为负数，顺时针旋转
-  * 参    数：EndAngle 指定圆弧的终止角度，范围：-180~180
-  *           水平向右为0度，水平向左为180度或-180度，下方为正数，上方为负数，顺时针旋转
-  * 参    数：IsFilled 指定圆弧是否填充，填充后为扇形
-  *           范围：OLED_UNFILLED		不填充
-  *                 OLED_FILLED			填充
-  * 返 回 值：无
-  * 说    明：调用此函数后，要想真正地呈现在屏幕上，还需调用更新函数
+  * 函    数：把一段圆弧（或扇形）累积到画布上，不写入显存
+  * 参    数：同OLED_DrawArc，Radius必须大于0
+  * 说    明：供OLED_DrawArc和OLED_DrawRoundedRectangle共用，调用者负责OLED_SpanCommit
   */
-void OLED_DrawArc(int16_t X, int16_t Y, int16_t Radius, int16_t StartAngle, int16_t EndAngle, uint8_t IsFilled)
+static void OLED_ArcSpans(int16_t X, int16_t Y, int16_t Radius, int16_t StartAngle, int16_t EndAngle, uint8_t IsFilled)
 {
-	int16_t x, y, d, j;
-	if(Radius <=0){return;} //半径为0，直接返回
+	int16_t x, y, d;
 	/*此函数借用Bresenham算法画圆的方法*/
 	
 	d = 1 - Radius;
@@ -1438,19 +1519,15 @@ void OLED_DrawArc(int16_t X, int16_t Y, int16_t Radius, int16_t StartAngle, int1
 	y = Radius;
 	
 	/*在画圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-	if (OLED_IsInAngle(x, y, StartAngle, EndAngle))	{OLED_DrawPoint(X + x, Y + y);}
-	if (OLED_IsInAngle(-x, -y, StartAngle, EndAngle)) {OLED_DrawPoint(X - x, Y - y);}
-	if (OLED_IsInAngle(y, x, StartAngle, EndAngle)) {OLED_DrawPoint(X + y, Y + x);}
-	if (OLED_IsInAngle(-y, -x, StartAngle, EndAngle)) {OLED_DrawPoint(X - y, Y - x);}
+	if (OLED_IsInAngle(x, y, StartAngle, EndAngle))	{OLED_SpanPoint(X + x, Y + y);}
+	if (OLED_IsInAngle(-x, -y, StartAngle, EndAngle)) {OLED_SpanPoint(X - x, Y - y);}
+	if (OLED_IsInAngle(y, x, StartAngle, EndAngle)) {OLED_SpanPoint(X + y, Y + x);}
+	if (OLED_IsInAngle(-y, -x, StartAngle, EndAngle)) {OLED_SpanPoint(X - y, Y - x);}
 	
 	if (IsFilled)	//指定圆弧填充
 	{
-		/*遍历起始点Y坐标*/
-		for (j = -y; j < y; j ++)
-		{
-			/*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-			if (OLED_IsInAngle(0, j, StartAngle, EndAngle)) {OLED_DrawPoint(X, Y + j);}
-		}
+		/*起始点所在列，记录纵向范围[-y, y)，画完后统一判断角度*/
+		OLED_ArcExtendColumn(X, y);
 	}
 	
 	while (x < y)		//遍历X轴的每个点
@@ -1467,34 +1544,57 @@ void OLED_DrawArc(int16_t X, int16_t Y, int16_t Radius, int16_t StartAngle, int1
 		}
 		
 		/*在画圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-		if (OLED_IsInAngle(x, y, StartAngle, EndAngle)) {OLED_DrawPoint(X + x, Y + y);}
-		if (OLED_IsInAngle(y, x, StartAngle, EndAngle)) {OLED_DrawPoint(X + y, Y + x);}
-		if (OLED_IsInAngle(-x, -y, StartAngle, EndAngle)) {OLED_DrawPoint(X - x, Y - y);}
-		if (OLED_IsInAngle(-y, -x, StartAngle, EndAngle)) {OLED_DrawPoint(X - y, Y - x);}
-		if (OLED_IsInAngle(x, -y, StartAngle, EndAngle)) {OLED_DrawPoint(X + x, Y - y);}
-		if (OLED_IsInAngle(y, -x, StartAngle, EndAngle)) {OLED_DrawPoint(X + y, Y - x);}
-		if (OLED_IsInAngle(-x, y, StartAngle, EndAngle)) {OLED_DrawPoint(X - x, Y + y);}
-		if (OLED_IsInAngle(-y, x, StartAngle, EndAngle)) {OLED_DrawPoint(X - y, Y + x);}
+		if (OLED_IsInAngle(x, y, StartAngle, EndAngle)) {OLED_SpanPoint(X + x, Y + y);}
+		if (OLED_IsInAngle(y, x, StartAngle, EndAngle)) {OLED_SpanPoint(X + y, Y + x);}
+		if (OLED_IsInAngle(-x, -y, StartAngle, EndAngle)) {OLED_SpanPoint(X - x, Y - y);}
+		if (OLED_IsInAngle(-y, -x, StartAngle, EndAngle)) {OLED_SpanPoint(X - y, Y - x);}
+		if (OLED_IsInAngle(x, -y, StartAngle, EndAngle)) {OLED_SpanPoint(X + x, Y - y);}
+		if (OLED_IsInAngle(y, -x, StartAngle, EndAngle)) {OLED_SpanPoint(X + y, Y - x);}
+		if (OLED_IsInAngle(-x, y, StartAngle, EndAngle)) {OLED_SpanPoint(X - x, Y + y);}
+		if (OLED_IsInAngle(-y, x, StartAngle, EndAngle)) {OLED_SpanPoint(X - y, Y + x);}
 		
 		if (IsFilled)	//指定圆弧填充
 		{
-			/*遍历中间部分*/
-			for (j = -y; j < y; j ++)
-			{
-				/*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-				if (OLED_IsInAngle(x, j, StartAngle, EndAngle)) {OLED_DrawPoint(X + x, Y + j);}
-				if (OLED_IsInAngle(-x, j, StartAngle, EndAngle)) {OLED_DrawPoint(X - x, Y + j);}
-			}
+			/*中间部分，记录纵向范围[-y, y)*/
+			OLED_ArcExtendColumn(X + x, y);
+			OLED_ArcExtendColumn(X - x, y);
 			
-			/*遍历两侧部分*/
-			for (j = -x; j < x; j ++)
-			{
-				/*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
-				if (OLED_IsInAngle(-y, j, StartAngle, EndAngle)) {OLED_DrawPoint(X - y, Y + j);}
-				if (OLED_IsInAngle(y, j, StartAngle, EndAngle)) {OLED_DrawPoint(X + y, Y + j);}
-			}
+			/*两侧部分，记录纵向范围[-x, x)*/
+			OLED_ArcExtendColumn(X - y, x);
+			OLED_ArcExtendColumn(X + y, x);
 		}
 	}
+	
+	if (IsFilled)	//指定圆弧填充
+	{
+		/*每个需要填充的点只判断一次角度*/
+		OLED_ArcFillColumns(X, Y, StartAngle, EndAngle);
+	}
+}
+
+/**
+  * 函    数：OLED画圆弧
+  * 参    数：X 指定圆弧的圆心横坐标，范围：0~127
+  * 参    数：Y 指定圆弧的圆心纵坐标，范围：0~63
+  * 参    数：Radius 指定圆弧的半径，范围：0~255
+  * 参    数：StartAngle 指定圆弧的起始角度，范围：-180~180
+  *           水平向右为0度，水平向左为180度或-180度，下方为正数，上方为负数，顺时针旋转
+  * 参    数：EndAngle 指定圆弧的终止角度，范围：-180~180
+  *           水平向右为0度，水平向左为180度或-180度，下方为正数，上方为负数，顺时针旋转
+  * 参    数：IsFilled 指定圆弧是否填充，填充后为扇形
+  *           范围：OLED_UNFILLED		不填充
+  *                 OLED_FILLED			填充
+  * 返 回 值：无
+  * 说    明：调用此函数后，要想真正地呈现在屏幕上，还需调用更新函数
+  */
+void OLED_DrawArc(int16_t X, int16_t Y, int16_t Radius, int16_t StartAngle, int16_t EndAngle, uint8_t IsFilled)
+{
+	if(Radius <=0){return;} //半径为0，直接返回
+	
+	OLED_ArcSpans(X, Y, Radius, StartAngle, EndAngle, IsFilled);
+	
+	/*将画布内容写入显存*/
+	OLED_SpanCommit();
 }
 
 /**
@@ -1523,132 +1623,50 @@ void OLED_DrawRoundedRectangle(int16_t X, int16_t Y, int16_t Width, int16_t Heig
         return;
     }
     else if(Radius == 2) {	// 如果半径为2，圆角可以简化为两个点，优化性能
-    	OLED_DrawPoint(X + 1, Y);
-    	OLED_DrawPoint(X + Width - 2, Y);
+    	OLED_SpanPoint(X + 1, Y);
+    	OLED_SpanPoint(X + Width - 2, Y);
 
-    	OLED_DrawPoint(X + 1, Y + Height - 1);
-    	OLED_DrawPoint(X + Width - 2, Y + Height - 1);
+    	OLED_SpanPoint(X + 1, Y + Height - 1);
+    	OLED_SpanPoint(X + Width - 2, Y + Height - 1);
 
-    	OLED_DrawPoint(X, Y + 1);
-    	OLED_DrawPoint(X, Y + Height - 2);
+    	OLED_SpanPoint(X, Y + 1);
+    	OLED_SpanPoint(X, Y + Height - 2);
 
-    	OLED_DrawPoint(X + Width - 1, Y + 1);
-    	OLED_DrawPoint(X + Width - 1, Y + Height - 2);
+    	OLED_SpanPoint(X + Width - 1, Y + 1);
+    	OLED_SpanPoint(X + Width - 1, Y + Height - 2);
     }
     else {
-		// 绘制四个圆角
-		OLED_DrawArc(X + Radius, Y + Radius, Radius,180,  -90, IsFilled);
-		OLED_DrawArc(X + Width - Radius - 1, Y + Radius, Radius,-90,  0, IsFilled);
-		OLED_DrawArc(X + Radius, Y + Height - Radius - 1, Radius,90,  180, IsFilled);
-		OLED_DrawArc(X + Width - Radius - 1, Y + Height - Radius - 1, Radius,0,  90, IsFilled);
+		// 绘制四个圆角，先累积在画布上，最后与主体一起写入显存
+		OLED_ArcSpans(X + Radius, Y + Radius, Radius,180,  -90, IsFilled);
+		OLED_ArcSpans(X + Width - Radius - 1, Y + Radius, Radius,-90,  0, IsFilled);
+		OLED_ArcSpans(X + Radius, Y + Height - Radius - 1, Radius,90,  180, IsFilled);
+		OLED_ArcSpans(X + Width - Radius - 1, Y + Height - Radius - 1, Radius,0,  90, IsFilled);
     }
 
     // 填充或绘制矩形主体
     if (IsFilled) {
-        OLED_DrawRectangle(X + Radius, Y, Width - 2 * Radius, Height, OLED_FILLED);
-        OLED_DrawRectangle(X, Y + Radius, Width, Height - 2 * Radius, OLED_FILLED);
+        // 中间各列整段填充，左右圆角所在列只填充去掉圆角后的部分
+        for (int16_t x = X; x < X + Width; x++) {
+            if (x >= X + Radius && x < X + Width - Radius) {
+                OLED_FillVSpan(x, Y, Height);
+            } else {
+                OLED_FillVSpan(x, Y + Radius, Height - 2 * Radius);
+            }
+        }
     } else {
+        // 直边端点与原先画线一致：两端点颠倒时（宽或高恰为两倍半径）画线会交换端点
+        int16_t x0 = X + Radius, x1 = X + Width - Radius - 1;
+        int16_t y0 = Y + Radius, y1 = Y + Height - Radius - 1;
+        if (x0 > x1) {int16_t t = x0; x0 = x1; x1 = t;}
+        if (y0 > y1) {int16_t t = y0; y0 = y1; y1 = t;}
         // 绘制顶部和底部的直线
-        OLED_DrawLine(X + Radius, Y, X + Width - Radius - 1, Y);
-        OLED_DrawLine(X + Radius, Y + Height - 1, X + Width - Radius - 1, Y + Height - 1);
+        OLED_FillHSpan(x0, Y, x1 - x0 + 1);
+        OLED_FillHSpan(x0, Y + Height - 1, x1 - x0 + 1);
         // 绘制左侧和右侧的直线
-        OLED_DrawLine(X, Y + Radius, X, Y + Height - Radius - 1);
-        OLED_DrawLine(X + Width - 1, Y + Radius, X + Width - 1, Y + Height - Radius - 1);
-    }
-}
-
-/**
-  * 函    数：DrawCube3D
-  * 功    能：在OLED屏幕上绘制一个旋转的三维立方体
-  * 参    数：centerX     指定立方体中心的横坐标，范围：0 ~ OLED_WIDTH-1
-  * 参    数：centerY     指定立方体中心的纵坐标，范围：0 ~ OLED_HEIGHT-1
-  * 参    数：size        指定立方体的边长，单位为像素，范围：正浮点数
-  * 参    数：perspective 指定投影方式
-  *                        范围：0 表示平行投影
-  *                              1 表示透视投影
-  * 返 回 值：无
-  * 说    明：调用此函数将根据欧拉角旋转立方体，并将三维顶点通过投影转换为二维坐标，
-  *           然后用画线函数连接各顶点形成立方体边。函数内部包含自增角度，可实现连续旋转效果。
-  *           每次调用会清空屏幕并重绘，调用完需执行OLED刷新函数才能显示图像。
-  */
-// ==== 欧拉角状态（全局） ====
-float yaw = 0.0f, pitch = 0.0f, roll = 0.0f;
-float yaw_v = 0.05f, pitch_v = 0.05f, roll_v = 0.05f;
-
-// ==== DEG 转 RAD ====
-#define DEG2RAD(x) ((x) * 0.0174533f)
-
-// ==== 立方体边的连接关系 ====
-const int edges[12][2] = {
-    {0,1},{1,2},{2,3},{3,0},
-    {4,5},{5,6},{6,7},{7,4},
-    {0,4},{1,5},{2,6},{3,7}
-};
-
-// ==== 主绘制函数 ====
-void DrawCube3D(int16_t centerX, int16_t centerY, float size, uint8_t perspective) {
-    // 三角函数计算
-    float sinY = sinf(yaw), cosY = cosf(yaw);
-    float sinP = sinf(pitch), cosP = cosf(pitch);
-    float sinR = sinf(roll), cosR = cosf(roll);
-
-    const float cube[8][3] = {
-        {-1,-1,-1},{1,-1,-1},{1,1,-1},{-1,1,-1},
-        {-1,-1,1},{1,-1,1},{1,1,1},{-1,1,1}
-    };
-
-//    float rotated[8][3];
-    int projected[8][2];
-
-    for (int i = 0; i < 8; i++) {
-        float x = cube[i][0] * size / 2;
-        float y = cube[i][1] * size / 2;
-        float z = cube[i][2] * size / 2;
-
-        // Roll (X-axis)
-        float y1 = cosR * y - sinR * z;
-        float z1 = sinR * y + cosR * z;
-        y = y1; z = z1;
-        // Pitch (Y-axis)
-        float x1 = cosP * x + sinP * z;
-        z1 = -sinP * x + cosP * z;
-        x = x1; z = z1;
-        // Yaw (Z-axis)
-        x1 = cosY * x - sinY * y;
-        y1 = sinY * x + cosY * y;
-        x = x1; y = y1;
-
-//        rotated[i][0] = x;
-//        rotated[i][1] = y;
-//        rotated[i][2] = z;
-
-        // 投影
-        if (perspective) {
-            float distance = 50.0f;
-            float factor = distance / (distance + z);
-            projected[i][0] = (int)(x * factor) + centerX;
-            projected[i][1] = (int)(y * factor) + centerY;
-        } else {
-            projected[i][0] = (int)x + centerX;
-            projected[i][1] = (int)y + centerY;
-        }
+        OLED_FillVSpan(X, y0, y1 - y0 + 1);
+        OLED_FillVSpan(X + Width - 1, y0, y1 - y0 + 1);
     }
 
-    // 清屏并画线
-    //OLED_Clear();
-    for (int i = 0; i < 12; i++) {
-        int a = edges[i][0], b = edges[i][1];
-        OLED_DrawLine(projected[a][0], projected[a][1], projected[b][0], projected[b][1]);
-    }
-    //OLED_Update();
-
-    // 更新欧拉角（旋转速度）
-    yaw   += DEG2RAD(yaw_v);
-    pitch += DEG2RAD(pitch_v);
-    roll  += DEG2RAD(roll_v);
-
-    // 保证角度在 [0, 2PI) 内循环
-    if (yaw > 6.283f) yaw -= 6.283f;
-    if (pitch > 6.283f) pitch -= 6.283f;
-    if (roll > 6.283f) roll -= 6.283f;
+    /*将画布内容写入显存*/
+    OLED_SpanCommit();
 }
\ No newline at end of file
@@ -0,0 +1,213 @@
+/*
+ * 定点数三维绘制模块 实现文件
+ * 全部使用整数运算，便于在未开启优化或没有双精度浮点单元的芯片上以较高帧率运行
+*/
+#include "OLED.h"
+#include "OLED_3D.h"
+
+/*sin在[0, 90度]上的257点表，Q16.16格式，第i项为sin(i/256 * 90度)*/
+static const int32_t OLED_3D_SinTable[257] = {
+	0, 402, 804, 1206, 1608, 2010, 2412, 2814, 3216, 3617,
+	4019, 4420, 4821, 5222, 5623, 6023, 6424, 6824, 7224, 7623,
+	8022, 8421, 8820, 9218, 9616, 10014, 10411, 10808, 11204, 11600,
+	11996, 12391, 12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+	15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639, 19024, 19409,
+	19792, 20175, 20557, 20939, 21320, 21699, 22078, 22457, 22834, 23210,
+	23586, 23961, 24335, 24708, 25080, 25451, 25821, 26190, 26558, 26925,
+	27291, 27656, 28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+	30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347, 33692, 34037,
+	34380, 34721, 35062, 35401, 35738, 36075, 36410, 36744, 37076, 37407,
+	37736, 38064, 38391, 38716, 39040, 39362, 39683, 40002, 40320, 40636,
+	40951, 41264, 41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+	44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056, 46341, 46624,
+	46906, 47186, 47464, 47741, 48015, 48288, 48559, 48828, 49095, 49361,
+	49624, 49886, 50146, 50404, 50660, 50914, 51166, 51417, 51665, 51911,
+	52156, 52398, 52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+	54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004, 56212, 56418,
+	56621, 56823, 57022, 57219, 57414, 57607, 57798, 57986, 58172, 58356,
+	58538, 58718, 58896, 59071, 59244, 59415, 59583, 59750, 59914, 60075,
+	60235, 60392, 60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+	61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596, 62714, 62830,
+	62943, 63054, 63162, 63268, 63372, 63473, 63572, 63668, 63763, 63854,
+	63944, 64031, 64115, 64197, 64277, 64354, 64429, 64501, 64571, 64639,
+	64704, 64766, 64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+	65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436, 65457, 65476,
+	65492, 65505, 65516, 65525, 65531, 65535, 65536,
+};
+
+/*********************功能函数↓*********************/
+OLED_Fix16_t OLED_3D_Sin(OLED_Angle_t Angle)
+{
+	/*高2位为象限，其余14位为象限内角度：高8位查表，低6位插值*/
+	uint8_t quadrant = Angle >> 14;
+	uint16_t phase = Angle & 0x3FFF;
+	if (quadrant & 1) {phase = 0x4000 - phase;}		//第二、四象限关于90度对称
+
+	uint16_t index = phase >> 6;
+	int32_t frac = phase & 0x3F;
+	int32_t value = OLED_3D_SinTable[index];
+	if (frac != 0)
+	{
+		value += ((OLED_3D_SinTable[index + 1] - value) * frac + 32) >> 6;
+	}
+
+	return (quadrant & 2) ? -value : value;			//第三、四象限取负
+}
+
+OLED_Fix16_t OLED_3D_Cos(OLED_Angle_t Angle)
+{
+	return OLED_3D_Sin((OLED_Angle_t)(Angle + 0x4000));
+}
+
+void OLED_3D_RotationEuler(OLED_Mat3_t *Matrix, OLED_Angle_t Yaw, OLED_Angle_t Pitch, OLED_Angle_t Roll)
+{
+	OLED_Fix16_t sinY = OLED_3D_Sin(Yaw), cosY = OLED_3D_Cos(Yaw);
+	OLED_Fix16_t sinP = OLED_3D_Sin(Pitch), cosP = OLED_3D_Cos(Pitch);
+	OLED_Fix16_t sinR = OLED_3D_Sin(Roll), cosR = OLED_3D_Cos(Roll);
+	OLED_Fix16_t sinPsinR = OLED_Fix16_Mul(sinP, sinR);
+	OLED_Fix16_t sinPcosR = OLED_Fix16_Mul(sinP, cosR);
+
+	/*Rz(Yaw) * Ry(Pitch) * Rx(Roll)*/
+	Matrix->M[0][0] = OLED_Fix16_Mul(cosY, cosP);
+	Matrix->M[0][1] = OLED_Fix16_Mul(cosY, sinPsinR) - OLED_Fix16_Mul(sinY, cosR);
+	Matrix->M[0][2] = OLED_Fix16_Mul(cosY, sinPcosR) + OLED_Fix16_Mul(sinY, sinR);
+	Matrix->M[1][0] = OLED_Fix16_Mul(sinY, cosP);
+	Matrix->M[1][1] = OLED_Fix16_Mul(sinY, sinPsinR) + OLED_Fix16_Mul(cosY, cosR);
+	Matrix->M[1][2] = OLED_Fix16_Mul(sinY, sinPcosR) - OLED_Fix16_Mul(cosY, sinR);
+	Matrix->M[2][0] = -sinP;
+	Matrix->M[2][1] = OLED_Fix16_Mul(cosP, sinR);
+	Matrix->M[2][2] = OLED_Fix16_Mul(cosP, cosR);
+}
+
+OLED_Vec3_t OLED_3D_Transform(const OLED_Mat3_t *Matrix, const OLED_Vec3_t *In)
+{
+	OLED_Vec3_t out;
+	out.X = OLED_Fix16_Mul(Matrix->M[0][0], In->X) + OLED_Fix16_Mul(Matrix->M[0][1], In->Y) + OLED_Fix16_Mul(Matrix->M[0][2], In->Z);
+	out.Y = OLED_Fix16_Mul(Matrix->M[1][0], In->X) + OLED_Fix16_Mul(Matrix->M[1][1], In->Y) + OLED_Fix16_Mul(Matrix->M[1][2], In->Z);
+	out.Z = OLED_Fix16_Mul(Matrix->M[2][0], In->X) + OLED_Fix16_Mul(Matrix->M[2][1], In->Y) + OLED_Fix16_Mul(Matrix->M[2][2], In->Z);
+	return out;
+}
+
+void OLED_3D_Project(const OLED_Vec3_t *V, int16_t CenterX, int16_t CenterY, OLED_Fix16_t Distance,
+					 int16_t *X, int16_t *Y)
+{
+	int32_t x = V->X, y = V->Y;
+
+	if (Distance > 0)
+	{
+		/*顶点位于视点之后时无法投影，退化为视点处的最大缩放*/
+		int32_t depth = Distance + V->Z;
+		if (depth < OLED_FIX16_ONE) {depth = OLED_FIX16_ONE;}
+		x = (int32_t)((int64_t)x * Distance / depth);
+		y = (int32_t)((int64_t)y * Distance / depth);
+	}
+
+	/*C语言整数除法向0取整，与原先浮点转int的行为一致*/
+	*X = (int16_t)(x / OLED_FIX16_ONE + CenterX);
+	*Y = (int16_t)(y / OLED_FIX16_ONE + CenterY);
+}
+
+void OLED_3D_DrawWireframe(const OLED_Vec3_t *Vertices, uint8_t VertexCount,
+						   const uint8_t (*Edges)[2], uint8_t EdgeCount,
+						   const OLED_Mat3_t *Matrix, int16_t CenterX, int16_t CenterY, OLED_Fix16_t Distance)
+{
+	int16_t projected[OLED_3D_MAX_VERTICES][2];
+
+	if (VertexCount > OLED_3D_MAX_VERTICES) {VertexCount = OLED_3D_MAX_VERTICES;}
+
+	for (uint8_t i = 0; i < VertexCount; i++)
+	{
+		OLED_Vec3_t v = OLED_3D_Transform(Matrix, &Vertices[i]);
+		OLED_3D_Project(&v, CenterX, CenterY, Distance, &projected[i][0], &projected[i][1]);
+	}
+
+	for (uint8_t i = 0; i < EdgeCount; i++)
+	{
+		uint8_t a = Edges[i][0], b = Edges[i][1];
+		if (a >= VertexCount || b >= VertexCount) {continue;}
+		OLED_DrawLine(projected[a][0], projected[a][1], projected[b][0], projected[b][1]);
+	}
+}
+
+/**
+  * 函    数：DrawCube3D
+  * 功    能：在OLED屏幕上绘制一个旋转的三维立方体
+  * 参    数：centerX     指定立方体中心的横坐标，范围：0 ~ OLED_WIDTH-1
+  * 参    数：centerY     指定立方体中心的纵坐标，范围：0 ~ OLED_HEIGHT-1
+  * 参    数：size        指定立方体的边长，单位为像素，范围：正浮点数
+  * 参    数：perspective 指定投影方式
+  *                        范围：0 表示平行投影
+  *                              1 表示透视投影
+  * 返 回 值：无
+  * 说    明：调用此函数将根据欧拉角旋转立方体，并将三维顶点通过投影转换为二维坐标，
+  *           然后用画线函数连接各顶点形成立方体边。函数内部包含自增角度，可实现连续旋转效果。
+  *           调用完需执行OLED刷新函数才能显示图像。
+  *           立方体顶点是三个轴向量的正负组合，因此每帧只需把旋转矩阵的三列乘以半边长，
+  *           8个顶点由这三列加减得到，不再逐顶点做矩阵乘法。
+  */
+// ==== 欧拉角状态 ====
+static OLED_Angle_t CubeYaw = 0, CubePitch = 0, CubeRoll = 0;
+
+// ==== 每帧旋转的角度（约0.05度） ====
+#define CUBE_YAW_STEP		OLED_ANGLE_FROM_DEG(0.05)
+#define CUBE_PITCH_STEP		OLED_ANGLE_FROM_DEG(0.05)
+#define CUBE_ROLL_STEP		OLED_ANGLE_FROM_DEG(0.05)
+
+// ==== 透视投影的视点距离 ====
+#define CUBE_DISTANCE		OLED_FIX16_FROM_INT(50)
+
+// ==== 立方体顶点在三个轴上的符号 ====
+static const int8_t CubeSigns[8][3] = {
+	{-1,-1,-1},{1,-1,-1},{1,1,-1},{-1,1,-1},
+	{-1,-1,1},{1,-1,1},{1,1,1},{-1,1,1}
+};
+
+// ==== 立方体边的连接关系 ====
+static const uint8_t CubeEdges[12][2] = {
+	{0,1},{1,2},{2,3},{3,0},
+	{4,5},{5,6},{6,7},{7,4},
+	{0,4},{1,5},{2,6},{3,7}
+};
+
+void DrawCube3D(int16_t centerX, int16_t centerY, float size, uint8_t perspective)
+{
+	OLED_Mat3_t m;
+	OLED_Vec3_t axis[3];
+	int16_t projected[8][2];
+
+	/*半边长，每帧只做这一次浮点转换*/
+	OLED_Fix16_t half = (OLED_Fix16_t)(size * (OLED_FIX16_ONE / 2));
+
+	OLED_3D_RotationEuler(&m, CubeYaw, CubePitch, CubeRoll);
+
+	/*旋转矩阵的第j列乘以半边长，即轴向量j变换后的结果*/
+	for (uint8_t j = 0; j < 3; j++)
+	{
+		axis[j].X = OLED_Fix16_Mul(m.M[0][j], half);
+		axis[j].Y = OLED_Fix16_Mul(m.M[1][j], half);
+		axis[j].Z = OLED_Fix16_Mul(m.M[2][j], half);
+	}
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		OLED_Vec3_t v = {0, 0, 0};
+		for (uint8_t j = 0; j < 3; j++)
+		{
+			if (CubeSigns[i][j] > 0) {v.X += axis[j].X; v.Y += axis[j].Y; v.Z += axis[j].Z;}
+			else                     {v.X -= axis[j].X; v.Y -= axis[j].Y; v.Z -= axis[j].Z;}
+		}
+		OLED_3D_Project(&v, centerX, centerY, perspective ? CUBE_DISTANCE : 0, &projected[i][0], &projected[i][1]);
+	}
+
+	for (uint8_t i = 0; i < 12; i++)
+	{
+		uint8_t a = CubeEdges[i][0], b = CubeEdges[i][1];
+		OLED_DrawLine(projected[a][0], projected[a][1], projected[b][0], projected[b][1]);
+	}
+
+	/*更新欧拉角，OLED_Angle_t溢出后自动回到0，无需手动限制范围*/
+	CubeYaw   += CUBE_YAW_STEP;
+	CubePitch += CUBE_PITCH_STEP;
+	CubeRoll  += CUBE_ROLL_STEP;
+}
+/*********************功能函数↑*********************/
@@ -0,0 +1,121 @@
+#ifndef __OLED_3D_H
+#define __OLED_3D_H
+
+// 检测是否是C++编译器
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * 定点数三维绘制模块
+ * 所有运算使用Q16.16定点数和整数角度，三角函数通过查表获得，不调用sinf/cosf，也不使用浮点运算。
+ * 每帧只根据欧拉角计算一次旋转矩阵，顶点变换、投影全部为整数乘加，
+ * 最后通过OLED_DrawLine直接写入显存。
+ * 适合屏保、待机动画等需要持续刷新的场景。
+ */
+
+/*Q16.16定点数，低16位为小数部分*/
+typedef int32_t OLED_Fix16_t;
+
+#define OLED_FIX16_ONE              (65536)
+#define OLED_FIX16_FROM_INT(x)      ((OLED_Fix16_t)(x) * OLED_FIX16_ONE)
+/*仅用于常量表达式，由编译器在编译期完成换算*/
+#define OLED_FIX16_FROM_CONST(x)    ((OLED_Fix16_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/*角度，65536对应一整圈，溢出后自动回绕*/
+typedef uint16_t OLED_Angle_t;
+
+/*仅用于常量表达式，将角度（度）换算为OLED_Angle_t*/
+#define OLED_ANGLE_FROM_DEG(d)      ((OLED_Angle_t)((d) * 65536.0 / 360.0 + 0.5))
+
+/*一个wireframe模型最多的顶点数*/
+#define OLED_3D_MAX_VERTICES        (32)
+
+/*三维向量*/
+typedef struct {
+    OLED_Fix16_t X;
+    OLED_Fix16_t Y;
+    OLED_Fix16_t Z;
+} OLED_Vec3_t;
+
+/*3x3旋转矩阵，M[行][列]*/
+typedef struct {
+    OLED_Fix16_t M[3][3];
+} OLED_Mat3_t;
+
+/**
+  * 函    数：定点数乘法
+  * 返 回 值：A*B，结果四舍五入
+  */
+static inline OLED_Fix16_t OLED_Fix16_Mul(OLED_Fix16_t A, OLED_Fix16_t B)
+{
+    return (OLED_Fix16_t)(((int64_t)A * B + 0x8000) >> 16);
+}
+
+/**
+  * 函    数：查表计算正弦值
+  * 参    数：Angle 角度，65536对应一整圈
+  * 返 回 值：正弦值，Q16.16格式，范围-65536~65536
+  * 说    明：四分之一周期257点查表，表项之间线性插值，误差约1个最低位
+  */
+OLED_Fix16_t OLED_3D_Sin(OLED_Angle_t Angle);
+
+/**
+  * 函    数：查表计算余弦值
+  * 参    数：Angle 角度，65536对应一整圈
+  * 返 回 值：余弦值，Q16.16格式
+  */
+OLED_Fix16_t OLED_3D_Cos(OLED_Angle_t Angle);
+
+/**
+  * 函    数：根据欧拉角计算旋转矩阵
+  * 参    数：Matrix 输出旋转矩阵
+  * 参    数：Yaw 绕Z轴旋转角度
+  * 参    数：Pitch 绕Y轴旋转角度
+  * 参    数：Roll 绕X轴旋转角度
+  * 说    明：旋转顺序为先Roll，再Pitch，最后Yaw，即Matrix = Rz * Ry * Rx
+  */
+void OLED_3D_RotationEuler(OLED_Mat3_t *Matrix, OLED_Angle_t Yaw, OLED_Angle_t Pitch, OLED_Angle_t Roll);
+
+/**
+  * 函    数：用旋转矩阵变换一个顶点
+  * 参    数：Matrix 旋转矩阵
+  * 参    数：In 输入顶点
+  * 返 回 值：变换后的顶点
+  */
+OLED_Vec3_t OLED_3D_Transform(const OLED_Mat3_t *Matrix, const OLED_Vec3_t *In);
+
+/**
+  * 函    数：将三维顶点投影到屏幕坐标
+  * 参    数：V 已经变换过的顶点
+  * 参    数：CenterX CenterY 投影中心在屏幕上的坐标
+  * 参    数：Distance 视点到原点的距离，0表示平行投影
+  * 参    数：X Y 输出屏幕坐标
+  * 说    明：透视投影的缩放系数为Distance/(Distance+Z)，坐标向0取整
+  */
+void OLED_3D_Project(const OLED_Vec3_t *V, int16_t CenterX, int16_t CenterY, OLED_Fix16_t Distance,
+                     int16_t *X, int16_t *Y);
+
+/**
+  * 函    数：绘制线框模型
+  * 参    数：Vertices 模型顶点，最多OLED_3D_MAX_VERTICES个
+  * 参    数：VertexCount 顶点数
+  * 参    数：Edges 边数组，每条边为两个顶点下标
+  * 参    数：EdgeCount 边数
+  * 参    数：Matrix 旋转矩阵，每帧由OLED_3D_RotationEuler计算一次
+  * 参    数：CenterX CenterY 模型原点在屏幕上的坐标
+  * 参    数：Distance 视点距离，0表示平行投影
+  * 说    明：每个顶点只变换和投影一次，之后按边连线。调用后需调用更新函数才能显示
+  */
+void OLED_3D_DrawWireframe(const OLED_Vec3_t *Vertices, uint8_t VertexCount,
+                           const uint8_t (*Edges)[2], uint8_t EdgeCount,
+                           const OLED_Mat3_t *Matrix, int16_t CenterX, int16_t CenterY, OLED_Fix16_t Distance);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ * 显存块传输（blit）模块 实现文件
+ * 所有函数只对OLED显存数组进行读写，调用后仍需调用更新函数才会显示
+*/
+#include "OLED.h"
+#include "OLED_Blit.h"
+
+extern uint8_t OLED_DisplayBuf[OLED_HEIGHT/8][OLED_WIDTH];
+
+/*********************工具函数↓********************/
+/**
+  * 函    数：向下取整的除8运算，负数同样向负无穷取整
+  */
+static inline int16_t Blit_FloorDiv8(int16_t Value)
+{
+	return (Value >= 0) ? (Value / 8) : -((-Value + 7) / 8);
+}
+
+/**
+  * 函    数：计算某一页中位于[Y0, Y1)范围内的行掩码
+  */
+static inline uint8_t Blit_PageMask(int16_t Page, int16_t Y0, int16_t Y1)
+{
+	int16_t lo = (Y0 > Page * 8) ? Y0 - Page * 8 : 0;
+	int16_t hi = (Y1 < Page * 8 + 8) ? Y1 - Page * 8 : 8;
+	return (uint8_t)((0xFF >> (8 - (hi - lo))) << lo);
+}
+
+/**
+  * 函    数：对一段连续的显存字节执行相同掩码的位运算
+  * 参    数：Dst 显存起始地址
+  * 参    数：Count 字节数
+  * 参    数：Mask 每个字节中参与运算的位
+  * 参    数：Op 位运算类型，OLED_BLIT_COPY按OLED_BLIT_OR处理
+  * 说    明：每次处理4个字节（4列），剩余不足4个字节的部分逐字节处理
+  */
+static void Blit_SpanConst(uint8_t *Dst, uint16_t Count, uint8_t Mask, OLED_BlitOp_t Op)
+{
+	uint32_t mask32 = Mask * 0x01010101u;
+	uint32_t word;
+
+	switch (Op)
+	{
+		case OLED_BLIT_ANDNOT:
+			for (; Count >= 4; Count -= 4, Dst += 4)
+			{
+				memcpy(&word, Dst, 4); word &= ~mask32; memcpy(Dst, &word, 4);
+			}
+			while (Count--) {*Dst++ &= ~Mask;}
+			break;
+		case OLED_BLIT_XOR:
+			for (; Count >= 4; Count -= 4, Dst += 4)
+			{
+				memcpy(&word, Dst, 4); word ^= mask32; memcpy(Dst, &word, 4);
+			}
+			while (Count--) {*Dst++ ^= Mask;}
+			break;
+		default:
+			for (; Count >= 4; Count -= 4, Dst += 4)
+			{
+				memcpy(&word, Dst, 4); word |= mask32; memcpy(Dst, &word, 4);
+			}
+			while (Count--) {*Dst++ |= Mask;}
+			break;
+	}
+}
+
+/**
+  * 函    数：将一段连续的源字节与显存字节做位运算
+  * 参    数：Dst 显存起始地址
+  * 参    数：Src 源数据起始地址
+  * 参    数：Count 字节数
+  * 参    数：Mask 每个字节中参与运算的位
+  * 参    数：Op 位运算类型
+  * 说    明：源数据已经与显存页对齐，无需移位，每次处理4个字节
+  */
+static void Blit_Span(uint8_t *Dst, const uint8_t *Src, uint16_t Count, uint8_t Mask, OLED_BlitOp_t Op)
+{
+	uint32_t mask32 = Mask * 0x01010101u;
+	uint32_t d, s;
+
+	for (; Count >= 4; Count -= 4, Dst += 4, Src += 4)
+	{
+		memcpy(&d, Dst, 4);
+		memcpy(&s, Src, 4);
+		s &= mask32;
+		switch (Op)
+		{
+			case OLED_BLIT_ANDNOT:	d &= ~s; break;
+			case OLED_BLIT_XOR:		d ^= s; break;
+			case OLED_BLIT_COPY:	d = (d & ~mask32) | s; break;
+			default:				d |= s; break;
+		}
+		memcpy(Dst, &d, 4);
+	}
+	while (Count--)
+	{
+		uint8_t b = *Src++ & Mask;
+		switch (Op)
+		{
+			case OLED_BLIT_ANDNOT:	*Dst &= ~b; break;
+			case OLED_BLIT_XOR:		*Dst ^= b; break;
+			case OLED_BLIT_COPY:	*Dst = (*Dst & ~Mask) | b; break;
+			default:				*Dst |= b; break;
+		}
+		Dst++;
+	}
+}
+/*********************工具函数↑********************/
+
+/*********************功能函数↓*********************/
+bool OLED_Blit_ClipInit(OLED_ClipRect_t *Clip, int16_t X, int16_t Y, int16_t Width, int16_t Height)
+{
+	Clip->X0 = 0;
+	Clip->Y0 = 0;
+	Clip->X1 = OLED_WIDTH;
+	Clip->Y1 = OLED_HEIGHT;
+	return OLED_Blit_ClipIntersect(Clip, X, Y, Width, Height);
+}
+
+bool OLED_Blit_ClipIntersect(OLED_ClipRect_t *Clip, int16_t X, int16_t Y, int16_t Width, int16_t Height)
+{
+	if (Width <= 0 || Height <= 0) {return false;}
+
+	/*使用32位计算右下角，避免大尺寸时溢出*/
+	int32_t x1 = (int32_t)X + Width;
+	int32_t y1 = (int32_t)Y + Height;
+
+	if (X > Clip->X0) {Clip->X0 = X;}
+	if (Y > Clip->Y0) {Clip->Y0 = Y;}
+	if (x1 < Clip->X1) {Clip->X1 = (int16_t)x1;}
+	if (y1 < Clip->Y1) {Clip->Y1 = (int16_t)y1;}
+
+	return Clip->X0 < Clip->X1 && Clip->Y0 < Clip->Y1;
+}
+
+void OLED_Blit_FillRect(const OLED_ClipRect_t *Clip, OLED_BlitOp_t Op)
+{
+	int16_t firstPage = Clip->Y0 / 8;
+	int16_t lastPage = (Clip->Y1 - 1) / 8;
+	uint16_t count = Clip->X1 - Clip->X0;
+
+	for (int16_t page = firstPage; page <= lastPage; page++)
+	{
+		Blit_SpanConst(&OLED_DisplayBuf[page][Clip->X0], count, Blit_PageMask(page, Clip->Y0, Clip->Y1), Op);
+	}
+}
+
+void OLED_Blit_Image(const OLED_ClipRect_t *Clip, int16_t X, int16_t Y, uint16_t Width, uint16_t Height,
+                     const uint8_t *Image, OLED_BlitOp_t Op)
+{
+	if (Width == 0 || Height == 0) {return;}
+
+	/*图像数据共Pages页，裁剪到图像实际覆盖的范围*/
+	int16_t pages = (Height - 1) / 8 + 1;
+	OLED_ClipRect_t clip = *Clip;
+	if (!OLED_Blit_ClipIntersect(&clip, X, Y, Width, pages * 8)) {return;}
+
+	int16_t firstPage = clip.Y0 / 8;
+	int16_t lastPage = (clip.Y1 - 1) / 8;
+	uint16_t count = clip.X1 - clip.X0;
+	uint16_t srcCol = clip.X0 - X;
+
+	for (int16_t page = firstPage; page <= lastPage; page++)
+	{
+		uint8_t mask = Blit_PageMask(page, clip.Y0, clip.Y1);
+		uint8_t *dst = &OLED_DisplayBuf[page][clip.X0];
+
+		/*当前显存页第0行对应的图像行，以及它所在的图像页和页内偏移*/
+		int16_t srcRow = page * 8 - Y;
+		int16_t srcPage = Blit_FloorDiv8(srcRow);
+		uint8_t shift = srcRow - srcPage * 8;
+
+		if (shift == 0)
+		{
+			/*页对齐：图像页与显存页一一对应，直接按字节运算*/
+			Blit_Span(dst, &Image[srcPage * Width + srcCol], count, mask, Op);
+			continue;
+		}
+
+		/*非页对齐：显存页由上一图像页的高位和下一图像页的低位拼成*/
+		const uint8_t *upper = (srcPage >= 0 && srcPage < pages) ? &Image[srcPage * Width + srcCol] : NULL;
+		const uint8_t *lower = (srcPage + 1 >= 0 && srcPage + 1 < pages) ? &Image[(srcPage + 1) * Width + srcCol] : NULL;
+		for (uint16_t i = 0; i < count; i++)
+		{
+			uint8_t b = 0;
+			if (upper != NULL) {b |= upper[i] >> shift;}
+			if (lower != NULL) {b |= lower[i] << (8 - shift);}
+			b &= mask;
+			switch (Op)
+			{
+				case OLED_BLIT_ANDNOT:	dst[i] &= ~b; break;
+				case OLED_BLIT_XOR:		dst[i] ^= b; break;
+				case OLED_BLIT_COPY:	dst[i] = (dst[i] & ~mask) | b; break;
+				default:				dst[i] |= b; break;
+			}
+		}
+	}
+}
+
+void OLED_Blit_ScrollV(const OLED_ClipRect_t *Clip, int16_t Dy)
+{
+	int16_t height = Clip->Y1 - Clip->Y0;
+	if (Dy == 0) {return;}
+	if (Dy >= height || -Dy >= height)		//全部移出矩形，等同于清除
+	{
+		OLED_Blit_FillRect(Clip, OLED_BLIT_ANDNOT);
+		return;
+	}
+
+	int16_t firstPage = Clip->Y0 / 8;
+	int16_t lastPage = (Clip->Y1 - 1) / 8;
+	uint8_t base = firstPage * 8;
+
+	/*矩形所占的行在列整数中的掩码，第0位对应firstPage页的第0行*/
+	uint64_t rowMask = ((height >= 64) ? ~0ull : ((1ull << height) - 1)) << (Clip->Y0 - base);
+
+	for (int16_t x = Clip->X0; x < Clip->X1; x++)
+	{
+		uint64_t column = 0;
+		for (int16_t page = firstPage; page <= lastPage; page++)
+		{
+			column |= (uint64_t)OLED_DisplayBuf[page][x] << ((page - firstPage) * 8);
+		}
+
+		uint64_t moved = (Dy > 0) ? (column & rowMask) << Dy : (column & rowMask) >> -Dy;
+		column = (column & ~rowMask) | (moved & rowMask);
+
+		for (int16_t page = firstPage; page <= lastPage; page++)
+		{
+			OLED_DisplayBuf[page][x] = (uint8_t)(column >> ((page - firstPage) * 8));
+		}
+	}
+}
+/*********************功能函数↑*********************/
@@ -0,0 +1,85 @@
+#ifndef __OLED_BLIT_H
+#define __OLED_BLIT_H
+
+// 检测是否是C++编译器
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * 显存块传输（blit）模块
+ * OLED显存按页组织，每页8行，一个字节对应一列中的8个像素。
+ * 此模块把"矩形区域 + 位运算"抽象为统一的操作：
+ *   1. 每次调用只计算一次裁剪矩形，内层循环不再做逐像素的边界判断
+ *   2. 图像纵坐标页对齐时，源数据无需移位，直接按字节运算
+ *   3. 同一页内连续的列按32位字一次处理4列
+ * OLED.c中的清除、取反、填充和图像显示函数都通过此模块写显存。
+ */
+
+/*位运算类型*/
+typedef enum {
+    OLED_BLIT_OR = 0,       // 置位：dst |= src
+    OLED_BLIT_ANDNOT,       // 清除：dst &= ~src
+    OLED_BLIT_XOR,          // 取反：dst ^= src
+    OLED_BLIT_COPY          // 覆盖：dst = src（仅裁剪区域内）
+} OLED_BlitOp_t;
+
+/*裁剪矩形，左闭右开：[X0, X1) x [Y0, Y1)*/
+typedef struct {
+    int16_t X0;
+    int16_t Y0;
+    int16_t X1;
+    int16_t Y1;
+} OLED_ClipRect_t;
+
+/**
+  * 函    数：计算矩形与屏幕的交集
+  * 参    数：Clip 输出裁剪矩形
+  * 参    数：X Y Width Height 指定矩形，坐标可为负
+  * 返 回 值：交集是否非空，为false时Clip内容无效
+  */
+bool OLED_Blit_ClipInit(OLED_ClipRect_t *Clip, int16_t X, int16_t Y, int16_t Width, int16_t Height);
+
+/**
+  * 函    数：将裁剪矩形与另一个矩形求交集
+  * 参    数：Clip 输入输出裁剪矩形
+  * 参    数：X Y Width Height 指定矩形，坐标可为负
+  * 返 回 值：交集是否非空
+  */
+bool OLED_Blit_ClipIntersect(OLED_ClipRect_t *Clip, int16_t X, int16_t Y, int16_t Width, int16_t Height);
+
+/**
+  * 函    数：对裁剪矩形内的全部像素执行位运算
+  * 参    数：Clip 裁剪矩形，必须已经与屏幕求过交集
+  * 参    数：Op OLED_BLIT_OR置1，OLED_BLIT_ANDNOT清0，OLED_BLIT_XOR取反
+  */
+void OLED_Blit_FillRect(const OLED_ClipRect_t *Clip, OLED_BlitOp_t Op);
+
+/**
+  * 函    数：将页格式图像与显存做位运算，只影响裁剪矩形内的像素
+  * 参    数：Clip 裁剪矩形，必须已经与屏幕求过交集
+  * 参    数：X Y 图像左上角坐标，可为负
+  * 参    数：Width Height 图像宽度和高度，图像数据按页存放，共(Height-1)/8+1页
+  * 参    数：Image 图像数据
+  * 参    数：Op 位运算类型
+  */
+void OLED_Blit_Image(const OLED_ClipRect_t *Clip, int16_t X, int16_t Y, uint16_t Width, uint16_t Height,
+                     const uint8_t *Image, OLED_BlitOp_t Op);
+
+/**
+  * 函    数：将裁剪矩形内的像素整体上下平移
+  * 参    数：Clip 裁剪矩形，必须已经与屏幕求过交集
+  * 参    数：Dy 平移的行数，正数向下，负数向上
+  * 说    明：移出矩形的像素被丢弃，移入的空白行清0，矩形外的像素不受影响
+  *           每列的各页拼成一个整数后一次移位，用于列表滚动时复用已经绘制好的行
+  */
+void OLED_Blit_ScrollV(const OLED_ClipRect_t *Clip, int16_t Dy);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
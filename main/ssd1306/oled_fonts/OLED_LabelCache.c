@@ -0,0 +1,307 @@
+/*
+ * 静态标签位图缓存 实现文件
+ * 标签第一次显示时借用显存左上角区域完成光栅化，随后把结果拷贝到内存池，
+ * 之后的重绘直接交给块传输模块按页拷贝位图，不再经过UTF-8解码和字模查找。
+*/
+#include "OLED.h"
+#include "OLED_LabelCache.h"
+
+extern uint8_t OLED_DisplayBuf[OLED_HEIGHT/8][OLED_WIDTH];
+
+/*可缓存标签的最大页数（20像素高的字体占3页）*/
+#define LABEL_MAX_PAGES		(3)
+
+/*缓存条目*/
+typedef struct {
+	const char *String;		//字符串指针（键）
+	uint32_t Hash;			//字符串内容哈希，防止指针被复用后显示旧内容
+	uint16_t Offset;		//位图在内存池中的偏移
+	uint16_t Size;			//位图字节数
+	uint8_t Width;			//标签宽度
+	uint8_t Height;			//标签高度
+	uint8_t ChineseFontSize;	//中文字体大小（键）
+	uint8_t ASCIIFontSize;		//ASCII字体大小（键）
+	bool Inverse;			//是否反色（键）
+	bool Used;				//条目是否有效
+	uint32_t LastUse;		//最近一次使用的时间戳，用于LRU淘汰
+} LabelCacheEntry_t;
+
+static uint8_t LabelArena[OLED_LABEL_CACHE_ARENA_SIZE];
+static LabelCacheEntry_t LabelEntries[OLED_LABEL_CACHE_MAX_ENTRIES];
+static uint16_t ArenaUsed = 0;
+static uint32_t UseClock = 0;
+static uint32_t CacheHits = 0, CacheMisses = 0, CacheEvictions = 0;
+
+/*光栅化时用于保存被借用的显存区域*/
+static uint8_t RasterSave[LABEL_MAX_PAGES][OLED_WIDTH];
+
+/*********************工具函数↓********************/
+/**
+  * 函    数：根据ASCII字体大小获取字体高度
+  * 参    数：ASCIIFontSize ASCII字体大小
+  * 返 回 值：字体高度，不支持的字体返回0
+  */
+static uint8_t LabelCache_ASCIIHeight(uint8_t ASCIIFontSize)
+{
+	switch (ASCIIFontSize)
+	{
+		case OLED_6X8_HALF:		return 8;
+		case OLED_7X12_HALF:	return 12;
+		case OLED_8X16_HALF:	return 16;
+		case OLED_10X20_HALF:	return 20;
+		default:				return 0;
+	}
+}
+
+/**
+  * 函    数：计算标签的尺寸和内容哈希（FNV-1a）
+  * 参    数：String 标签字符串
+  * 参    数：Width Height 输出标签宽度和高度
+  * 返 回 值：标签是否可以缓存，过宽、过高或含不同高度的字形时不可缓存
+  * 说    明：只有所有字形高度一致时，整体位图的清除区域才与逐字符绘制完全相同
+  */
+static bool LabelCache_Measure(const char *String, uint8_t ChineseFontSize, uint8_t ASCIIFontSize,
+							   uint16_t *Width, uint8_t *Height, uint32_t *Hash)
+{
+	uint32_t hash = 2166136261u;
+	uint16_t w = 0;
+	uint8_t h = 0;
+	bool uniform = true;
+	uint8_t asciiHeight = LabelCache_ASCIIHeight(ASCIIFontSize);
+
+	while (*String != '\0')
+	{
+		uint8_t glyphHeight;
+		uint8_t bytes;
+		if (*String & 0x80)		//中文字符，与OLED_ShowMixString的判断方式一致
+		{
+			glyphHeight = ChineseFontSize;
+			w += ChineseFontSize;
+			bytes = OLED_CHN_CHAR_WIDTH;
+		}
+		else
+		{
+			glyphHeight = asciiHeight;
+			w += ASCIIFontSize;
+			bytes = 1;
+		}
+		for (uint8_t i = 0; i < bytes; i++)
+		{
+			hash = (hash ^ (uint8_t)String[i]) * 16777619u;
+		}
+		if (h != 0 && glyphHeight != h) {uniform = false;}
+		if (glyphHeight > h) {h = glyphHeight;}
+		String += bytes;
+	}
+
+	*Width = w;
+	*Height = h;
+	*Hash = hash;
+	return uniform && w > 0 && w <= OLED_WIDTH && h > 0 && h <= LABEL_MAX_PAGES * 8;
+}
+
+/**
+  * 函    数：整理内存池，将有效条目紧凑排列到内存池前部
+  */
+static void LabelCache_Compact(void)
+{
+	uint16_t cursor = 0;
+	while (1)
+	{
+		/*在剩余条目中找到偏移最小的一个，按偏移顺序依次前移*/
+		LabelCacheEntry_t *next = NULL;
+		for (uint8_t i = 0; i < OLED_LABEL_CACHE_MAX_ENTRIES; i++)
+		{
+			LabelCacheEntry_t *e = &LabelEntries[i];
+			if (e->Used && e->Offset >= cursor && (next == NULL || e->Offset < next->Offset))
+			{
+				next = e;
+			}
+		}
+		if (next == NULL) {break;}
+		if (next->Offset != cursor)
+		{
+			memmove(&LabelArena[cursor], &LabelArena[next->Offset], next->Size);
+			next->Offset = cursor;
+		}
+		cursor += next->Size;
+	}
+	ArenaUsed = cursor;
+}
+
+/**
+  * 函    数：为新条目分配内存池空间，空间不足时按LRU淘汰旧条目
+  * 参    数：Size 需要的字节数
+  * 返 回 值：可用的空闲条目，失败返回NULL
+  */
+static LabelCacheEntry_t *LabelCache_Alloc(uint16_t Size)
+{
+	if (Size > OLED_LABEL_CACHE_ARENA_SIZE) {return NULL;}
+
+	while (1)
+	{
+		LabelCacheEntry_t *freeEntry = NULL;
+		LabelCacheEntry_t *oldest = NULL;
+		uint16_t liveBytes = 0;
+		for (uint8_t i = 0; i < OLED_LABEL_CACHE_MAX_ENTRIES; i++)
+		{
+			LabelCacheEntry_t *e = &LabelEntries[i];
+			if (!e->Used)
+			{
+				if (freeEntry == NULL) {freeEntry = e;}
+				continue;
+			}
+			liveBytes += e->Size;
+			if (oldest == NULL || e->LastUse < oldest->LastUse) {oldest = e;}
+		}
+
+		if (freeEntry != NULL && liveBytes + Size <= OLED_LABEL_CACHE_ARENA_SIZE)
+		{
+			/*总空间足够但尾部不够时整理一次碎片*/
+			if (ArenaUsed + Size > OLED_LABEL_CACHE_ARENA_SIZE) {LabelCache_Compact();}
+			freeEntry->Offset = ArenaUsed;
+			freeEntry->Size = Size;
+			ArenaUsed += Size;
+			return freeEntry;
+		}
+
+		if (oldest == NULL) {return NULL;}
+		oldest->Used = false;
+		CacheEvictions++;
+	}
+}
+
+/**
+  * 函    数：将标签光栅化到缓存条目
+  * 说    明：暂时借用显存左上角区域，用OLED_ShowMixString绘制后取出，再恢复原有内容
+  */
+static void LabelCache_Rasterize(LabelCacheEntry_t *Entry)
+{
+	uint8_t pages = (Entry->Height + 7) / 8;
+	uint8_t *dst = &LabelArena[Entry->Offset];
+
+	for (uint8_t p = 0; p < pages; p++)
+	{
+		memcpy(RasterSave[p], OLED_DisplayBuf[p], Entry->Width);
+		memset(OLED_DisplayBuf[p], 0, Entry->Width);
+	}
+
+	OLED_ShowMixString(0, 0, (char *)Entry->String, Entry->ChineseFontSize, Entry->ASCIIFontSize);
+
+	for (uint8_t p = 0; p < pages; p++)
+	{
+		/*反色时只翻转标签高度以内的位，保证位图外的位为0*/
+		uint8_t validBits = Entry->Height - p * 8;
+		uint8_t mask = (validBits >= 8) ? 0xFF : (uint8_t)(0xFF >> (8 - validBits));
+		for (uint8_t i = 0; i < Entry->Width; i++)
+		{
+			uint8_t data = OLED_DisplayBuf[p][i];
+			dst[p * Entry->Width + i] = Entry->Inverse ? (uint8_t)(~data & mask) : data;
+		}
+		memcpy(OLED_DisplayBuf[p], RasterSave[p], Entry->Width);
+	}
+}
+
+/**
+  * 函    数：把缓存的标签位图绘制到显存
+  * 说    明：标签高度为整页且页对齐时，OLED_ShowImage会走块传输的直接拷贝路径
+  */
+static void LabelCache_Blit(int16_t X, int16_t Y, const LabelCacheEntry_t *Entry)
+{
+	OLED_ShowImage(X, Y, Entry->Width, Entry->Height, &LabelArena[Entry->Offset]);
+}
+/*********************工具函数↑********************/
+
+/*********************功能函数↓*********************/
+void OLED_ShowMixStringCached(int16_t X, int16_t Y, const char *String, uint8_t ChineseFontSize, uint8_t ASCIIFontSize, bool Inverse)
+{
+	uint16_t width;
+	uint8_t height;
+	uint32_t hash;
+	LabelCacheEntry_t *entry = NULL;
+
+	if (String == NULL) {return;}
+
+	bool cacheable = LabelCache_Measure(String, ChineseFontSize, ASCIIFontSize, &width, &height, &hash);
+	UseClock++;
+
+	for (uint8_t i = 0; i < OLED_LABEL_CACHE_MAX_ENTRIES; i++)
+	{
+		LabelCacheEntry_t *e = &LabelEntries[i];
+		if (e->Used && e->String == String && e->Hash == hash && e->Inverse == Inverse &&
+			e->ChineseFontSize == ChineseFontSize && e->ASCIIFontSize == ASCIIFontSize)
+		{
+			entry = e;
+			break;
+		}
+	}
+
+	if (entry != NULL)
+	{
+		CacheHits++;
+		entry->LastUse = UseClock;
+		LabelCache_Blit(X, Y, entry);
+		return;
+	}
+
+	CacheMisses++;
+
+	if (cacheable)
+	{
+		entry = LabelCache_Alloc(width * ((height + 7) / 8));
+	}
+
+	if (entry == NULL)
+	{
+		/*无法缓存，退回逐字符绘制*/
+		if (Inverse) {OLED_ReverseArea(X, Y, width, height);}
+		OLED_ShowMixString(X, Y, (char *)String, ChineseFontSize, ASCIIFontSize);
+		if (Inverse) {OLED_ReverseArea(X, Y, width, height);}
+		return;
+	}
+
+	entry->String = String;
+	entry->Hash = hash;
+	entry->Width = width;
+	entry->Height = height;
+	entry->ChineseFontSize = ChineseFontSize;
+	entry->ASCIIFontSize = ASCIIFontSize;
+	entry->Inverse = Inverse;
+	entry->Used = true;
+	entry->LastUse = UseClock;
+
+	LabelCache_Rasterize(entry);
+	LabelCache_Blit(X, Y, entry);
+}
+
+void OLED_LabelCache_Invalidate(void)
+{
+	memset(LabelEntries, 0, sizeof(LabelEntries));
+	ArenaUsed = 0;
+}
+
+void OLED_LabelCache_GetStats(OLED_LabelCacheStats_t *Stats)
+{
+	if (Stats == NULL) {return;}
+
+	uint32_t total = CacheHits + CacheMisses;
+	uint8_t count = 0;
+	uint16_t used = 0;
+	for (uint8_t i = 0; i < OLED_LABEL_CACHE_MAX_ENTRIES; i++)
+	{
+		if (LabelEntries[i].Used)
+		{
+			count++;
+			used += LabelEntries[i].Size;
+		}
+	}
+
+	Stats->hits = CacheHits;
+	Stats->misses = CacheMisses;
+	Stats->evictions = CacheEvictions;
+	Stats->hit_rate = (total > 0) ? (uint8_t)((uint64_t)CacheHits * 100 / total) : 0;
+	Stats->entry_count = count;
+	Stats->arena_used = used;
+	Stats->arena_size = OLED_LABEL_CACHE_ARENA_SIZE;
+}
+/*********************功能函数↑*********************/
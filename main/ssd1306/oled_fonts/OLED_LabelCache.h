@@ -0,0 +1,66 @@
+#ifndef __OLED_LABEL_CACHE_H
+#define __OLED_LABEL_CACHE_H
+
+// 检测是否是C++编译器
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * 静态标签位图缓存
+ * 菜单项名称等静态文本每次重绘都要重新解码UTF-8、查找字模并逐位绘制。
+ * 此模块将整条标签预先光栅化为与OLED显存相同的页格式位图，保存在固定大小的内存池中，
+ * 以(字符串指针, 字体大小, 是否反色)为键，按LRU策略淘汰。
+ * 命中后只需按页拷贝位图，不再逐字符绘制。
+ */
+
+/*缓存内存池大小（字节），128x16的整行标签占用256字节*/
+#define OLED_LABEL_CACHE_ARENA_SIZE     (2048)
+/*最多缓存的标签数量*/
+#define OLED_LABEL_CACHE_MAX_ENTRIES    (16)
+
+/*缓存统计信息*/
+typedef struct {
+    uint32_t hits;              // 命中次数
+    uint32_t misses;            // 未命中次数（包括无法缓存的标签）
+    uint32_t evictions;         // 因空间不足被淘汰的条目数
+    uint8_t  hit_rate;          // 命中率，百分比 0~100
+    uint8_t  entry_count;       // 当前缓存的条目数
+    uint16_t arena_used;        // 内存池已使用字节数
+    uint16_t arena_size;        // 内存池总字节数
+} OLED_LabelCacheStats_t;
+
+/**
+  * 函    数：使用缓存显示中英文混合标签
+  * 参    数：X 指定标签左上角的横坐标，范围：负值~OLED_WIDTH-1
+  * 参    数：Y 指定标签左上角的纵坐标，范围：负值~OLED_HEIGHT-1
+  * 参    数：String 要显示的标签，必须是内容不会变化的静态字符串（如菜单项名称）
+  * 参    数：ChineseFontSize 中文字体大小，OLED_8X8_FULL,OLED_12X12_FULL,OLED_16X16_FULL,OLED_20X20_FULL
+  * 参    数：ASCIIFontSize ASCII字体大小，OLED_6X8_HALF,OLED_7X12_HALF,OLED_8X16_HALF,OLED_10X20_HALF
+  * 参    数：Inverse 是否反色显示标签（文字区域取反）
+  * 返 回 值：无
+  * 说    明：显示效果与OLED_ShowMixString相同，Inverse为true时等同于在文字区域前后各调用一次OLED_ReverseArea
+  *           标签过宽或过高无法缓存时，直接退回逐字符绘制
+  */
+void OLED_ShowMixStringCached(int16_t X, int16_t Y, const char *String, uint8_t ChineseFontSize, uint8_t ASCIIFontSize, bool Inverse);
+
+/**
+  * 函    数：清空标签缓存
+  * 说    明：字符串内容被修改或释放后需要调用此函数
+  */
+void OLED_LabelCache_Invalidate(void);
+
+/**
+  * 函    数：获取标签缓存统计信息
+  * 参    数：Stats 输出统计信息
+  */
+void OLED_LabelCache_GetStats(OLED_LabelCacheStats_t *Stats);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
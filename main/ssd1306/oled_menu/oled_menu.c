@@ -1,10 +1,6 @@
 #include "oled_menu.h"
 
 
-// 前向声明，避免循环引用
-void MenuManager_ClearKeyQueue(void);
-
-
 // 最大移动偏移量
 #define MAX_MOVE_OFFSET 5
 
@@ -15,6 +11,8 @@ void MenuManager_ClearKeyQueue(void);
 void MenuManager_Init(MenuManager* manager) {
     if (manager == NULL) return;
     
+    manager->tree = NULL;
+    manager->itemCount = 0;
     manager->rootMenu = NULL;
     manager->currentMenu = NULL;
     manager->selectedItem = NULL;
@@ -27,139 +25,74 @@ void MenuManager_Init(MenuManager* manager) {
     // 初始化状态栈
     manager->stackDepth = 0;
     memset(manager->stateStack, 0, sizeof(manager->stateStack));
-}
-
-
-/**
- * @brief 创建文本菜单项
- * @param name 菜单项名称
- * @param action 选择菜单项执行的操作
- * @return 菜单项指针，失败返回NULL
- */
-static MenuItem* MenuItem_CreateText(char* name, MenuAction action) {
-    MenuItem* item = (MenuItem*)malloc(sizeof(MenuItem));
-    if (item == NULL) return NULL;
-    
-    // 初始化所有字段
-    item->type = MENU_ITEM_TEXT;
-    
-    // 复制菜单项名称
-    item->name = (char*)malloc(strlen(name) + 1);
-    if (item->name == NULL) {
-        free(item);
-        return NULL;
-    }
-    strcpy(item->name, name);
-    
-    item->action = action;
-    item->parent = NULL;
-    item->child = NULL;
-    item->next = NULL;
     
-    // 图片相关字段设为默认值
-    item->imageData = NULL;
-    item->imageWidth = 0;
-    item->imageHeight = 0;
+    // 初始化保留模式渲染状态，首次显示时整屏绘制
+    memset(&manager->view, 0, sizeof(manager->view));
     
-    return item;
+    // 没有运行中的活动，也没有待绘制的内容
+    manager->activity = NULL;
+    manager->timerArmed = false;
+    manager->timerDeadline = 0;
+    manager->dirty = false;
+    manager->lastFrame = 0;
 }
 
 /**
- * @brief 创建图片菜单项（支持不显示文字）
- * @param name 菜单项名称
- * @param imageData 图片数据
- * @param width 图片宽度
- * @param height 图片高度
- * @param action 选择菜单项执行的操作
- * @param showName 是否显示名称
- * @return 菜单项指针，失败返回NULL
+ * @brief 设置菜单管理器的菜单树
+ * @param manager 菜单管理器指针
+ * @param tree 菜单树数组，索引0为根菜单
+ * @param count 菜单项数量
  */
-static MenuItem* MenuItem_CreateImage(char* name, const uint8_t* imageData, uint16_t width, uint16_t height, MenuAction action) {
-    MenuItem* item = (MenuItem*)malloc(sizeof(MenuItem));
-    if (item == NULL) return NULL;
-    
-    // 初始化所有字段
-    item->type = MENU_ITEM_IMAGE;
-    
-    // 复制菜单项名称
-    item->name = (char*)malloc(strlen(name) + 1);
-    if (item->name == NULL) {
-        free(item);
-        return NULL;
-    }
-    strcpy(item->name, name);
-    
-    item->action = action;
-    item->parent = NULL;
-    item->child = NULL;
-    item->next = NULL;
+void MenuManager_SetMenuTree(MenuManager* manager, const MenuItemDef* tree, uint8_t count) {
+    if (manager == NULL || tree == NULL || count == 0) return;
     
-    // 设置图片相关字段
-    item->imageData = imageData;
-    item->imageWidth = width;
-    item->imageHeight = height;
-    
-    item->moveOffset = 0;  // 默认没有偏移
-    
-    return item;
-}
-
-/**
- * @brief 向父菜单项添加子菜单项
- * @param parent 父菜单项指针
- * @param child 要添加的子菜单项指针
- */
-static void MenuItem_AddChild(MenuItem* parent, MenuItem* child) {
-    if (parent == NULL || child == NULL) return;
-    
-    // 设置父子关系
-    child->parent = parent;
-    
-    // 如果父菜单项没有子菜单，则直接添加
-    if (parent->child == NULL) {
-        parent->child = child;
-    } else {
-        // 否则添加到子菜单链表的末尾
-        MenuItem* current = parent->child;
-        while (current->next != NULL) {
-            current = current->next;
-        }
-        current->next = child;
-    }
+    manager->tree = tree;
+    manager->itemCount = count;
+    manager->rootMenu = &tree[0];
+    manager->currentMenu = &tree[0];
+    // 将selectedItem设置为第一个子菜单项，确保初始显示时有选中项
+    manager->selectedItem = (tree[0].childCount > 0) ? &tree[tree[0].firstChild] : &tree[0];
+    manager->startRow = 0;
+    MenuManager_Invalidate(manager);
 }
 
 /**
- * @brief 向菜单项添加同级菜单项
- * @param item 菜单项指针
- * @param sibling 要添加的同级菜单项指针
+ * @brief 检查菜单树的子菜单范围
+ * @param tree 菜单树数组
+ * @param count 菜单项数量
+ * @return 每个菜单项的子菜单范围都在数组内且与子菜单项的parentIndex一致时返回true
  */
-static void MenuItem_AddSibling(MenuItem* item, MenuItem* sibling) {
-    if (item == NULL || sibling == NULL) return;
+bool MenuManager_ValidateTree(const MenuItemDef* tree, uint8_t count) {
+    if (tree == NULL || count == 0 || tree[0].parentIndex != -1) return false;
     
-    // 设置兄弟项的父菜单与当前项相同
-    sibling->parent = item->parent;
-    
-    // 添加到链表末尾
-    MenuItem* current = item;
-    while (current->next != NULL) {
-        current = current->next;
+    for (uint8_t i = 0; i < count; i++) {
+        const MenuItemDef* item = &tree[i];
+        if (item->childCount > 0 && item->firstChild + item->childCount > count) return false;
+        
+        // 子菜单范围内的每一项都必须指向当前菜单项
+        for (uint8_t c = 0; c < item->childCount; c++) {
+            if (tree[item->firstChild + c].parentIndex != i) return false;
+        }
+        
+        // 非根菜单项必须落在父菜单的子菜单范围内
+        if (i > 0) {
+            if (item->parentIndex < 0 || item->parentIndex >= count) return false;
+            const MenuItemDef* parent = &tree[item->parentIndex];
+            if (i < parent->firstChild || i >= parent->firstChild + parent->childCount) return false;
+        }
     }
-    current->next = sibling;
+    return true;
 }
 
 /**
- * @brief 设置菜单管理器的根菜单
+ * @brief 获取菜单项的父菜单
  * @param manager 菜单管理器指针
- * @param root 根菜单指针
+ * @param item 菜单项指针
+ * @return 父菜单指针，根菜单返回NULL
  */
-void MenuManager_SetRootMenu(MenuManager* manager, MenuItem* root) {
-    if (manager == NULL || root == NULL) return;
-    
-    manager->rootMenu = root;
-    manager->currentMenu = root;
-    // 将selectedItem设置为第一个子菜单项，确保初始显示时有选中项
-    manager->selectedItem = (root->child != NULL) ? root->child : root;
-    manager->startRow = 0;
+static const MenuItemDef* MenuItem_GetParent(MenuManager* manager, const MenuItemDef* item) {
+    if (item == NULL || item->parentIndex < 0) return NULL;
+    return &manager->tree[item->parentIndex];
 }
 
 /**
@@ -167,51 +100,77 @@ void MenuManager_SetRootMenu(MenuManager* manager, MenuItem* root) {
  * @param menu 当前菜单指针
  * @return 子菜单项数量
  */
-static uint8_t MenuItem_GetChildCount(MenuItem* menu) {
-    if (menu == NULL || menu->child == NULL) return 0;
-    
-    uint8_t count = 0;
-    MenuItem* current = menu->child;
-    while (current != NULL) {
-        count++;
-        current = current->next;
-    }
-    return count;
+static uint8_t MenuItem_GetChildCount(const MenuItemDef* menu) {
+    if (menu == NULL) return 0;
+    return menu->childCount;
 }
 
 /**
  * @brief 根据索引获取当前菜单的子菜单项
+ * @param manager 菜单管理器指针
  * @param menu 当前菜单指针
  * @param index 索引值
- * @return 子菜单项指针
+ * @return 子菜单项指针，索引超出范围返回NULL
  */
-static MenuItem* MenuItem_GetChildByIndex(MenuItem* menu, uint8_t index) {
-    if (menu == NULL || menu->child == NULL) return NULL;
-    
-    uint8_t count = 0;
-    MenuItem* current = menu->child;
-    while (current != NULL && count < index) {
-        count++;
-        current = current->next;
-    }
-    return current;
+static const MenuItemDef* MenuItem_GetChildByIndex(MenuManager* manager, const MenuItemDef* menu, uint8_t index) {
+    if (menu == NULL || index >= menu->childCount) return NULL;
+    return &manager->tree[menu->firstChild + index];
 }
 
 /**
  * @brief 获取当前菜单项在同级菜单中的索引
+ * @param manager 菜单管理器指针
  * @param item 当前菜单项指针
  * @return 索引值
  */
-static uint8_t MenuItem_GetIndexInParent(MenuItem* item) {
-    if (item == NULL || item->parent == NULL) return 0;
-    
-    uint8_t index = 0;
-    MenuItem* current = item->parent->child;
-    while (current != NULL && current != item) {
-        index++;
-        current = current->next;
+static uint8_t MenuItem_GetIndexInParent(MenuManager* manager, const MenuItemDef* item) {
+    const MenuItemDef* parent = MenuItem_GetParent(manager, item);
+    if (parent == NULL) return 0;
+    return (uint8_t)((item - manager->tree) - parent->firstChild);
+}
+
+/**
+ * @brief 启动菜单项的活动
+ * @param manager 菜单管理器指针
+ * @param activity 要启动的活动
+ * @return 活动启动成功返回true
+ */
+static bool MenuManager_StartActivity(MenuManager* manager, const MenuActivity* activity) {
+    manager->activity = activity;
+    manager->timerArmed = false;
+    // 活动运行期间摇杆事件交给活动处理，不再用于菜单导航
+    manager->blockKeyEvents = true;
+    
+    if (activity->on_enter != NULL && !activity->on_enter()) {
+        // 活动无法启动（例如资源初始化失败），直接返回菜单
+        manager->activity = NULL;
+        manager->timerArmed = false;
+        manager->blockKeyEvents = false;
+        return false;
+    }
+    
+    // 活动会绘制自己的界面，返回菜单时需要整屏重绘
+    MenuManager_Invalidate(manager);
+    manager->dirty = true;
+    return true;
+}
+
+/**
+ * @brief 结束当前活动并返回菜单
+ * @param manager 菜单管理器指针
+ */
+static void MenuManager_StopActivity(MenuManager* manager) {
+    const MenuActivity* activity = manager->activity;
+    
+    manager->activity = NULL;
+    manager->timerArmed = false;
+    if (activity != NULL && activity->on_exit != NULL) {
+        activity->on_exit();
     }
-    return index;
+    
+    manager->blockKeyEvents = false;
+    MenuManager_Invalidate(manager);
+    manager->dirty = true;
 }
 
 /**
@@ -226,7 +185,7 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
     uint8_t childCount = MenuItem_GetChildCount(manager->currentMenu);  //获取当前子菜单项数量
     if (childCount == 0) return false; 
     
-    uint8_t selectedIndex = MenuItem_GetIndexInParent(manager->selectedItem);
+    uint8_t selectedIndex = MenuItem_GetIndexInParent(manager, manager->selectedItem);
     
     switch (op) {
         case MENU_OP_UP:
@@ -238,7 +197,7 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
             
             if (selectedIndex > 0) {
                 selectedIndex--;
-                manager->selectedItem = MenuItem_GetChildByIndex(manager->currentMenu, selectedIndex);
+                manager->selectedItem = MenuItem_GetChildByIndex(manager, manager->currentMenu, selectedIndex);
                 
                 // 调整显示起始行
                 if (selectedIndex < manager->startRow) {
@@ -257,7 +216,7 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
             
             if (selectedIndex < childCount - 1) {
                 selectedIndex++;
-                manager->selectedItem = MenuItem_GetChildByIndex(manager->currentMenu, selectedIndex);
+                manager->selectedItem = MenuItem_GetChildByIndex(manager, manager->currentMenu, selectedIndex);
                 
                 // 调整显示起始行
                 if (selectedIndex >= manager->startRow + manager->visibleRows) {
@@ -272,7 +231,7 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
             if (manager->moveMode == IMAGE_MOVE_LEFT_RIGHT && manager->isEvenVisibleImages == 1) {
                 if (selectedIndex < childCount - 1) {
                     selectedIndex++;
-                    manager->selectedItem = MenuItem_GetChildByIndex(manager->currentMenu, selectedIndex);
+                    manager->selectedItem = MenuItem_GetChildByIndex(manager, manager->currentMenu, selectedIndex);
                     
                     // 调整显示起始行
                     if (selectedIndex >= manager->startRow + manager->visibleRows) {
@@ -287,7 +246,7 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
                     selectedIndex = 0 ;
                 }
 
-                manager->selectedItem = MenuItem_GetChildByIndex(manager->currentMenu, selectedIndex);
+                manager->selectedItem = MenuItem_GetChildByIndex(manager, manager->currentMenu, selectedIndex);
                 if(selectedIndex - 1 < 0){
                     manager->startRow = childCount - 1 ;
                 }else if(selectedIndex - 1 >= 0){
@@ -303,7 +262,7 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
             if (manager->moveMode == IMAGE_MOVE_LEFT_RIGHT && manager->isEvenVisibleImages == 1) {
                 if (selectedIndex > 0) {
                     selectedIndex--;
-                    manager->selectedItem = MenuItem_GetChildByIndex(manager->currentMenu, selectedIndex);
+                    manager->selectedItem = MenuItem_GetChildByIndex(manager, manager->currentMenu, selectedIndex);
                     
                     // 调整显示起始行
                     if (selectedIndex < manager->startRow) {
@@ -318,7 +277,7 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
                     selectedIndex = childCount - 1 ;
                 }
 
-                manager->selectedItem = MenuItem_GetChildByIndex(manager->currentMenu, selectedIndex);
+                manager->selectedItem = MenuItem_GetChildByIndex(manager, manager->currentMenu, selectedIndex);
                 if(selectedIndex - 1 < 0){
                     manager->startRow = childCount - 1 ;
                 }else if(selectedIndex - 1 >= 0){
@@ -332,20 +291,20 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
         case MENU_OP_BACK:
             
             // 返回上一级菜单
-            if (manager->currentMenu->parent != NULL) {
+            if (manager->currentMenu->parentIndex >= 0) {
                 // 从栈中弹出状态，恢复到进入子菜单前的状态
                 if (manager->stackDepth > 0) {
                     manager->stackDepth--;
                     MenuState* state = &manager->stateStack[manager->stackDepth];
                     
-                    manager->currentMenu = manager->currentMenu->parent;
+                    manager->currentMenu = MenuItem_GetParent(manager, manager->currentMenu);
                     // 恢复到进入子菜单前的选中项
-                    manager->selectedItem = MenuItem_GetChildByIndex(manager->currentMenu, state->selectedIndex);
+                    manager->selectedItem = MenuItem_GetChildByIndex(manager, manager->currentMenu, state->selectedIndex);
                     // 恢复到进入子菜单前的startRow值
                     manager->startRow = state->startRow;
                     
                     // 根据当前菜单类型设置移动模式
-                    if (manager->selectedItem->type == MENU_ITEM_IMAGE) {
+                    if (manager->selectedItem->type == MENU_TYPE_IMAGE) {
                         manager->moveMode = IMAGE_MOVE_LEFT_RIGHT;  // 图像菜单使用左右移动
                     } else {
                         manager->moveMode = IMAGE_MOVE_UP_DOWN;     // 文本菜单使用上下移动
@@ -357,10 +316,10 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
                         
         case MENU_OP_ENTER:
             // 进入子菜单或执行操作
-            if (manager->selectedItem->child != NULL) {
+            if (manager->selectedItem->childCount > 0) {
                 // 保存当前菜单状态到栈中，以便返回时恢复
                 if (manager->stackDepth < MAX_MENU_DEPTH) {
-                    uint8_t parentMenuIndex = MenuItem_GetIndexInParent(manager->selectedItem);
+                    uint8_t parentMenuIndex = MenuItem_GetIndexInParent(manager, manager->selectedItem);
                     MenuState* state = &manager->stateStack[manager->stackDepth];
                     state->selectedIndex = parentMenuIndex;
                     state->startRow = manager->startRow;
@@ -368,28 +327,20 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op) {
                     
                     // 有子菜单，进入子菜单
                     manager->currentMenu = manager->selectedItem;
-                    manager->selectedItem = manager->selectedItem->child;
+                    manager->selectedItem = MenuItem_GetChildByIndex(manager, manager->selectedItem, 0);
                     manager->startRow = 0;
                     
                     // 根据子菜单类型设置模式
-                    if (manager->selectedItem->type == MENU_ITEM_IMAGE) {
+                    if (manager->selectedItem->type == MENU_TYPE_IMAGE) {
                         manager->moveMode = IMAGE_MOVE_LEFT_RIGHT;  // 图像菜单使用左右移动
                     } else {
                         manager->moveMode = IMAGE_MOVE_UP_DOWN;     // 文本菜单使用上下移动
                     }
                     return true;
                 }
-            } else if (manager->selectedItem->action != NULL) {
-                // 没有子菜单但有操作函数，执行操作
-                // 设置blockKeyEvents为true，临时禁用按键事件处理
-                manager->blockKeyEvents = true;
-                // 执行操作函数
-                manager->selectedItem->action();
-                // 清空按键队列，避免执行action期间积累的事件被处理
-                MenuManager_ClearKeyQueue();
-                // 操作完成后，恢复按键事件处理
-                manager->blockKeyEvents = false;
-                return true;
+            } else if (manager->selectedItem->activity != NULL) {
+                // 没有子菜单但有活动，启动活动后立即返回，之后的事件由UI任务交给活动处理
+                return MenuManager_StartActivity(manager, manager->selectedItem->activity);
             }
             break;
             
@@ -437,6 +388,254 @@ static uint8_t calculateVisibleRows(uint8_t fontSize, bool hasTitle) {
     return (visibleRows > 0) ? visibleRows : 1;
 }
 
+/**
+ * @brief 标记屏幕内容已被改写，下次显示菜单时整屏重绘
+ * @param manager 菜单管理器指针
+ */
+void MenuManager_Invalidate(MenuManager* manager) {
+    if (manager == NULL) return;
+    manager->view.valid = false;
+}
+
+/**
+ * @brief 分发一个输入事件
+ * @param manager 菜单管理器指针
+ * @param event 事件
+ * 
+ * 有活动运行时事件交给活动的on_event处理，否则摇杆事件作为菜单导航操作，
+ * 键盘和定时器事件在菜单界面下没有意义，直接丢弃。
+ */
+void MenuManager_HandleEvent(MenuManager* manager, const MenuEvent* event) {
+    if (manager == NULL || event == NULL) return;
+    
+    if (manager->activity != NULL) {
+        MenuActivityResult result;
+        if (manager->activity->on_event != NULL) {
+            result = manager->activity->on_event(event);
+        } else {
+            // 没有事件处理函数的活动，任意摇杆操作都退出
+            result = (event->type == MENU_EVENT_JOYSTICK) ? MENU_ACTIVITY_EXIT : MENU_ACTIVITY_IDLE;
+        }
+        
+        if (result == MENU_ACTIVITY_EXIT) {
+            MenuManager_StopActivity(manager);
+        } else if (result == MENU_ACTIVITY_REDRAW) {
+            manager->dirty = true;
+        }
+        return;
+    }
+    
+    if (event->type != MENU_EVENT_JOYSTICK) return;
+    
+    if (MenuManager_HandleOperation(manager, (MenuOperation)event->code)) {
+        manager->dirty = true;
+    }
+}
+
+/**
+ * @brief 启动活动定时器
+ * @param manager 菜单管理器指针
+ * @param ms 定时时长（毫秒），为0时取消定时器
+ * 
+ * 定时器是单次的，到期后UI任务向当前活动发送一次MENU_EVENT_TIMER，
+ * 活动结束时定时器自动取消。用于替代活动中的vTaskDelay，例如提示信息显示一段时间后退出。
+ */
+void MenuManager_SetActivityTimer(MenuManager* manager, uint32_t ms) {
+    if (manager == NULL) return;
+    
+    if (ms == 0 || manager->activity == NULL) {
+        manager->timerArmed = false;
+        return;
+    }
+    manager->timerDeadline = xTaskGetTickCount() + pdMS_TO_TICKS(ms);
+    manager->timerArmed = true;
+}
+
+/**
+ * @brief 请求在下一帧重绘当前界面
+ * @param manager 菜单管理器指针
+ */
+void MenuManager_RequestRedraw(MenuManager* manager) {
+    if (manager == NULL) return;
+    manager->dirty = true;
+}
+
+/**
+ * @brief 提示信息类活动的事件处理函数
+ * @param event 事件
+ * @return 定时器到期时退出活动，其余事件忽略
+ * 
+ * 活动在on_enter中启动定时器，提示信息显示期间的输入被丢弃，与原来阻塞延时期间的行为一致
+ */
+MenuActivityResult MenuActivity_ExitOnTimer(const MenuEvent* event) {
+    return (event->type == MENU_EVENT_TIMER) ? MENU_ACTIVITY_EXIT : MENU_ACTIVITY_IDLE;
+}
+
+/**
+ * @brief 处理到期的定时器并按帧率重绘
+ * @param manager 菜单管理器指针
+ * @param startX 菜单显示起始X坐标
+ * @param startY 菜单显示起始Y坐标
+ * @param fontSize 菜单字体大小
+ * @return UI任务最多等待多少个节拍后必须再次调用，portMAX_DELAY表示只需等待输入事件
+ * 
+ * 连续的输入事件只把界面标记为需要重绘，两次重绘至少间隔MENU_FRAME_INTERVAL_MS，
+ * 摇杆长拉时的多次导航会合并为一次绘制和一次屏幕传输。
+ */
+TickType_t MenuManager_Service(MenuManager* manager, uint8_t startX, uint8_t startY, uint8_t fontSize) {
+    if (manager == NULL) return portMAX_DELAY;
+    
+    TickType_t now = xTaskGetTickCount();
+    
+    // 活动定时器到期，发送定时器事件
+    if (manager->activity != NULL && manager->timerArmed &&
+        (int32_t)(now - manager->timerDeadline) >= 0) {
+        manager->timerArmed = false;
+        MenuEvent event = {MENU_EVENT_TIMER, 0};
+        MenuManager_HandleEvent(manager, &event);
+    }
+    
+    // 距离上一帧超过帧间隔时才重绘
+    const TickType_t frameTicks = pdMS_TO_TICKS(MENU_FRAME_INTERVAL_MS);
+    if (manager->dirty && (TickType_t)(now - manager->lastFrame) >= frameTicks) {
+        manager->dirty = false;
+        manager->lastFrame = now;
+        if (manager->activity == NULL) {
+            MenuManager_DisplayMenu(manager, startX, startY, fontSize);
+        } else if (manager->activity->on_render != NULL) {
+            manager->activity->on_render();
+            OLED_Update();
+        }
+    }
+    
+    // 计算下一次需要唤醒的时间：待绘制的帧或活动定时器，取较早者
+    TickType_t wait = portMAX_DELAY;
+    if (manager->dirty) {
+        TickType_t elapsed = now - manager->lastFrame;
+        wait = (elapsed < frameTicks) ? (frameTicks - elapsed) : 0;
+    }
+    if (manager->activity != NULL && manager->timerArmed) {
+        int32_t remain = (int32_t)(manager->timerDeadline - now);
+        TickType_t timerWait = (remain > 0) ? (TickType_t)remain : 0;
+        if (timerWait < wait) wait = timerWait;
+    }
+    return wait;
+}
+
+/**
+ * @brief 计算纵向范围[y, y+height)在屏幕内覆盖的页
+ * @return 页位图，第n位表示第n页
+ */
+static uint8_t MenuView_PageMask(int16_t y, int16_t height) {
+    if (y < 0) { height += y; y = 0; }
+    if (y + height > OLED_HEIGHT) height = OLED_HEIGHT - y;
+    if (height <= 0) return 0;
+    
+    uint8_t mask = 0;
+    for (int16_t page = y / 8; page <= (y + height - 1) / 8; page++) {
+        mask |= 1 << page;
+    }
+    return mask;
+}
+
+/**
+ * @brief 只把有变化的页发送到屏幕，相邻的页合并为一次传输
+ * @param dirtyPages 页位图
+ */
+static void MenuView_FlushPages(uint8_t dirtyPages) {
+    uint8_t page = 0;
+    while (page < OLED_HEIGHT / 8) {
+        if (!(dirtyPages & (1 << page))) {
+            page++;
+            continue;
+        }
+        uint8_t first = page;
+        while (page < OLED_HEIGHT / 8 && (dirtyPages & (1 << page))) {
+            page++;
+        }
+        OLED_UpdateArea(0, first * 8, OLED_WIDTH, (page - first) * 8);
+    }
+}
+
+/**
+ * @brief 增量重绘文本菜单
+ * @param manager 菜单管理器指针
+ * @param startX 显示起始X坐标
+ * @param startY 显示起始Y坐标
+ * @param fontSize 字体大小
+ * @param lineHeight 行高
+ * @return 完成增量重绘返回true，返回false时需要整屏重绘
+ * 
+ * 起始行变化时先把列表区域的显存整体平移，复用已经绘制好的行，
+ * 然后只重绘内容或选中状态与记录不一致的行，最后只刷新这些行所在的页。
+ */
+static bool MenuManager_DisplayDelta(MenuManager* manager, uint8_t startX, uint8_t startY, uint8_t fontSize, uint8_t lineHeight) {
+    MenuView* view = &manager->view;
+    
+    if (!view->valid || view->menu != manager->currentMenu) return false;
+    if (view->startX != startX || view->startY != startY || view->fontSize != fontSize) return false;
+    uint8_t childCount = MenuItem_GetChildCount(manager->currentMenu);
+    if (view->rowCount != manager->visibleRows || childCount == 0) return false;
+    // 行高小于标签高度时相邻行会互相覆盖，只重绘一行的结果与整屏重绘不同
+    if (lineHeight < OLED_16X16_FULL) return false;
+    
+    // 计算本次每一行应显示的菜单项，到达末尾后从第一项继续，与整屏重绘一致
+    if (manager->startRow >= childCount) return false;
+    const MenuItemDef* wanted[MENU_VIEW_MAX_ROWS];
+    for (uint8_t i = 0; i < view->rowCount; i++) {
+        wanted[i] = MenuItem_GetChildByIndex(manager, manager->currentMenu, (manager->startRow + i) % childCount);
+        if (wanted[i]->type == MENU_TYPE_IMAGE) return false;
+    }
+    
+    uint8_t dirtyPages = 0;
+    
+    // 起始行变化：列表区域整体平移，平移后仍在屏幕内的行无需重绘
+    int16_t delta = (int16_t)manager->startRow - view->startRow;
+    if (delta != 0) {
+        const MenuItemDef* rows[MENU_VIEW_MAX_ROWS];
+        bool rowSelected[MENU_VIEW_MAX_ROWS];
+        for (int16_t i = 0; i < view->rowCount; i++) {
+            int16_t src = i + delta;
+            // 只有完整显示在屏幕内的行才能被平移复用
+            bool reusable = src >= 0 && src < view->rowCount &&
+                            view->listY + (src + 1) * lineHeight <= OLED_HEIGHT;
+            rows[i] = reusable ? view->rows[src] : NULL;
+            rowSelected[i] = reusable ? view->rowSelected[src] : false;
+        }
+        memcpy(view->rows, rows, sizeof(rows));
+        memcpy(view->rowSelected, rowSelected, sizeof(rowSelected));
+        
+        if (delta < view->rowCount && -delta < view->rowCount) {
+            OLED_ClipRect_t clip;
+            if (OLED_Blit_ClipInit(&clip, 0, view->listY, OLED_WIDTH, view->rowCount * lineHeight)) {
+                OLED_Blit_ScrollV(&clip, -delta * lineHeight);
+                dirtyPages |= MenuView_PageMask(view->listY, view->rowCount * lineHeight);
+            }
+        }
+        view->startRow = manager->startRow;
+    }
+    
+    // 只重绘内容或选中状态有变化的行
+    for (uint8_t i = 0; i < view->rowCount; i++) {
+        bool selected = (wanted[i] == manager->selectedItem);
+        if (view->rows[i] == wanted[i] && view->rowSelected[i] == selected) continue;
+        
+        int16_t yPos = view->listY + i * lineHeight;
+        OLED_ClearArea(0, yPos, OLED_WIDTH, lineHeight);
+        OLED_ShowMixStringCached(startX, yPos, wanted[i]->name, OLED_16X16_FULL, fontSize, selected);
+        if (wanted[i]->childCount > 0 && manager->currentMenu->parentIndex >= 0) {
+            OLED_ShowString(OLED_WIDTH - 12, yPos, ">", fontSize);
+        }
+        
+        view->rows[i] = wanted[i];
+        view->rowSelected[i] = selected;
+        dirtyPages |= MenuView_PageMask(yPos, lineHeight);
+    }
+    
+    MenuView_FlushPages(dirtyPages);
+    return true;
+}
+
 /**
  * @brief 显示当前菜单
  * @param manager 菜单管理器指针
@@ -451,13 +650,15 @@ void MenuManager_DisplayMenu(MenuManager* manager, uint8_t startX, uint8_t start
     uint8_t lineHeight = calculateLineHeight(fontSize);
     
     // 自动计算可见行数
-    bool hasTitle = (manager->currentMenu->parent != NULL);
+    bool hasTitle = (manager->currentMenu->parentIndex >= 0);
+    uint8_t childCount = MenuItem_GetChildCount(manager->currentMenu);
+    const MenuItemDef* firstChild = MenuItem_GetChildByIndex(manager, manager->currentMenu, 0);
     manager->visibleRows = calculateVisibleRows(fontSize, hasTitle);
     
     // 如果是图像菜单项，需要根据屏幕宽度重新计算可见数量
-    if (manager->currentMenu->child != NULL && manager->currentMenu->child->type == MENU_ITEM_IMAGE) {
+    if (firstChild != NULL && firstChild->type == MENU_TYPE_IMAGE) {
         // 获取第一个图像菜单项的宽度
-        uint16_t imageWidth = manager->currentMenu->child->imageWidth;
+        uint16_t imageWidth = firstChild->imageWidth;
         uint8_t spacing = 10; // 图像间距
         
         // 计算水平方向可以显示的图像数量（考虑OLED_WIDTH为128）
@@ -465,7 +666,7 @@ void MenuManager_DisplayMenu(MenuManager* manager, uint8_t startX, uint8_t start
         manager->isEvenVisibleImages = (visibleImages % 2 == 0) ? 1 : 0;
         // 只有当startRow尚未初始化时才执行此操作
         if (manager->isEvenVisibleImages == 0 && !manager->startRowInitialized) {
-            manager->startRow = MenuItem_GetChildCount(manager->currentMenu) - 1;
+            manager->startRow = childCount - 1;
             manager->startRowInitialized = true;  // 设置标志位表示已执行
         }
         manager->visibleRows = (visibleImages > 0) ? visibleImages : 1;
@@ -473,28 +674,44 @@ void MenuManager_DisplayMenu(MenuManager* manager, uint8_t startX, uint8_t start
         manager->isEvenVisibleImages = 1 ;
     }
     
+    // 屏幕内容仍然有效时只重绘有变化的行
+    if (MenuManager_DisplayDelta(manager, startX, startY, fontSize, lineHeight)) {
+        return;
+    }
+    
+    // 整屏重绘，同时记录每一行绘制的内容，供下次增量重绘使用
+    MenuView* view = &manager->view;
+    view->valid = firstChild != NULL && firstChild->type != MENU_TYPE_IMAGE &&
+                  manager->visibleRows <= MENU_VIEW_MAX_ROWS;
+    view->menu = manager->currentMenu;
+    view->startX = startX;
+    view->startY = startY;
+    view->fontSize = fontSize;
+    view->startRow = manager->startRow;
+    
     // 清空显示区域
     OLED_Clear();
     
     // 显示当前菜单名称（如果不是根菜单）
-    if (manager->currentMenu->parent != NULL) {
-        OLED_ShowMixString(startX, startY, manager->currentMenu->name, OLED_16X16_FULL, fontSize);
+    if (hasTitle) {
+        OLED_ShowMixStringCached(startX, startY, manager->currentMenu->name, OLED_16X16_FULL, fontSize, false);
         startY += lineHeight + 2;  // 增加间距
     }
+    view->listY = startY;
     
     // 显示菜单项列表
     uint8_t displayCount = 0;
-    MenuItem* current = MenuItem_GetChildByIndex(manager->currentMenu, manager->startRow);
+    const MenuItemDef* current = MenuItem_GetChildByIndex(manager, manager->currentMenu, manager->startRow);
 
     while (current != NULL && displayCount < manager->visibleRows) {
         uint8_t yPos = startY, xPos = startX ,xFixed = 0;
         
         // 根据菜单项类型设置不同的显示位置
-        if (current->type == MENU_ITEM_TEXT) {
+        if (current->type != MENU_TYPE_IMAGE) {
             // 文本菜单项：垂直排列
             yPos = startY + displayCount * lineHeight;
             xPos = startX;
-        } else if (current->type == MENU_ITEM_IMAGE && manager->isEvenVisibleImages == 1) {
+        } else if (current->type == MENU_TYPE_IMAGE && manager->isEvenVisibleImages == 1) {
             // 图片菜单项：水平排列，使用屏幕底部对齐
             // 对于图像菜单项，使用OLED_HEIGHT作为基准，确保图像在屏幕内显示
             yPos = OLED_HEIGHT - current->imageHeight; // 从屏幕底部向上对齐
@@ -503,7 +720,7 @@ void MenuManager_DisplayMenu(MenuManager* manager, uint8_t startX, uint8_t start
             uint16_t totalWidth = manager->visibleRows * current->imageWidth + (manager->visibleRows - 1) * 10;
             uint16_t startXPos = (OLED_WIDTH - totalWidth) / 2;
             xPos = startXPos + displayCount * (current->imageWidth + 10);
-        } else if (current->type == MENU_ITEM_IMAGE && manager->isEvenVisibleImages == 0){
+        } else if (current->type == MENU_TYPE_IMAGE && manager->isEvenVisibleImages == 0){
             yPos = OLED_HEIGHT - current->imageHeight; // 从屏幕底部向上对齐
 
             uint16_t totalWidth = manager->visibleRows * current->imageWidth + (manager->visibleRows - 1) * 10;
@@ -512,33 +729,23 @@ void MenuManager_DisplayMenu(MenuManager* manager, uint8_t startX, uint8_t start
             xPos = startXPos + displayCount * (current->imageWidth + 10);
         } 
 
-        // 如果是当前选中项且为文本菜单项，反色显示背景
-        if (current == manager->selectedItem && current->type == MENU_ITEM_TEXT) {
-            OLED_ReverseArea(startX, yPos, OLED_WIDTH - startX, lineHeight);
-        }
-        
         // 根据菜单项类型进行不同的显示处理
         switch (current->type) {
-            case MENU_ITEM_TEXT:
-                // 文本菜单项，显示文本
-                OLED_ShowMixString(startX, yPos, current->name, OLED_16X16_FULL, fontSize);
-                break;
-                
-            case MENU_ITEM_IMAGE:
+            case MENU_TYPE_IMAGE:
 
                 // 图片菜单项，显示图片
-                if (current->imageData != NULL && manager->isEvenVisibleImages == 1) {
+                if (current->image != NULL && manager->isEvenVisibleImages == 1) {
                     // 移除行高限制，始终使用原始尺寸完整显示图像
-                    OLED_ShowImage(xPos, yPos, current->imageWidth, current->imageHeight, current->imageData);
+                    OLED_ShowImage(xPos, yPos, current->imageWidth, current->imageHeight, current->image);
 
                     // // 如果是当前选中项，绘制比图像大两个像素的正方形框作为指示
                     if (current == manager->selectedItem) {
                         OLED_DrawRectangle(xPos - 1, yPos - 1, current->imageWidth + 2, current->imageHeight + 2, 0);
                     }
 
-                }else if (current->imageData != NULL && manager->isEvenVisibleImages == 0) {
+                }else if (current->image != NULL && manager->isEvenVisibleImages == 0) {
                     
-                    OLED_ShowImage(xPos, yPos, current->imageWidth, current->imageHeight, current->imageData);
+                    OLED_ShowImage(xPos, yPos, current->imageWidth, current->imageHeight, current->image);
                     if(current == manager->selectedItem){
                         OLED_DrawRectangle(xFixed - 1, yPos - 1, current->imageWidth + 2, current->imageHeight + 2, 0);
                     }
@@ -547,130 +754,55 @@ void MenuManager_DisplayMenu(MenuManager* manager, uint8_t startX, uint8_t start
                 break;
                 
             default:
-                // 默认按文本处理
-                OLED_ShowMixString(startX, yPos, current->name, OLED_16X16_FULL, fontSize);
+                // 文本菜单项和动作菜单项，显示文本，当前选中项反色显示（标签位图已缓存，无需前后两次反色）
+                OLED_ShowMixStringCached(startX, yPos, current->name, OLED_16X16_FULL, fontSize,
+                                         current == manager->selectedItem);
                 break;
         }
         
-        // 恢复反色区域（如果是选中项且为文本菜单项）
-        if (current == manager->selectedItem && current->type == MENU_ITEM_TEXT) {
-            OLED_ReverseArea(startX, yPos, OLED_WIDTH - startX, lineHeight);
-        }
-        
         // 如果有子菜单，显示指示箭头
-        if (current->child != NULL && manager->currentMenu->parent != NULL) {
+        if (current->childCount > 0 && hasTitle) {
             OLED_ShowString(OLED_WIDTH - 12, yPos, ">", fontSize);
         }
         
-        if (current->next == NULL) {
-            // 遍历到最后一个同层菜单项，自动指向第一个同层菜单项
-            current = MenuItem_GetChildByIndex(manager->currentMenu, 0);
-        }else {
-            current = current->next;
+        if (displayCount < MENU_VIEW_MAX_ROWS) {
+            view->rows[displayCount] = current;
+            view->rowSelected[displayCount] = (current == manager->selectedItem);
         }
-
+        
         displayCount++;
+        
+        // 遍历到最后一个同层菜单项后，自动指向第一个同层菜单项
+        current = MenuItem_GetChildByIndex(manager, manager->currentMenu, (manager->startRow + displayCount) % childCount);
     }
+    view->rowCount = displayCount;
     
     // 刷新OLED显示
     OLED_Update();
 }
 
 /**
- * @brief 递归销毁菜单树
- * @param item 菜单项指针
- */
-static void MenuItem_DestroyRecursive(MenuItem* item) {
-    if (item == NULL) return;
-    
-    // 递归销毁子菜单
-    if (item->child != NULL) {
-        MenuItem_DestroyRecursive(item->child);
-    }
-    
-    // 销毁同级菜单项
-    if (item->next != NULL) {
-        MenuItem_DestroyRecursive(item->next);
-    }
-
-    // 释放菜单项名称和菜单项本身
-    free(item->name);
-    free(item);
-}
-
-/**
- * @brief 销毁菜单管理器和所有菜单
+ * @brief 重置菜单管理器
  * @param manager 菜单管理器指针
+ * 
+ * 菜单树是常量数组，没有需要释放的内存，只清空管理器中的引用
  */
 void MenuManager_Destroy(MenuManager* manager) {
     if (manager == NULL) return;
     
-    // 递归销毁根菜单树
-    if (manager->rootMenu != NULL) {
-        MenuItem_DestroyRecursive(manager->rootMenu);
+    // 先结束运行中的活动，让活动释放自己占用的资源
+    if (manager->activity != NULL) {
+        MenuManager_StopActivity(manager);
     }
+    manager->dirty = false;
+    MenuManager_Invalidate(manager);
     
     // 重置管理器状态
+    manager->tree = NULL;
+    manager->itemCount = 0;
     manager->rootMenu = NULL;
     manager->currentMenu = NULL;
     manager->selectedItem = NULL;
     manager->visibleRows = 0;
     manager->startRow = 0;
 }
-
-/**
- * @brief 构建菜单树
- * @return 根菜单指针
- */
-MenuItem* build_menu_tree(void) {
-    MenuItem* items[MENU_ITEM_COUNT]; // 存储创建的菜单项指针
-    
-    // 初始化所有元素为NULL
-    for (int i = 0; i < MENU_ITEM_COUNT; i++) {
-        items[i] = NULL;
-    }
-    
-    // 第一步：创建所有菜单项
-    for (int i = 0; i < MENU_ITEM_COUNT; i++) {
-        MenuItemDef* def = &menuItems[i];
-        
-        if (def->type == 1) {
-            // 图像菜单
-            items[i] = MenuItem_CreateImage((char*)def->name, def->image, def->imageWidth, def->imageHeight, def->action);
-        } else {
-            // 文本菜单或动作菜单
-            items[i] = MenuItem_CreateText((char*)def->name, def->action);
-        }
-    }
-    
-    // 第二步：构建菜单层次结构
-    for (int i = 0; i < MENU_ITEM_COUNT; i++) {
-        MenuItemDef* def = &menuItems[i];
-        
-        if (def->parentIndex >= 0 && def->parentIndex < MENU_ITEM_COUNT) {
-            // 找到父菜单
-            MenuItem* parent = items[def->parentIndex];
-            MenuItem* child = items[i];
-            
-            if (parent && child) {
-                // 检查父菜单是否已有子菜单
-                if (parent->child == NULL) {
-                    // 第一个子菜单，直接添加为子节点
-                    MenuItem_AddChild(parent, child);
-                } else {
-                    // 不是第一个子菜单，添加为同级菜单
-                    MenuItem* lastChild = parent->child;
-                    // 找到最后一个同级菜单
-                    while (lastChild->next != NULL) {
-                        lastChild = lastChild->next;
-                    }
-                    // 添加为同级菜单
-                    MenuItem_AddSibling(lastChild, child);
-                }
-            }
-        }
-    }
-    
-    // 返回根菜单（索引为0的菜单项）
-    return items[0];
-}
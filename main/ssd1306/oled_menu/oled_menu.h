@@ -10,9 +10,12 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 #include "../oled_fonts/OLED.h"  // 使用OLED显示函数
+#include "../oled_fonts/OLED_LabelCache.h"  // 静态标签位图缓存
+#include "../oled_fonts/OLED_Blit.h"  // 显存块传输，用于列表滚动
 #include "esp_log.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <freertos/task.h>
 
 
 // 菜单操作枚举
@@ -32,28 +35,60 @@ typedef enum {
     MENU_TYPE_ACTION = 2
 } MenuDefType;
 
-// 前向声明
-typedef struct MenuItem MenuItem;
+// 菜单事件类型
+typedef enum {
+    MENU_EVENT_JOYSTICK,     // 摇杆操作，code为MenuOperation
+    MENU_EVENT_KEY,          // 键盘按键，code为键码
+    MENU_EVENT_TIMER,        // 活动定时器到期，code无意义
+    MENU_EVENT_AUDIO         // 音频播放状态或频谱变化，code为input_audio_event_t
+} MenuEventType;
+
+// 菜单事件 - 由UI任务从输入队列或定时器生成后分发给菜单或当前活动
+typedef struct {
+    MenuEventType type;
+    uint16_t code;
+} MenuEvent;
+
+// 活动处理事件后的返回值
+typedef enum {
+    MENU_ACTIVITY_IDLE,      // 事件已处理，界面无变化
+    MENU_ACTIVITY_REDRAW,    // 界面需要重绘，在下一帧调用on_render
+    MENU_ACTIVITY_EXIT       // 活动结束，返回菜单
+} MenuActivityResult;
+
+// 菜单活动 - 菜单项被选中后接管屏幕和输入的界面
+// 活动不再自己循环读取队列和延时，所有回调都在UI任务中执行，必须立即返回：
+//   on_enter  进入活动时调用一次，返回false表示无法启动、直接返回菜单，可为NULL
+//   on_event  收到摇杆、键盘、定时器或音频事件时调用，可为NULL（此时任何摇杆事件都退出活动）
+//   on_render 需要重绘时调用，只负责写显存，由UI任务统一刷新屏幕；为NULL时活动不改变屏幕内容
+//   on_exit   退出活动时调用一次，可为NULL
+typedef struct {
+    bool (*on_enter)(void);
+    MenuActivityResult (*on_event)(const MenuEvent* event);
+    void (*on_render)(void);
+    void (*on_exit)(void);
+} MenuActivity;
 
-// 菜单项选择回调函数类型
-typedef void (*MenuAction)(void);
+// UI任务的帧间隔，两次重绘之间至少间隔这么多毫秒（约30帧/秒）
+#define MENU_FRAME_INTERVAL_MS 33
 
-// 菜单结构定义
+// 菜单结构定义 - 整棵菜单树是一个按菜单项索引排列的常量数组，编译后存放在Flash中
+// 同一父菜单的子菜单项在数组中必须连续，父菜单通过firstChild和childCount直接定位子菜单项
 typedef struct {
     const char* name;          // 菜单项名称
     MenuDefType type;          // 类型: 0=普通菜单, 1=图像菜单, 2=动作菜单
     const uint8_t* image;      // 图像数据指针
     uint16_t imageWidth;       // 图像宽度
     uint16_t imageHeight;      // 图像高度
-    MenuAction action;         // 菜单项动作函数
+    const MenuActivity* activity; // 菜单项活动，NULL表示进入子菜单
     int parentIndex;           // 父菜单索引 (-1表示根菜单)
+    uint8_t firstChild;        // 第一个子菜单项的索引
+    uint8_t childCount;        // 子菜单项数量，0表示没有子菜单
 } MenuItemDef;
 
-// 菜单项类型枚举
-typedef enum {
-    MENU_ITEM_TEXT,    // 文本菜单项
-    MENU_ITEM_IMAGE    // 图片菜单项
-} MenuItemType;
+// 子菜单范围，用于填写MenuItemDef的firstChild和childCount两个字段
+#define MENU_CHILDREN(first, last)  (first), ((last) - (first) + 1)
+#define MENU_NO_CHILDREN            0, 0
 
 // 图片菜单项移动模式枚举
 typedef enum {
@@ -61,22 +96,6 @@ typedef enum {
     IMAGE_MOVE_UP_DOWN      // 上下移动模式
 } ImageMoveMode;
 
-// 菜单项结构体 - 链表节点
-typedef struct MenuItem {
-    MenuItemType type;       // 菜单项类型
-    char* name;              // 菜单项名称
-    MenuAction action;       // 选择此菜单项执行的操作，NULL表示进入子菜单
-    struct MenuItem* parent; // 父菜单项指针
-    struct MenuItem* child;  // 第一个子菜单项指针
-    struct MenuItem* next;   // 下一个同级菜单项指针
-    
-    // 图片菜单项特有字段
-    const uint8_t* imageData; // 图片数据
-    uint16_t imageWidth;      // 图片宽度
-    uint16_t imageHeight;     // 图片高度
-    int8_t moveOffset;        // 图片移动偏移量
-} MenuItem;
-
 // 菜单状态结构体 - 用于保存每一级菜单的状态
 typedef struct {
     uint8_t selectedIndex; // 选中项的索引
@@ -86,34 +105,63 @@ typedef struct {
 // 定义菜单栈的最大深度
 #define MAX_MENU_DEPTH 8
 
+// 保留模式渲染最多记录的可见行数（行高不小于8像素）
+#define MENU_VIEW_MAX_ROWS (OLED_HEIGHT / 8)
+
+// 保留模式渲染状态 - 记录屏幕上已经绘制的内容，选中项或起始行变化时只重绘有变化的行
+typedef struct {
+    bool valid;                                   // 屏幕内容是否与记录一致，菜单以外的界面绘制后必须置为false
+    const MenuItemDef* menu;                      // 已绘制的菜单
+    uint8_t startX;                               // 绘制参数，与本次不同时整屏重绘
+    uint8_t startY;
+    uint8_t fontSize;
+    uint8_t listY;                                // 第一行菜单项的纵坐标
+    uint8_t startRow;                             // 已绘制的起始行
+    uint8_t rowCount;                             // 已绘制的行数
+    const MenuItemDef* rows[MENU_VIEW_MAX_ROWS];  // 每一行上绘制的菜单项，NULL表示该行需要重绘
+    bool rowSelected[MENU_VIEW_MAX_ROWS];         // 每一行是否以选中状态绘制
+} MenuView;
+
 // 菜单管理器结构体
 typedef struct {
-    MenuItem* rootMenu;      // 根菜单指针
-    MenuItem* currentMenu;   // 当前菜单指针
-    MenuItem* selectedItem;  // 当前选中的菜单项
+    const MenuItemDef* tree;         // 菜单树数组，索引0为根菜单
+    uint8_t itemCount;               // 菜单树中的菜单项数量
+    const MenuItemDef* rootMenu;     // 根菜单指针
+    const MenuItemDef* currentMenu;  // 当前菜单指针
+    const MenuItemDef* selectedItem; // 当前选中的菜单项
     uint8_t visibleRows;     // 屏幕可见行数
     uint8_t startRow;        // 当前显示的起始行
     ImageMoveMode moveMode;  // 当前层级的图片移动模式
     bool isEvenVisibleImages; // 可见图像数量的奇偶性（1表示偶数，0表示奇数）
-    bool blockKeyEvents;      // 是否阻塞按键事件处理
+    bool blockKeyEvents;      // 是否阻塞菜单导航（活动运行期间为true）
     bool startRowInitialized; // startRow是否已初始化（用于确保特定代码只运行一次）
     
     // 菜单状态栈 - 用于多级菜单导航时保存和恢复状态
     MenuState stateStack[MAX_MENU_DEPTH]; // 状态栈数组
     uint8_t stackDepth;                    // 当前栈深度
+    
+    // 保留模式渲染状态
+    MenuView view;
+    
+    // 活动与帧率控制
+    const MenuActivity* activity;    // 当前运行的活动，NULL表示显示菜单
+    bool timerArmed;                 // 活动定时器是否启动
+    TickType_t timerDeadline;        // 活动定时器到期时刻
+    bool dirty;                      // 是否有待绘制的内容
+    TickType_t lastFrame;            // 上一次绘制的时刻
 } MenuManager;
 
-extern MenuItemDef menuItems[];
+extern const MenuItemDef menuItems[];
 extern const uint8_t MENU_ITEM_COUNT;
 
 // 菜单初始化函数
 void MenuManager_Init(MenuManager* manager);
 
-// 菜单树构建函数
-MenuItem* build_menu_tree(void);
+// 设置菜单树，索引0为根菜单
+void MenuManager_SetMenuTree(MenuManager* manager, const MenuItemDef* tree, uint8_t count);
 
-// 设置根菜单
-void MenuManager_SetRootMenu(MenuManager* manager, MenuItem* root);
+// 检查菜单树中每个菜单项的子菜单范围与parentIndex是否一致
+bool MenuManager_ValidateTree(const MenuItemDef* tree, uint8_t count);
 
 // 菜单操作处理
 bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op);
@@ -121,7 +169,25 @@ bool MenuManager_HandleOperation(MenuManager* manager, MenuOperation op);
 // 显示当前菜单
 void MenuManager_DisplayMenu(MenuManager* manager, uint8_t startX, uint8_t startY, uint8_t fontSize);
 
-// 销毁菜单树
+// 标记屏幕内容已被菜单以外的界面改写，下次显示时整屏重绘
+void MenuManager_Invalidate(MenuManager* manager);
+
+// 分发一个输入事件：有活动运行时交给活动处理，否则作为菜单导航操作
+void MenuManager_HandleEvent(MenuManager* manager, const MenuEvent* event);
+
+// 启动活动定时器，ms毫秒后向当前活动发送一次MENU_EVENT_TIMER，传0取消
+void MenuManager_SetActivityTimer(MenuManager* manager, uint32_t ms);
+
+// 请求在下一帧重绘当前界面
+void MenuManager_RequestRedraw(MenuManager* manager);
+
+// 提示信息类活动的事件处理函数：忽略输入，定时器到期后退出
+MenuActivityResult MenuActivity_ExitOnTimer(const MenuEvent* event);
+
+// UI任务每次被唤醒后调用：处理到期的定时器，到帧时间时重绘，返回距离下一次需要唤醒的节拍数
+TickType_t MenuManager_Service(MenuManager* manager, uint8_t startX, uint8_t startY, uint8_t fontSize);
+
+// 重置菜单管理器（菜单树为常量数组，无需释放）
 void MenuManager_Destroy(MenuManager* manager);
 
 #ifdef __cplusplus
@@ -2,19 +2,38 @@
 #include "spi_scanner/keymap_manager.h"
 #include "nvs_manager/unified_nvs_manager.h"
 #include "audio_player/mp3_player.h"
+#include "audio_player/audio_spectrum.h"
+#include "joystick_mouse.h"
+#include "esp_timer.h"
 
 // 内部static函数声明
 static esp_err_t menu_nvs_init(void);
 static void load_menu_config(void);
 static void save_menu_config(void);
 static void menu_init(uint8_t fontSize);
+static void publish_joystick_direction(joystick_direction_t direction);
 static void joystick_task(void *arg);
 static void menu_task(void *arg);
-static void menuActionMp3Player(void);
+static bool mp3_activity_enter(void);
+static MenuActivityResult mp3_activity_event(const MenuEvent* event);
+static void mp3_activity_render(void);
+static void mp3_activity_exit(void);
+static bool cube_activity_enter(void);
+static MenuActivityResult cube_activity_event(const MenuEvent* event);
+static void cube_activity_render(void);
+static bool joystick_pointer_activity_enter(void);
+static bool joystick_scroll_activity_enter(void);
+static MenuActivityResult joystick_mouse_activity_event(const MenuEvent* event);
+static void joystick_mouse_activity_render(void);
+static void joystick_mouse_activity_exit(void);
+
+// UI任务输入事件缓冲区容量
+#define MENU_INPUT_CAPACITY     32
 
 // 定义菜单项索引枚举，使菜单层次关系更加直观
 // 注意：新增菜单项时，请严格按照"根菜单→一级菜单→二级菜单→三级菜单"的顺序添加
-//       同一层级内的菜单项应按照功能分组，保持与menuItems数组中的顺序完全一致
+//       同一父菜单的子菜单项必须相邻，menuItems数组按此枚举下标初始化，
+//       父菜单使用MENU_CHILDREN(第一个子项, 最后一个子项)指定子菜单范围
 typedef enum {
     // 根菜单
     MENU_ID_MAIN,                
@@ -28,10 +47,13 @@ typedef enum {
     // 二级菜单 - 系统设置的子项
     MENU_ID_TIME_SETTINGS,         // 时间设置
     MENU_ID_MP3_PLAYER,            // MP3播放器
+    MENU_ID_CUBE_3D,               // 3D立方体
     
     // 二级菜单 - 键盘选项的子项
     MENU_ID_MAPPING_LAYER,         // 映射层
     MENU_ID_RGB_EFFECTS,           // 灯效管理
+    MENU_ID_JOYSTICK_MOUSE,        // 摇杆鼠标
+    MENU_ID_JOYSTICK_SCROLL,       // 摇杆滚轮
     
     // 二级菜单 - 网络配置的子项
     MENU_ID_WIFI_TOGGLE,           // WiFi开关
@@ -43,17 +65,19 @@ typedef enum {
     MENU_ID_RGB_TOGGLE,            // 开关灯效
     MENU_ID_RGB_MODE_SELECT,       // 选择灯效模式
     MENU_ID_RGB_SPEED_ADJUST,      // 调节灯效速度
-    MENU_ID_RGB_HSV_ADJUST         // HSV统一调控
+    MENU_ID_RGB_HSV_ADJUST,        // HSV统一调控
+    
+    MENU_ID_COUNT                  // 菜单项数量
 
 } MenuItemId;
 
 // 全局变量定义
 
-// 摇杆操作码队列（uint8_t类型）
-static QueueHandle_t joystickQueue = NULL;
+// UI任务在输入事件总线上的订阅者
+static input_subscriber_t* menuInput = NULL;
 
-// 键盘键码队列（uint16_t类型）
-static QueueHandle_t keyboardQueue = NULL;
+// MP3播放器活动使用的播放器实例
+static MP3Player* mp3Player = NULL;
 
 // 菜单管理器实例
 static MenuManager menuManager;
@@ -202,38 +226,80 @@ static void save_menu_config(void) {
 }
 
 
-// 菜单定义结构
-MenuItemDef menuItems[] = {
+// MP3播放器活动 - 摇杆控制播放，屏幕随播放状态和频谱变化重绘
+static const MenuActivity menuActivityMp3Player = {
+    .on_enter  = mp3_activity_enter,
+    .on_event  = mp3_activity_event,
+    .on_render = mp3_activity_render,
+    .on_exit   = mp3_activity_exit,
+};
+
+// 3D立方体活动 - 按帧率旋转线框立方体，右上角显示单帧绘制耗时
+static const MenuActivity menuActivityCube3D = {
+    .on_enter  = cube_activity_enter,
+    .on_event  = cube_activity_event,
+    .on_render = cube_activity_render,
+};
+
+// 摇杆鼠标活动 - 活动运行期间摇杆移动指针，短按点击左键，长按或双击退出
+static const MenuActivity menuActivityJoystickPointer = {
+    .on_enter  = joystick_pointer_activity_enter,
+    .on_event  = joystick_mouse_activity_event,
+    .on_render = joystick_mouse_activity_render,
+    .on_exit   = joystick_mouse_activity_exit,
+};
+
+// 摇杆滚轮活动 - 活动运行期间上下为垂直滚轮、左右为水平滚轮
+static const MenuActivity menuActivityJoystickScroll = {
+    .on_enter  = joystick_scroll_activity_enter,
+    .on_event  = joystick_mouse_activity_event,
+    .on_render = joystick_mouse_activity_render,
+    .on_exit   = joystick_mouse_activity_exit,
+};
+
+// 菜单定义结构 - 常量数组，编译后存放在Flash中，运行时无需构建菜单树
+const MenuItemDef menuItems[] = {
     // 根菜单
-    {"Main Menu", MENU_TYPE_IMAGE, Image_setings, 32, 32, NULL, -1},
+    [MENU_ID_MAIN]                = {"Main Menu", MENU_TYPE_IMAGE, Image_setings, 32, 32, NULL, -1,
+                                     MENU_CHILDREN(MENU_ID_SYS_SETTINGS, MENU_ID_CALCULATOR)},
     
     // 一级菜单 (父菜单为根菜单)
-    {"系统设置", MENU_TYPE_IMAGE, Image_setings, 30, 30, NULL, MENU_ID_MAIN},
-    {"键盘选项", MENU_TYPE_IMAGE, Image_keyboard, 30, 30, NULL, MENU_ID_MAIN},
-    {"网络配置", MENU_TYPE_IMAGE, Image_wifi, 30, 30, NULL, MENU_ID_MAIN},
-    {"计算器", MENU_TYPE_IMAGE, Image_custom, 30, 30, menuActionCalculator, MENU_ID_MAIN},
+    [MENU_ID_SYS_SETTINGS]        = {"系统设置", MENU_TYPE_IMAGE, Image_setings, 30, 30, NULL, MENU_ID_MAIN,
+                                     MENU_CHILDREN(MENU_ID_TIME_SETTINGS, MENU_ID_CUBE_3D)},
+    [MENU_ID_KEYBOARD_OPTIONS]    = {"键盘选项", MENU_TYPE_IMAGE, Image_keyboard, 30, 30, NULL, MENU_ID_MAIN,
+                                     MENU_CHILDREN(MENU_ID_MAPPING_LAYER, MENU_ID_JOYSTICK_SCROLL)},
+    [MENU_ID_NETWORK_CONFIG]      = {"网络配置", MENU_TYPE_IMAGE, Image_wifi, 30, 30, NULL, MENU_ID_MAIN,
+                                     MENU_CHILDREN(MENU_ID_WIFI_TOGGLE, MENU_ID_CLEAR_WIFI_PASSWORD)},
+    [MENU_ID_CALCULATOR]          = {"计算器", MENU_TYPE_IMAGE, Image_custom, 30, 30, &menuActivityCalculator, MENU_ID_MAIN, MENU_NO_CHILDREN},
     
     // 二级菜单 - 系统设置的子项
-    {"时间设置", MENU_TYPE_TEXT, NULL, 0, 0, NULL, MENU_ID_SYS_SETTINGS},
-    {"MP3播放器", MENU_TYPE_ACTION, NULL, 0, 0, menuActionMp3Player, MENU_ID_SYS_SETTINGS},
+    [MENU_ID_TIME_SETTINGS]       = {"时间设置", MENU_TYPE_TEXT, NULL, 0, 0, NULL, MENU_ID_SYS_SETTINGS, MENU_NO_CHILDREN},
+    [MENU_ID_MP3_PLAYER]          = {"MP3播放器", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityMp3Player, MENU_ID_SYS_SETTINGS, MENU_NO_CHILDREN},
+    [MENU_ID_CUBE_3D]             = {"3D立方体", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityCube3D, MENU_ID_SYS_SETTINGS, MENU_NO_CHILDREN},
     
     // 二级菜单 - 键盘选项的子项
-    {"映射层", MENU_TYPE_ACTION, NULL, 0, 0, menuActionMappingLayer, MENU_ID_KEYBOARD_OPTIONS},
-    {"灯效管理", MENU_TYPE_TEXT, NULL, 0, 0, NULL, MENU_ID_KEYBOARD_OPTIONS},
+    [MENU_ID_MAPPING_LAYER]       = {"映射层", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityMappingLayer, MENU_ID_KEYBOARD_OPTIONS, MENU_NO_CHILDREN},
+    [MENU_ID_RGB_EFFECTS]         = {"灯效管理", MENU_TYPE_TEXT, NULL, 0, 0, NULL, MENU_ID_KEYBOARD_OPTIONS,
+                                     MENU_CHILDREN(MENU_ID_RGB_TOGGLE, MENU_ID_RGB_HSV_ADJUST)},
+    [MENU_ID_JOYSTICK_MOUSE]      = {"摇杆鼠标", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityJoystickPointer, MENU_ID_KEYBOARD_OPTIONS, MENU_NO_CHILDREN},
+    [MENU_ID_JOYSTICK_SCROLL]     = {"摇杆滚轮", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityJoystickScroll, MENU_ID_KEYBOARD_OPTIONS, MENU_NO_CHILDREN},
     
     // 三级菜单 - 灯效管理的子项
-    {"开关灯效", MENU_TYPE_ACTION, NULL, 0, 0, menuActionRgbToggle, MENU_ID_RGB_EFFECTS},
-    {"灯效模式", MENU_TYPE_ACTION, NULL, 0, 0, menuActionRgbModeSelect, MENU_ID_RGB_EFFECTS},
-    {"速度", MENU_TYPE_ACTION, NULL, 0, 0, menuActionRgbSpeedAdjust, MENU_ID_RGB_EFFECTS},
-    {"HSV", MENU_TYPE_ACTION, NULL, 0, 0, menuActionRgbHsvAdjust, MENU_ID_RGB_EFFECTS},
+    [MENU_ID_RGB_TOGGLE]          = {"开关灯效", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityRgbToggle, MENU_ID_RGB_EFFECTS, MENU_NO_CHILDREN},
+    [MENU_ID_RGB_MODE_SELECT]     = {"灯效模式", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityRgbModeSelect, MENU_ID_RGB_EFFECTS, MENU_NO_CHILDREN},
+    [MENU_ID_RGB_SPEED_ADJUST]    = {"速度", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityRgbSpeedAdjust, MENU_ID_RGB_EFFECTS, MENU_NO_CHILDREN},
+    [MENU_ID_RGB_HSV_ADJUST]      = {"HSV", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityRgbHsvAdjust, MENU_ID_RGB_EFFECTS, MENU_NO_CHILDREN},
     
     // WiFi相关菜单项 - 网络配置的子项
-    {"WiFi开关", MENU_TYPE_ACTION, NULL, 0, 0, menuActionWifiToggle, MENU_ID_NETWORK_CONFIG},
-    {"WiFi信息", MENU_TYPE_ACTION, NULL, 0, 0, menuActionWifiStatus, MENU_ID_NETWORK_CONFIG},
-    {"配置页面", MENU_TYPE_ACTION, NULL, 0, 0, menuActionHtmlUrl, MENU_ID_NETWORK_CONFIG},
-    {"清除密码", MENU_TYPE_ACTION, NULL, 0, 0, menuActionClearWifiPassword, MENU_ID_NETWORK_CONFIG},
+    [MENU_ID_WIFI_TOGGLE]         = {"WiFi开关", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityWifiToggle, MENU_ID_NETWORK_CONFIG, MENU_NO_CHILDREN},
+    [MENU_ID_WIFI_INFO]           = {"WiFi信息", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityWifiStatus, MENU_ID_NETWORK_CONFIG, MENU_NO_CHILDREN},
+    [MENU_ID_HTML_URL]            = {"配置页面", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityHtmlUrl, MENU_ID_NETWORK_CONFIG, MENU_NO_CHILDREN},
+    [MENU_ID_CLEAR_WIFI_PASSWORD] = {"清除密码", MENU_TYPE_ACTION, NULL, 0, 0, &menuActivityClearWifiPassword, MENU_ID_NETWORK_CONFIG, MENU_NO_CHILDREN},
 };
 
+// 菜单项枚举与菜单数组必须一一对应
+_Static_assert(sizeof(menuItems) / sizeof(MenuItemDef) == MENU_ID_COUNT, "MenuItemId枚举数量与menuItems数组数量不一致");
+
 // 计算菜单项数量
 const uint8_t MENU_ITEM_COUNT = sizeof(menuItems)/sizeof(MenuItemDef);
 
@@ -245,17 +311,13 @@ const uint8_t MENU_ITEM_COUNT = sizeof(menuItems)/sizeof(MenuItemDef);
 static void menu_init(uint8_t fontSize) {
     MenuManager_Init(&menuManager);
     
-    // 验证MenuItemId枚举与menuItems数组的一致性
-    // 确保MenuItemId枚举中最大的值不超过menuItems数组的大小
-    if (MENU_ID_RGB_HSV_ADJUST >= MENU_ITEM_COUNT) {
-        ESP_LOGE("OLED_MENU", "MenuItemId枚举数量与menuItems数组数量不一致! 请检查MenuItemId枚举定义.");
+    // 验证每个菜单项的子菜单范围与parentIndex一致
+    if (!MenuManager_ValidateTree(menuItems, MENU_ITEM_COUNT)) {
+        ESP_LOGE("OLED_MENU", "menuItems子菜单范围与parentIndex不一致! 请检查MENU_CHILDREN定义.");
     }
     
-    // 自动构建菜单树
-    MenuItem* root = build_menu_tree();
-    
-    // 设置根菜单
-    MenuManager_SetRootMenu(&menuManager, root);
+    // 设置菜单树（常量数组，无需动态分配）
+    MenuManager_SetMenuTree(&menuManager, menuItems, MENU_ITEM_COUNT);
 
     // 显示初始菜单
     MenuManager_DisplayMenu(&menuManager, 0, 0, fontSize);
@@ -264,14 +326,42 @@ static void menu_init(uint8_t fontSize) {
 // 任务函数
 
 /**
- * @brief 摇杆扫描任务 - 检测摇杆方向和按键状态
+ * @brief 把摇杆方向转换为菜单操作并发布
+ */
+static void publish_joystick_direction(joystick_direction_t direction) {
+    switch (direction) {
+        case JOYSTICK_UP:
+            input_event_publish(INPUT_EVENT_JOYSTICK, MENU_OP_DOWN);
+            break;
+        case JOYSTICK_DOWN:
+            input_event_publish(INPUT_EVENT_JOYSTICK, MENU_OP_UP);
+            break;
+        case JOYSTICK_LEFT:
+            input_event_publish(INPUT_EVENT_JOYSTICK, MENU_OP_LEFT); 
+            break;
+        case JOYSTICK_RIGHT:
+            input_event_publish(INPUT_EVENT_JOYSTICK, MENU_OP_RIGHT);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 摇杆任务 - 把摇杆方向和按键事件转换为菜单操作
+ * 
+ * 摇杆由ADC连续采样驱动，方向改变和按键类型以事件形式到达；
+ * 保持同一方向时按长拉参数重复发送操作，等待超时即下一次重复的时刻，摇杆回中后任务一直阻塞。
  */
 void joystick_task(void *arg) {
+    // 先订阅再启动采样，不会漏掉第一个方向事件
+    input_subscriber_t *stickInput = input_event_subscribe(
+        INPUT_EVENT_MASK(INPUT_EVENT_STICK_DIRECTION) | INPUT_EVENT_MASK(INPUT_EVENT_STICK_BUTTON), 16);
 
     sw_gpio_init();
+    ESP_ERROR_CHECK(joystick_start_sampling());
     
-    const TickType_t scanInterval = 10 / portTICK_PERIOD_MS;  // 10ms扫描周期
-    joystick_state_t lastState = {JOYSTICK_CENTER, BUTTON_NONE};
+    joystick_direction_t direction = JOYSTICK_CENTER;
     
     // 摇杆长拉相关变量
     typedef struct {
@@ -289,111 +379,83 @@ void joystick_task(void *arg) {
     const uint32_t slow_repeat_delay = 200; // 慢速重复时间间隔(ms)
     const uint32_t acceleration_threshold = 5; // 加速阈值（重复次数）
     
+    TickType_t wait = portMAX_DELAY;
     while (1) {
+        input_event_t input;
+        bool received = input_event_receive(stickInput, &input, wait);
+        
         // 获取当前时间
         uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
         
-        // 获取摇杆状态
-        joystick_state_t currentState = get_joystick_direction();
-        
-        // 检查方向变化或长拉状态
-        if (currentState.direction != JOYSTICK_CENTER) {
-            // 方向不为中心
-            if (currentState.direction != lastState.direction) {
-                // 方向改变，发送初始事件
-                switch (currentState.direction) {
-                    case JOYSTICK_UP:
-                        xQueueSend(joystickQueue, &(uint8_t){MENU_OP_DOWN}, 0);
-                        break;
-                    case JOYSTICK_DOWN:
-                        xQueueSend(joystickQueue, &(uint8_t){MENU_OP_UP}, 0);
-                        break;
-                    case JOYSTICK_LEFT:
-                        xQueueSend(joystickQueue, &(uint8_t){MENU_OP_LEFT}, 0); 
-                        break;
-                    case JOYSTICK_RIGHT:
-                        xQueueSend(joystickQueue, &(uint8_t){MENU_OP_RIGHT}, 0);
-                        break;
-                    default:
-                        break;
-                }
-                
-                // 初始化长拉状态
+        if (received && input.type == INPUT_EVENT_STICK_DIRECTION) {
+            direction = (joystick_direction_t)input.code;
+            if (direction != JOYSTICK_CENTER) {
+                // 方向改变，发送初始事件并初始化长拉状态
+                publish_joystick_direction(direction);
                 holdState.active = true;
                 holdState.start_time = current_time;
                 holdState.repeat_count = 0;
                 holdState.next_repeat_time = current_time + initial_delay;
-            } else if (holdState.active) {
-                // 持续保持同一方向，检查是否需要发送重复事件
-                if (current_time >= holdState.next_repeat_time) {
-                    // 发送重复事件
-                    switch (currentState.direction) {
-                        case JOYSTICK_UP:
-                            xQueueSend(joystickQueue, &(uint8_t){MENU_OP_DOWN}, 0);
-                            break;
-                        case JOYSTICK_DOWN:
-                            xQueueSend(joystickQueue, &(uint8_t){MENU_OP_UP}, 0);
-                            break;
-                        case JOYSTICK_LEFT:
-                            xQueueSend(joystickQueue, &(uint8_t){MENU_OP_LEFT}, 0); 
-                            break;
-                        case JOYSTICK_RIGHT:
-                            xQueueSend(joystickQueue, &(uint8_t){MENU_OP_RIGHT}, 0);
-                            break;
-                        default:
-                            break;
-                    }
-                    
-                    // 更新重复计数和下一次重复时间
-                    holdState.repeat_count++;
-                    
-                    // 根据重复次数调整重复速度（加速机制）
-                    if (holdState.repeat_count >= acceleration_threshold) {
-                        holdState.next_repeat_time = current_time + fast_repeat_delay;
-                    } else {
-                        holdState.next_repeat_time = current_time + slow_repeat_delay;
-                    }
-                }
+            } else {
+                // 方向回到中心，立即重置所有长拉状态，确保不再发送重复事件
+                holdState.active = false;
+                holdState.repeat_count = 0;
+                holdState.next_repeat_time = 0;
             }
-        } else {
-            // 方向回到中心，立即重置所有长拉状态，确保不再发送重复事件
-            holdState.active = false;
-            holdState.repeat_count = 0;
-            holdState.next_repeat_time = 0;
-            
-            // 清空事件队列，防止残留的重复事件被处理
-            uint8_t dummy;
-            while (uxQueueMessagesWaiting(joystickQueue) > 0) {
-                xQueueReceive(joystickQueue, &dummy, 0);
+        } else if (received && input.type == INPUT_EVENT_STICK_BUTTON) {
+            // 短按进入，长按和双击返回
+            switch (input.code) {
+                case BUTTON_SHORT_PRESS:
+                    input_event_publish(INPUT_EVENT_JOYSTICK, MENU_OP_ENTER);
+                    break;
+                case BUTTON_LONG_PRESS:
+                case BUTTON_DOUBLE_PRESS:
+                    input_event_publish(INPUT_EVENT_JOYSTICK, MENU_OP_BACK);
+                    break;
+                default:
+                    break;
             }
         }
         
-        // 检测摇杆按键按下（短按）
-        if (lastState.press_type != BUTTON_SHORT_PRESS && currentState.press_type == BUTTON_SHORT_PRESS) {
-            xQueueSend(joystickQueue, &(uint8_t){MENU_OP_ENTER}, 0);
-        }
-        
-        // 检测摇杆按键长按
-        if (lastState.press_type != BUTTON_LONG_PRESS && currentState.press_type == BUTTON_LONG_PRESS) {
-            // TODO: 添加长按事件处理逻辑
-            xQueueSend(joystickQueue, &(uint8_t){MENU_OP_BACK}, 0);
+        // 持续保持同一方向，检查是否需要发送重复事件
+        if (holdState.active && (int32_t)(current_time - holdState.next_repeat_time) >= 0) {
+            publish_joystick_direction(direction);
+            
+            // 更新重复计数和下一次重复时间
+            holdState.repeat_count++;
+            
+            // 根据重复次数调整重复速度（加速机制）
+            if (holdState.repeat_count >= acceleration_threshold) {
+                holdState.next_repeat_time = current_time + fast_repeat_delay;
+            } else {
+                holdState.next_repeat_time = current_time + slow_repeat_delay;
+            }
         }
         
-        // 检测摇杆按键双击
-        if (lastState.press_type != BUTTON_DOUBLE_PRESS && currentState.press_type == BUTTON_DOUBLE_PRESS) {
-            // TODO: 添加双击事件处理逻辑
-            xQueueSend(joystickQueue, &(uint8_t){MENU_OP_BACK}, 0);
+        // 长拉期间等到下一次重复的时刻，否则一直等待事件
+        if (holdState.active) {
+            uint32_t remaining = holdState.next_repeat_time - current_time;
+            wait = pdMS_TO_TICKS(remaining);
+            if (wait == 0) {
+                wait = 1;
+            }
+        } else {
+            wait = portMAX_DELAY;
         }
-        
-        // 保存当前状态
-        lastState = currentState;
-        
-        vTaskDelay(scanInterval);
     }
 }
 
 
+/**
+ * @brief UI任务 - 唯一接收输入事件和绘制屏幕的任务
+ * 
+ * 从输入事件总线接收摇杆和键盘事件，把事件交给菜单或当前活动处理，
+ * 等待超时由活动定时器和下一帧的时间决定，没有事件时任务一直阻塞。
+ */
 static void menu_task(void *arg) {
+    // 订阅摇杆事件，键盘事件只在活动运行时订阅，菜单界面下扫描任务不会唤醒UI任务
+    menuInput = input_event_subscribe(INPUT_EVENT_MASK(INPUT_EVENT_JOYSTICK), MENU_INPUT_CAPACITY);
+    
     // 初始化OLED显示
     OLED_Init();    
     
@@ -404,19 +466,34 @@ static void menu_task(void *arg) {
     menu_init(OLED_8X16_HALF);
     
     // 菜单处理循环
-    uint8_t keyCode;
+    TickType_t wait = portMAX_DELAY;
     while (1) {
-        // 等待按键事件
-        if (xQueueReceive(joystickQueue, &keyCode, portMAX_DELAY) == pdTRUE) {
-            // 检查是否应该阻塞按键事件
-            if (!menuManager.blockKeyEvents) {
-                // 处理菜单操作
-                if (MenuManager_HandleOperation(&menuManager, keyCode)) {
-                    // 操作成功，刷新显示
-                    MenuManager_DisplayMenu(&menuManager, 0, 0, OLED_8X16_HALF);
-                }
+        input_event_t input;
+        if (input_event_receive(menuInput, &input, wait)) {
+            MenuEvent event;
+            if (input.type == INPUT_EVENT_KEY) {
+                event.type = MENU_EVENT_KEY;
+            } else if (input.type == INPUT_EVENT_AUDIO) {
+                event.type = MENU_EVENT_AUDIO;
+            } else {
+                event.type = MENU_EVENT_JOYSTICK;
             }
+            event.code = input.code;
+            MenuManager_HandleEvent(&menuManager, &event);
+        }
+        
+        // 处理到期的活动定时器，按帧率重绘，并得到下一次等待的时长
+        wait = MenuManager_Service(&menuManager, 0, 0, OLED_8X16_HALF);
+        
+        // 活动运行期间才需要键盘事件，音频事件只有MP3播放器活动需要
+        uint32_t mask = INPUT_EVENT_MASK(INPUT_EVENT_JOYSTICK);
+        if (menuManager.activity != NULL) {
+            mask |= INPUT_EVENT_MASK(INPUT_EVENT_KEY);
         }
+        if (menuManager.activity == &menuActivityMp3Player) {
+            mask |= INPUT_EVENT_MASK(INPUT_EVENT_AUDIO);
+        }
+        input_event_set_filter(menuInput, mask);
     }
 }
 
@@ -426,12 +503,6 @@ static void menu_task(void *arg) {
  * @brief 菜单系统入口函数
  */
 void oled_menu_example_start(void) {
-    // 创建摇杆操作码队列（uint8_t类型）
-    joystickQueue = xQueueCreate(10, sizeof(uint8_t));
-    
-    // 创建键盘键码队列（uint16_t类型）
-    keyboardQueue = xQueueCreate(20, sizeof(uint16_t));
-    
     // 创建摇杆扫描任务
     xTaskCreate(joystick_task, "joystick_task", 3*1024, NULL, 5, NULL);
     
@@ -442,61 +513,228 @@ void oled_menu_example_start(void) {
 /**
  * @brief 清空按键事件队列
  * 
- * 移除队列中的所有按键事件
+ * 丢弃UI任务输入缓冲区中尚未处理的事件，只能在UI任务中调用
  */
 void MenuManager_ClearKeyQueue(void) {
-    if (joystickQueue != NULL) {
-        xQueueReset(joystickQueue);
-    }
+    input_event_flush(menuInput);
 }
 
 // 公共访问函数定义
-QueueHandle_t get_keyboard_queue(void) {
-    return keyboardQueue;
+
+MenuManager* get_menu_manager(void) {
+    return &menuManager;
 }
 
-QueueHandle_t get_joystick_queue(void) {
-    return joystickQueue;
+/**
+ * @brief MP3播放器活动 - 进入时初始化播放器
+ * @return 播放器初始化失败时返回false，直接返回菜单
+ */
+static bool mp3_activity_enter(void) {
+    mp3Player = mp3_player_init();
+    if (mp3Player == NULL) {
+        return false;
+    }
+    return true;
 }
 
-MenuManager* get_menu_manager(void) {
-    return &menuManager;
+/**
+ * @brief MP3播放器活动 - 摇杆控制播放，播放状态或频谱变化时重绘
+ *
+ * 上下调音量，按下播放/暂停，左切换随机播放，右在不循环、列表循环、单曲循环之间切换。
+ * 不使用活动定时器：播放器和频谱分析任务在变化时发布音频事件，暂停或静音时UI任务不会被唤醒，
+ * 连续的频谱事件由MenuManager_Service合并为每帧最多一次重绘。
+ *
+ * @param event 菜单事件
+ * @return 长按或双击（MENU_OP_BACK）时退出活动
+ */
+static MenuActivityResult mp3_activity_event(const MenuEvent* event) {
+    if (event->type == MENU_EVENT_AUDIO) {
+        return MENU_ACTIVITY_REDRAW;
+    }
+    if (event->type != MENU_EVENT_JOYSTICK) return MENU_ACTIVITY_IDLE;
+    
+    switch (event->code) {
+        case MENU_OP_UP:
+            mp3_player_volume_up(mp3Player);
+            break;
+        case MENU_OP_DOWN:
+            mp3_player_volume_down(mp3Player);
+            break;
+        case MENU_OP_ENTER:
+            mp3_player_play_pause(mp3Player);
+            break;
+        case MENU_OP_LEFT:
+            mp3_player_set_shuffle(mp3Player, !mp3_player_get_shuffle(mp3Player));
+            return MENU_ACTIVITY_REDRAW;
+        case MENU_OP_RIGHT: {
+            playlist_repeat_t repeat = mp3_player_get_repeat(mp3Player);
+            repeat = (repeat == PLAYLIST_REPEAT_ONE) ? PLAYLIST_REPEAT_OFF : repeat + 1;
+            mp3_player_set_repeat(mp3Player, repeat);
+            return MENU_ACTIVITY_REDRAW;
+        }
+        case MENU_OP_BACK:
+            return MENU_ACTIVITY_EXIT;
+        default:
+            break;
+    }
+    return MENU_ACTIVITY_IDLE;
+}
+
+/**
+ * @brief MP3播放器活动 - 第一行显示播放状态和播放模式，下面按频段画柱状图
+ */
+static void mp3_activity_render(void) {
+    // 保留上一帧的结果，分析任务正在发布时沿用
+    static audio_spectrum_t spectrum;
+    audio_spectrum_read(&spectrum);
+    
+    OLED_Clear();
+    OLED_ShowString(0, 0, mp3_player_is_playing(mp3Player) ? "Playing" : "Paused", OLED_6X8_HALF);
+    
+    // 播放模式靠右显示：随机播放为Shuf，列表循环为RepA，单曲循环为Rep1
+    static const char *const repeat_labels[] = {
+        [PLAYLIST_REPEAT_OFF] = "",
+        [PLAYLIST_REPEAT_ALL] = "RepA",
+        [PLAYLIST_REPEAT_ONE] = "Rep1",
+    };
+    if (mp3_player_get_shuffle(mp3Player)) {
+        OLED_ShowString(74, 0, "Shuf", OLED_6X8_HALF);
+    }
+    OLED_ShowString(104, 0, repeat_labels[mp3_player_get_repeat(mp3Player)], OLED_6X8_HALF);
+    
+    // 暂停后不再有频谱事件，不画柱状图，避免停在最后一帧
+    if (!mp3_player_is_playing(mp3Player)) return;
+    
+    // 柱状图占第一行以下的区域，每个频段一根柱子
+    const int16_t top = 8;
+    const int16_t height = OLED_HEIGHT - top;
+    const int16_t pitch = OLED_WIDTH / AUDIO_SPECTRUM_BANDS;
+    for (int b = 0; b < AUDIO_SPECTRUM_BANDS; b++) {
+        int16_t bar = spectrum.bands[b] * height / 256;
+        if (bar > 0) {
+            OLED_DrawRectangle(b * pitch + 1, OLED_HEIGHT - bar, pitch - 2, bar, OLED_FILLED);
+        }
+    }
 }
 
 /**
- * @brief MP3播放器菜单项动作函数
- * 进入MP3播放器控制模式，监控摇杆状态来控制MP3播放
+ * @brief MP3播放器活动 - 退出时停止播放并释放播放器
  */
-static void menuActionMp3Player(void) {
+static void mp3_activity_exit(void) {
+    mp3_player_stop_playback(mp3Player);
+    mp3_player_deinit(mp3Player);
+    mp3Player = NULL;
+}
 
-    MP3Player* player = mp3_player_init();
-    if (player == NULL) {
-        return;
+// 立方体边长（像素）与投影方式，按下摇杆切换平行/透视投影
+#define CUBE_SIZE_PX    18
+static uint8_t cubePerspective = 1;
+// 单帧绘制耗时的平滑值（微秒），0表示尚未测量
+static uint32_t cubeFrameUs;
+
+/**
+ * @brief 3D立方体活动 - 进入时清零耗时统计并启动帧定时器
+ */
+static bool cube_activity_enter(void) {
+    cubeFrameUs = 0;
+    MenuManager_SetActivityTimer(get_menu_manager(), MENU_FRAME_INTERVAL_MS);
+    return true;
+}
+
+/**
+ * @brief 3D立方体活动 - 定时器到期时绘制下一帧，按下切换投影方式
+ * @param event 菜单事件
+ * @return 长按或双击（MENU_OP_BACK）时退出活动，定时器随活动结束自动取消
+ */
+static MenuActivityResult cube_activity_event(const MenuEvent* event) {
+    if (event->type == MENU_EVENT_TIMER) {
+        MenuManager_SetActivityTimer(get_menu_manager(), MENU_FRAME_INTERVAL_MS);
+        return MENU_ACTIVITY_REDRAW;
     }
+    if (event->type != MENU_EVENT_JOYSTICK) return MENU_ACTIVITY_IDLE;
+    
+    switch (event->code) {
+        case MENU_OP_ENTER:
+            cubePerspective = !cubePerspective;
+            return MENU_ACTIVITY_REDRAW;
+        case MENU_OP_BACK:
+            return MENU_ACTIVITY_EXIT;
+        default:
+            break;
+    }
+    return MENU_ACTIVITY_IDLE;
+}
+
+/**
+ * @brief 3D立方体活动 - 绘制一帧并测量DrawCube3D的耗时
+ *
+ * 耗时只包含旋转、投影和画线，不含清屏和屏幕传输，按1/8权重做指数平均
+ */
+static void cube_activity_render(void) {
+    OLED_Clear();
     
-    // 等待用户输入
-    bool confirmed = false;
-    while (!confirmed) {
-        uint8_t op; // 改为uint8_t类型，与joystick_task中发送的数据类型匹配
-        if (xQueueReceive(get_joystick_queue(), &op, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-            switch (op) {
-                case MENU_OP_UP:
-                    mp3_player_volume_up(player);
-                    break;
-                case MENU_OP_DOWN:
-                    mp3_player_volume_down(player);
-                    break;
-                case MENU_OP_ENTER:
-                    mp3_player_play_pause(player);
-                    break;
-                case MENU_OP_BACK:
-                    mp3_player_stop_playback(player);
-                    mp3_player_deinit(player);
-                    confirmed = true;
-                    break;
-                default:
-                    break;
-            }
-        }
+    int64_t start = esp_timer_get_time();
+    DrawCube3D(OLED_WIDTH / 2, OLED_HEIGHT / 2, CUBE_SIZE_PX, cubePerspective);
+    uint32_t frameUs = (uint32_t)(esp_timer_get_time() - start);
+    cubeFrameUs = cubeFrameUs ? (cubeFrameUs * 7 + frameUs) / 8 : frameUs;
+    
+    OLED_Printf(92, 0, OLED_6X8_HALF, "%3luus", (unsigned long)cubeFrameUs);
+    OLED_ShowString(0, 0, cubePerspective ? "Persp" : "Ortho", OLED_6X8_HALF);
+}
+
+/**
+ * @brief 摇杆鼠标活动 - 进入时切换到指针模式
+ */
+static bool joystick_pointer_activity_enter(void) {
+    joystick_mouse_set_mode(JOYSTICK_MOUSE_POINTER);
+    return true;
+}
+
+/**
+ * @brief 摇杆滚轮活动 - 进入时切换到滚轮模式
+ */
+static bool joystick_scroll_activity_enter(void) {
+    joystick_mouse_set_mode(JOYSTICK_MOUSE_SCROLL);
+    return true;
+}
+
+/**
+ * @brief 摇杆鼠标活动 - 摇杆移动由采样任务直接交给鼠标模块，这里只处理按键
+ * @param event 菜单事件
+ * @return 长按或双击（MENU_OP_BACK）时退出活动
+ */
+static MenuActivityResult joystick_mouse_activity_event(const MenuEvent* event) {
+    if (event->type != MENU_EVENT_JOYSTICK) return MENU_ACTIVITY_IDLE;
+    
+    switch (event->code) {
+        case MENU_OP_ENTER:
+            joystick_mouse_click(JOYSTICK_MOUSE_BUTTON_LEFT);
+            break;
+        case MENU_OP_BACK:
+            return MENU_ACTIVITY_EXIT;
+        default:
+            break;
+    }
+    return MENU_ACTIVITY_IDLE;
+}
+
+/**
+ * @brief 摇杆鼠标活动 - 显示当前模式和操作提示
+ */
+static void joystick_mouse_activity_render(void) {
+    OLED_Clear();
+    if (joystick_mouse_get_mode() == JOYSTICK_MOUSE_SCROLL) {
+        OLED_ShowString(30, 0, "Stick Scroll", OLED_6X8_HALF);
+    } else {
+        OLED_ShowString(30, 0, "Stick Mouse", OLED_6X8_HALF);
     }
+    OLED_ShowString(10, 12, "Press: Left Click", OLED_6X8_HALF);
+    OLED_ShowString(10, 24, "Hold: Exit", OLED_6X8_HALF);
+}
+
+/**
+ * @brief 摇杆鼠标活动 - 退出时关闭摇杆鼠标，摇杆恢复菜单导航
+ */
+static void joystick_mouse_activity_exit(void) {
+    joystick_mouse_set_mode(JOYSTICK_MOUSE_OFF);
 }
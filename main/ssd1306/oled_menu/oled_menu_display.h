@@ -30,6 +30,7 @@
 
 /* 项目内部模块头文件 */
 #include "joystick.h"
+#include "input_event.h"                 // 输入事件总线
 #include "../oled_driver/OLED_driver.h"
 #include "keyboard_led.h"
 #include "wifi_app/wifi_app.h"           // WiFi功能接口
@@ -82,30 +83,12 @@ void oled_menu_example_start(void);
 /**
  * @brief 清空按键事件队列
  * 
- * 移除队列中的所有按键事件，用于重置输入状态
+ * 丢弃UI任务输入缓冲区中尚未处理的事件，用于重置输入状态
  * 
- * @note 该函数是线程安全的
+ * @note 只能在UI任务（菜单活动的回调）中调用
  */
 void MenuManager_ClearKeyQueue(void);
 
-/**
- * @brief 获取键盘键码队列句柄
- * 
- * 用于外部模块访问键盘键码事件队列（uint16_t类型）
- * 
- * @return 键盘键码队列句柄，如果未初始化则返回NULL
- */
-QueueHandle_t get_keyboard_queue(void);
-
-/**
- * @brief 获取摇杆操作码队列句柄
- * 
- * 用于外部模块访问摇杆操作码事件队列（uint8_t类型）
- * 
- * @return 摇杆操作码队列句柄，如果未初始化则返回NULL
- */
-QueueHandle_t get_joystick_queue(void);
-
 /**
  * @brief 获取菜单管理器实例
  * 
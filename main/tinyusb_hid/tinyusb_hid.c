@@ -16,6 +16,9 @@
 #include "usb_descriptors.h"
 #include "device/usbd.h"
 #include "keyboard_led/keyboard_led.h"
+#include "lamp_array_buffer.h"
+#include "input_event.h"
+#include "joystick_mouse.h"
 
 static const char *TAG = "tinyusb_hid.c";
 
@@ -104,10 +107,33 @@ void tinyusb_hid_keyboard_report(hid_report_t report)
     }
 }
 
+/**
+ * @brief 生成并发送一份摇杆鼠标报告
+ *
+ * 设备未枚举或端点仍忙时不生成报告，累积的移动和点击留到下一次发送
+ *
+ * @return 报告已提交给USB协议栈时返回true
+ */
+static bool send_mouse_report(void)
+{
+    if (!tud_mounted() || !tud_hid_n_ready(0)) {
+        return false;
+    }
+
+    joystick_mouse_report_t mouse;
+    if (!joystick_mouse_build_report(&mouse)) {
+        return false;
+    }
+    return tud_hid_n_report(0, REPORT_ID_MOUSE, &mouse, sizeof(mouse));
+}
+
 /**
  * @brief TinyUSB HID任务
  * 
- * 处理HID报告队列中的报告并发送到主机
+ * 处理HID报告队列中的报告并发送到主机。
+ * 摇杆鼠标移动期间不在队列上长时间阻塞：队列为空时立即生成下一份鼠标报告，
+ * 每份报告都等待IN传输完成后再继续，发送速率由USB轮询间隔限制。
+ * 上一轮没有发出鼠标报告时（端点忙、未枚举或没有移动量）至少等待一个tick，避免空转。
  * 
  * @param arg 任务参数（未使用）
  */
@@ -115,39 +141,66 @@ static void tinyusb_hid_task(void *arg)
 {
     (void) arg;
     hid_report_t report;
+    bool mouse_idle = false;
     
     while (1) {
-        if (xQueueReceive(s_tinyusb_hid->hid_queue, &report, portMAX_DELAY)) {
-            // 检查是否需要远程唤醒
-            if (tud_suspended()) {
-                tud_remote_wakeup();
-                xQueueReset(s_tinyusb_hid->hid_queue);
-            } else {
-                // 根据报告ID处理不同类型的报告
-                switch (report.report_id) {
-                case REPORT_ID_KEYBOARD:
-                    tud_hid_n_report(0, REPORT_ID_KEYBOARD, &report.keyboard_report, sizeof(report.keyboard_report));
-                    break;
-                case REPORT_ID_FULL_KEY_KEYBOARD:
-                    tud_hid_n_report(0, REPORT_ID_FULL_KEY_KEYBOARD, &report.keyboard_full_key_report, sizeof(report.keyboard_full_key_report));
-                    break;
-                case REPORT_ID_CONSUMER:
-                    tud_hid_n_report(0, REPORT_ID_CONSUMER, &report.consumer_report, sizeof(report.consumer_report));
-                    break;
-                default:
-                    // 未知报告类型，跳过处理
+        TickType_t wait = portMAX_DELAY;
+        if (joystick_mouse_is_active() && !tud_suspended()) {
+            wait = mouse_idle ? 1 : 0;
+        }
+        if (!xQueueReceive(s_tinyusb_hid->hid_queue, &report, wait)) {
+            // 没有排队的键盘报告，继续发送摇杆鼠标报告
+            report.report_id = REPORT_ID_MOUSE;
+        }
+        
+        // 检查是否需要远程唤醒
+        if (tud_suspended()) {
+            tud_remote_wakeup();
+            xQueueReset(s_tinyusb_hid->hid_queue);
+        } else {
+            // 根据报告ID处理不同类型的报告
+            switch (report.report_id) {
+            case REPORT_ID_KEYBOARD:
+                tud_hid_n_report(0, REPORT_ID_KEYBOARD, &report.keyboard_report, sizeof(report.keyboard_report));
+                break;
+            case REPORT_ID_FULL_KEY_KEYBOARD:
+                tud_hid_n_report(0, REPORT_ID_FULL_KEY_KEYBOARD, &report.keyboard_full_key_report, sizeof(report.keyboard_full_key_report));
+                break;
+            case REPORT_ID_CONSUMER:
+                tud_hid_n_report(0, REPORT_ID_CONSUMER, &report.consumer_report, sizeof(report.consumer_report));
+                break;
+            case REPORT_ID_MOUSE:
+                // 鼠标报告在发送前才生成，没有发出时不等待完成，下一轮在队列上等一个tick
+                mouse_idle = !send_mouse_report();
+                if (mouse_idle) {
                     continue;
                 }
-                
-                // 等待报告发送完成
-                if (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100))) {
-                    ESP_LOGW(TAG, "Report not sent");
-                }
+                break;
+            default:
+                // 未知报告类型，跳过处理
+                continue;
+            }
+            
+            // 等待报告发送完成
+            if (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100))) {
+                ESP_LOGW(TAG, "Report not sent");
             }
         }
     }
 }
 
+void tinyusb_hid_mouse_wakeup(void)
+{
+    if (s_tinyusb_hid == NULL) {
+        return;
+    }
+    
+    // 队列中已有报告时HID任务本来就会被唤醒，唤醒报告丢失无影响
+    hid_report_t report = {0};
+    report.report_id = REPORT_ID_MOUSE;
+    xQueueSend(s_tinyusb_hid->hid_queue, &report, 0);
+}
+
 /**
  * @brief 初始化TinyUSB HID设备
  * 
@@ -208,45 +261,40 @@ void tud_hid_report_complete_cb(uint8_t itf, uint8_t const *report, uint16_t len
 }
 
 /************************************************** Windows Lighting **********************************************/
-// Windows Lighting 灯的位置和颜色数据
-static int32_t lamp_positions[WS2812B_NUM][3]; // 灯的位置坐标(仅内部使用)
-uint8_t lamp_colors[WS2812B_NUM][4];           // RGBA颜色数据(全局变量，供keyboard_led.c访问)
-bool autonomous_mode = false;                  // 自主模式标志(全局变量，供keyboard_led.c访问)
+// 灯属性，按LED索引排列，由KOB_LED_POINTS在编译时生成
+typedef struct {
+    int32_t x_um;
+    int32_t y_um;
+} lamp_position_t;
 
-// 声明从keyboard_led.c获取的互斥锁，用于保护共享资源访问
-extern SemaphoreHandle_t g_windows_lighting_mutex;
+static const lamp_position_t lamp_positions[WS2812B_NUM] = {
+#define LAMP_POSITION(x, y) { LAMP_POINT_TO_UM(x), LAMP_POINT_TO_UM(y) },
+    KOB_LED_POINTS(LAMP_POSITION)
+#undef LAMP_POSITION
+};
 
-/**
- * @brief 初始化灯的位置信息
- * 
- * 设置键盘上每个LED的坐标位置，用于Windows Lighting功能
- */
+_Static_assert(sizeof(lamp_positions) / sizeof(lamp_positions[0]) == WS2812B_NUM,
+               "KOB_LED_POINTS must list one point per LED");
 
-static void init_lamp_positions(void) {
-    // 设置默认的灯位置信息，这些坐标与实际键盘布局相匹配
-    const int32_t default_lamp_positions[WS2812B_NUM][3] = {
-        {10000, 10000, 0},  // LED 0
-        {20000, 10000, 0},  // LED 1
-        {30000, 10000, 0},  // LED 2
-        {40000, 10000, 0},  // LED 3
-        {50000, 10000, 0},  // LED 4
-        {60000, 10000, 0},  // LED 5
-        {70000, 10000, 0},  // LED 6
-        {80000, 10000, 0},  // LED 7
-        {15000, 20000, 0},  // LED 8
-        {25000, 20000, 0},  // LED 9
-        {35000, 20000, 0},  // LED 10
-        {45000, 20000, 0},  // LED 11
-        {55000, 20000, 0},  // LED 12
-        {65000, 20000, 0},  // LED 13
-        {20000, 30000, 0},  // LED 14
-        {30000, 30000, 0},  // LED 15
-        {40000, 30000, 0},  // LED 16
-    };
-    
-    // 复制默认位置信息
-    memcpy(lamp_positions, default_lamp_positions, sizeof(lamp_positions));
-}
+// 灯阵列边界框：各轴取所有灯位置的最大值再加半个按键间距，灯都在同一平面上，深度为0
+// 最大值在编译时折叠：嵌套union的大小等于其中最大的成员，每个灯贡献一个长度为其坐标的char数组
+#define LAMP_FOLD_X(x, y)       union { char lamp[LAMP_POINT_TO_UM(x)];
+#define LAMP_FOLD_Y(x, y)       union { char lamp[LAMP_POINT_TO_UM(y)];
+#define LAMP_FOLD_END(x, y)     } next;
+#define LAMP_MAX_X_UM           ((int32_t)sizeof(union { KOB_LED_POINTS(LAMP_FOLD_X) char end; KOB_LED_POINTS(LAMP_FOLD_END) }))
+#define LAMP_MAX_Y_UM           ((int32_t)sizeof(union { KOB_LED_POINTS(LAMP_FOLD_Y) char end; KOB_LED_POINTS(LAMP_FOLD_END) }))
+#define LAMP_BOUNDING_WIDTH_UM  (LAMP_MAX_X_UM + LAMP_KEY_PITCH_UM / 2)
+#define LAMP_BOUNDING_HEIGHT_UM (LAMP_MAX_Y_UM + LAMP_KEY_PITCH_UM / 2)
+#define LAMP_BOUNDING_DEPTH_UM  0
+
+// 主机的帧经过后台缓冲区在两个帧周期内送到灯带
+#define LAMP_UPDATE_LATENCY_US      (2 * 1000000 / KOB_LED_DEFAULT_FPS)
+#define LAMP_MIN_UPDATE_INTERVAL_US (1000000 / KOB_LED_DEFAULT_FPS)
+
+bool autonomous_mode = false;                  // 自主模式标志(全局变量，供keyboard_led.c访问)
+
+// 下一次灯属性响应返回的灯ID，只由USB任务访问
+static uint16_t s_lamp_attributes_id = 0;
 
 /**
  * @brief 初始化Windows Lighting相关功能
@@ -254,7 +302,7 @@ static void init_lamp_positions(void) {
  * 在USB设备初始化时调用，为键盘提供Windows Lighting支持
  */
 void windows_lighting_init(void) {
-    init_lamp_positions();
+    s_lamp_attributes_id = 0;
 }
 
 /**
@@ -289,43 +337,46 @@ void tinyusb_hid_enable_report(bool enable)
 uint16_t tud_hid_get_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t report_type, uint8_t *buffer, uint16_t reqlen)
 {
     (void) itf;
-    (void) report_type;
-    (void) reqlen;
 
     switch (report_id) {
     case REPORT_ID_LIGHTING_LAMP_ARRAY_ATTRIBUTES: {
-        // 填充灯阵列属性报告
-        uint16_t *report = (uint16_t *)buffer;
-        report[0] = WS2812B_NUM;  // 灯的数量
+        if (reqlen < 22) {
+            return 0;
+        }
         
-        // 填充其他属性
-        int32_t *report32 = (int32_t *)(buffer + 2);
-        report32[0] = 80000;  // 边界框宽度
-        report32[1] = 30000;  // 边界框高度
-        report32[2] = 0;      // 边界框深度
-        report32[3] = LAMP_ARRAY_KIND_KEYBOARD;  // 灯阵列类型
-        report32[4] = 10000;  // 最小更新间隔
+        // 填充灯阵列属性报告
+        uint16_t lamp_count = WS2812B_NUM;
+        int32_t attributes[5] = {
+            LAMP_BOUNDING_WIDTH_UM,             // 边界框宽度
+            LAMP_BOUNDING_HEIGHT_UM,            // 边界框高度
+            LAMP_BOUNDING_DEPTH_UM,             // 边界框深度
+            LAMP_ARRAY_KIND_KEYBOARD,           // 灯阵列类型
+            LAMP_MIN_UPDATE_INTERVAL_US,        // 最小更新间隔
+        };
+        memcpy(buffer, &lamp_count, 2);
+        memcpy(buffer + 2, attributes, sizeof(attributes));
         
         return 22;  // 报告长度
     }
     
     case REPORT_ID_LIGHTING_LAMP_ATTRIBUTES_RESPONSE: {
-        // 获取灯ID
-        uint16_t lamp_id = ((uint16_t *)buffer)[0];
-        if (lamp_id >= WS2812B_NUM) {
-            return 0;  // 无效的灯ID
+        if (reqlen < 28) {
+            return 0;
         }
         
-        // 填充灯属性响应报告
-        ((uint16_t *)buffer)[0] = lamp_id;  // 灯ID
+        // 返回主机通过属性请求报告指定的灯，之后自动指向下一个灯
+        uint16_t lamp_id = s_lamp_attributes_id;
+        s_lamp_attributes_id = (lamp_id + 1 < WS2812B_NUM) ? lamp_id + 1 : 0;
         
-        // 填充位置信息
-        int32_t *report32 = (int32_t *)(buffer + 2);
-        report32[0] = lamp_positions[lamp_id][0];  // X坐标
-        report32[1] = lamp_positions[lamp_id][1];  // Y坐标
-        report32[2] = lamp_positions[lamp_id][2];  // Z坐标
-        report32[3] = 1000;  // 更新延迟
-        report32[4] = 0x00000001;  // 灯的用途（键盘按键）
+        int32_t attributes[5] = {
+            lamp_positions[lamp_id].x_um,   // X坐标
+            lamp_positions[lamp_id].y_um,   // Y坐标
+            0,                              // Z坐标
+            LAMP_UPDATE_LATENCY_US,         // 更新延迟
+            LAMP_PURPOSE_CONTROL,           // 灯的用途（键盘按键）
+        };
+        memcpy(buffer, &lamp_id, 2);
+        memcpy(buffer + 2, attributes, sizeof(attributes));
         
         // 填充颜色通道信息
         uint8_t *report8 = buffer + 22;
@@ -339,6 +390,14 @@ uint16_t tud_hid_get_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t
         return 28;  // 报告长度
     }
     
+    case REPORT_ID_MOUSE:
+        // 滚轮分辨率倍数功能报告
+        if (report_type != HID_REPORT_TYPE_FEATURE || reqlen < 1) {
+            return 0;
+        }
+        buffer[0] = joystick_mouse_get_resolution();
+        return 1;
+    
     default:
         // 不支持的报告ID
         return 0;
@@ -353,79 +412,74 @@ uint16_t tud_hid_get_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t
 void tud_hid_set_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t report_type, uint8_t const *buffer, uint16_t bufsize)
 {
     (void) itf;
-    (void) report_type;
-    (void) bufsize;
 
     switch (report_id) {
+    case REPORT_ID_LIGHTING_LAMP_ATTRIBUTES_REQUEST: {
+        // 主机指定下一次属性响应返回的灯
+        if (bufsize < 2) {
+            break;
+        }
+        uint16_t lamp_id = buffer[0] | (buffer[1] << 8);
+        s_lamp_attributes_id = (lamp_id < WS2812B_NUM) ? lamp_id : 0;
+        break;
+    }
+    
     case REPORT_ID_LIGHTING_LAMP_MULTI_UPDATE: {
-        // 多灯更新报告
+        // 多灯更新报告：灯数量、更新标志、灯ID数组、颜色数组
+        if (bufsize < 2 + LAMP_MULTI_UPDATE_MAX_LAMPS * 6) {
+            break;
+        }
         uint8_t lamp_count = buffer[0];
-        (void)buffer[1]; // 未使用的update_flags
+        uint8_t update_flags = buffer[1];
+        const uint8_t *lamp_ids = &buffer[2];
+        const uint8_t *lamp_colors = &buffer[2 + LAMP_MULTI_UPDATE_MAX_LAMPS * 2];
         
-        if (lamp_count > 8) lamp_count = 8;  // 最多8个灯
+        if (lamp_count > LAMP_MULTI_UPDATE_MAX_LAMPS) lamp_count = LAMP_MULTI_UPDATE_MAX_LAMPS;
         
-        // 获取互斥锁，保护共享资源访问
-        if (g_windows_lighting_mutex && xSemaphoreTake(g_windows_lighting_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            for (uint8_t i = 0; i < lamp_count; i++) {
-                uint16_t lamp_id = ((uint16_t *)&buffer[2])[i];
-                if (lamp_id >= WS2812B_NUM) continue;
-                
-                // 获取灯的颜色信息
-                uint8_t red = buffer[18 + i * 4];
-                uint8_t green = buffer[19 + i * 4];
-                uint8_t blue = buffer[20 + i * 4];
-                uint8_t intensity = buffer[21 + i * 4];
-                
-                // 更新灯的颜色
-                lamp_colors[lamp_id][0] = red;
-                lamp_colors[lamp_id][1] = green;
-                lamp_colors[lamp_id][2] = blue;
-                lamp_colors[lamp_id][3] = intensity;
-            }
+        // 写入暂存区，不加锁，不会阻塞USB任务
+        for (uint8_t i = 0; i < lamp_count; i++) {
+            uint16_t lamp_id = lamp_ids[i * 2] | (lamp_ids[i * 2 + 1] << 8);
             
-            // 释放互斥锁
-            xSemaphoreGive(g_windows_lighting_mutex);
-            
-            // 如果不是自主模式，记录更新信息
-            if (!autonomous_mode) {
-                ESP_LOGD(TAG, "Updated %d lamps in Windows Lighting mode", lamp_count);
-            }
-        } else {
-            ESP_LOGW(TAG, "Failed to acquire mutex for Windows Lighting multi update");
+            // 获取灯的颜色信息（红、绿、蓝、亮度）
+            lamp_array_stage(lamp_id, &lamp_colors[i * 4]);
+        }
+        
+        // 主机标记本批更新完成时一次性发布
+        if (update_flags & LAMP_UPDATE_COMPLETE) {
+            lamp_array_commit();
+        }
+        
+        // 如果不是自主模式，记录更新信息
+        if (!autonomous_mode) {
+            ESP_LOGD(TAG, "Updated %d lamps in Windows Lighting mode", lamp_count);
         }
         break;
     }
     
     case REPORT_ID_LIGHTING_LAMP_RANGE_UPDATE: {
         // 灯范围更新报告
-        (void)buffer[0]; // 未使用的update_flags
-        uint16_t start_lamp_id = ((uint16_t *)&buffer[1])[0];
-        uint16_t end_lamp_id = ((uint16_t *)&buffer[3])[0];
+        if (bufsize < 9) {
+            break;
+        }
+        uint8_t update_flags = buffer[0];
+        uint16_t start_lamp_id = buffer[1] | (buffer[2] << 8);
+        uint16_t end_lamp_id = buffer[3] | (buffer[4] << 8);
         
-        // 获取颜色信息
-        uint8_t red = buffer[5];
-        uint8_t green = buffer[6];
-        uint8_t blue = buffer[7];
-        uint8_t intensity = buffer[8];
+        // 颜色信息（红、绿、蓝、亮度）
+        const uint8_t *rgbi = &buffer[5];
         
         // 确保ID在有效范围内
         if (start_lamp_id >= WS2812B_NUM) start_lamp_id = WS2812B_NUM - 1;
         if (end_lamp_id >= WS2812B_NUM) end_lamp_id = WS2812B_NUM - 1;
         
-        // 获取互斥锁，保护共享资源访问
-        if (g_windows_lighting_mutex && xSemaphoreTake(g_windows_lighting_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            // 更新范围内的所有灯
-            for (uint16_t i = start_lamp_id; i <= end_lamp_id; i++) {
-                lamp_colors[i][0] = red;
-                lamp_colors[i][1] = green;
-                lamp_colors[i][2] = blue;
-                lamp_colors[i][3] = intensity;
-            }
-            
-            // 释放互斥锁
-            xSemaphoreGive(g_windows_lighting_mutex);
-        } else {
-            ESP_LOGW(TAG, "Failed to acquire mutex for Windows Lighting range update");
+        // 更新范围内的所有灯
+        for (uint16_t i = start_lamp_id; i <= end_lamp_id; i++) {
+            lamp_array_stage(i, rgbi);
+        }
+        
+        // 主机标记本批更新完成时一次性发布
+        if (update_flags & LAMP_UPDATE_COMPLETE) {
+            lamp_array_commit();
         }
         break;
     }
@@ -438,6 +492,15 @@ void tud_hid_set_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t rep
         break;
     }
     
+    case REPORT_ID_MOUSE: {
+        // 主机设置滚轮分辨率倍数，启用后滚轮报告以1/HID_MOUSE_SCROLL_RESOLUTION刻度为单位
+        if (report_type == HID_REPORT_TYPE_FEATURE && bufsize >= 1) {
+            joystick_mouse_set_resolution(buffer[0]);
+            ESP_LOGD(TAG, "Mouse resolution multiplier 0x%02x", buffer[0]);
+        }
+        break;
+    }
+    
     default:
         // 其他报告类型不处理
         break;
@@ -450,6 +513,7 @@ void tud_hid_set_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t rep
 void tud_mount_cb(void)
 {
     ESP_LOGI(TAG, "USB Mount");
+    input_event_publish(INPUT_EVENT_USB, INPUT_USB_MOUNTED);
 }
 
 /**
@@ -458,6 +522,7 @@ void tud_mount_cb(void)
 void tud_umount_cb(void)
 {
     ESP_LOGI(TAG, "USB Un-Mount");
+    input_event_publish(INPUT_EVENT_USB, INPUT_USB_UNMOUNTED);
 }
 
 // 全局变量，用于保存USB挂起前的WS2812状态
@@ -474,6 +539,7 @@ void tud_suspend_cb(bool remote_wakeup_en)
 {
     s_remote_wakeup_enabled = remote_wakeup_en;
     ESP_LOGI(TAG, "USB Suspended - Remote wakeup allowed: %s", remote_wakeup_en ? "YES" : "NO");
+    input_event_publish(INPUT_EVENT_USB, INPUT_USB_SUSPENDED);
     
     // 保存当前WS2812状态并关闭灯光效果以节省电量
     s_saved_ws2812_state = kob_ws2812_is_enable();
@@ -486,7 +552,13 @@ void tud_suspend_cb(bool remote_wakeup_en)
 void tud_resume_cb(void)
 {
     ESP_LOGI(TAG, "USB Resume");
+    input_event_publish(INPUT_EVENT_USB, INPUT_USB_RESUMED);
     
     // 主机苏醒时恢复之前保存的WS2812状态
     kob_ws2812_enable(s_saved_ws2812_state);
+    
+    // 挂起期间HID任务不发送鼠标报告，摇杆仍未回中时需要重新唤醒
+    if (joystick_mouse_is_active()) {
+        tinyusb_hid_mouse_wakeup();
+    }
 }
@@ -14,8 +14,16 @@ extern "C" {
 #include "../../../hid_device/usb_descriptors.h"  // 包含报告ID枚举定义
 #include "../../../main/keyboard_led/keyboard_led.h"  // 包含WS2812B_NUM定义
 
-// 键盘类型的灯阵列标识
-#define LAMP_ARRAY_KIND_KEYBOARD 0x00010000
+// 键盘类型的灯阵列标识（LampArrayKind）
+#define LAMP_ARRAY_KIND_KEYBOARD 0x01
+
+// 灯的用途（LampPurposes）：按键背光
+#define LAMP_PURPOSE_CONTROL     0x01
+
+// rgb_matrix坐标到微米的换算：一个按键间距19.05mm对应18个坐标单位
+#define LAMP_KEY_PITCH_UM        19050
+#define LAMP_KEY_PITCH_POINTS    18
+#define LAMP_POINT_TO_UM(p)      ((int32_t)(p) * LAMP_KEY_PITCH_UM / LAMP_KEY_PITCH_POINTS + LAMP_KEY_PITCH_UM / 2)
 
 // LED数量宏定义，与keyboard_led.c保持一致
 #define MAX_LAMPS WS2812B_NUM
@@ -24,7 +32,6 @@ extern "C" {
 extern void windows_lighting_init(void);
 
 // Windows Lighting 全局变量声明
-extern uint8_t lamp_colors[MAX_LAMPS][4];  // RGBA颜色数据
 extern bool autonomous_mode;               // 自主模式标志
 
 
@@ -55,6 +62,11 @@ typedef struct {
 // 控制HID报告发送的函数
 extern void tinyusb_hid_enable_report(bool enable);
 
+/**
+ * @brief 唤醒HID任务开始发送摇杆鼠标报告，之后的报告由IN传输完成驱动
+ */
+void tinyusb_hid_mouse_wakeup(void);
+
 
 /**
  * @brief Initialize tinyusb HID device.
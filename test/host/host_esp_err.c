@@ -0,0 +1,14 @@
+/**
+ * @file host_esp_err.c
+ * @brief esp_err_to_name的主机实现
+ */
+
+#include <stdio.h>
+#include "esp_err.h"
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    static char buf[16];
+    snprintf(buf, sizeof(buf), "0x%x", code);
+    return buf;
+}
@@ -0,0 +1,16 @@
+/**
+ * @file host_esp_timer.c
+ * @brief esp_timer_get_time的主机实现，微秒单调时钟
+ *
+ * 单独成一个文件：需要假时钟的测试自己定义esp_timer_*，静态库中的这份就不会被链接进来
+ */
+
+#include <time.h>
+#include "esp_timer.h"
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
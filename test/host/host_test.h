@@ -0,0 +1,32 @@
+/**
+ * @file host_test.h
+ * @brief 主机单元测试的最小断言工具
+ *
+ * 固件源码在PC上用stubs/下的桩头文件编译，测试失败时打印位置并计数，
+ * main()以失败数作为退出码交给ctest判定。
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+static int host_test_failures;
+
+#define HOST_CHECK(cond, ...)                                              \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            if (host_test_failures++ < 20) {                               \
+                printf("%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond); \
+                printf(__VA_ARGS__);                                       \
+                printf("\n");                                              \
+            }                                                              \
+        }                                                                  \
+    } while (0)
+
+#define HOST_TEST_RESULT(name)                                             \
+    (printf("%s: %s (%d failures)\n", (name),                              \
+            host_test_failures ? "FAIL" : "OK", host_test_failures),       \
+     host_test_failures != 0)
+
+#endif /* HOST_TEST_H */
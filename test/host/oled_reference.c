@@ -0,0 +1,765 @@
+/**
+ * @file oled_reference.c
+ * @brief 重构前的逐像素绘图实现，仅供主机回归测试对照
+ *
+ * 函数体原样取自改为页块写入之前的OLED.c，只把函数名改为Ref_前缀、
+ * 显存改为Ref_DisplayBuf，不要在这里做任何“修正”。
+ */
+
+#include "oled_reference.h"
+
+uint8_t Ref_DisplayBuf[OLED_HEIGHT / 8][OLED_WIDTH];
+
+void Ref_DrawPoint(int16_t X, int16_t Y)
+{
+	/*参数检查，保证指定位置不会超出屏幕范围*/
+	if(X < 0 || Y < 0 || X > OLED_WIDTH-1 || Y > OLED_HEIGHT-1) {return;}
+	
+	/*将显存数组指定位置的一个Bit数据置1*/
+	Ref_DisplayBuf[Y / 8][X] |= 0x01 << (Y % 8);
+}
+
+  void Ref_ClearArea(int16_t X, int16_t Y, int16_t Width, int16_t Height)
+  {
+	  int16_t x_start, y_start, x_end, y_end;
+	  int16_t i, j;
+  
+	  if (Width <= 0 || Height <= 0) return;
+  
+	  // 计算X方向的起始和结束位置
+	  x_start = (X < 0) ? 0 : X;
+	  x_end = X + Width;
+	  if (x_end > OLED_WIDTH) x_end = OLED_WIDTH;
+	  if (x_start >= x_end) return;
+  
+	  // 计算Y方向的起始和结束位置
+	  y_start = (Y < 0) ? 0 : Y;
+	  y_end = Y + Height;
+	  if (y_end > OLED_HEIGHT) y_end = OLED_HEIGHT;
+	  if (y_start >= y_end) return;
+  
+	  // 调整Width和Height为实际需要清除的区域
+	  Width = x_end - x_start;
+	  Height = y_end - y_start;
+  
+	  for (j = y_start; j < y_end; j++) {
+		  for (i = x_start; i < x_end; i++) {
+			  Ref_DisplayBuf[j / 8][i] &= ~(0x01 << (j % 8));
+		  }
+	  }
+  }
+
+void Ref_ReverseArea(int16_t X, int16_t Y, int16_t Width, int16_t Height)
+{
+	int16_t i, j, x, y;
+	if(Width <= 0 || Height <= 0) {return; }
+	/*参数检查，保证指定区域不会超出屏幕范围*/
+	if (X > OLED_WIDTH-1) {return;}
+	if (Y > OLED_HEIGHT-1) {return;}
+	if (X + Width > OLED_WIDTH) {Width = OLED_WIDTH - X;}
+	if (Y + Height > OLED_HEIGHT) {Height = OLED_HEIGHT - Y;}
+	if (X + Width < 0) {return;}
+	if (Y + Height < 0) {return;}
+	if (X < 0) { x = 0;} else { x = X;}
+	if (Y < 0) { y = 0;} else { y = Y;}
+	
+	for (j = y; j < Y + Height; j ++)		//遍历指定页
+	{
+		for (i = x; i < X + Width; i ++)	//遍历指定列
+		{
+			Ref_DisplayBuf[j / 8][i] ^= 0x01 << (j % 8);	//将显存数组指定数据取反
+		}
+	}
+}
+
+void Ref_ShowImage(int16_t X, int16_t Y, uint16_t Width, uint16_t Height, const uint8_t *Image)
+{
+      uint8_t i, j;
+    
+    /* 参数检查，保证指定图像不会超出屏幕范围 */
+    if (Width == 0 || Height == 0) {
+        return; // 如果宽度或高度为0，直接返回
+    }
+    
+    if (X > OLED_WIDTH-1) {
+        return; // X 超出右边界，直接返回
+    }
+    if (Y > OLED_HEIGHT-1) {
+        return; // Y 超出下边界，直接返回
+    }
+    
+    /* 将图像所在区域清空 */
+    uint8_t startX = (X < 0) ? 0 : X; // 计算实际起始显示位置的 X 坐标
+    uint8_t startY = (Y < 0) ? 0 : Y; // 计算实际起始显示位置的 Y 坐标
+    uint8_t endX = (X + Width - 1 > OLED_WIDTH-1) ? OLED_WIDTH-1 : X + Width - 1; // 计算实际结束显示位置的 X 坐标
+    uint8_t endY = (Y + Height - 1 > OLED_HEIGHT-1) ? OLED_HEIGHT-1 : Y + Height - 1; // 计算实际结束显示位置的 Y 坐标
+    
+    Ref_ClearArea(startX, startY, endX - startX + 1, endY - startY + 1);
+    
+    /* 遍历指定图像涉及的相关页 */
+    for (j = 0; j < (Height - 1) / 8 + 1; j++)
+    {
+        /* 遍历指定图像涉及的相关列 */
+        for (i = 0; i < Width; i++)
+        {
+            int16_t currX = X + i;
+            int16_t currY = Y + j * 8;
+            
+            /* 超出边界，则跳过显示 */
+            if (currX < 0 || currX > OLED_WIDTH-1 ||currY < 0 || currY > OLED_HEIGHT-1) {
+                continue;
+            }
+			/* 显示图像在当前页的内容 */
+			Ref_DisplayBuf[currY / 8][currX] |= Image[j * Width + i] << (currY % 8);
+			/* 当前页下一页 */
+			if (currY + 8 <= OLED_HEIGHT-1) {
+				Ref_DisplayBuf[currY / 8 + 1][currX] |= Image[j * Width + i] >> (8 - currY % 8);
+			}
+        }
+    }
+	if(Y<0){
+		for (i = 0; i < Width; i++)
+        {
+            int16_t currX = X + i;
+			if (currX < 0 || currX > OLED_WIDTH-1) {
+                continue;
+            }
+			Ref_DisplayBuf[0][currX] |= Image[ -Y/8*Width+i] >> -Y%8;
+		}
+	}
+}
+
+ void Ref_ShowImageArea(int16_t X_Pic, int16_t Y_Pic, int16_t PictureWidth, int16_t PictureHeight, int16_t X_Area, int16_t Y_Area, int16_t AreaWidth, int16_t AreaHeight, const uint8_t *Image)
+ {
+	 if (PictureWidth == 0 || PictureHeight == 0 || AreaWidth == 0 || AreaHeight == 0 || X_Pic > OLED_WIDTH-1 || X_Area > OLED_WIDTH-1 || Y_Pic > OLED_HEIGHT-1 || Y_Area > OLED_HEIGHT-1) {return; }
+		 int16_t startX = (X_Pic < X_Area) ? X_Area : X_Pic;
+	 int16_t endX = ((X_Area + AreaWidth - 1) < (X_Pic + PictureWidth - 1)) ? (X_Area + AreaWidth - 1) : (X_Pic + PictureWidth - 1);
+	 int16_t startY = (Y_Pic < Y_Area) ? Y_Area : Y_Pic;
+	 int16_t endY = ((Y_Area + AreaHeight - 1) < (Y_Pic + PictureHeight - 1)) ? (Y_Area + AreaHeight - 1) : (Y_Pic + PictureHeight - 1);
+	 endX = (endX > OLED_WIDTH-1) ? OLED_WIDTH-1 : endX;
+	 endY = (endY > OLED_HEIGHT-1) ? OLED_HEIGHT-1 : endY;
+		 if(startX > endX || startY > endY){return;}
+		 //Ref_ClearArea(startX, startY, endX - startX + 1, endY - startY + 1);
+		 for (uint8_t j = 0; j <= (PictureHeight - 1) / 8; j++) {
+		 for (uint8_t i = 0; i < PictureWidth; i++) {
+			 uint8_t currX = X_Pic + i;
+			 if (currX < startX || currX > endX) {continue;};
+			 for (uint8_t bit = 0; bit < 8; bit++) {
+				 uint8_t currY = Y_Pic + j * 8 + bit;
+				 if (currY < startY || currY > endY) {continue;};
+				 uint8_t page = currY / 8;
+				 uint8_t bit_pos = currY % 8;
+				 uint8_t data = Image[j * PictureWidth + i];
+				 if (data & (1 << bit)) {Ref_DisplayBuf[page][currX] |= (1 << bit_pos); }
+			 }
+		 }
+	 }
+ }
+
+void Ref_DrawRectangle(int16_t X, int16_t Y, int16_t Width, int16_t Height, uint8_t IsFilled)
+{
+    if (Width == 0 || Height == 0) { return; } // 宽度或高度为0，不绘制
+
+    int16_t X_start = X;
+    int16_t X_end = X + Width - 1;
+    int16_t Y_start = Y;
+    int16_t Y_end = Y + Height - 1;
+
+    // 限制坐标在屏幕范围内
+    if (X_start < 0) X_start = 0;
+    if (X_end >= OLED_WIDTH) X_end = OLED_WIDTH - 1;
+    if (Y_start < 0) Y_start = 0;
+    if (Y_end >= OLED_HEIGHT) Y_end = OLED_HEIGHT - 1;
+
+    // 计算有效宽度和高度
+    int16_t validWidth = X_end - X_start + 1;
+    int16_t validHeight = Y_end - Y_start + 1;
+    if (validWidth <= 0 || validHeight <= 0) { return; }
+
+    if (!IsFilled) {
+        // 绘制矩形边框
+        for (int16_t i = X_start; i <= X_end; i++) {
+            Ref_DrawPoint(i, Y_start);
+            Ref_DrawPoint(i, Y_end);
+        }
+        for (int16_t i = Y_start; i <= Y_end; i++) {
+            Ref_DrawPoint(X_start, i);
+            Ref_DrawPoint(X_end, i);
+        }
+    } else {
+        // 计算起始和结束页
+        int16_t start_page = Y_start / 8;
+        int16_t end_page = Y_end / 8;
+
+        // 计算每页的掩码
+        uint8_t start_mask = 0xFF << (Y_start % 8);
+        uint8_t end_mask = 0xFF >> (7 - (Y_end % 8));
+
+        // 遍历每一列，应用掩码
+        for (int16_t x = X_start; x <= X_end; x++) {
+            for (int16_t page = start_page; page <= end_page; page++) {
+                uint8_t mask = 0xFF;
+                if (page == start_page) mask &= start_mask;
+                if (page == end_page) mask &= end_mask;
+                if (page >= 0 && page < OLED_HEIGHT / 8) { // 确保页数有效
+                    Ref_DisplayBuf[page][x] |= mask;
+                }
+            }
+        }
+    }
+}
+
+static uint8_t Ref_pnpoly(uint8_t nvert, int16_t *vertx, int16_t *verty, int16_t testx, int16_t testy)
+{
+	int16_t i = 0, j = 0;
+	uint8_t c = 0;
+	/*此算法由W. Randolph Franklin提出*/
+	/*参考链接：https://wrfranklin.org/Research/Short_Notes/pnpoly.html*/
+	for (i = 0, j = nvert - 1; i < nvert; j = i++)
+	{
+		if (((verty[i] > testy) != (verty[j] > testy)) &&
+			(testx < (vertx[j] - vertx[i]) * (testy - verty[i]) / (verty[j] - verty[i]) + vertx[i]))
+		{
+			c = !c;
+		}
+	}
+	return c;
+}
+
+uint8_t Ref_IsInAngle(int16_t X, int16_t Y, int16_t StartAngle, int16_t EndAngle)
+{
+	int16_t PointAngle;
+	PointAngle = atan2(Y, X) / 3.14 * 180;	//计算指定点的弧度，并转换为角度表示
+	if (StartAngle < EndAngle)	//起始角度小于终止角度的情况
+	{
+		/*如果指定角度在起始终止角度之间，则判定指定点在指定角度*/
+		if (PointAngle >= StartAngle && PointAngle <= EndAngle)
+		{
+			return 1;
+		}
+	}
+	else			//起始角度大于于终止角度的情况
+	{
+		/*如果指定角度大于起始角度或者小于终止角度，则判定指定点在指定角度*/
+		if (PointAngle >= StartAngle || PointAngle <= EndAngle)
+		{
+			return 1;
+		}
+	}
+	return 0;		//不满足以上条件，则判断判定指定点不在指定角度
+}
+
+void Ref_DrawLine(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1)
+{
+	int16_t x, y, dx, dy, d, incrE, incrNE, temp;
+	int16_t x0 = X0, y0 = Y0, x1 = X1, y1 = Y1;
+	uint8_t yflag = 0, xyflag = 0;
+	
+	if (y0 == y1)		//横线单独处理
+	{
+		/*0号点X坐标大于1号点X坐标，则交换两点X坐标*/
+		if (x0 > x1) {temp = x0; x0 = x1; x1 = temp;}
+		
+		/*遍历X坐标*/
+		for (x = x0; x <= x1; x ++)
+		{
+			Ref_DrawPoint(x, y0);	//依次画点
+		}
+	}
+	else if (x0 == x1)	//竖线单独处理
+	{
+		/*0号点Y坐标大于1号点Y坐标，则交换两点Y坐标*/
+		if (y0 > y1) {temp = y0; y0 = y1; y1 = temp;}
+		
+		/*遍历Y坐标*/
+		for (y = y0; y <= y1; y ++)
+		{
+			Ref_DrawPoint(x0, y);	//依次画点
+		}
+	}
+	else				//斜线
+	{
+		/*使用Bresenham算法画直线，可以避免耗时的浮点运算，效率更高*/
+		/*参考文档：https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf*/
+		/*参考教程：https://www.bilibili.com/video/BV1364y1d7Lo*/
+		
+		if (x0 > x1)	//0号点X坐标大于1号点X坐标
+		{
+			/*交换两点坐标*/
+			/*交换后不影响画线，但是画线方向由第一、二、三、四象限变为第一、四象限*/
+			temp = x0; x0 = x1; x1 = temp;
+			temp = y0; y0 = y1; y1 = temp;
+		}
+		
+		if (y0 > y1)	//0号点Y坐标大于1号点Y坐标
+		{
+			/*将Y坐标取负*/
+			/*取负后影响画线，但是画线方向由第一、四象限变为第一象限*/
+			y0 = -y0;
+			y1 = -y1;
+			
+			/*置标志位yflag，记住当前变换，在后续实际画线时，再将坐标换回来*/
+			yflag = 1;
+		}
+		
+		if (y1 - y0 > x1 - x0)	//画线斜率大于1
+		{
+			/*将X坐标与Y坐标互换*/
+			/*互换后影响画线，但是画线方向由第一象限0~90度范围变为第一象限0~45度范围*/
+			temp = x0; x0 = y0; y0 = temp;
+			temp = x1; x1 = y1; y1 = temp;
+			
+			/*置标志位xyflag，记住当前变换，在后续实际画线时，再将坐标换回来*/
+			xyflag = 1;
+		}
+		
+		/*以下为Bresenham算法画直线*/
+		/*算法要求，画线方向必须为第一象限0~45度范围*/
+		dx = x1 - x0;
+		dy = y1 - y0;
+		incrE = 2 * dy;
+		incrNE = 2 * (dy - dx);
+		d = 2 * dy - dx;
+		x = x0;
+		y = y0;
+		
+		/*画起始点，同时判断标志位，将坐标换回来*/
+		if (yflag && xyflag){Ref_DrawPoint(y, -x);}
+		else if (yflag)		{Ref_DrawPoint(x, -y);}
+		else if (xyflag)	{Ref_DrawPoint(y, x);}
+		else				{Ref_DrawPoint(x, y);}
+		
+		while (x < x1)		//遍历X轴的每个点
+		{
+			x ++;
+			if (d < 0)		//下一个点在当前点东方
+			{
+				d += incrE;
+			}
+			else			//下一个点在当前点东北方
+			{
+				y ++;
+				d += incrNE;
+			}
+			
+			/*画每一个点，同时判断标志位，将坐标换回来*/
+			if (yflag && xyflag){Ref_DrawPoint(y, -x);}
+			else if (yflag)		{Ref_DrawPoint(x, -y);}
+			else if (xyflag)	{Ref_DrawPoint(y, x);}
+			else				{Ref_DrawPoint(x, y);}
+		}	
+	}
+}
+
+void Ref_DrawTriangle(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1, int16_t X2, int16_t Y2, uint8_t IsFilled)
+{
+	int16_t minx = X0, miny = Y0, maxx = X0, maxy = Y0;
+	int16_t i, j;
+	int16_t vx[] = {X0, X1, X2};
+	int16_t vy[] = {Y0, Y1, Y2};
+	
+	if (!IsFilled)			//指定三角形不填充
+	{
+		/*调用画线函数，将三个点用直线连接*/
+		Ref_DrawLine(X0, Y0, X1, Y1);
+		Ref_DrawLine(X0, Y0, X2, Y2);
+		Ref_DrawLine(X1, Y1, X2, Y2);
+	}
+	else					//指定三角形填充
+	{
+		/*找到三个点最小的X、Y坐标*/
+		if (X1 < minx) {minx = X1;}
+		if (X2 < minx) {minx = X2;}
+		if (Y1 < miny) {miny = Y1;}
+		if (Y2 < miny) {miny = Y2;}
+		
+		/*找到三个点最大的X、Y坐标*/
+		if (X1 > maxx) {maxx = X1;}
+		if (X2 > maxx) {maxx = X2;}
+		if (Y1 > maxy) {maxy = Y1;}
+		if (Y2 > maxy) {maxy = Y2;}
+		
+		/*最小最大坐标之间的矩形为可能需要填充的区域*/
+		/*遍历此区域中所有的点*/
+		/*遍历X坐标*/
+		for (i = minx; i <= maxx; i ++)
+		{
+			/*遍历Y坐标*/
+			for (j = miny; j <= maxy; j ++)
+			{
+				/*调用OLED_pnpoly，判断指定点是否在指定三角形之中*/
+				/*如果在，则画点，如果不在，则不做处理*/
+				if (Ref_pnpoly(3, vx, vy, i, j)) {Ref_DrawPoint(i, j);}
+			}
+		}
+	}
+}
+
+void Ref_DrawCircle(int16_t X, int16_t Y, int16_t Radius, uint8_t IsFilled)
+{
+	int16_t x, y, d, j;
+	
+	/*使用Bresenham算法画圆，可以避免耗时的浮点运算，效率更高*/
+	/*参考文档：https://www.cs.montana.edu/courses/spring2009/425/dslectures/Bresenham.pdf*/
+	/*参考教程：https://www.bilibili.com/video/BV1VM4y1u7wJ*/
+	
+	d = 1 - Radius;
+	x = 0;
+	y = Radius;
+	
+	/*画每个八分之一圆弧的起始点*/
+	Ref_DrawPoint(X + x, Y + y);
+	Ref_DrawPoint(X - x, Y - y);
+	Ref_DrawPoint(X + y, Y + x);
+	Ref_DrawPoint(X - y, Y - x);
+	
+	if (IsFilled)		//指定圆填充
+	{
+		/*遍历起始点Y坐标*/
+		for (j = -y; j < y; j ++)
+		{
+			/*在指定区域画点，填充部分圆*/
+			Ref_DrawPoint(X, Y + j);
+		}
+	}
+	
+	while (x < y)		//遍历X轴的每个点
+	{
+		x ++;
+		if (d < 0)		//下一个点在当前点东方
+		{
+			d += 2 * x + 1;
+		}
+		else			//下一个点在当前点东南方
+		{
+			y --;
+			d += 2 * (x - y) + 1;
+		}
+		
+		/*画每个八分之一圆弧的点*/
+		Ref_DrawPoint(X + x, Y + y);
+		Ref_DrawPoint(X + y, Y + x);
+		Ref_DrawPoint(X - x, Y - y);
+		Ref_DrawPoint(X - y, Y - x);
+		Ref_DrawPoint(X + x, Y - y);
+		Ref_DrawPoint(X + y, Y - x);
+		Ref_DrawPoint(X - x, Y + y);
+		Ref_DrawPoint(X - y, Y + x);
+		
+		if (IsFilled)	//指定圆填充
+		{
+			/*遍历中间部分*/
+			for (j = -y; j < y; j ++)
+			{
+				/*在指定区域画点，填充部分圆*/
+				Ref_DrawPoint(X + x, Y + j);
+				Ref_DrawPoint(X - x, Y + j);
+			}
+			
+			/*遍历两侧部分*/
+			for (j = -x; j < x; j ++)
+			{
+				/*在指定区域画点，填充部分圆*/
+				Ref_DrawPoint(X - y, Y + j);
+				Ref_DrawPoint(X + y, Y + j);
+			}
+		}
+	}
+}
+
+void Ref_DrawEllipse(int16_t X, int16_t Y, int16_t A, int16_t B, uint8_t IsFilled)
+{
+	int16_t x, y, j;
+	int16_t a = A, b = B;
+	float d1, d2;
+	
+	/*使用Bresenham算法画椭圆，可以避免部分耗时的浮点运算，效率更高*/
+	/*参考链接：https://blog.csdn.net/myf_666/article/details/128167392*/
+	
+	x = 0;
+	y = b;
+	d1 = b * b + a * a * (-b + 0.5);
+	
+	if (IsFilled)	//指定椭圆填充
+	{
+		/*遍历起始点Y坐标*/
+		for (j = -y; j < y; j ++)
+		{
+			/*在指定区域画点，填充部分椭圆*/
+			Ref_DrawPoint(X, Y + j);
+			Ref_DrawPoint(X, Y + j);
+		}
+	}
+	
+	/*画椭圆弧的起始点*/
+	Ref_DrawPoint(X + x, Y + y);
+	Ref_DrawPoint(X - x, Y - y);
+	Ref_DrawPoint(X - x, Y + y);
+	Ref_DrawPoint(X + x, Y - y);
+	
+	/*画椭圆中间部分*/
+	while (b * b * (x + 1) < a * a * (y - 0.5))
+	{
+		if (d1 <= 0)		//下一个点在当前点东方
+		{
+			d1 += b * b * (2 * x + 3);
+		}
+		else				//下一个点在当前点东南方
+		{
+			d1 += b * b * (2 * x + 3) + a * a * (-2 * y + 2);
+			y --;
+		}
+		x ++;
+		
+		if (IsFilled)	//指定椭圆填充
+		{
+			/*遍历中间部分*/
+			for (j = -y; j < y; j ++)
+			{
+				/*在指定区域画点，填充部分椭圆*/
+				Ref_DrawPoint(X + x, Y + j);
+				Ref_DrawPoint(X - x, Y + j);
+			}
+		}
+		
+		/*画椭圆中间部分圆弧*/
+		Ref_DrawPoint(X + x, Y + y);
+		Ref_DrawPoint(X - x, Y - y);
+		Ref_DrawPoint(X - x, Y + y);
+		Ref_DrawPoint(X + x, Y - y);
+	}
+	
+	/*画椭圆两侧部分*/
+	d2 = b * b * (x + 0.5) * (x + 0.5) + a * a * (y - 1) * (y - 1) - a * a * b * b;
+	
+	while (y > 0)
+	{
+		if (d2 <= 0)		//下一个点在当前点东方
+		{
+			d2 += b * b * (2 * x + 2) + a * a * (-2 * y + 3);
+			x ++;
+			
+		}
+		else				//下一个点在当前点东南方
+		{
+			d2 += a * a * (-2 * y + 3);
+		}
+		y --;
+		
+		if (IsFilled)	//指定椭圆填充
+		{
+			/*遍历两侧部分*/
+			for (j = -y; j < y; j ++)
+			{
+				/*在指定区域画点，填充部分椭圆*/
+				Ref_DrawPoint(X + x, Y + j);
+				Ref_DrawPoint(X - x, Y + j);
+			}
+		}
+		
+		/*画椭圆两侧部分圆弧*/
+		Ref_DrawPoint(X + x, Y + y);
+		Ref_DrawPoint(X - x, Y - y);
+		Ref_DrawPoint(X - x, Y + y);
+		Ref_DrawPoint(X + x, Y - y);
+	}
+}
+
+void Ref_DrawArc(int16_t X, int16_t Y, int16_t Radius, int16_t StartAngle, int16_t EndAngle, uint8_t IsFilled)
+{
+	int16_t x, y, d, j;
+	if(Radius <=0){return;} //半径为0，直接返回
+	/*此函数借用Bresenham算法画圆的方法*/
+	
+	d = 1 - Radius;
+	x = 0;
+	y = Radius;
+	
+	/*在画圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
+	if (Ref_IsInAngle(x, y, StartAngle, EndAngle))	{Ref_DrawPoint(X + x, Y + y);}
+	if (Ref_IsInAngle(-x, -y, StartAngle, EndAngle)) {Ref_DrawPoint(X - x, Y - y);}
+	if (Ref_IsInAngle(y, x, StartAngle, EndAngle)) {Ref_DrawPoint(X + y, Y + x);}
+	if (Ref_IsInAngle(-y, -x, StartAngle, EndAngle)) {Ref_DrawPoint(X - y, Y - x);}
+	
+	if (IsFilled)	//指定圆弧填充
+	{
+		/*遍历起始点Y坐标*/
+		for (j = -y; j < y; j ++)
+		{
+			/*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
+			if (Ref_IsInAngle(0, j, StartAngle, EndAngle)) {Ref_DrawPoint(X, Y + j);}
+		}
+	}
+	
+	while (x < y)		//遍历X轴的每个点
+	{
+		x ++;
+		if (d < 0)		//下一个点在当前点东方
+		{
+			d += 2 * x + 1;
+		}
+		else			//下一个点在当前点东南方
+		{
+			y --;
+			d += 2 * (x - y) + 1;
+		}
+		
+		/*在画圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
+		if (Ref_IsInAngle(x, y, StartAngle, EndAngle)) {Ref_DrawPoint(X + x, Y + y);}
+		if (Ref_IsInAngle(y, x, StartAngle, EndAngle)) {Ref_DrawPoint(X + y, Y + x);}
+		if (Ref_IsInAngle(-x, -y, StartAngle, EndAngle)) {Ref_DrawPoint(X - x, Y - y);}
+		if (Ref_IsInAngle(-y, -x, StartAngle, EndAngle)) {Ref_DrawPoint(X - y, Y - x);}
+		if (Ref_IsInAngle(x, -y, StartAngle, EndAngle)) {Ref_DrawPoint(X + x, Y - y);}
+		if (Ref_IsInAngle(y, -x, StartAngle, EndAngle)) {Ref_DrawPoint(X + y, Y - x);}
+		if (Ref_IsInAngle(-x, y, StartAngle, EndAngle)) {Ref_DrawPoint(X - x, Y + y);}
+		if (Ref_IsInAngle(-y, x, StartAngle, EndAngle)) {Ref_DrawPoint(X - y, Y + x);}
+		
+		if (IsFilled)	//指定圆弧填充
+		{
+			/*遍历中间部分*/
+			for (j = -y; j < y; j ++)
+			{
+				/*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
+				if (Ref_IsInAngle(x, j, StartAngle, EndAngle)) {Ref_DrawPoint(X + x, Y + j);}
+				if (Ref_IsInAngle(-x, j, StartAngle, EndAngle)) {Ref_DrawPoint(X - x, Y + j);}
+			}
+			
+			/*遍历两侧部分*/
+			for (j = -x; j < x; j ++)
+			{
+				/*在填充圆的每个点时，判断指定点是否在指定角度内，在，则画点，不在，则不做处理*/
+				if (Ref_IsInAngle(-y, j, StartAngle, EndAngle)) {Ref_DrawPoint(X - y, Y + j);}
+				if (Ref_IsInAngle(y, j, StartAngle, EndAngle)) {Ref_DrawPoint(X + y, Y + j);}
+			}
+		}
+	}
+}
+
+void Ref_DrawRoundedRectangle(int16_t X, int16_t Y, int16_t Width, int16_t Height, int16_t Radius, uint8_t IsFilled)
+{
+    // 安全检查
+    if (Width == 0 || Height == 0) return;  // 宽度或高度为0,直接返回
+    if (Radius > Width / 2 || Radius > Height / 2) {
+        Radius = (Width < Height ? Width : Height) / 2;  // 限制圆角半径不超过宽高的一半
+    }
+
+    if (Radius <= 0) {
+        Ref_DrawRectangle(X, Y, Width, Height, IsFilled);  // 如果半径为0,退化为普通矩形
+        return;
+    }
+    else if(Radius == 2) {	// 如果半径为2，圆角可以简化为两个点，优化性能
+    	Ref_DrawPoint(X + 1, Y);
+    	Ref_DrawPoint(X + Width - 2, Y);
+
+    	Ref_DrawPoint(X + 1, Y + Height - 1);
+    	Ref_DrawPoint(X + Width - 2, Y + Height - 1);
+
+    	Ref_DrawPoint(X, Y + 1);
+    	Ref_DrawPoint(X, Y + Height - 2);
+
+    	Ref_DrawPoint(X + Width - 1, Y + 1);
+    	Ref_DrawPoint(X + Width - 1, Y + Height - 2);
+    }
+    else {
+		// 绘制四个圆角
+		Ref_DrawArc(X + Radius, Y + Radius, Radius,180,  -90, IsFilled);
+		Ref_DrawArc(X + Width - Radius - 1, Y + Radius, Radius,-90,  0, IsFilled);
+		Ref_DrawArc(X + Radius, Y + Height - Radius - 1, Radius,90,  180, IsFilled);
+		Ref_DrawArc(X + Width - Radius - 1, Y + Height - Radius - 1, Radius,0,  90, IsFilled);
+    }
+
+    // 填充或绘制矩形主体
+    if (IsFilled) {
+        Ref_DrawRectangle(X + Radius, Y, Width - 2 * Radius, Height, OLED_FILLED);
+        Ref_DrawRectangle(X, Y + Radius, Width, Height - 2 * Radius, OLED_FILLED);
+    } else {
+        // 绘制顶部和底部的直线
+        Ref_DrawLine(X + Radius, Y, X + Width - Radius - 1, Y);
+        Ref_DrawLine(X + Radius, Y + Height - 1, X + Width - Radius - 1, Y + Height - 1);
+        // 绘制左侧和右侧的直线
+        Ref_DrawLine(X, Y + Radius, X, Y + Height - Radius - 1);
+        Ref_DrawLine(X + Width - 1, Y + Radius, X + Width - 1, Y + Height - Radius - 1);
+    }
+}
+
+// ==== 欧拉角状态（全局） ====
+static float yaw = 0.0f, pitch = 0.0f, roll = 0.0f;
+static float yaw_v = 0.05f, pitch_v = 0.05f, roll_v = 0.05f;
+
+// ==== DEG 转 RAD ====
+#define DEG2RAD(x) ((x) * 0.0174533f)
+
+// ==== 立方体边的连接关系 ====
+static const int edges[12][2] = {
+    {0,1},{1,2},{2,3},{3,0},
+    {4,5},{5,6},{6,7},{7,4},
+    {0,4},{1,5},{2,6},{3,7}
+};
+
+// ==== 主绘制函数 ====
+void Ref_DrawCube3D(int16_t centerX, int16_t centerY, float size, uint8_t perspective) {
+    // 三角函数计算
+    float sinY = sinf(yaw), cosY = cosf(yaw);
+    float sinP = sinf(pitch), cosP = cosf(pitch);
+    float sinR = sinf(roll), cosR = cosf(roll);
+
+    const float cube[8][3] = {
+        {-1,-1,-1},{1,-1,-1},{1,1,-1},{-1,1,-1},
+        {-1,-1,1},{1,-1,1},{1,1,1},{-1,1,1}
+    };
+
+//    float rotated[8][3];
+    int projected[8][2];
+
+    for (int i = 0; i < 8; i++) {
+        float x = cube[i][0] * size / 2;
+        float y = cube[i][1] * size / 2;
+        float z = cube[i][2] * size / 2;
+
+        // Roll (X-axis)
+        float y1 = cosR * y - sinR * z;
+        float z1 = sinR * y + cosR * z;
+        y = y1; z = z1;
+        // Pitch (Y-axis)
+        float x1 = cosP * x + sinP * z;
+        z1 = -sinP * x + cosP * z;
+        x = x1; z = z1;
+        // Yaw (Z-axis)
+        x1 = cosY * x - sinY * y;
+        y1 = sinY * x + cosY * y;
+        x = x1; y = y1;
+
+//        rotated[i][0] = x;
+//        rotated[i][1] = y;
+//        rotated[i][2] = z;
+
+        // 投影
+        if (perspective) {
+            float distance = 50.0f;
+            float factor = distance / (distance + z);
+            projected[i][0] = (int)(x * factor) + centerX;
+            projected[i][1] = (int)(y * factor) + centerY;
+        } else {
+            projected[i][0] = (int)x + centerX;
+            projected[i][1] = (int)y + centerY;
+        }
+    }
+
+    // 清屏并画线
+    //OLED_Clear();
+    for (int i = 0; i < 12; i++) {
+        int a = edges[i][0], b = edges[i][1];
+        Ref_DrawLine(projected[a][0], projected[a][1], projected[b][0], projected[b][1]);
+    }
+    //OLED_Update();
+
+    // 更新欧拉角（旋转速度）
+    yaw   += DEG2RAD(yaw_v);
+    pitch += DEG2RAD(pitch_v);
+    roll  += DEG2RAD(roll_v);
+
+    // 保证角度在 [0, 2PI) 内循环
+    if (yaw > 6.283f) yaw -= 6.283f;
+    if (pitch > 6.283f) pitch -= 6.283f;
+    if (roll > 6.283f) roll -= 6.283f;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file oled_reference.h
+ * @brief 重构前逐像素绘图函数（Ref_前缀），用于与现行实现逐字节比对
+ */
+
+#ifndef OLED_REFERENCE_H
+#define OLED_REFERENCE_H
+
+#include <stdint.h>
+#include "OLED.h"
+
+extern uint8_t Ref_DisplayBuf[OLED_HEIGHT / 8][OLED_WIDTH];
+
+void Ref_DrawPoint(int16_t X, int16_t Y);
+void Ref_ClearArea(int16_t X, int16_t Y, int16_t Width, int16_t Height);
+void Ref_ReverseArea(int16_t X, int16_t Y, int16_t Width, int16_t Height);
+void Ref_ShowImage(int16_t X, int16_t Y, uint16_t Width, uint16_t Height, const uint8_t *Image);
+void Ref_ShowImageArea(int16_t X_Pic, int16_t Y_Pic, int16_t PictureWidth, int16_t PictureHeight,
+                       int16_t X_Area, int16_t Y_Area, int16_t AreaWidth, int16_t AreaHeight, const uint8_t *Image);
+void Ref_DrawRectangle(int16_t X, int16_t Y, int16_t Width, int16_t Height, uint8_t IsFilled);
+uint8_t Ref_IsInAngle(int16_t X, int16_t Y, int16_t StartAngle, int16_t EndAngle);
+void Ref_DrawLine(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1);
+void Ref_DrawTriangle(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1, int16_t X2, int16_t Y2, uint8_t IsFilled);
+void Ref_DrawCircle(int16_t X, int16_t Y, int16_t Radius, uint8_t IsFilled);
+void Ref_DrawEllipse(int16_t X, int16_t Y, int16_t A, int16_t B, uint8_t IsFilled);
+void Ref_DrawArc(int16_t X, int16_t Y, int16_t Radius, int16_t StartAngle, int16_t EndAngle, uint8_t IsFilled);
+void Ref_DrawRoundedRectangle(int16_t X, int16_t Y, int16_t Width, int16_t Height, int16_t Radius, uint8_t IsFilled);
+void Ref_DrawCube3D(int16_t centerX, int16_t centerY, float size, uint8_t perspective);
+
+#endif /* OLED_REFERENCE_H */
@@ -0,0 +1,5 @@
+/* 主机测试桩：OLED_driver.h只需要句柄类型 */
+#pragma once
+#include <stdint.h>
+typedef void *i2c_master_dev_handle_t;
+typedef void *i2c_master_bus_handle_t;
@@ -0,0 +1,2 @@
+/* 主机测试桩：只为让joystick.h能被包含，测试不访问ADC */
+#pragma once
@@ -0,0 +1,6 @@
+/* 主机测试桩：链接段属性在主机上没有意义 */
+#pragma once
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define DMA_ATTR
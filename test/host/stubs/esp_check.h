@@ -0,0 +1,3 @@
+/* 主机测试桩：只为让keyboard_led.h能被包含 */
+#pragma once
+#include "esp_err.h"
@@ -0,0 +1,20 @@
+/* 主机测试桩：没有PSRAM，申请SPIRAM内存总是失败，以覆盖回退到内部RAM的路径 */
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_DMA          (1 << 3)
+static inline void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? NULL : malloc(size);
+}
+static inline void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? NULL : calloc(n, size);
+}
+static inline void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
@@ -0,0 +1,17 @@
+/* 主机测试桩：日志输出到stdout，只保留错误和警告，避免淹没测试结果 */
+#pragma once
+#include <stdio.h>
+#define ESP_LOGE(tag, fmt, ...)     printf("E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...)     printf("W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...)     do { } while (0)
+#define ESP_LOGD(tag, fmt, ...)     do { } while (0)
+#define ESP_LOGV(tag, fmt, ...)     do { } while (0)
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
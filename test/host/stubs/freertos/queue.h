@@ -0,0 +1,4 @@
+/* 主机测试桩：只提供句柄类型 */
+#pragma once
+#include "FreeRTOS.h"
+typedef struct host_queue *QueueHandle_t;
@@ -0,0 +1,5 @@
+/* 主机测试桩：只提供灯带句柄类型，测试不访问灯带 */
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+typedef struct led_strip_t *led_strip_handle_t;
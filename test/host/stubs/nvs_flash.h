@@ -0,0 +1,4 @@
+/* 主机测试桩：只为让unified_nvs_manager.h能被包含，测试不访问NVS */
+#pragma once
+#include <stdint.h>
+typedef uint32_t nvs_handle_t;
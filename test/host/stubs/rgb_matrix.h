@@ -0,0 +1,31 @@
+/* 主机测试桩：keyboard_rgb_matrix组件中测试用到的类型和模式编号，布局尺寸来自测试的编译参数 */
+#pragma once
+#include <stdint.h>
+
+#define NO_LED 255
+
+typedef struct {
+    uint8_t x;
+    uint8_t y;
+} led_point_t;
+
+typedef struct {
+    uint8_t matrix_co[CONFIG_MATRIX_ROWS][CONFIG_MATRIX_COLS];
+    led_point_t point[CONFIG_MATRIX_LED_COUNT];
+    uint8_t flags[CONFIG_MATRIX_LED_COUNT];
+} led_config_t;
+
+enum rgb_matrix_effects {
+    RGB_MATRIX_NONE = 0,
+    RGB_MATRIX_SOLID_COLOR,
+    RGB_MATRIX_RAINBOW_BEACON,
+    RGB_MATRIX_RAINBOW_PINWHEELS,
+    RGB_MATRIX_RAINBOW_MOVING_CHEVRON,
+    RGB_MATRIX_CYCLE_LEFT_RIGHT,
+    RGB_MATRIX_CYCLE_UP_DOWN,
+    RGB_MATRIX_CYCLE_OUT_IN,
+    RGB_MATRIX_CYCLE_OUT_IN_DUAL,
+    RGB_MATRIX_CYCLE_PINWHEEL,
+    RGB_MATRIX_CYCLE_SPIRAL,
+    RGB_MATRIX_EFFECT_MAX
+};
@@ -0,0 +1,2 @@
+/* 主机测试桩：测试不依赖menuconfig选项，需要的配置由各测试在编译参数中定义 */
+#pragma once
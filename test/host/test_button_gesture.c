@@ -0,0 +1,378 @@
+/**
+ * @file test_button_gesture.c
+ * @brief 按键手势状态机与驱动的时间线测试
+ *
+ * 1. 状态机：直接按时间线输入边沿和到期时刻，检查单击、双击、长按、长按重复和长按松开
+ * 2. 驱动：用假时钟和假定时器运行button_gesture_driver.c，
+ *    GPIO按键通过捕获的中断处理函数注入边沿，软件按键通过button_gesture_set_pressed报告状态，
+ *    包括定时器回调停止定时器时恰好来了新边沿的情况
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "button_gesture_driver.h"
+#include "esp_timer.h"
+#include "host_test.h"
+
+#define MS(x)   ((int64_t)(x) * 1000)
+
+/* ---------------- 记录上报的手势 ---------------- */
+
+#define MAX_EVENTS  32
+
+typedef struct {
+    button_gesture_event_t events[MAX_EVENTS];
+    int64_t delivered_us[MAX_EVENTS];   // 回调执行时的假时钟，检查驱动是否按时处理
+    int count;
+} recorder_t;
+
+static void record(const button_gesture_event_t *event, void *user_ctx)
+{
+    recorder_t *rec = user_ctx;
+    if (rec->count < MAX_EVENTS) {
+        rec->events[rec->count] = *event;
+        rec->delivered_us[rec->count] = esp_timer_get_time();
+    }
+    rec->count++;
+}
+
+typedef struct {
+    button_gesture_type_t type;
+    uint8_t count;
+    int64_t time_us;
+} expect_t;
+
+static void check_events(const char *name, const recorder_t *rec, const expect_t *want, int n)
+{
+    HOST_CHECK(rec->count == n, "%s: %d events, want %d", name, rec->count, n);
+    for (int i = 0; i < n && i < rec->count; i++) {
+        const button_gesture_event_t *e = &rec->events[i];
+        HOST_CHECK(e->type == want[i].type && e->count == want[i].count && e->timestamp_us == want[i].time_us,
+                   "%s event %d: got (%d,%u,%lld) want (%d,%u,%lld)", name, i,
+                   e->type, e->count, (long long)e->timestamp_us,
+                   want[i].type, want[i].count, (long long)want[i].time_us);
+    }
+}
+
+/* ---------------- 状态机时间线 ---------------- */
+
+static const button_gesture_config_t s_config = {
+    .debounce_ms = 20,
+    .tap_gap_ms = 400,
+    .hold_ms = 1000,
+    .repeat_ms = 200,
+    .max_taps = 3,
+};
+
+/* 时间线步骤：正数为按下时刻，负数为松开时刻（毫秒），最后一步之后推进到end_ms */
+static void run_timeline(button_gesture_t *g, const int *edges, int n, int end_ms)
+{
+    for (int i = 0; i < n; i++) {
+        bool pressed = edges[i] >= 0;
+        int64_t t = MS(pressed ? edges[i] : -edges[i]);
+        // 像驱动一样在每个到期时刻调用expire，再输入边沿
+        while (button_gesture_next_deadline(g) < t) {
+            button_gesture_expire(g, button_gesture_next_deadline(g));
+        }
+        button_gesture_input(g, pressed, t);
+    }
+    button_gesture_expire(g, MS(end_ms));
+}
+
+static void test_state_machine(void)
+{
+    button_gesture_t g;
+    recorder_t rec;
+
+    // 单击：松开后400ms没有再按，上报在连击超时时刻
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_init(&g, &s_config, record, &rec);
+    run_timeline(&g, (const int[]){0, -100}, 2, 2000);
+    check_events("tap", &rec, (const expect_t[]){{BUTTON_GESTURE_TAP, 1, MS(500)}}, 1);
+    HOST_CHECK(button_gesture_next_deadline(&g) == BUTTON_GESTURE_NO_DEADLINE, "tap leaves a deadline");
+
+    // 双击：第二次按下在间隔内
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_init(&g, &s_config, record, &rec);
+    run_timeline(&g, (const int[]){0, -100, 300, -400}, 4, 2000);
+    check_events("double tap", &rec, (const expect_t[]){{BUTTON_GESTURE_TAP, 2, MS(800)}}, 1);
+
+    // 间隔超时后的第二次点击是新的一组
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_init(&g, &s_config, record, &rec);
+    run_timeline(&g, (const int[]){0, -100, 600, -700}, 4, 2000);
+    check_events("two single taps", &rec,
+                 (const expect_t[]){{BUTTON_GESTURE_TAP, 1, MS(500)}, {BUTTON_GESTURE_TAP, 1, MS(1100)}}, 2);
+
+    // 达到max_taps立即上报，不等待间隔
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_init(&g, &s_config, record, &rec);
+    run_timeline(&g, (const int[]){0, -50, 100, -150, 200, -250}, 6, 250);
+    check_events("max taps", &rec, (const expect_t[]){{BUTTON_GESTURE_TAP, 3, MS(250)}}, 1);
+
+    // 长按、重复、松开：重复每200ms一次，序号从1开始，松开带上长按的count
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_init(&g, &s_config, record, &rec);
+    run_timeline(&g, (const int[]){0, -1450}, 2, 3000);
+    check_events("hold", &rec, (const expect_t[]){
+        {BUTTON_GESTURE_HOLD, 0, MS(1000)},
+        {BUTTON_GESTURE_REPEAT, 1, MS(1200)},
+        {BUTTON_GESTURE_REPEAT, 2, MS(1400)},
+        {BUTTON_GESTURE_RELEASE, 0, MS(1450)},
+    }, 4);
+
+    // 单击后长按：count为之前完成的点击次数
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_init(&g, &s_config, record, &rec);
+    run_timeline(&g, (const int[]){0, -100, 300, -1350}, 4, 3000);
+    check_events("tap then hold", &rec, (const expect_t[]){
+        {BUTTON_GESTURE_HOLD, 1, MS(1300)},
+        {BUTTON_GESTURE_RELEASE, 1, MS(1350)},
+    }, 2);
+
+    // 处理落后多个间隔时不补发积压的重复
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_init(&g, &s_config, record, &rec);
+    button_gesture_input(&g, true, 0);
+    button_gesture_expire(&g, MS(1000));
+    button_gesture_expire(&g, MS(1900));
+    check_events("late repeat", &rec, (const expect_t[]){
+        {BUTTON_GESTURE_HOLD, 0, MS(1000)},
+        {BUTTON_GESTURE_REPEAT, 1, MS(1200)},
+    }, 2);
+    HOST_CHECK(button_gesture_next_deadline(&g) == MS(2100), "late repeat deadline %lld",
+               (long long)button_gesture_next_deadline(&g));
+
+    // 不识别长按时一直按住不产生手势
+    button_gesture_config_t no_hold = s_config;
+    no_hold.hold_ms = 0;
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_init(&g, &no_hold, record, &rec);
+    run_timeline(&g, (const int[]){0, -5000}, 2, 6000);
+    check_events("no hold", &rec, (const expect_t[]){{BUTTON_GESTURE_TAP, 1, MS(5400)}}, 1);
+}
+
+/* ---------------- 假时钟、假定时器和假GPIO ---------------- */
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    bool armed;
+    int64_t expiry;
+};
+
+#define MAX_TIMERS  4
+
+static struct esp_timer s_timers[MAX_TIMERS];
+static int s_timer_count;
+static int64_t s_now;
+
+/* 下一次esp_timer_stop时先注入的边沿，模拟定时器回调停止定时器时恰好来了中断 */
+static void (*s_on_stop)(void);
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out)
+{
+    if (s_timer_count >= MAX_TIMERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    struct esp_timer *timer = &s_timers[s_timer_count++];
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    timer->armed = false;
+    *out = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = true;
+    timer->expiry = s_now + (int64_t)timeout_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (s_on_stop != NULL) {
+        void (*inject)(void) = s_on_stop;
+        s_on_stop = NULL;
+        inject();
+    }
+    if (!timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    timer->armed = false;
+    return ESP_OK;
+}
+
+/* 推进假时钟，按到期顺序执行定时器回调 */
+static void advance_to(int64_t t)
+{
+    while (true) {
+        struct esp_timer *next = NULL;
+        for (int i = 0; i < s_timer_count; i++) {
+            if (s_timers[i].armed && s_timers[i].expiry <= t &&
+                (next == NULL || s_timers[i].expiry < next->expiry)) {
+                next = &s_timers[i];
+            }
+        }
+        if (next == NULL) {
+            break;
+        }
+        s_now = next->expiry;
+        next->armed = false;
+        next->callback(next->arg);
+    }
+    s_now = t;
+}
+
+static int s_level = 1;             // 低电平有效，1为松开
+static gpio_isr_t s_isr;
+static void *s_isr_arg;
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio, gpio_isr_t isr_handler, void *args)
+{
+    (void)gpio;
+    s_isr = isr_handler;
+    s_isr_arg = args;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio)
+{
+    (void)gpio;
+    return s_level;
+}
+
+static void gpio_edge(int level)
+{
+    s_level = level;
+    s_isr(s_isr_arg);
+}
+
+static void release_edge(void)
+{
+    gpio_edge(1);
+}
+
+/* ---------------- 驱动时间线 ---------------- */
+
+static void test_gpio_driver(void)
+{
+    recorder_t rec;
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_handle_t button = NULL;
+    HOST_CHECK(button_gesture_new_gpio(4, true, &s_config, record, &rec, &button) == ESP_OK, "new gpio button");
+
+    // 按下时抖动三次，按最后一次边沿计时；松开同样抖动
+    s_now = MS(1000);
+    gpio_edge(0);
+    advance_to(MS(1005));
+    gpio_edge(1);
+    advance_to(MS(1008));
+    gpio_edge(0);
+    advance_to(MS(1100));
+    gpio_edge(1);
+    advance_to(MS(1103));
+    gpio_edge(0);
+    advance_to(MS(1104));
+    gpio_edge(1);
+    advance_to(MS(3000));
+    check_events("gpio bouncy tap", &rec, (const expect_t[]){{BUTTON_GESTURE_TAP, 1, MS(1504)}}, 1);
+    HOST_CHECK(rec.delivered_us[0] == MS(1504), "bouncy tap delivered at %lld", (long long)rec.delivered_us[0]);
+
+    // 回调刚接受按下、正在停止定时器时来了松开边沿：仍应在去抖后处理松开，识别为单击而不是长按
+    memset(&rec, 0, sizeof(rec));
+    gpio_edge(0);
+    s_on_stop = release_edge;
+    advance_to(MS(6000));
+    check_events("gpio edge during rearm", &rec, (const expect_t[]){{BUTTON_GESTURE_TAP, 1, MS(3420)}}, 1);
+    HOST_CHECK(rec.delivered_us[0] == MS(3420), "edge during rearm delivered at %lld, want on time",
+               (long long)rec.delivered_us[0]);
+}
+
+static void test_source_driver(void)
+{
+    recorder_t rec;
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_handle_t button = NULL;
+    HOST_CHECK(button_gesture_new_source(&s_config, record, &rec, &button) == ESP_OK, "new source button");
+
+    // 软件按键：重复报告相同状态不算边沿
+    s_now = MS(10000);
+    button_gesture_set_pressed(button, true);
+    advance_to(MS(10010));
+    button_gesture_set_pressed(button, true);
+    advance_to(MS(10100));
+    button_gesture_set_pressed(button, false);
+    advance_to(MS(10250));
+    button_gesture_set_pressed(button, true);
+    advance_to(MS(10300));
+    button_gesture_set_pressed(button, false);
+    advance_to(MS(12000));
+    check_events("source double tap", &rec, (const expect_t[]){{BUTTON_GESTURE_TAP, 2, MS(10700)}}, 1);
+
+    // 长按经过驱动：到期时刻由定时器驱动，空闲后定时器不再运行
+    memset(&rec, 0, sizeof(rec));
+    button_gesture_set_pressed(button, true);
+    advance_to(MS(13300));
+    button_gesture_set_pressed(button, false);
+    advance_to(MS(15000));
+    check_events("source hold", &rec, (const expect_t[]){
+        {BUTTON_GESTURE_HOLD, 0, MS(13000)},
+        {BUTTON_GESTURE_REPEAT, 1, MS(13200)},
+        {BUTTON_GESTURE_RELEASE, 0, MS(13300)},
+    }, 3);
+    // 状态来自软件报告，松开要等去抖结束才被读取
+    HOST_CHECK(rec.delivered_us[1] == MS(13200) && rec.delivered_us[2] == MS(13320),
+               "source hold delivered at %lld/%lld", (long long)rec.delivered_us[1], (long long)rec.delivered_us[2]);
+    for (int i = 0; i < s_timer_count; i++) {
+        HOST_CHECK(!s_timers[i].armed, "timer %d still armed when idle", i);
+    }
+
+    // 已经去抖的扫描结果：debounce_ms为0时边沿立即处理
+    button_gesture_config_t scanned = s_config;
+    scanned.debounce_ms = 0;
+    recorder_t rec0;
+    memset(&rec0, 0, sizeof(rec0));
+    button_gesture_handle_t key = NULL;
+    HOST_CHECK(button_gesture_new_source(&scanned, record, &rec0, &key) == ESP_OK, "new scanned key");
+    button_gesture_set_pressed(key, true);
+    advance_to(MS(15050));
+    button_gesture_set_pressed(key, false);
+    advance_to(MS(16000));
+    check_events("scanned key tap", &rec0, (const expect_t[]){{BUTTON_GESTURE_TAP, 1, MS(15450)}}, 1);
+}
+
+int main(void)
+{
+    test_state_machine();
+    test_gpio_driver();
+    test_source_driver();
+    return HOST_TEST_RESULT("button_gesture");
+}
@@ -0,0 +1,132 @@
+/**
+ * @file test_joystick_filter.c
+ * @brief 摇杆滤波与方向判断的主机测试
+ *
+ * 1. 增量中值滤波与每次复制排序整个窗口的参考实现逐样本比较
+ * 2. 死区迟滞：离开中心需达到500‰，回到中心需低于350‰
+ * 3. 最小行程保护：行程小于256个ADC计数时按256归一化，不除零、不放大到满量程
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "joystick_filter.h"
+#include "host_test.h"
+
+#define CENTER0     2041        // 与joystick_filter.c的默认中心一致
+#define CENTER1     2183
+#define HALF_SPAN   1600
+#define GUARD_SPAN  256         // joystick_filter.c中的MIN_HALF_SPAN
+
+static int cmp_u16(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+/* 参考实现：复制最近的样本并排序取中值 */
+static uint16_t reference_median(const uint16_t *history, int n)
+{
+    uint16_t window[JOYSTICK_MEDIAN_WINDOW];
+    int count = n < JOYSTICK_MEDIAN_WINDOW ? n : JOYSTICK_MEDIAN_WINDOW;
+    memcpy(window, history + n - count, count * sizeof(uint16_t));
+    qsort(window, count, sizeof(uint16_t), cmp_u16);
+    return window[(count - 1) / 2];
+}
+
+static void test_median(void)
+{
+    enum { SAMPLES = 200000 };
+    static uint16_t history[SAMPLES];
+    joystick_median_t filter;
+    joystick_median_init(&filter);
+    srand(35);
+
+    for (int i = 0; i < SAMPLES; i++) {
+        // 交替使用随机噪声、小范围取值（大量重复值）和突变尖峰
+        uint16_t sample;
+        switch ((i / 1000) % 3) {
+        case 0:  sample = rand() & 0xfff; break;
+        case 1:  sample = 2000 + (rand() & 3); break;
+        default: sample = (rand() % 16 == 0) ? 4095 : 2041 + (rand() % 9) - 4; break;
+        }
+        history[i] = sample;
+        uint16_t got = joystick_median_update(&filter, sample);
+        uint16_t want = reference_median(history, i + 1);
+        HOST_CHECK(got == want, "median sample %d: got %u want %u", i, got, want);
+        HOST_CHECK(joystick_median_full(&filter) == (i + 1 >= JOYSTICK_MEDIAN_WINDOW),
+                   "median full flag at sample %d", i);
+    }
+}
+
+/* 轴0按千分比偏离中心，其余保持中心 */
+static uint16_t axis0_at(int permille)
+{
+    return (uint16_t)(CENTER0 + permille * HALF_SPAN / 1000);
+}
+
+static void test_deadzone_hysteresis(void)
+{
+    joystick_classifier_t c;
+    joystick_classifier_init(&c, NULL);
+
+    HOST_CHECK(joystick_classifier_update(&c, axis0_at(490), CENTER1) == JOYSTICK_CENTER,
+               "490 permille must stay in the deadzone");
+    HOST_CHECK(joystick_classifier_update(&c, axis0_at(500), CENTER1) == JOYSTICK_UP,
+               "500 permille must leave the deadzone");
+    // 已离开中心：400‰仍在死区外
+    HOST_CHECK(joystick_classifier_update(&c, axis0_at(400), CENTER1) == JOYSTICK_UP,
+               "400 permille must hold the direction once outside");
+    HOST_CHECK(joystick_classifier_update(&c, axis0_at(350), CENTER1) == JOYSTICK_UP,
+               "350 permille is still on the exit boundary");
+    HOST_CHECK(joystick_classifier_update(&c, axis0_at(340), CENTER1) == JOYSTICK_CENTER,
+               "340 permille must return to center");
+    // 回到中心后又要重新达到500‰
+    HOST_CHECK(joystick_classifier_update(&c, axis0_at(400), CENTER1) == JOYSTICK_CENTER,
+               "400 permille must not leave the deadzone from center");
+    HOST_CHECK(joystick_classifier_update(&c, axis0_at(-500), CENTER1) == JOYSTICK_DOWN,
+               "-500 permille must leave the deadzone downward");
+    HOST_CHECK(c.offset[0] == -500, "offset after -500 permille: %d", c.offset[0]);
+}
+
+static void test_min_half_span_guard(void)
+{
+    joystick_calibration_t cal;
+    joystick_calibration_default(&cal);
+    HOST_CHECK(joystick_calibration_valid(&cal), "default calibration must be valid");
+
+    // 有效校准数据的行程下限正好是256
+    cal.max[1] = cal.center[1] + GUARD_SPAN;
+    HOST_CHECK(joystick_calibration_valid(&cal), "half span of %d must be valid", GUARD_SPAN);
+    cal.max[1] = cal.center[1] + GUARD_SPAN - 1;
+    HOST_CHECK(!joystick_calibration_valid(&cal), "half span below %d must be invalid", GUARD_SPAN);
+    joystick_calibration_default(&cal);
+    cal.min[0] = cal.center[0] - GUARD_SPAN + 1;
+    HOST_CHECK(!joystick_calibration_valid(&cal), "lower half span below %d must be invalid", GUARD_SPAN);
+
+    // 中心漂到行程端点：向右的行程为0，除数按256计算
+    joystick_calibration_default(&cal);
+    cal.max[1] = cal.center[1];
+    joystick_classifier_t c;
+    joystick_classifier_init(&c, &cal);
+    HOST_CHECK(joystick_classifier_update(&c, CENTER0, CENTER1) == JOYSTICK_CENTER,
+               "center sample with zero span");
+    HOST_CHECK(c.offset[1] == 0, "zero offset with zero span: %d", c.offset[1]);
+
+    // 偏移128计数：行程随观测扩展到128，仍小于256，应得到500‰而不是满量程
+    joystick_direction_t dir = joystick_classifier_update(&c, CENTER0, CENTER1 + GUARD_SPAN / 2);
+    HOST_CHECK(c.offset[1] == 500, "offset with guarded span: got %d want 500", c.offset[1]);
+    HOST_CHECK(dir == JOYSTICK_RIGHT, "guarded 500 permille must leave the deadzone: %d", dir);
+
+    // 行程扩展到256以上后恢复按实际行程归一化
+    joystick_classifier_update(&c, CENTER0, CENTER1 + 2 * GUARD_SPAN);
+    HOST_CHECK(c.offset[1] == 1000, "offset at observed maximum: %d", c.offset[1]);
+    joystick_classifier_update(&c, CENTER0, CENTER1 + GUARD_SPAN);
+    HOST_CHECK(c.offset[1] == 500, "offset at half of the expanded span: %d", c.offset[1]);
+}
+
+int main(void)
+{
+    test_median();
+    test_deadzone_hysteresis();
+    test_min_half_span_guard();
+    return HOST_TEST_RESULT("joystick_filter");
+}
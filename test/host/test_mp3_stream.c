@@ -0,0 +1,306 @@
+/**
+ * @file test_mp3_stream.c
+ * @brief MP3预读缓冲区在假文件系统上的测试
+ *
+ * 1. 按各种长度取数据拼接后与文件内容逐字节相同，跳过的文件头不计入大小和位置
+ * 2. 文件系统每次只返回一部分数据（短读）时拼接结果不变
+ * 3. 缓冲区写满后读取任务休眠，数据降到低水位以上时不读文件，降到低水位后立即连续读满
+ * 4. 读取出错时先取完已读入的数据，再返回MP3_STREAM_ERROR
+ * 5. 文件系统卡住时mp3_stream_read等待超时返回MP3_STREAM_TIMEOUT并记一次欠载，恢复后数据不丢
+ * open/fstat/lseek/read/close通过链接器--wrap换成本文件中的内存文件
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "mp3_stream.h"
+#include "host_test.h"
+
+#define FILE_PATH   "/spiffs/test.mp3"
+#define FILE_FD     42
+#define FILE_SIZE   (MP3_STREAM_RING_SIZE * 5 + 1234)
+#define HEADER_SIZE 321         // 模拟ID3v2标签，从这里开始读
+
+/* ---------------- 假文件系统 ---------------- */
+
+static uint8_t s_file[FILE_SIZE];
+static size_t s_file_pos;
+static size_t s_max_read;               // 每次read最多返回的字节数，0为不限制
+static size_t s_error_at;               // 读到这个位置时返回-1，0为不出错
+static atomic_uint s_reads;             // read调用次数
+static pthread_mutex_t s_gate_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_gate_cond = PTHREAD_COND_INITIALIZER;
+static bool s_gate_closed;              // 为true时read阻塞，模拟文件系统卡住
+
+int __wrap_open(const char *path, int flags, ...)
+{
+    (void)flags;
+    if (strcmp(path, FILE_PATH) != 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    s_file_pos = 0;
+    return FILE_FD;
+}
+
+int __wrap_fstat(int fd, struct stat *st)
+{
+    if (fd != FILE_FD) {
+        errno = EBADF;
+        return -1;
+    }
+    memset(st, 0, sizeof(*st));
+    st->st_size = FILE_SIZE;
+    return 0;
+}
+
+off_t __wrap_lseek(int fd, off_t offset, int whence)
+{
+    if (fd != FILE_FD || whence != SEEK_SET || offset > FILE_SIZE) {
+        errno = EINVAL;
+        return -1;
+    }
+    s_file_pos = (size_t)offset;
+    return offset;
+}
+
+ssize_t __wrap_read(int fd, void *buf, size_t count)
+{
+    if (fd != FILE_FD) {
+        errno = EBADF;
+        return -1;
+    }
+    pthread_mutex_lock(&s_gate_lock);
+    while (s_gate_closed) {
+        pthread_cond_wait(&s_gate_cond, &s_gate_lock);
+    }
+    pthread_mutex_unlock(&s_gate_lock);
+
+    atomic_fetch_add(&s_reads, 1);
+    if (s_error_at != 0 && s_file_pos >= s_error_at) {
+        errno = EIO;
+        return -1;
+    }
+    size_t n = count;
+    if (s_max_read != 0 && n > s_max_read) {
+        n = s_max_read;
+    }
+    if (n > FILE_SIZE - s_file_pos) {
+        n = FILE_SIZE - s_file_pos;
+    }
+    memcpy(buf, s_file + s_file_pos, n);
+    s_file_pos += n;
+    return (ssize_t)n;
+}
+
+int __wrap_close(int fd)
+{
+    return fd == FILE_FD ? 0 : -1;
+}
+
+static void set_gate(bool closed)
+{
+    pthread_mutex_lock(&s_gate_lock);
+    s_gate_closed = closed;
+    pthread_cond_broadcast(&s_gate_cond);
+    pthread_mutex_unlock(&s_gate_lock);
+}
+
+static void reset_fs(void)
+{
+    s_max_read = 0;
+    s_error_at = 0;
+    atomic_store(&s_reads, 0);
+    set_gate(false);
+}
+
+static void sleep_ms(int ms)
+{
+    struct timespec ts = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+static int64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* 等待read调用次数达到count，超时返回false */
+static bool wait_reads(unsigned count, int timeout_ms)
+{
+    int64_t end = now_ms() + timeout_ms;
+    while (atomic_load(&s_reads) < count) {
+        if (now_ms() >= end) {
+            return false;
+        }
+        sleep_ms(1);
+    }
+    return true;
+}
+
+/* 取len字节并与文件内容比较 */
+static void consume(mp3_stream_t *stream, size_t len, const char *what)
+{
+    static char buf[MP3_STREAM_RING_SIZE];
+    size_t done = 0;
+    while (done < len) {
+        size_t pos = mp3_stream_pos(stream);
+        int n = mp3_stream_read(stream, buf, (int)(len - done), pdMS_TO_TICKS(1000));
+        if (n <= 0) {
+            HOST_CHECK(n > 0, "%s: read returned %d at %zu", what, n, pos);
+            return;
+        }
+        HOST_CHECK(memcmp(buf, s_file + HEADER_SIZE + pos, n) == 0, "%s: data differs at %zu", what, pos);
+        done += n;
+    }
+}
+
+/* 按一串互质的长度取完整个文件 */
+static void read_all(mp3_stream_t *stream, const char *what)
+{
+    static const int lengths[] = { 1, 417, 4096, 13, 1152, 9999, 2, 16384, 577 };
+    static char buf[MP3_STREAM_RING_SIZE];
+    size_t pos = 0;
+    int n;
+    for (int i = 0;; i++) {
+        n = mp3_stream_read(stream, buf, lengths[i % 9], pdMS_TO_TICKS(1000));
+        if (n <= 0) {
+            break;
+        }
+        HOST_CHECK(memcmp(buf, s_file + HEADER_SIZE + pos, n) == 0, "%s: data differs at %zu", what, pos);
+        pos += n;
+        HOST_CHECK(mp3_stream_pos(stream) == pos, "%s: pos %zu, expected %zu", what, mp3_stream_pos(stream), pos);
+    }
+    HOST_CHECK(n == MP3_STREAM_EOF, "%s: ended with %d", what, n);
+    HOST_CHECK(pos == FILE_SIZE - HEADER_SIZE, "%s: got %zu of %d bytes", what, pos, FILE_SIZE - HEADER_SIZE);
+    HOST_CHECK(mp3_stream_read(stream, buf, 100, 0) == MP3_STREAM_EOF, "%s: read after EOF", what);
+}
+
+/* ---------------- 测试 ---------------- */
+
+static void test_reassembly(mp3_stream_t *stream)
+{
+    reset_fs();
+    HOST_CHECK(mp3_stream_open(stream, FILE_PATH, HEADER_SIZE) == ESP_OK, "open");
+    HOST_CHECK(mp3_stream_size(stream) == FILE_SIZE - HEADER_SIZE, "size %zu", mp3_stream_size(stream));
+    read_all(stream, "reassembly");
+
+    // 整块读取：读满一次缓冲区加文件末尾的一次0字节读
+    unsigned chunks = (FILE_SIZE - HEADER_SIZE + MP3_STREAM_CHUNK_SIZE - 1) / MP3_STREAM_CHUNK_SIZE;
+    mp3_stream_stats_t stats;
+    mp3_stream_get_stats(stream, &stats);
+    HOST_CHECK(stats.reads == chunks + 1, "%u reads, expected %u", (unsigned)stats.reads, chunks + 1);
+    mp3_stream_close(stream);
+
+    HOST_CHECK(mp3_stream_open(stream, "/spiffs/missing.mp3", 0) == ESP_FAIL, "missing file must fail");
+    HOST_CHECK(!mp3_stream_is_open(stream), "failed open leaves the stream closed");
+    HOST_CHECK(mp3_stream_open(stream, FILE_PATH, FILE_SIZE + 1) == ESP_FAIL, "offset past the end must fail");
+}
+
+static void test_short_reads(mp3_stream_t *stream)
+{
+    reset_fs();
+    s_max_read = 1000;
+    HOST_CHECK(mp3_stream_open(stream, FILE_PATH, HEADER_SIZE) == ESP_OK, "open");
+    read_all(stream, "short reads");
+    mp3_stream_close(stream);
+}
+
+static void test_low_water(mp3_stream_t *stream)
+{
+    const unsigned fill = MP3_STREAM_RING_SIZE / MP3_STREAM_CHUNK_SIZE;
+
+    reset_fs();
+    HOST_CHECK(mp3_stream_open(stream, FILE_PATH, HEADER_SIZE) == ESP_OK, "open");
+    HOST_CHECK(wait_reads(fill, 1000), "reader must fill the ring, %u reads", atomic_load(&s_reads));
+
+    // 缓冲区满后不再读文件；取走一块，数据仍在低水位以上，读取任务继续休眠
+    sleep_ms(10);
+    HOST_CHECK(atomic_load(&s_reads) == fill, "full ring: %u reads", atomic_load(&s_reads));
+    consume(stream, MP3_STREAM_CHUNK_SIZE, "above low water");
+    sleep_ms(20);
+    HOST_CHECK(atomic_load(&s_reads) == fill, "above low water: %u reads", atomic_load(&s_reads));
+
+    // 取到低水位，读取任务马上被唤醒并连续读满，不必等到轮询超时（READER_POLL_MS为100ms）
+    consume(stream, MP3_STREAM_RING_SIZE - MP3_STREAM_CHUNK_SIZE - MP3_STREAM_LOW_WATER, "to low water");
+    unsigned refill = fill + MP3_STREAM_LOW_WATER / MP3_STREAM_CHUNK_SIZE;
+    HOST_CHECK(wait_reads(refill, 50), "low water must wake the reader, %u reads", atomic_load(&s_reads));
+    sleep_ms(10);
+    HOST_CHECK(atomic_load(&s_reads) == refill, "refill stops when full, %u reads", atomic_load(&s_reads));
+
+    mp3_stream_stats_t stats;
+    mp3_stream_get_stats(stream, &stats);
+    HOST_CHECK(stats.underruns == 0, "%u underruns", (unsigned)stats.underruns);
+    mp3_stream_close(stream);
+}
+
+static void test_error(mp3_stream_t *stream)
+{
+    reset_fs();
+    s_error_at = HEADER_SIZE + 3 * MP3_STREAM_CHUNK_SIZE;
+    HOST_CHECK(mp3_stream_open(stream, FILE_PATH, HEADER_SIZE) == ESP_OK, "open");
+
+    // 出错前读入的数据全部交给解码器，之后才报告错误
+    consume(stream, 3 * MP3_STREAM_CHUNK_SIZE, "before error");
+    char buf[16];
+    int n = mp3_stream_read(stream, buf, sizeof(buf), pdMS_TO_TICKS(1000));
+    HOST_CHECK(n == MP3_STREAM_ERROR, "read after a failed file read returned %d", n);
+    mp3_stream_close(stream);
+}
+
+static void test_timeout(mp3_stream_t *stream)
+{
+    reset_fs();
+    set_gate(true);
+    HOST_CHECK(mp3_stream_open(stream, FILE_PATH, HEADER_SIZE) == ESP_OK, "open");
+
+    char buf[16];
+    int n = mp3_stream_read(stream, buf, sizeof(buf), pdMS_TO_TICKS(20));
+    HOST_CHECK(n == MP3_STREAM_TIMEOUT, "stalled file system returned %d", n);
+    mp3_stream_stats_t stats;
+    mp3_stream_get_stats(stream, &stats);
+    HOST_CHECK(stats.underruns == 1, "%u underruns", (unsigned)stats.underruns);
+    HOST_CHECK(stats.underrun_ms >= 15, "waited %u ms", (unsigned)stats.underrun_ms);
+
+    // 文件系统恢复后从头拿到完整的数据
+    set_gate(false);
+    read_all(stream, "after timeout");
+    mp3_stream_close(stream);
+}
+
+static void test_mapped(mp3_stream_t *stream)
+{
+    HOST_CHECK(mp3_stream_open_mapped(stream, s_file + HEADER_SIZE, FILE_SIZE - HEADER_SIZE) == ESP_OK, "open mapped");
+    read_all(stream, "mapped");
+    mp3_stream_close(stream);
+    HOST_CHECK(!mp3_stream_is_open(stream), "closed");
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < FILE_SIZE; i++) {
+        s_file[i] = (uint8_t)(i * 2654435761u >> 13);
+    }
+
+    mp3_stream_t *stream = mp3_stream_create();
+    HOST_CHECK(stream != NULL, "create");
+    if (stream == NULL) {
+        return HOST_TEST_RESULT("mp3_stream");
+    }
+
+    test_reassembly(stream);
+    test_short_reads(stream);
+    test_low_water(stream);
+    test_error(stream);
+    test_timeout(stream);
+    test_mapped(stream);
+
+    mp3_stream_destroy(stream);
+    return HOST_TEST_RESULT("mp3_stream");
+}
@@ -0,0 +1,149 @@
+/**
+ * @file test_oled_3d.c
+ * @brief 定点数三维模块的精度检查与单帧耗时对比
+ *
+ * 1. OLED_3D_Sin/Cos与libm在全部65536个角度上的误差
+ * 2. 随机欧拉角下旋转+投影后的顶点与双精度结果的误差
+ * 3. 旋转前若干帧，定点数DrawCube3D与原浮点版本画出的线框在一个像素内重合
+ * 4. 两个版本绘制一帧的平均耗时（主机上测得，仅作相对比较）
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "OLED.h"
+#include "OLED_3D.h"
+#include "oled_reference.h"
+#include "host_test.h"
+
+uint8_t OLED_DisplayBuf[OLED_HEIGHT / 8][OLED_WIDTH];
+
+#define CUBE_SIZE           18.0f
+#define COMPARE_FRAMES      200
+#define BENCH_FRAMES        200000
+
+static int popcount_buf(const uint8_t *buf, size_t len)
+{
+    int n = 0;
+    for (size_t i = 0; i < len; i++) {
+        n += __builtin_popcount(buf[i]);
+    }
+    return n;
+}
+
+static void test_sine_table(void)
+{
+    int32_t worst = 0;
+    for (uint32_t a = 0; a < 65536; a++) {
+        double rad = a * (2.0 * M_PI / 65536.0);
+        int32_t s = OLED_3D_Sin((OLED_Angle_t)a) - (int32_t)lround(sin(rad) * 65536.0);
+        int32_t c = OLED_3D_Cos((OLED_Angle_t)a) - (int32_t)lround(cos(rad) * 65536.0);
+        if (abs(s) > worst) worst = abs(s);
+        if (abs(c) > worst) worst = abs(c);
+    }
+    printf("sin/cos max error: %d LSB (Q16.16)\n", worst);
+    HOST_CHECK(worst <= 2, "sin/cos error %d LSB", worst);
+}
+
+static int lit(const uint8_t buf[OLED_HEIGHT / 8][OLED_WIDTH], int x, int y)
+{
+    if (x < 0 || y < 0 || x >= OLED_WIDTH || y >= OLED_HEIGHT) return 0;
+    return (buf[y / 8][x] >> (y % 8)) & 1;
+}
+
+/* a中每个点亮的像素，b在其周围一个像素内都有点亮的像素 */
+static int count_unmatched(const uint8_t a[OLED_HEIGHT / 8][OLED_WIDTH], const uint8_t b[OLED_HEIGHT / 8][OLED_WIDTH])
+{
+    int misses = 0;
+    for (int y = 0; y < OLED_HEIGHT; y++) {
+        for (int x = 0; x < OLED_WIDTH; x++) {
+            if (!lit(a, x, y)) continue;
+            int found = 0;
+            for (int dy = -1; dy <= 1 && !found; dy++) {
+                for (int dx = -1; dx <= 1 && !found; dx++) {
+                    found = lit(b, x + dx, y + dy);
+                }
+            }
+            misses += !found;
+        }
+    }
+    return misses;
+}
+
+/*
+ * 两个版本各自维护转角，每帧步长相同（定点数步长量化后略小），
+ * 顶点取整方式一致但舍入边界附近会差一个像素，因此按一个像素的邻域比对
+ */
+static void test_cube_matches_float(uint8_t perspective)
+{
+    int misses = 0, total = 0;
+    for (int frame = 0; frame < COMPARE_FRAMES; frame++) {
+        memset(OLED_DisplayBuf, 0, sizeof(OLED_DisplayBuf));
+        memset(Ref_DisplayBuf, 0, sizeof(Ref_DisplayBuf));
+        DrawCube3D(OLED_WIDTH / 2, OLED_HEIGHT / 2, CUBE_SIZE, perspective);
+        Ref_DrawCube3D(OLED_WIDTH / 2, OLED_HEIGHT / 2, CUBE_SIZE, perspective);
+        misses += count_unmatched(OLED_DisplayBuf, Ref_DisplayBuf);
+        misses += count_unmatched(Ref_DisplayBuf, OLED_DisplayBuf);
+        total += popcount_buf((uint8_t *)Ref_DisplayBuf, sizeof(Ref_DisplayBuf));
+    }
+    printf("cube perspective=%u: %d of %d lit pixels farther than 1px from the float version\n",
+           perspective, misses, total);
+    HOST_CHECK(misses == 0, "cube perspective=%u: %d unmatched pixels", perspective, misses);
+}
+
+/* 同一组欧拉角下，定点数旋转+投影与双精度计算的顶点坐标相差不超过一个像素 */
+static void test_projection_matches_double(void)
+{
+    int worst = 0;
+    srand(3);
+    for (int n = 0; n < 20000; n++) {
+        OLED_Angle_t a[3];
+        for (int k = 0; k < 3; k++) a[k] = (OLED_Angle_t)rand();
+        OLED_Mat3_t m;
+        OLED_3D_RotationEuler(&m, a[0], a[1], a[2]);
+
+        double yaw = a[0] * 2.0 * M_PI / 65536.0, pitch = a[1] * 2.0 * M_PI / 65536.0, roll = a[2] * 2.0 * M_PI / 65536.0;
+        double v[3] = {rand() % 41 - 20, rand() % 41 - 20, rand() % 41 - 20};
+        /* 与DrawCube3D原浮点版本相同的顺序：先Roll，再Pitch，最后Yaw */
+        double y1 = cos(roll) * v[1] - sin(roll) * v[2], z1 = sin(roll) * v[1] + cos(roll) * v[2];
+        double x2 = cos(pitch) * v[0] + sin(pitch) * z1, z2 = -sin(pitch) * v[0] + cos(pitch) * z1;
+        double x3 = cos(yaw) * x2 - sin(yaw) * y1, y3 = sin(yaw) * x2 + cos(yaw) * y1;
+        double f = 50.0 / (50.0 + z2);
+
+        OLED_Vec3_t in = {OLED_FIX16_FROM_INT(v[0]), OLED_FIX16_FROM_INT(v[1]), OLED_FIX16_FROM_INT(v[2])};
+        OLED_Vec3_t out = OLED_3D_Transform(&m, &in);
+        int16_t px, py;
+        OLED_3D_Project(&out, 0, 0, OLED_FIX16_FROM_INT(50), &px, &py);
+        int ex = abs(px - (int)(x3 * f)), ey = abs(py - (int)(y3 * f));
+        if (ex > worst) worst = ex;
+        if (ey > worst) worst = ey;
+    }
+    printf("projected vertex max error: %d px\n", worst);
+    HOST_CHECK(worst <= 1, "projected vertex error %d px", worst);
+}
+
+static double frame_ns(void (*draw)(int16_t, int16_t, float, uint8_t), uint8_t perspective)
+{
+    clock_t t = clock();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        draw(OLED_WIDTH / 2, OLED_HEIGHT / 2, CUBE_SIZE, perspective);
+    }
+    return (double)(clock() - t) / CLOCKS_PER_SEC * 1e9 / BENCH_FRAMES;
+}
+
+int main(void)
+{
+    test_sine_table();
+    test_projection_matches_double();
+    test_cube_matches_float(0);
+    test_cube_matches_float(1);
+
+    for (uint8_t p = 0; p <= 1; p++) {
+        double fixed = frame_ns(DrawCube3D, p);
+        double ref = frame_ns(Ref_DrawCube3D, p);
+        printf("DrawCube3D frame, perspective=%u: float %.0f ns, fixed %.0f ns\n", p, ref, fixed);
+    }
+
+    return HOST_TEST_RESULT("oled_3d");
+}
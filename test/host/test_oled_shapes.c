@@ -0,0 +1,121 @@
+/**
+ * @file test_oled_shapes.c
+ * @brief 图形绘制（画布累积 + 按列提交）与原逐像素实现的逐字节比对
+ *
+ * 覆盖矩形、圆、椭圆、圆弧、圆角矩形和三角形的空心与填充两种形式，
+ * 圆心/顶点在屏幕内外各处分布，以检验裁剪。整数角度判断另做穷举比对。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "OLED.h"
+#include "oled_reference.h"
+#include "host_test.h"
+
+uint8_t OLED_DisplayBuf[OLED_HEIGHT / 8][OLED_WIDTH];
+uint8_t OLED_IsInAngle(int16_t X, int16_t Y, int16_t StartAngle, int16_t EndAngle);
+
+static uint8_t s_noise[2 * sizeof(OLED_DisplayBuf)];
+static size_t s_noise_pos;
+
+/* 底图取稀疏噪声，让“多画”和“漏画”都能在比对中暴露出来 */
+static void seed_buffers(void)
+{
+    s_noise_pos = (s_noise_pos + 37) % sizeof(OLED_DisplayBuf);
+    memcpy(OLED_DisplayBuf, &s_noise[s_noise_pos], sizeof(OLED_DisplayBuf));
+    memcpy(Ref_DisplayBuf, &s_noise[s_noise_pos], sizeof(Ref_DisplayBuf));
+}
+
+static int buffers_equal(void)
+{
+    return memcmp(OLED_DisplayBuf, Ref_DisplayBuf, sizeof(OLED_DisplayBuf)) == 0;
+}
+
+static void test_angle_predicate(void)
+{
+    for (int x = -160; x <= 160; x++) {
+        for (int y = -160; y <= 160; y++) {
+            for (int k = 0; k < 8; k++) {
+                int s = rand() % 361 - 180;
+                int e = rand() % 361 - 180;
+                HOST_CHECK(OLED_IsInAngle(x, y, s, e) == Ref_IsInAngle(x, y, s, e),
+                           "IsInAngle(%d,%d,%d,%d)", x, y, s, e);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    srand(2);
+    for (size_t i = 0; i < sizeof(s_noise); i++) {
+        s_noise[i] = (uint8_t)(rand() & rand());
+    }
+
+    test_angle_predicate();
+
+    for (uint8_t f = 0; f <= 1; f++) {
+        for (int n = 0; n < 20000; n++) {
+            int x = rand() % 180 - 30, y = rand() % 60 - 14, w = rand() % 140 - 4, h = rand() % 44 - 4;
+            seed_buffers();
+            OLED_DrawRectangle(x, y, w, h, f);
+            Ref_DrawRectangle(x, y, w, h, f);
+            HOST_CHECK(buffers_equal(), "DrawRectangle(%d,%d,%d,%d,%u)", x, y, w, h, f);
+        }
+
+        for (int x = -40; x < 170; x += 3) {
+            for (int y = -40; y < 72; y += 2) {
+                for (int r = 0; r < 70; r += (r < 12 ? 1 : 5)) {
+                    seed_buffers();
+                    OLED_DrawCircle(x, y, r, f);
+                    Ref_DrawCircle(x, y, r, f);
+                    HOST_CHECK(buffers_equal(), "DrawCircle(%d,%d,%d,%u)", x, y, r, f);
+                }
+            }
+        }
+
+        for (int x = -20; x < 150; x += 7) {
+            for (int y = -20; y < 52; y += 3) {
+                for (int a = 0; a < 80; a += (a < 10 ? 1 : 7)) {
+                    for (int b = 0; b < 40; b += (b < 10 ? 1 : 5)) {
+                        seed_buffers();
+                        OLED_DrawEllipse(x, y, a, b, f);
+                        Ref_DrawEllipse(x, y, a, b, f);
+                        HOST_CHECK(buffers_equal(), "DrawEllipse(%d,%d,%d,%d,%u)", x, y, a, b, f);
+                    }
+                }
+            }
+        }
+
+        for (int n = 0; n < 20000; n++) {
+            int x = rand() % 160 - 16, y = rand() % 60 - 14, r = rand() % 40;
+            int s = rand() % 361 - 180, e = rand() % 361 - 180;
+            seed_buffers();
+            OLED_DrawArc(x, y, r, s, e, f);
+            Ref_DrawArc(x, y, r, s, e, f);
+            HOST_CHECK(buffers_equal(), "DrawArc(%d,%d,%d,%d,%d,%u)", x, y, r, s, e, f);
+        }
+
+        for (int n = 0; n < 20000; n++) {
+            int x = rand() % 160 - 16, y = rand() % 60 - 14, w = rand() % 90, h = rand() % 40, r = rand() % 20;
+            seed_buffers();
+            OLED_DrawRoundedRectangle(x, y, w, h, r, f);
+            Ref_DrawRoundedRectangle(x, y, w, h, r, f);
+            HOST_CHECK(buffers_equal(), "DrawRoundedRectangle(%d,%d,%d,%d,%d,%u)", x, y, w, h, r, f);
+        }
+
+        for (int n = 0; n < 100000; n++) {
+            int v[6];
+            for (int i = 0; i < 6; i++) {
+                v[i] = (i & 1) ? rand() % 80 - 24 : rand() % 200 - 36;
+            }
+            seed_buffers();
+            OLED_DrawTriangle(v[0], v[1], v[2], v[3], v[4], v[5], f);
+            Ref_DrawTriangle(v[0], v[1], v[2], v[3], v[4], v[5], f);
+            HOST_CHECK(buffers_equal(), "DrawTriangle(%d,%d,%d,%d,%d,%d,%u)",
+                       v[0], v[1], v[2], v[3], v[4], v[5], f);
+        }
+    }
+
+    return HOST_TEST_RESULT("oled_shapes");
+}
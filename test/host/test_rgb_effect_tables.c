@@ -0,0 +1,256 @@
+/**
+ * @file test_rgb_effect_tables.c
+ * @brief 查表灯效与rgb_matrix坐标公式的等价性测试和10000帧基准
+ *
+ * 参考实现逐帧按g_led_config的坐标计算色相，公式与rgb_matrix库中的同名灯效相同：
+ * 正弦用FastLED的sin8/cos8，距离用整数开方sqrt16，角度用atan2_8（截断）。
+ * 查表实现的正弦表、距离和角度都是四舍五入的，所以坐标相关的灯效允许少量色相误差，
+ * 只与坐标和时间线性相关的灯效必须逐位一致。
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "rgb_effect_tables.h"
+#include "keyboard_led.h"
+#include "host_test.h"
+
+#define LED_COUNT   RGB_EFFECT_LED_COUNT
+#define FRAMES      10000
+#define FRAME_MS    20
+
+/* 与keyboard_led.c相同的布局 */
+static const led_config_t s_led_config = {
+    {
+        {0, 1, 2, 3},
+        {4, 5, 6, 7},
+        {8, 9, 10, NO_LED},
+        {11, 12, 13, NO_LED},
+        {14, NO_LED, 15, 16}
+    },
+    {
+#define LED_POINT(x, y) {x, y},
+        KOB_LED_POINTS(LED_POINT)
+#undef LED_POINT
+    },
+    {0}
+};
+
+/* ---------------- rgb_matrix的坐标公式 ---------------- */
+
+static uint8_t sin8(uint8_t theta)
+{
+    static const uint8_t b_m16_interleave[] = {0, 49, 49, 41, 90, 27, 117, 10};
+    uint8_t offset = theta;
+    if (theta & 0x40) {
+        offset = (uint8_t)255 - offset;
+    }
+    offset &= 0x3F;
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) {
+        secoffset++;
+    }
+    uint8_t section = offset >> 4;
+    uint8_t b = b_m16_interleave[section * 2];
+    uint8_t m16 = b_m16_interleave[section * 2 + 1];
+    uint8_t mx = (m16 * secoffset) >> 4;
+    int8_t y = (int8_t)(mx + b);
+    if (theta & 0x80) {
+        y = -y;
+    }
+    return (uint8_t)(y + 128);
+}
+
+static uint8_t cos8(uint8_t theta)
+{
+    return sin8((uint8_t)(theta + 64));
+}
+
+static uint8_t sqrt16(uint16_t x)
+{
+    uint8_t root = 0;
+    while ((uint16_t)(root + 1) * (root + 1) <= x && root < 255) {
+        root++;
+    }
+    return root;
+}
+
+static uint8_t atan2_8(int16_t dy, int16_t dx)
+{
+    return (uint8_t)(int)(atan2f(dy, dx) * 128.0f / (float)M_PI);
+}
+
+/* 逐帧从坐标计算每个LED的色相 */
+static void reference_hues(uint16_t mode, uint32_t time_ms, const rgb_effect_params_t *p, uint8_t hues[])
+{
+    uint8_t min_x = UINT8_MAX, max_x = 0, min_y = UINT8_MAX, max_y = 0;
+    for (int i = 0; i < LED_COUNT; i++) {
+        const led_point_t *pt = &s_led_config.point[i];
+        if (pt->x < min_x) min_x = pt->x;
+        if (pt->x > max_x) max_x = pt->x;
+        if (pt->y < min_y) min_y = pt->y;
+        if (pt->y > max_y) max_y = pt->y;
+    }
+    const int cx = (min_x + max_x) / 2;
+    const int cy = (min_y + max_y) / 2;
+
+    uint8_t time = (uint8_t)((time_ms * (uint32_t)(p->speed / 4 + 1)) >> 8);
+    int8_t cos_value = (int8_t)(cos8(time) - 128);
+    int8_t sin_value = (int8_t)(sin8(time) - 128);
+
+    for (int i = 0; i < LED_COUNT; i++) {
+        int x = s_led_config.point[i].x;
+        int y = s_led_config.point[i].y;
+        int dx = x - cx;
+        int dy = y - cy;
+        int h = p->hue;
+        switch (mode) {
+        case RGB_MATRIX_RAINBOW_BEACON:
+            h += (dy * 2 * cos_value + dx * 2 * sin_value) / 128;
+            break;
+        case RGB_MATRIX_RAINBOW_PINWHEELS:
+            h += (dy * 3 * cos_value + (cx / 2 - abs(dx)) * 3 * sin_value) / 128;
+            break;
+        case RGB_MATRIX_RAINBOW_MOVING_CHEVRON:
+            h += abs(dy) + (x - time);
+            break;
+        case RGB_MATRIX_CYCLE_LEFT_RIGHT:
+            h = x - time;
+            break;
+        case RGB_MATRIX_CYCLE_UP_DOWN:
+            h = y - time;
+            break;
+        case RGB_MATRIX_CYCLE_OUT_IN:
+            h = 3 * sqrt16(dx * dx + dy * dy) / 2 + time;
+            break;
+        case RGB_MATRIX_CYCLE_OUT_IN_DUAL: {
+            int ddx = cx / 2 - abs(dx);
+            h = 3 * sqrt16(ddx * ddx + dy * dy) + time;
+            break;
+        }
+        case RGB_MATRIX_CYCLE_PINWHEEL:
+            h = atan2_8(dy, dx) + time;
+            break;
+        case RGB_MATRIX_CYCLE_SPIRAL:
+            h = sqrt16(dx * dx + dy * dy) - time - atan2_8(dy, dx);
+            break;
+        }
+        hues[i] = (uint8_t)h;
+    }
+}
+
+/* 与坐标公式的色相误差，查表结果对应不上附近任何色相时返回INT32_MAX */
+static int hue_error(const uint8_t rgb[3], uint8_t ref_hue, const rgb_effect_params_t *p, int search)
+{
+    for (int d = 0; d <= search; d++) {
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            uint8_t want[3];
+            rgb_effect_hsv_to_rgb((uint8_t)(ref_hue + sign * d), p->sat, p->val, want);
+            if (memcmp(want, rgb, 3) == 0) {
+                return d;
+            }
+        }
+    }
+    return INT32_MAX;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile uint8_t s_sink;
+
+typedef struct {
+    uint16_t mode;
+    const char *name;
+    int tolerance;          // 允许的色相误差（一圈为256）
+} mode_case_t;
+
+/*
+ * 误差上限：距离和角度四舍五入与截断最多差1，按公式中的系数放大（3/2、3、1、1+1）；
+ * 旋转类灯效的正弦表与sin8最多差2/127，乘以最大系数约64（beacon）或96（pinwheels）后再加取整误差
+ */
+static const mode_case_t s_modes[] = {
+    {RGB_MATRIX_RAINBOW_BEACON,         "rainbow_beacon",    3},
+    {RGB_MATRIX_RAINBOW_PINWHEELS,      "rainbow_pinwheels", 4},
+    {RGB_MATRIX_RAINBOW_MOVING_CHEVRON, "moving_chevron",    0},
+    {RGB_MATRIX_CYCLE_LEFT_RIGHT,       "cycle_left_right",  0},
+    {RGB_MATRIX_CYCLE_UP_DOWN,          "cycle_up_down",     0},
+    {RGB_MATRIX_CYCLE_OUT_IN,           "cycle_out_in",      2},
+    {RGB_MATRIX_CYCLE_OUT_IN_DUAL,      "cycle_out_in_dual", 3},
+    {RGB_MATRIX_CYCLE_PINWHEEL,         "cycle_pinwheel",    1},
+    {RGB_MATRIX_CYCLE_SPIRAL,           "cycle_spiral",      2},
+};
+
+int main(void)
+{
+    rgb_effect_tables_init(&s_led_config);
+
+    HOST_CHECK(!rgb_effect_select(RGB_MATRIX_SOLID_COLOR), "solid color must stay with rgb_matrix");
+    HOST_CHECK(!rgb_effect_is_active(), "table renderer active after a non-table mode");
+
+    // 色相表在三原色上的取值
+    uint8_t rgb[3];
+    rgb_effect_hsv_to_rgb(0, 255, 255, rgb);
+    HOST_CHECK(rgb[0] == 255 && rgb[1] == 0 && rgb[2] == 0, "red %u,%u,%u", rgb[0], rgb[1], rgb[2]);
+    rgb_effect_hsv_to_rgb(0, 0, 255, rgb);
+    HOST_CHECK(rgb[0] == 255 && rgb[1] == 255 && rgb[2] == 255, "white %u,%u,%u", rgb[0], rgb[1], rgb[2]);
+
+    const rgb_effect_params_t params_list[] = {
+        {.hue = 0,   .sat = 255, .val = 255, .speed = 100},
+        {.hue = 170, .sat = 255, .val = 255, .speed = 255},
+        {.hue = 40,  .sat = 255, .val = 255, .speed = 0},
+    };
+
+    for (size_t m = 0; m < sizeof(s_modes) / sizeof(s_modes[0]); m++) {
+        const mode_case_t *mc = &s_modes[m];
+        HOST_CHECK(rgb_effect_select(mc->mode), "%s has no table implementation", mc->name);
+
+        // 等价性：每帧每个LED的颜色都必须是坐标公式色相附近tolerance以内的颜色
+        int max_error = 0;
+        for (size_t p = 0; p < sizeof(params_list) / sizeof(params_list[0]); p++) {
+            const rgb_effect_params_t *params = &params_list[p];
+            for (uint32_t f = 0; f < FRAMES; f++) {
+                uint32_t time_ms = f * FRAME_MS;
+                uint8_t colors[LED_COUNT][3];
+                uint8_t hues[LED_COUNT];
+                rgb_effect_render(time_ms, params, colors);
+                reference_hues(mc->mode, time_ms, params, hues);
+                for (int i = 0; i < LED_COUNT; i++) {
+                    int err = hue_error(colors[i], hues[i], params, 8);
+                    HOST_CHECK(err <= mc->tolerance, "%s frame %lu led %d: hue error %d > %d", mc->name,
+                               (unsigned long)f, i, err, mc->tolerance);
+                    if (err != INT32_MAX && err > max_error) {
+                        max_error = err;
+                    }
+                }
+            }
+        }
+
+        // 基准：查表渲染与逐帧坐标计算（再做同样的HSV转换）各10000帧
+        uint8_t colors[LED_COUNT][3];
+        uint8_t hues[LED_COUNT];
+        double t0 = now_ns();
+        for (uint32_t f = 0; f < FRAMES; f++) {
+            rgb_effect_render(f * FRAME_MS, &params_list[0], colors);
+            s_sink ^= colors[f % LED_COUNT][f % 3];
+        }
+        double t1 = now_ns();
+        for (uint32_t f = 0; f < FRAMES; f++) {
+            reference_hues(mc->mode, f * FRAME_MS, &params_list[0], hues);
+            for (int i = 0; i < LED_COUNT; i++) {
+                rgb_effect_hsv_to_rgb(hues[i], params_list[0].sat, params_list[0].val, colors[i]);
+            }
+            s_sink ^= colors[f % LED_COUNT][f % 3];
+        }
+        double t2 = now_ns();
+        printf("%-18s max hue error %d  table %7.1f ns/frame  coordinates %7.1f ns/frame\n", mc->name,
+               max_error, (t1 - t0) / FRAMES, (t2 - t1) / FRAMES);
+    }
+
+    return HOST_TEST_RESULT("rgb_effect_tables");
+}
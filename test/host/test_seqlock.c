@@ -0,0 +1,216 @@
+/**
+ * @file test_seqlock.c
+ * @brief 顺序锁的多线程测试
+ *
+ * 一个写方不停发布，多个读方用不休眠的try_read读取：
+ *   1. 读到的数据必须是某一次完整的发布（所有字来自同一次发布），发布次数与数据一致且不回退
+ *   2. lamp_array_buffer按同样的方式检查：每次提交时所有灯为同一颜色，读到的一帧不能混色
+ * 同时统计try_read失败的比例，失败只能发生在写方发布到一半时
+ * 写方每次发布后空转一段时间，序号大部分时间为偶数，读方在读到一半时被抢占才能暴露撕裂，
+ * 单核机器上也一样；测试按时间而不是发布次数运行
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#include "seqlock.h"
+#include "lamp_array_buffer.h"
+#include "host_test.h"
+
+#define WORDS       1024
+#define RUN_MS      300
+#define IDLE_SPINS  2000        // 两次发布之间写方空转的次数
+#define READERS     3
+
+static seqlock_t s_lock;
+static _Atomic uint32_t s_words[WORDS];
+static atomic_bool s_done;
+static uint32_t s_publishes;
+
+static int64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void idle_spin(void)
+{
+    for (volatile int i = 0; i < IDLE_SPINS; i++) {
+    }
+}
+
+typedef struct {
+    uint32_t reads;
+    uint32_t failed;
+    uint32_t torn;
+    uint32_t mismatched;
+    uint32_t backwards;
+} reader_stats_t;
+
+static void *seqlock_writer(void *arg)
+{
+    (void)arg;
+    static uint32_t data[WORDS];
+    int64_t end = now_ms() + RUN_MS;
+    uint32_t n = 0;
+    while (now_ms() < end) {
+        n++;
+        for (int i = 0; i < WORDS; i++) {
+            data[i] = n * 2654435761u + (uint32_t)i;
+        }
+        seqlock_publish(&s_lock, s_words, data, WORDS);
+        idle_spin();
+    }
+    s_publishes = n;
+    atomic_store(&s_done, true);
+    return NULL;
+}
+
+static void *seqlock_reader(void *arg)
+{
+    reader_stats_t *stats = arg;
+    uint32_t last = 0;
+    static _Thread_local uint32_t data[WORDS];
+
+    while (!atomic_load(&s_done)) {
+        uint32_t published;
+        stats->reads++;
+        if (!seqlock_try_read(&s_lock, s_words, data, WORDS, &published)) {
+            stats->failed++;
+            continue;
+        }
+        if (published == 0) {
+            continue;
+        }
+        // 第0个字确定是第几次发布，其余字必须来自同一次
+        uint32_t n = published;
+        for (int i = 0; i < WORDS; i++) {
+            if (data[i] != n * 2654435761u + (uint32_t)i) {
+                if (data[0] == n * 2654435761u) {
+                    stats->torn++;
+                } else {
+                    stats->mismatched++;
+                }
+                break;
+            }
+        }
+        if (published < last) {
+            stats->backwards++;
+        }
+        last = published;
+    }
+    return NULL;
+}
+
+static void test_seqlock(void)
+{
+    pthread_t writer, readers[READERS];
+    reader_stats_t stats[READERS];
+    memset(stats, 0, sizeof(stats));
+
+    for (int i = 0; i < READERS; i++) {
+        pthread_create(&readers[i], NULL, seqlock_reader, &stats[i]);
+    }
+    pthread_create(&writer, NULL, seqlock_writer, NULL);
+    pthread_join(writer, NULL);
+    for (int i = 0; i < READERS; i++) {
+        pthread_join(readers[i], NULL);
+        HOST_CHECK(stats[i].torn == 0, "reader %d saw %lu torn snapshots", i, (unsigned long)stats[i].torn);
+        HOST_CHECK(stats[i].mismatched == 0, "reader %d: %lu snapshots disagree with the sequence", i,
+                   (unsigned long)stats[i].mismatched);
+        HOST_CHECK(stats[i].backwards == 0, "reader %d saw the sequence go backwards", i);
+        printf("seqlock reader %d: %lu reads, %lu gave up while the writer was publishing\n", i,
+               (unsigned long)stats[i].reads, (unsigned long)stats[i].failed);
+    }
+
+    static uint32_t data[WORDS];
+    uint32_t published;
+    HOST_CHECK(seqlock_try_read(&s_lock, s_words, data, WORDS, &published) && published == s_publishes,
+               "final read must see every publish");
+}
+
+/* ---------------- lamp_array_buffer ---------------- */
+
+static atomic_bool s_lamp_done;
+static uint32_t s_commits;
+
+static void *lamp_writer(void *arg)
+{
+    (void)arg;
+    int64_t end = now_ms() + RUN_MS;
+    uint32_t n = 0;
+    while (now_ms() < end) {
+        n++;
+        uint8_t rgbi[LAMP_CHANNELS] = {(uint8_t)n, (uint8_t)(n >> 8), (uint8_t)(n >> 16), 0xa5};
+        for (uint16_t lamp = 0; lamp < WS2812B_NUM; lamp++) {
+            lamp_array_stage(lamp, rgbi);
+        }
+        lamp_array_commit();
+        idle_spin();
+    }
+    s_commits = n;
+    atomic_store(&s_lamp_done, true);
+    return NULL;
+}
+
+static void *lamp_reader(void *arg)
+{
+    reader_stats_t *stats = arg;
+    uint8_t colors[WS2812B_NUM][LAMP_CHANNELS];
+
+    while (!atomic_load(&s_lamp_done)) {
+        uint32_t generation;
+        stats->reads++;
+        if (!lamp_array_try_read(colors, &generation)) {
+            stats->failed++;
+            continue;
+        }
+        if (generation == 0) {
+            continue;
+        }
+        uint32_t n = colors[0][0] | (colors[0][1] << 8) | (colors[0][2] << 16);
+        if (n != generation) {
+            stats->mismatched++;
+        }
+        for (int lamp = 1; lamp < WS2812B_NUM; lamp++) {
+            if (memcmp(colors[lamp], colors[0], LAMP_CHANNELS) != 0) {
+                stats->torn++;
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void test_lamp_array(void)
+{
+    pthread_t writer, readers[READERS];
+    reader_stats_t stats[READERS];
+    memset(stats, 0, sizeof(stats));
+
+    for (int i = 0; i < READERS; i++) {
+        pthread_create(&readers[i], NULL, lamp_reader, &stats[i]);
+    }
+    pthread_create(&writer, NULL, lamp_writer, NULL);
+    pthread_join(writer, NULL);
+    for (int i = 0; i < READERS; i++) {
+        pthread_join(readers[i], NULL);
+        HOST_CHECK(stats[i].torn == 0, "lamp reader %d saw %lu mixed frames", i, (unsigned long)stats[i].torn);
+        HOST_CHECK(stats[i].mismatched == 0, "lamp reader %d: %lu frames disagree with the generation", i,
+                   (unsigned long)stats[i].mismatched);
+    }
+
+    uint8_t colors[WS2812B_NUM][LAMP_CHANNELS];
+    uint32_t generation;
+    HOST_CHECK(lamp_array_try_read(colors, &generation) && generation == s_commits,
+               "final lamp read must see the last commit");
+}
+
+int main(void)
+{
+    test_seqlock();
+    test_lamp_array();
+    return HOST_TEST_RESULT("seqlock");
+}
@@ -0,0 +1,200 @@
+/**
+ * @file test_ws2812_spi.c
+ * @brief WS2812 SPI编码与led_strip SPI后端的逐字节比较
+ *
+ * 1. ws2812_spi_encode_byte对全部256个字节值的编码与led_strip的SPI后端逐字节相同
+ * 2. 经过set_pixel和refresh送到SPI的整条波形按GRB顺序排列，只有颜色变化的灯珠被重新编码
+ * 3. 上一帧仍在传输时refresh返回ESP_ERR_TIMEOUT，不修改正在发送的缓冲区
+ * SPI主机驱动由本文件中的假实现代替，只记录放入队列的传输
+ */
+
+#include <string.h>
+#include "ws2812_spi.h"
+#include "keyboard_led.h"
+#include "led_strip_interface.h"
+#include "host_test.h"
+
+#define LED_COUNT   WS2812B_NUM
+#define WAVE_BYTES  (LED_COUNT * WS2812_SPI_BYTES_PER_LED)
+
+/*
+ * led_strip组件（2.5.x）SPI后端的编码函数，原样保留作为参考：
+ * 每个数据位用3个SPI位表示，0为100，1为110，一个颜色字节占3个SPI字节
+ */
+#define BIT(n)  (1u << (n))
+static void led_strip_spi_bit(uint8_t data, uint8_t *buf)
+{
+    *(buf + 2) |= data & BIT(0) ? BIT(2) | BIT(1) : BIT(2);
+    *(buf + 2) |= data & BIT(1) ? BIT(5) | BIT(4) : BIT(5);
+    *(buf + 2) |= data & BIT(2) ? BIT(7) : 0x00;
+    *(buf + 1) |= BIT(0);
+    *(buf + 1) |= data & BIT(3) ? BIT(3) | BIT(2) : BIT(3);
+    *(buf + 1) |= data & BIT(4) ? BIT(6) | BIT(5) : BIT(6);
+    *(buf + 0) |= data & BIT(5) ? BIT(1) | BIT(0) : BIT(1);
+    *(buf + 0) |= data & BIT(6) ? BIT(4) | BIT(3) : BIT(4);
+    *(buf + 0) |= data & BIT(7) ? BIT(7) | BIT(6) : BIT(7);
+}
+
+/* led_strip按GRB顺序编码整条灯带 */
+static void reference_wave(const uint8_t colors[][3], uint8_t wave[WAVE_BYTES])
+{
+    memset(wave, 0, WAVE_BYTES);
+    for (int i = 0; i < LED_COUNT; i++) {
+        uint8_t *out = wave + i * WS2812_SPI_BYTES_PER_LED;
+        led_strip_spi_bit(colors[i][1], out);
+        led_strip_spi_bit(colors[i][0], out + 3);
+        led_strip_spi_bit(colors[i][2], out + 6);
+    }
+}
+
+/* ---------------- 假SPI主机驱动 ---------------- */
+
+static transaction_cb_t s_post_cb;
+static spi_transaction_t *s_in_flight;  // 已放入队列、尚未完成的传输
+static spi_transaction_t *s_done;       // 已完成、尚未取回结果的传输
+static uint8_t s_sent[WAVE_BYTES];      // 最近一次放入队列时缓冲区的内容
+static int s_queued;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *bus_config, int dma_chan)
+{
+    (void)host;
+    (void)bus_config;
+    (void)dma_chan;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host)
+{
+    (void)host;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *dev_config,
+                             spi_device_handle_t *handle)
+{
+    (void)host;
+    s_post_cb = dev_config->post_cb;
+    *handle = (spi_device_handle_t)&s_post_cb;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+    (void)handle;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_actual_freq(spi_device_handle_t handle, int *freq_khz)
+{
+    (void)handle;
+    *freq_khz = WS2812_SPI_CLOCK_HZ / 1000;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans, TickType_t ticks_to_wait)
+{
+    (void)handle;
+    (void)ticks_to_wait;
+    if (s_in_flight != NULL || s_done != NULL) {
+        return ESP_ERR_TIMEOUT;
+    }
+    HOST_CHECK(trans->length == WAVE_BYTES * 8, "transfer length %zu bits", trans->length);
+    memcpy(s_sent, trans->tx_buffer, WAVE_BYTES);
+    s_in_flight = trans;
+    s_queued++;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans, TickType_t ticks_to_wait)
+{
+    (void)handle;
+    (void)ticks_to_wait;
+    if (s_done == NULL) {
+        return ESP_ERR_TIMEOUT;
+    }
+    *trans = s_done;
+    s_done = NULL;
+    return ESP_OK;
+}
+
+/* 模拟传输完成中断 */
+static void complete_transfer(void)
+{
+    s_done = s_in_flight;
+    s_in_flight = NULL;
+    s_post_cb(s_done);
+}
+
+/* ---------------- 测试 ---------------- */
+
+static void test_encode_all_bytes(void)
+{
+    for (int value = 0; value < 256; value++) {
+        uint8_t want[3] = {0};
+        uint8_t got[3];
+        led_strip_spi_bit((uint8_t)value, want);
+        ws2812_spi_encode_byte((uint8_t)value, got);
+        HOST_CHECK(memcmp(want, got, 3) == 0, "byte 0x%02x: got %02x %02x %02x want %02x %02x %02x", value,
+                   got[0], got[1], got[2], want[0], want[1], want[2]);
+    }
+}
+
+static void test_strip_wave(void)
+{
+    led_strip_handle_t strip = NULL;
+    const ws2812_spi_config_t config = {
+        .gpio_num = WS2812B_DATA_PIN,
+        .led_count = LED_COUNT,
+        .spi_host = SPI2_HOST,
+    };
+    HOST_CHECK(ws2812_spi_new(&config, &strip) == ESP_OK, "ws2812_spi_new");
+
+    uint8_t colors[LED_COUNT][3] = {{0}};
+    uint8_t want[WAVE_BYTES];
+
+    // 创建后第一帧为全部熄灭
+    HOST_CHECK(strip->refresh(strip) == ESP_OK, "first refresh");
+    reference_wave(colors, want);
+    HOST_CHECK(memcmp(s_sent, want, WAVE_BYTES) == 0, "initial wave is not all off");
+
+    // 传输未完成时refresh不等待也不改缓冲区
+    colors[0][0] = 255;
+    strip->set_pixel(strip, 0, 255, 0, 0);
+    HOST_CHECK(strip->refresh(strip) == ESP_ERR_TIMEOUT, "refresh while busy must time out");
+    HOST_CHECK(s_queued == 1, "refresh while busy queued a transfer");
+    complete_transfer();
+
+    // 多帧随机颜色，每帧只改部分灯珠
+    uint32_t seed = 45;
+    for (int frame = 0; frame < 200; frame++) {
+        for (int i = 0; i < LED_COUNT; i++) {
+            seed = seed * 1103515245u + 12345u;
+            if ((seed >> 16) % 3 == 0) {
+                for (int ch = 0; ch < 3; ch++) {
+                    seed = seed * 1103515245u + 12345u;
+                    colors[i][ch] = (uint8_t)(seed >> 16);
+                }
+            }
+            strip->set_pixel(strip, i, colors[i][0], colors[i][1], colors[i][2]);
+        }
+        HOST_CHECK(strip->refresh(strip) == ESP_OK, "refresh frame %d", frame);
+        reference_wave(colors, want);
+        HOST_CHECK(memcmp(s_sent, want, WAVE_BYTES) == 0, "wave differs from led_strip at frame %d", frame);
+        complete_transfer();
+    }
+
+    HOST_CHECK(strip->set_pixel(strip, LED_COUNT, 1, 2, 3) == ESP_ERR_INVALID_ARG, "index out of range accepted");
+    HOST_CHECK(strip->clear(strip) == ESP_OK, "clear");
+    memset(colors, 0, sizeof(colors));
+    reference_wave(colors, want);
+    HOST_CHECK(memcmp(s_sent, want, WAVE_BYTES) == 0, "wave after clear is not all off");
+    complete_transfer();
+    HOST_CHECK(strip->del(strip) == ESP_OK, "del");
+}
+
+int main(void)
+{
+    test_encode_all_bytes();
+    test_strip_wave();
+    return HOST_TEST_RESULT("ws2812_spi");
+}
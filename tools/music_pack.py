@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成music分区的打包镜像，格式见main/audio_player/music_pack.h
+
+用法:
+    python tools/music_pack.py -o music.bin spiffs_image/*.mp3
+    parttool.py write_partition --partition-name music --input music.bin
+
+镜像烧录后播放器直接映射分区播放；改回SPIFFS时重新烧录SPIFFS镜像即可
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x4B504D4B      # "KMPK"
+VERSION = 1
+NAME_LEN = 32
+ALIGN = 16
+PARTITION_SIZE = 6 * 1024 * 1024
+
+HEADER = struct.Struct('<IHHII')
+ENTRY = struct.Struct('<II%ds' % NAME_LEN)
+
+
+def align(value):
+    return (value + ALIGN - 1) // ALIGN * ALIGN
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack MP3 files into a music partition image')
+    parser.add_argument('-o', '--output', required=True, help='output image')
+    parser.add_argument('--size', type=lambda v: int(v, 0), default=PARTITION_SIZE, help='partition size')
+    parser.add_argument('files', nargs='+', help='MP3 files in playback order')
+    args = parser.parse_args()
+
+    if len(args.files) > 0xFFFF:
+        sys.exit('too many tracks')
+
+    # 目录紧跟文件头，曲目数据从对齐后的位置开始连续存放
+    offset = align(HEADER.size + ENTRY.size * len(args.files))
+    entries = []
+    blobs = []
+    for path in args.files:
+        with open(path, 'rb') as f:
+            data = f.read()
+        name = os.path.basename(path).encode('utf-8')[:NAME_LEN - 1]
+        entries.append(ENTRY.pack(offset, len(data), name))
+        blobs.append((offset, data))
+        offset = align(offset + len(data))
+
+    data_end = blobs[-1][0] + len(blobs[-1][1])
+    if data_end > args.size:
+        sys.exit('image is %d bytes, partition is %d bytes' % (data_end, args.size))
+
+    image = bytearray(HEADER.pack(MAGIC, VERSION, len(entries), data_end, 0))
+    for entry in entries:
+        image += entry
+    for blob_offset, data in blobs:
+        image += b'\xff' * (blob_offset - len(image))
+        image += data
+
+    with open(args.output, 'wb') as f:
+        f.write(image)
+    print('%s: %d tracks, %d bytes' % (args.output, len(entries), len(image)))
+
+
+if __name__ == '__main__':
+    main()